@@ -0,0 +1,874 @@
+/**
+ * @file bigfloat.c
+ * @brief Arbitrary-precision binary floating-point numbers
+ * @date 18.10.2026
+ */
+
+#include "bigfloat.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BIGFLOAT_GUARD_BITS 64      // extra precision of intermediate results of division and roots
+#define BIGFLOAT_TIE_BITS 32        // results closer to a midpoint than 2^32 of their ulps are checked exactly
+#define BIGFLOAT_NEWTON_START 60    // precision of the initial long double approximation in bits
+#define BIGFLOAT_MAX_NEWTON_STEPS 64
+#define BIGFLOAT_MAX_DEC_EXP 100000 // largest decimal exponent accepted by bigfloat_set_string
+
+/**
+ * @brief Bit k of |a|.
+ */
+static bool mag_bit(const bigint_t *a, size_t k)
+{
+    size_t limb = k / 64;
+    return limb < a->size && (a->limbs[limb] >> (k % 64) & 1);
+}
+
+/**
+ * @brief Tests whether any of the bits 0 .. k-1 of |a| is set.
+ */
+static bool mag_low_nonzero(const bigint_t *a, size_t k)
+{
+    size_t limbs = k / 64;
+    for (size_t i = 0; i < limbs && i < a->size; i++)
+    {
+        if (a->limbs[i] != 0)
+        {
+            return true;
+        }
+    }
+    return limbs < a->size && k % 64 != 0 && (a->limbs[limbs] & (((uint64_t)1 << (k % 64)) - 1)) != 0;
+}
+
+/**
+ * @brief Rounds mant * 2^exp to the precision of r and moves it into r (the content of mant is lost).
+ * @param r
+ * @param mant mantissa
+ * @param exp exponent
+ * @param sticky true if the exact value is slightly greater in magnitude than mant * 2^exp,
+ * mant has to have at least prec + 2 bits in that case
+ */
+static void bf_round(bigfloat_t *r, bigint_t *mant, long exp, bool sticky)
+{
+    size_t bits = bigint_bit_length(mant);
+    if (bits > r->prec)
+    {
+        size_t k = bits - r->prec;
+        bool half = mag_bit(mant, k - 1);
+        bool low = sticky || mag_low_nonzero(mant, k - 1);
+        bigint_shr(mant, mant, k);
+        exp += (long)k;
+        if (half && (low || mag_bit(mant, 0)))
+        {
+            int sign = mant->sign;
+            mant->sign = 1;
+            bigint_mul_add_u64(mant, mant, 1, 1);
+            mant->sign = sign;
+            if (bigint_bit_length(mant) > r->prec)
+            {
+                bigint_shr(mant, mant, 1);
+                exp++;
+            }
+        }
+    }
+    bigint_swap(&r->mant, mant);
+    r->exp = bigint_is_zero(&r->mant) ? 0 : exp;
+}
+
+/**
+ * @brief Position above the most significant bit, |x| lies in [2^(top-1), 2^top).
+ */
+static long bf_top(const bigfloat_t *x)
+{
+    return x->exp + (long)bigint_bit_length(&x->mant);
+}
+
+/**
+ * @brief Precisions of the Newton steps, from the last one down to the first one.
+ * @param precs destination, BIGFLOAT_MAX_NEWTON_STEPS long
+ * @param prec final precision
+ * @param guard bits added at every step
+ * @return number of steps
+ */
+static int bf_newton_precisions(size_t *precs, size_t prec, size_t guard)
+{
+    int n = 0;
+    while (prec > BIGFLOAT_NEWTON_START && n < BIGFLOAT_MAX_NEWTON_STEPS)
+    {
+        precs[n++] = prec;
+        prec = prec / 2 + guard;
+    }
+    return n;
+}
+
+void bigfloat_init(bigfloat_t *x, size_t prec)
+{
+    bigint_init(&x->mant);
+    x->exp = 0;
+    x->prec = (prec < BIGFLOAT_MIN_PREC) ? BIGFLOAT_MIN_PREC : prec;
+}
+
+void bigfloat_free(bigfloat_t *x)
+{
+    bigint_free(&x->mant);
+    x->exp = 0;
+}
+
+void bigfloat_set_prec(bigfloat_t *x, size_t prec)
+{
+    x->prec = (prec < BIGFLOAT_MIN_PREC) ? BIGFLOAT_MIN_PREC : prec;
+    bigint_t m;
+    bigint_init(&m);
+    bigint_swap(&m, &x->mant);
+    bf_round(x, &m, x->exp, false);
+    bigint_free(&m);
+}
+
+size_t bigfloat_digits_to_prec(size_t digits)
+{
+    return (size_t)ceill((long double)digits * 3.32192809488736234787L) + 8;
+}
+
+void bigfloat_copy(bigfloat_t *r, const bigfloat_t *a)
+{
+    bigint_t m;
+    bigint_init(&m);
+    bigint_copy(&m, &a->mant);
+    bf_round(r, &m, a->exp, false);
+    bigint_free(&m);
+}
+
+void bigfloat_set_i64(bigfloat_t *r, long long x)
+{
+    bigint_t m;
+    bigint_init(&m);
+    bigint_set_i64(&m, x);
+    bf_round(r, &m, 0, false);
+    bigint_free(&m);
+}
+
+void bigfloat_set_ld(bigfloat_t *r, long double x)
+{
+    int e = 0;
+    long double f = frexpl(fabsl(x), &e);
+    bigint_t m;
+    bigint_init(&m);
+    bigint_set_u64(&m, (uint64_t)ldexpl(f, 64));
+    if (x < 0)
+    {
+        bigint_neg(&m, &m);
+    }
+    bf_round(r, &m, (long)e - 64, false);
+    bigint_free(&m);
+}
+
+void bigfloat_set_bigint(bigfloat_t *r, const bigint_t *m, long e)
+{
+    bigint_t t;
+    bigint_init(&t);
+    bigint_copy(&t, m);
+    bf_round(r, &t, e, false);
+    bigint_free(&t);
+}
+
+long double bigfloat_get_ld(const bigfloat_t *x)
+{
+    if (bigint_is_zero(&x->mant))
+    {
+        return 0.0L;
+    }
+    // rounded to the 64-bit mantissa of long double
+    bigfloat_t t;
+    bigfloat_init(&t, 64);
+    bigfloat_copy(&t, x);
+    long double v = (long double)t.mant.limbs[0];
+    long exp = t.exp;
+    bigfloat_free(&t);
+    if (exp > 100000)
+    {
+        exp = 100000;
+    }
+    else if (exp < -100000)
+    {
+        exp = -100000;
+    }
+    v = ldexpl(v, (int)exp);
+    return (x->mant.sign < 0) ? -v : v;
+}
+
+bool bigfloat_set_string(bigfloat_t *r, const char *str, char dp_sep)
+{
+    size_t len = strlen(str);
+    char *digits = malloc(len + 2);
+    if (digits == NULL)
+    {
+        fprintf(stderr, "bigint - memory allocation error\n");
+        abort();
+    }
+    const char *s = str;
+    size_t n = 0;
+    if (*s == '-' || *s == '+')
+    {
+        digits[n++] = *s++;
+    }
+    size_t first_digit = n;
+    long exp = 0;
+    bool after_point = false;
+    for (;; s++)
+    {
+        if (*s >= '0' && *s <= '9')
+        {
+            digits[n++] = *s;
+            if (after_point)
+            {
+                exp--;
+            }
+        }
+        else if (*s == dp_sep && !after_point)
+        {
+            after_point = true;
+        }
+        else
+        {
+            break;
+        }
+    }
+    bool valid = n > first_digit;
+    if (valid && (*s == 'e' || *s == 'E'))
+    {
+        s++;
+        char *end;
+        long e = strtol(s, &end, 10);
+        valid = (*s == '-' || *s == '+' || (*s >= '0' && *s <= '9')) && end != s &&
+                e <= BIGFLOAT_MAX_DEC_EXP && e >= -BIGFLOAT_MAX_DEC_EXP;
+        exp += e;
+        s = end;
+    }
+    valid = valid && *s == '\0';
+
+    bigint_t m, p, rem;
+    bigint_init(&m);
+    bigint_init(&p);
+    bigint_init(&rem);
+    valid = valid && bigint_set_string(&m, digits, n);
+    if (valid)
+    {
+        bigint_set_u64(&p, 10);
+        if (exp >= 0)
+        {
+            bigint_pow_u64(&p, &p, (uint64_t)exp);
+            bigint_mul(&m, &m, &p);
+            bf_round(r, &m, 0, false);
+        }
+        else
+        {
+            // m / 10^-exp with at least prec + 2 significant bits
+            bigint_pow_u64(&p, &p, (uint64_t)-exp);
+            long shift = (long)(r->prec + 2 + bigint_bit_length(&p)) - (long)bigint_bit_length(&m);
+            if (shift < 0)
+            {
+                shift = 0;
+            }
+            bigint_shl(&m, &m, (size_t)shift);
+            bigint_divmod(&m, &rem, &m, &p);
+            bf_round(r, &m, -shift, !bigint_is_zero(&rem));
+        }
+    }
+    bigint_free(&m);
+    bigint_free(&p);
+    bigint_free(&rem);
+    free(digits);
+    return valid;
+}
+
+/**
+ * @brief N = round(|x| * 10^s)
+ */
+static void bf_scaled_integer(bigint_t *n, const bigfloat_t *x, long s)
+{
+    bigint_t num, den, p;
+    bigint_init(&num);
+    bigint_init(&den);
+    bigint_init(&p);
+    bigint_copy(&num, &x->mant);
+    num.sign = 1;
+    bigint_set_u64(&den, 1);
+    bigint_set_u64(&p, 10);
+    bigint_pow_u64(&p, &p, (uint64_t)labs(s));
+    bigint_mul((s >= 0) ? &num : &den, (s >= 0) ? &num : &den, &p);
+    if (x->exp >= 0)
+    {
+        bigint_shl(&num, &num, (size_t)x->exp);
+    }
+    else
+    {
+        bigint_shl(&den, &den, (size_t)-x->exp);
+    }
+    // (2*num + den) / (2*den)
+    bigint_shl(&num, &num, 1);
+    bigint_add(&num, &num, &den);
+    bigint_shl(&den, &den, 1);
+    bigint_divmod(n, NULL, &num, &den);
+    bigint_free(&num);
+    bigint_free(&den);
+    bigint_free(&p);
+}
+
+size_t bigfloat_get_string(const bigfloat_t *x, char *str, size_t size, size_t digits, char dp_sep)
+{
+    if (digits == 0)
+    {
+        digits = 1;
+    }
+    if (bigint_is_zero(&x->mant))
+    {
+        if (str != NULL && size > 1)
+        {
+            strcpy(str, "0");
+        }
+        return 1;
+    }
+
+    // decimal exponent estimated from the top 64 bits, corrected below
+    bigfloat_t t;
+    bigfloat_init(&t, BIGFLOAT_MIN_PREC);
+    bigfloat_copy(&t, x);
+    long top = bf_top(&t);
+    t.exp -= top;
+    long double lg = (log2l(fabsl(bigfloat_get_ld(&t))) + (long double)top) * 0.30102999566398119521L;
+    bigfloat_free(&t);
+    long k = (long)floorl(lg);
+
+    bigint_t n, low, high;
+    bigint_init(&n);
+    bigint_init(&low);
+    bigint_init(&high);
+    bigint_set_u64(&low, 10);
+    bigint_pow_u64(&low, &low, digits - 1);
+    bigint_set_u64(&high, 10);
+    bigint_pow_u64(&high, &high, digits);
+    for (int attempt = 0; attempt < 3; attempt++)
+    {
+        bf_scaled_integer(&n, x, (long)digits - 1 - k);
+        if (bigint_cmp(&n, &high) >= 0)
+        {
+            k++;
+        }
+        else if (bigint_cmp(&n, &low) < 0)
+        {
+            k--;
+        }
+        else
+        {
+            break;
+        }
+    }
+    if (bigint_cmp(&n, &high) >= 0)
+    {
+        bigint_copy(&n, &low); // rounded up to the next power of 10
+        k++;
+    }
+
+    char *d = malloc(digits + 32);
+    char *out = malloc(2 * digits + 64);
+    if (d == NULL || out == NULL)
+    {
+        fprintf(stderr, "bigint - memory allocation error\n");
+        abort();
+    }
+    bigint_get_string(&n, d, digits + 32);
+    size_t nd = strlen(d);
+    while (nd > 1 && d[nd - 1] == '0')
+    {
+        nd--;
+    }
+
+    size_t len = 0;
+    if (x->mant.sign < 0)
+    {
+        out[len++] = '-';
+    }
+    if (k >= -5 && k < (long)digits)
+    {
+        if (k < 0)
+        {
+            out[len++] = '0';
+            out[len++] = dp_sep;
+            for (long i = 0; i < -k - 1; i++)
+            {
+                out[len++] = '0';
+            }
+            memcpy(out + len, d, nd);
+            len += nd;
+        }
+        else
+        {
+            for (long i = 0; i <= k; i++)
+            {
+                out[len++] = ((size_t)i < nd) ? d[i] : '0';
+            }
+            if ((size_t)k + 1 < nd)
+            {
+                out[len++] = dp_sep;
+                memcpy(out + len, d + k + 1, nd - (size_t)k - 1);
+                len += nd - (size_t)k - 1;
+            }
+        }
+        out[len] = '\0';
+    }
+    else
+    {
+        out[len++] = d[0];
+        if (nd > 1)
+        {
+            out[len++] = dp_sep;
+            memcpy(out + len, d + 1, nd - 1);
+            len += nd - 1;
+        }
+        len += sprintf(out + len, "e%+03ld", k);
+    }
+
+    if (str != NULL && len < size)
+    {
+        memcpy(str, out, len + 1);
+    }
+    free(d);
+    free(out);
+    bigint_free(&n);
+    bigint_free(&low);
+    bigint_free(&high);
+    return len;
+}
+
+bool bigfloat_is_zero(const bigfloat_t *x)
+{
+    return bigint_is_zero(&x->mant);
+}
+
+int bigfloat_sign(const bigfloat_t *x)
+{
+    return bigint_is_zero(&x->mant) ? 0 : x->mant.sign;
+}
+
+int bigfloat_cmp(const bigfloat_t *a, const bigfloat_t *b)
+{
+    int sa = bigfloat_sign(a);
+    int sb = bigfloat_sign(b);
+    if (sa != sb || sa == 0)
+    {
+        return sa - sb;
+    }
+    long ta = bf_top(a);
+    long tb = bf_top(b);
+    if (ta != tb)
+    {
+        return (ta > tb) ? sa : -sa;
+    }
+    bigint_t x, y;
+    bigint_init(&x);
+    bigint_init(&y);
+    bigint_copy(&x, &a->mant);
+    bigint_copy(&y, &b->mant);
+    if (a->exp > b->exp)
+    {
+        bigint_shl(&x, &x, (size_t)(a->exp - b->exp));
+    }
+    else
+    {
+        bigint_shl(&y, &y, (size_t)(b->exp - a->exp));
+    }
+    int c = bigint_cmp(&x, &y);
+    bigint_free(&x);
+    bigint_free(&y);
+    return c;
+}
+
+void bigfloat_neg(bigfloat_t *r, const bigfloat_t *a)
+{
+    bigfloat_copy(r, a);
+    bigint_neg(&r->mant, &r->mant);
+}
+
+void bigfloat_mul_2exp(bigfloat_t *r, const bigfloat_t *a, long e)
+{
+    bigfloat_copy(r, a);
+    if (!bigint_is_zero(&r->mant))
+    {
+        r->exp += e;
+    }
+}
+
+/**
+ * @brief r = a + b * b_sign
+ */
+static void bf_add_signed(bigfloat_t *r, const bigfloat_t *a, const bigfloat_t *b, int b_sign)
+{
+    if (bigint_is_zero(&b->mant))
+    {
+        bigfloat_copy(r, a);
+        return;
+    }
+    if (bigint_is_zero(&a->mant))
+    {
+        bigfloat_copy(r, b);
+        if (b_sign < 0)
+        {
+            bigint_neg(&r->mant, &r->mant);
+        }
+        return;
+    }
+
+    bigint_t mx, my;
+    bigint_init(&mx);
+    bigint_init(&my);
+    bigint_copy(&mx, &a->mant);
+    bigint_copy(&my, &b->mant);
+    if (b_sign < 0)
+    {
+        bigint_neg(&my, &my);
+    }
+    long ex = a->exp;
+    long ey = b->exp;
+    long tx = bf_top(a);
+    long ty = bf_top(b);
+    if (tx < ty)
+    {
+        bigint_swap(&mx, &my);
+        long t = ex;
+        ex = ey;
+        ey = t;
+        t = tx;
+        tx = ty;
+        ty = t;
+    }
+    // an operand entirely below the rounding bit only decides the rounding, replace it with a small one
+    long limit = tx - (long)r->prec - 3;
+    if (ex < limit)
+    {
+        limit = ex;
+    }
+    if (ty <= limit - 1)
+    {
+        bigint_set_i64(&my, my.sign);
+        ey = limit - 2;
+    }
+    long e = (ex < ey) ? ex : ey;
+    bigint_shl(&mx, &mx, (size_t)(ex - e));
+    bigint_shl(&my, &my, (size_t)(ey - e));
+    bigint_add(&mx, &mx, &my);
+    bf_round(r, &mx, e, false);
+    bigint_free(&mx);
+    bigint_free(&my);
+}
+
+void bigfloat_add(bigfloat_t *r, const bigfloat_t *a, const bigfloat_t *b)
+{
+    bf_add_signed(r, a, b, 1);
+}
+
+void bigfloat_sub(bigfloat_t *r, const bigfloat_t *a, const bigfloat_t *b)
+{
+    bf_add_signed(r, a, b, -1);
+}
+
+void bigfloat_mul(bigfloat_t *r, const bigfloat_t *a, const bigfloat_t *b)
+{
+    bigint_t m;
+    bigint_init(&m);
+    bigint_mul(&m, &a->mant, &b->mant);
+    bf_round(r, &m, a->exp + b->exp, false);
+    bigint_free(&m);
+}
+
+void bigfloat_div_u64(bigfloat_t *r, const bigfloat_t *a, uint64_t x)
+{
+    bigint_t m;
+    bigint_init(&m);
+    long shift = (long)(r->prec + 2 + 64) - (long)bigint_bit_length(&a->mant);
+    if (shift < 0)
+    {
+        shift = 0;
+    }
+    bigint_shl(&m, &a->mant, (size_t)shift);
+    uint64_t rem = bigint_divmod_u64(&m, &m, x);
+    bf_round(r, &m, a->exp - shift, rem != 0);
+    bigint_free(&m);
+}
+
+/**
+ * @brief y = 1 / b by Newton iteration y = y + y * (1 - b * y) with precision doubling.
+ * @param y receives the result with the precision of y
+ * @param b nonzero divisor
+ */
+static void bf_reciprocal(bigfloat_t *y, const bigfloat_t *b)
+{
+    // b = B * 2^top with B in [0.5, 1)
+    long top = bf_top(b);
+    bigfloat_t B, Bw, t, e, z;
+    bigfloat_init(&B, y->prec);
+    bigfloat_init(&Bw, y->prec);
+    bigfloat_init(&t, y->prec);
+    bigfloat_init(&e, y->prec);
+    bigfloat_init(&z, BIGFLOAT_MIN_PREC);
+    bigfloat_copy(&B, b);
+    B.exp -= top;
+    bigfloat_copy(&Bw, &B);
+    bigfloat_set_ld(&z, 1.0L / bigfloat_get_ld(&Bw));
+
+    size_t precs[BIGFLOAT_MAX_NEWTON_STEPS];
+    int steps = bf_newton_precisions(precs, y->prec, 2);
+    for (int i = steps - 1; i >= 0; i--)
+    {
+        size_t w = precs[i];
+        Bw.prec = w;
+        bigfloat_copy(&Bw, &B);
+        t.prec = w;
+        e.prec = w;
+        bigfloat_mul(&t, &Bw, &z);
+        bigfloat_set_i64(&e, 1);
+        bigfloat_sub(&e, &e, &t);
+        bigfloat_mul(&t, &z, &e);
+        bigfloat_set_prec(&z, w);
+        bigfloat_add(&z, &z, &t);
+    }
+    bigfloat_mul_2exp(y, &z, -top);
+    bigfloat_free(&B);
+    bigfloat_free(&Bw);
+    bigfloat_free(&t);
+    bigfloat_free(&e);
+    bigfloat_free(&z);
+}
+
+/**
+ * @brief Compares the magnitude of the exact result with m * 2^e.
+ * @return negative, 0 or positive
+ */
+typedef int (*bf_midpoint_cmp)(const bigint_t *m, long e, const void *ctx);
+
+/**
+ * @brief Rounds q, an approximation of a quotient or a root with BIGFLOAT_GUARD_BITS more bits than r,
+ * to the precision of r without double rounding.
+ * @details Rounding q is correct unless q lies within 2^BIGFLOAT_TIE_BITS of its ulps from a midpoint
+ * between two numbers of the precision of r. In that case the exact result is compared with the midpoint.
+ * @param r receives the result, it may alias the operands compared by cmp
+ * @param q approximation, its precision is r->prec + BIGFLOAT_GUARD_BITS
+ * @param cmp comparison of the exact result with a midpoint
+ * @param ctx operands of cmp
+ */
+static void bf_round_checked(bigfloat_t *r, const bigfloat_t *q, bf_midpoint_cmp cmp, const void *ctx)
+{
+    if (bigint_is_zero(&q->mant))
+    {
+        bigfloat_copy(r, q);
+        return;
+    }
+    // |q| = Q * 2^u with Q of prec + BIGFLOAT_GUARD_BITS bits, midpoints are odd multiples of 2^(GUARD-1)
+    long u = bf_top(q) - (long)(r->prec + BIGFLOAT_GUARD_BITS);
+    bigint_t m;
+    bigint_init(&m);
+    bigint_shl(&m, &q->mant, (size_t)(q->exp - u));
+    m.sign = 1;
+    uint64_t low = m.limbs[0] & ((((uint64_t)1 << (BIGFLOAT_GUARD_BITS - 1)) << 1) - 1);
+    uint64_t half = (uint64_t)1 << (BIGFLOAT_GUARD_BITS - 1);
+    uint64_t distance = (low > half) ? low - half : half - low;
+    if (distance >= ((uint64_t)1 << BIGFLOAT_TIE_BITS))
+    {
+        bigfloat_copy(r, q);
+        bigint_free(&m);
+        return;
+    }
+
+    // the midpoint rounds to even, a value below it is truncated, a value above it is rounded up
+    bigint_t step;
+    bigint_init(&step);
+    bigint_set_u64(&step, low);
+    bigint_sub(&m, &m, &step);
+    bigint_set_u64(&step, half);
+    bigint_add(&m, &m, &step);
+    int c = cmp(&m, u, ctx);
+    if (c < 0)
+    {
+        bigint_set_u64(&step, 1);
+        bigint_sub(&m, &m, &step);
+    }
+    m.sign = q->mant.sign;
+    bf_round(r, &m, u, c != 0);
+    bigint_free(&step);
+    bigint_free(&m);
+}
+
+/** @struct bf_div_operands
+ *  @brief Operands of an exact comparison of a quotient a / b.
+ */
+struct bf_div_operands
+{
+    const bigfloat_t *a;
+    const bigfloat_t *b;
+};
+
+/**
+ * @brief Compares |a / b| with m * 2^e by the sign of |a| - m * |b| * 2^e.
+ */
+static int bf_div_cmp(const bigint_t *m, long e, const void *ctx)
+{
+    const struct bf_div_operands *o = ctx;
+    bigint_t lhs, rhs;
+    bigint_init(&lhs);
+    bigint_init(&rhs);
+    bigint_mul(&rhs, m, &o->b->mant);
+    rhs.sign = 1;
+    long shift = o->a->exp - (e + o->b->exp);
+    bigint_shl(&lhs, &o->a->mant, (size_t)((shift > 0) ? shift : 0));
+    lhs.sign = 1;
+    bigint_shl(&rhs, &rhs, (size_t)((shift < 0) ? -shift : 0));
+    int c = bigint_cmp(&lhs, &rhs);
+    bigint_free(&lhs);
+    bigint_free(&rhs);
+    return c;
+}
+
+bool bigfloat_div(bigfloat_t *r, const bigfloat_t *a, const bigfloat_t *b)
+{
+    if (bigint_is_zero(&b->mant))
+    {
+        return false;
+    }
+    bigfloat_t y;
+    bigfloat_init(&y, r->prec + BIGFLOAT_GUARD_BITS);
+    bf_reciprocal(&y, b);
+    bigfloat_mul(&y, a, &y);
+    struct bf_div_operands o = {a, b};
+    bf_round_checked(r, &y, bf_div_cmp, &o);
+    bigfloat_free(&y);
+    return true;
+}
+
+/**
+ * @brief r = a^n, intermediate results are rounded to the precision of r
+ */
+static void bf_pow_u64(bigfloat_t *r, const bigfloat_t *a, unsigned long n)
+{
+    bigfloat_t base, acc;
+    bigfloat_init(&base, r->prec);
+    bigfloat_init(&acc, r->prec);
+    bigfloat_copy(&base, a);
+    bigfloat_set_i64(&acc, 1);
+    while (n > 0)
+    {
+        if (n & 1)
+        {
+            bigfloat_mul(&acc, &acc, &base);
+        }
+        n >>= 1;
+        if (n > 0)
+        {
+            bigfloat_mul(&base, &base, &base);
+        }
+    }
+    bigfloat_copy(r, &acc);
+    bigfloat_free(&base);
+    bigfloat_free(&acc);
+}
+
+/** @struct bf_root_operands
+ *  @brief Operands of an exact comparison of a root of a.
+ */
+struct bf_root_operands
+{
+    const bigfloat_t *a;
+    unsigned long n;
+};
+
+/**
+ * @brief Compares |a|^(1/n) with m * 2^e by comparing |a| with m^n * 2^(n*e).
+ */
+static int bf_root_cmp(const bigint_t *m, long e, const void *ctx)
+{
+    const struct bf_root_operands *o = ctx;
+    bigint_t lhs, rhs;
+    bigint_init(&lhs);
+    bigint_init(&rhs);
+    bigint_pow_u64(&rhs, m, o->n);
+    long shift = o->a->exp - e * (long)o->n;
+    bigint_shl(&lhs, &o->a->mant, (size_t)((shift > 0) ? shift : 0));
+    lhs.sign = 1;
+    bigint_shl(&rhs, &rhs, (size_t)((shift < 0) ? -shift : 0));
+    int c = bigint_cmp(&lhs, &rhs);
+    bigint_free(&lhs);
+    bigint_free(&rhs);
+    return c;
+}
+
+bool bigfloat_root(bigfloat_t *r, const bigfloat_t *a, unsigned long n)
+{
+    int sign = bigfloat_sign(a);
+    if (n == 0 || (sign < 0 && n % 2 == 0))
+    {
+        return false;
+    }
+    if (sign == 0 || n == 1)
+    {
+        bigfloat_copy(r, a);
+        return true;
+    }
+
+    size_t prec = r->prec + BIGFLOAT_GUARD_BITS;
+    // |a| = A * 2^s, s divisible by n, A in [0.5, 2^(n-1))
+    long top = bf_top(a);
+    long s = ((top >= 0) ? top / (long)n : -((-top + (long)n - 1) / (long)n)) * (long)n;
+    bigfloat_t A, Aw, t, e, y;
+    bigfloat_init(&A, prec);
+    bigfloat_init(&Aw, prec);
+    bigfloat_init(&t, prec);
+    bigfloat_init(&e, prec);
+    bigfloat_init(&y, BIGFLOAT_MIN_PREC);
+    bigfloat_copy(&A, a);
+    A.mant.sign = 1;
+    A.exp -= s;
+
+    // initial approximation of A^(-1/n) from log2(A) = log2(F) + top - s, F in [0.5, 1)
+    bigfloat_copy(&t, &A);
+    t.exp -= top - s;
+    long double lg = log2l(bigfloat_get_ld(&t)) + (long double)(top - s);
+    bigfloat_set_ld(&y, exp2l(-lg / (long double)n));
+
+    // y = y + y * (1 - A * y^n) / n
+    size_t precs[BIGFLOAT_MAX_NEWTON_STEPS];
+    int steps = bf_newton_precisions(precs, prec, 4);
+    for (int i = steps - 1; i >= 0; i--)
+    {
+        size_t w = precs[i];
+        Aw.prec = w;
+        bigfloat_copy(&Aw, &A);
+        t.prec = w;
+        e.prec = w;
+        bf_pow_u64(&t, &y, n);
+        bigfloat_mul(&t, &Aw, &t);
+        bigfloat_set_i64(&e, 1);
+        bigfloat_sub(&e, &e, &t);
+        bigfloat_mul(&t, &y, &e);
+        bigfloat_div_u64(&t, &t, n);
+        bigfloat_set_prec(&y, w);
+        bigfloat_add(&y, &y, &t);
+    }
+
+    // A^(1/n) = A * y^(n-1)
+    bigfloat_set_prec(&y, prec);
+    t.prec = prec;
+    bf_pow_u64(&t, &y, n - 1);
+    bigfloat_mul(&t, &A, &t);
+    t.exp += s / (long)n;
+    if (sign < 0)
+    {
+        bigint_neg(&t.mant, &t.mant);
+    }
+    struct bf_root_operands o = {a, n};
+    bf_round_checked(r, &t, bf_root_cmp, &o);
+    bigfloat_free(&A);
+    bigfloat_free(&Aw);
+    bigfloat_free(&t);
+    bigfloat_free(&e);
+    bigfloat_free(&y);
+    return true;
+}
@@ -0,0 +1,175 @@
+/**
+ * @file bigfloat.h
+ * @brief Arbitrary-precision binary floating-point numbers
+ * @date 18.10.2026
+ *
+ * A number is mant * 2^exp with a bigint mantissa and a long exponent. Every number has its own
+ * precision in bits (the mantissa never has more significant bits) and results of operations are
+ * rounded to nearest (ties to even) to the precision of the destination.
+ * Division and roots use Newton iteration with precision doubling, so their cost is a small
+ * multiple of one multiplication at the target precision. Their results carry guard bits and are
+ * rounded once, a result close to a midpoint is rounded by comparing the exact value with it.
+ * Every bigfloat_t has to be initialized with bigfloat_init and released with bigfloat_free.
+ */
+
+#ifndef BIGFLOAT_H
+#define BIGFLOAT_H
+
+#include "bigint.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+#define BIGFLOAT_MIN_PREC 64 // lowest precision in bits
+
+/** @struct bigfloat
+ *  @brief Binary floating-point number mant * 2^exp.
+ *  @param mant signed mantissa, zero or with at most prec significant bits
+ *  @param exp binary exponent
+ *  @param prec precision in bits
+ */
+struct bigfloat
+{
+    bigint_t mant;
+    long exp;
+    size_t prec;
+};
+
+typedef struct bigfloat bigfloat_t;
+
+/**
+ * @brief Initializes the number to zero.
+ * @param x
+ * @param prec precision in bits (at least BIGFLOAT_MIN_PREC is used)
+ */
+void bigfloat_init(bigfloat_t *x, size_t prec);
+
+/**
+ * @brief Frees memory of the number.
+ * @param x
+ */
+void bigfloat_free(bigfloat_t *x);
+
+/**
+ * @brief Changes the precision of the number, the value is rounded if necessary.
+ * @param x
+ * @param prec precision in bits (at least BIGFLOAT_MIN_PREC is used)
+ */
+void bigfloat_set_prec(bigfloat_t *x, size_t prec);
+
+/**
+ * @brief Number of bits required for the given number of decimal digits.
+ */
+size_t bigfloat_digits_to_prec(size_t digits);
+
+/**
+ * @brief r = a, rounded to the precision of r
+ */
+void bigfloat_copy(bigfloat_t *r, const bigfloat_t *a);
+
+/**
+ * @brief r = x
+ */
+void bigfloat_set_i64(bigfloat_t *r, long long x);
+
+/**
+ * @brief r = x
+ * @param r
+ * @param x finite number
+ */
+void bigfloat_set_ld(bigfloat_t *r, long double x);
+
+/**
+ * @brief r = m * 2^e
+ */
+void bigfloat_set_bigint(bigfloat_t *r, const bigint_t *m, long e);
+
+/**
+ * @brief Converts the number to long double (inf on overflow).
+ */
+long double bigfloat_get_ld(const bigfloat_t *x);
+
+/**
+ * @brief Parses a number in decimal notation, e.g. "-12.5e-3".
+ * @param r receives the value rounded to the precision of r
+ * @param str string to be parsed
+ * @param dp_sep decimal point character
+ * @return false if str is not a valid number
+ */
+bool bigfloat_set_string(bigfloat_t *r, const char *str, char dp_sep);
+
+/**
+ * @brief Writes the number in decimal notation rounded to the given number of significant digits.
+ * @details Trailing zeros are removed. Plain notation is used for decimal exponents from -5 to
+ * digits - 1, scientific notation ("1.5e+40") otherwise.
+ * @param x
+ * @param str destination, NULL to only compute the length
+ * @param size size of str
+ * @param digits number of significant digits (at least 1)
+ * @param dp_sep decimal point character
+ * @return length of the string, the string is written only if it is lower than size
+ */
+size_t bigfloat_get_string(const bigfloat_t *x, char *str, size_t size, size_t digits, char dp_sep);
+
+/**
+ * @brief Tests whether the number is zero.
+ */
+bool bigfloat_is_zero(const bigfloat_t *x);
+
+/**
+ * @brief Sign of the number.
+ * @return -1, 0 or 1
+ */
+int bigfloat_sign(const bigfloat_t *x);
+
+/**
+ * @brief Compares a and b.
+ * @return negative if a < b, 0 if a == b, positive if a > b
+ */
+int bigfloat_cmp(const bigfloat_t *a, const bigfloat_t *b);
+
+/**
+ * @brief r = -a
+ */
+void bigfloat_neg(bigfloat_t *r, const bigfloat_t *a);
+
+/**
+ * @brief r = a * 2^e
+ */
+void bigfloat_mul_2exp(bigfloat_t *r, const bigfloat_t *a, long e);
+
+/**
+ * @brief r = a + b
+ */
+void bigfloat_add(bigfloat_t *r, const bigfloat_t *a, const bigfloat_t *b);
+
+/**
+ * @brief r = a - b
+ */
+void bigfloat_sub(bigfloat_t *r, const bigfloat_t *a, const bigfloat_t *b);
+
+/**
+ * @brief r = a * b
+ */
+void bigfloat_mul(bigfloat_t *r, const bigfloat_t *a, const bigfloat_t *b);
+
+/**
+ * @brief r = a / b
+ * @return false if b is zero, r is unchanged in that case
+ */
+bool bigfloat_div(bigfloat_t *r, const bigfloat_t *a, const bigfloat_t *b);
+
+/**
+ * @brief r = a / x
+ * @param r
+ * @param a
+ * @param x x != 0
+ */
+void bigfloat_div_u64(bigfloat_t *r, const bigfloat_t *a, uint64_t x);
+
+/**
+ * @brief r = n-th root of a
+ * @return false if n is zero or a is negative and n is even, r is unchanged in that case
+ */
+bool bigfloat_root(bigfloat_t *r, const bigfloat_t *a, unsigned long n);
+
+#endif
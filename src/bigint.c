@@ -0,0 +1,855 @@
+/**
+ * @file bigint.c
+ * @brief Arbitrary-precision integers
+ * @date 18.10.2026
+ */
+
+#include "bigint.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef unsigned __int128 uint128;
+
+#define DEC_CHUNK 10000000000000000000ull // 10^19, the largest power of 10 in a limb
+#define DEC_CHUNK_DIGITS 19
+#define KARATSUBA_THRESHOLD 32 // operand size in limbs from which Karatsuba multiplication is used
+
+/**
+ * @brief Makes sure that at least n limbs are allocated. The value is preserved.
+ */
+static void bigint_reserve(bigint_t *a, size_t n)
+{
+    if (a->capacity >= n)
+    {
+        return;
+    }
+    size_t capacity = (a->capacity * 2 > n) ? a->capacity * 2 : n;
+    uint64_t *limbs = realloc(a->limbs, capacity * sizeof(uint64_t));
+    if (limbs == NULL)
+    {
+        fprintf(stderr, "bigint - memory allocation error\n");
+        abort();
+    }
+    a->limbs = limbs;
+    a->capacity = capacity;
+}
+
+/**
+ * @brief Removes leading zero limbs.
+ */
+static void bigint_normalize(bigint_t *a)
+{
+    while (a->size > 0 && a->limbs[a->size - 1] == 0)
+    {
+        a->size--;
+    }
+    if (a->size == 0)
+    {
+        a->sign = 1;
+    }
+}
+
+/**
+ * @brief Compares magnitudes given as limb arrays.
+ */
+static int mag_cmp(const uint64_t *a, size_t an, const uint64_t *b, size_t bn)
+{
+    if (an != bn)
+    {
+        return (an > bn) ? 1 : -1;
+    }
+    for (size_t i = an; i-- > 0;)
+    {
+        if (a[i] != b[i])
+        {
+            return (a[i] > b[i]) ? 1 : -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief r = a + b for magnitudes, an >= bn, r has room for an + 1 limbs and may alias a or b.
+ * @return number of limbs of the result
+ */
+static size_t mag_add(uint64_t *r, const uint64_t *a, size_t an, const uint64_t *b, size_t bn)
+{
+    uint64_t carry = 0;
+    size_t i = 0;
+    for (; i < bn; i++)
+    {
+        uint128 s = (uint128)a[i] + b[i] + carry;
+        r[i] = (uint64_t)s;
+        carry = (uint64_t)(s >> 64);
+    }
+    for (; i < an; i++)
+    {
+        uint64_t s = a[i] + carry;
+        carry = (s < carry);
+        r[i] = s;
+    }
+    r[i] = carry;
+    return an + carry;
+}
+
+/**
+ * @brief r = a - b for magnitudes, a >= b, r has room for an limbs and may alias a or b.
+ */
+static void mag_sub(uint64_t *r, const uint64_t *a, size_t an, const uint64_t *b, size_t bn)
+{
+    uint64_t borrow = 0;
+    size_t i = 0;
+    for (; i < bn; i++)
+    {
+        uint64_t bi = b[i] + borrow;
+        uint64_t next = (bi < borrow) || (a[i] < bi);
+        r[i] = a[i] - bi;
+        borrow = next;
+    }
+    for (; i < an; i++)
+    {
+        uint64_t ai = a[i];
+        r[i] = ai - borrow;
+        borrow = (ai < borrow);
+    }
+}
+
+/**
+ * @brief r = a * b for magnitudes (schoolbook), r has room for an + bn limbs and must not alias a or b.
+ */
+static void mag_mul(uint64_t *r, const uint64_t *a, size_t an, const uint64_t *b, size_t bn)
+{
+    memset(r, 0, (an + bn) * sizeof(uint64_t));
+    for (size_t i = 0; i < an; i++)
+    {
+        uint64_t carry = 0;
+        uint64_t ai = a[i];
+        for (size_t j = 0; j < bn; j++)
+        {
+            uint128 t = (uint128)ai * b[j] + r[i + j] + carry;
+            r[i + j] = (uint64_t)t;
+            carry = (uint64_t)(t >> 64);
+        }
+        r[i + bn] = carry;
+    }
+}
+
+/**
+ * @brief Allocates n limbs, allocation failure is fatal.
+ */
+static uint64_t *mag_alloc(size_t n)
+{
+    uint64_t *p = malloc(n * sizeof(uint64_t));
+    if (p == NULL)
+    {
+        fprintf(stderr, "bigint - memory allocation error\n");
+        abort();
+    }
+    return p;
+}
+
+/**
+ * @brief r += a for magnitudes, the sum has to fit in rn limbs.
+ */
+static void mag_add_to(uint64_t *r, size_t rn, const uint64_t *a, size_t an)
+{
+    while (an > 0 && a[an - 1] == 0)
+    {
+        an--;
+    }
+    uint64_t carry = 0;
+    size_t i = 0;
+    for (; i < an; i++)
+    {
+        uint128 s = (uint128)r[i] + a[i] + carry;
+        r[i] = (uint64_t)s;
+        carry = (uint64_t)(s >> 64);
+    }
+    for (; carry != 0 && i < rn; i++)
+    {
+        r[i]++;
+        carry = (r[i] == 0);
+    }
+}
+
+/**
+ * @brief r = a * b for magnitudes, Karatsuba for large operands, schoolbook otherwise.
+ * @details r has room for an + bn limbs and must not alias a or b.
+ */
+static void mag_mul_fast(uint64_t *r, const uint64_t *a, size_t an, const uint64_t *b, size_t bn)
+{
+    if (an < bn)
+    {
+        const uint64_t *t = a;
+        a = b;
+        b = t;
+        size_t tn = an;
+        an = bn;
+        bn = tn;
+    }
+    if (bn < KARATSUBA_THRESHOLD)
+    {
+        mag_mul(r, a, an, b, bn);
+        return;
+    }
+    if (an >= 2 * bn)
+    {
+        // unbalanced operands, b is multiplied by slices of a of its own size
+        memset(r, 0, (an + bn) * sizeof(uint64_t));
+        uint64_t *t = mag_alloc(2 * bn);
+        for (size_t i = 0; i < an; i += bn)
+        {
+            size_t n = (an - i < bn) ? an - i : bn;
+            mag_mul_fast(t, a + i, n, b, bn);
+            mag_add_to(r + i, an + bn - i, t, n + bn);
+        }
+        free(t);
+        return;
+    }
+
+    // a = a1*B^m + a0, b = b1*B^m + b0, a*b = z2*B^2m + (z1 - z2 - z0)*B^m + z0, z1 = (a0 + a1)*(b0 + b1)
+    size_t m = an / 2;
+    size_t a1n = an - m;
+    size_t b1n = bn - m;
+    uint64_t *sa = mag_alloc(a1n + 1);
+    uint64_t *sb = mag_alloc(((m > b1n) ? m : b1n) + 1);
+    size_t san = mag_add(sa, a + m, a1n, a, m);
+    size_t sbn = (m >= b1n) ? mag_add(sb, b, m, b + m, b1n) : mag_add(sb, b + m, b1n, b, m);
+    uint64_t *z1 = mag_alloc(san + sbn);
+    mag_mul_fast(r, a, m, b, m);
+    mag_mul_fast(r + 2 * m, a + m, a1n, b + m, b1n);
+    mag_mul_fast(z1, sa, san, sb, sbn);
+    mag_sub(z1, z1, san + sbn, r, 2 * m);
+    mag_sub(z1, z1, san + sbn, r + 2 * m, a1n + b1n);
+    mag_add_to(r + m, an + bn - m, z1, san + sbn);
+    free(sa);
+    free(sb);
+    free(z1);
+}
+
+void bigint_init(bigint_t *a)
+{
+    a->sign = 1;
+    a->size = 0;
+    a->capacity = 0;
+    a->limbs = NULL;
+}
+
+void bigint_free(bigint_t *a)
+{
+    free(a->limbs);
+    bigint_init(a);
+}
+
+void bigint_copy(bigint_t *a, const bigint_t *b)
+{
+    if (a == b)
+    {
+        return;
+    }
+    bigint_reserve(a, b->size);
+    if (b->size > 0)
+    {
+        memcpy(a->limbs, b->limbs, b->size * sizeof(uint64_t));
+    }
+    a->size = b->size;
+    a->sign = b->sign;
+}
+
+void bigint_swap(bigint_t *a, bigint_t *b)
+{
+    bigint_t tmp = *a;
+    *a = *b;
+    *b = tmp;
+}
+
+void bigint_set_u64(bigint_t *a, uint64_t x)
+{
+    bigint_reserve(a, 1);
+    a->limbs[0] = x;
+    a->size = 1;
+    a->sign = 1;
+    bigint_normalize(a);
+}
+
+void bigint_set_i64(bigint_t *a, int64_t x)
+{
+    bigint_set_u64(a, (x < 0) ? 0ull - (uint64_t)x : (uint64_t)x);
+    if (x < 0)
+    {
+        a->sign = -1;
+    }
+}
+
+void bigint_set_u128(bigint_t *a, unsigned __int128 x)
+{
+    bigint_reserve(a, 2);
+    a->limbs[0] = (uint64_t)x;
+    a->limbs[1] = (uint64_t)(x >> 64);
+    a->size = 2;
+    a->sign = 1;
+    bigint_normalize(a);
+}
+
+void bigint_set_i128(bigint_t *a, __int128 x)
+{
+    bigint_set_u128(a, (x < 0) ? (uint128)0 - (uint128)x : (uint128)x);
+    if (x < 0)
+    {
+        a->sign = -1;
+    }
+}
+
+bool bigint_get_i128(const bigint_t *a, __int128 *x)
+{
+    if (a->size > 2)
+    {
+        return false;
+    }
+    uint128 mag = 0;
+    for (size_t i = a->size; i-- > 0;)
+    {
+        mag = (mag << 64) | a->limbs[i];
+    }
+    uint128 limit = ((uint128)1) << 127;
+    if (a->sign > 0)
+    {
+        if (mag >= limit)
+        {
+            return false;
+        }
+        *x = (__int128)mag;
+    }
+    else
+    {
+        if (mag > limit)
+        {
+            return false;
+        }
+        *x = (__int128)(0 - mag);
+    }
+    return true;
+}
+
+long double bigint_get_ld(const bigint_t *a)
+{
+    if (a->size == 0)
+    {
+        return 0.0L;
+    }
+    // the top two limbs hold more bits than the mantissa of long double
+    long double result = a->limbs[a->size - 1];
+    if (a->size > 1)
+    {
+        result = result * 18446744073709551616.0L + a->limbs[a->size - 2];
+    }
+    for (size_t i = 2; i < a->size; i++)
+    {
+        result *= 18446744073709551616.0L; // 2^64
+    }
+    return (a->sign < 0) ? -result : result;
+}
+
+bool bigint_set_string(bigint_t *a, const char *str, size_t len)
+{
+    int sign = 1;
+    size_t i = 0;
+    if (len > 0 && (str[0] == '-' || str[0] == '+'))
+    {
+        sign = (str[0] == '-') ? -1 : 1;
+        i++;
+    }
+    if (i == len)
+    {
+        return false;
+    }
+
+    a->size = 0;
+    a->sign = 1;
+    while (i < len)
+    {
+        // reads up to 19 digits at once
+        uint64_t chunk = 0, scale = 1;
+        for (int d = 0; d < DEC_CHUNK_DIGITS && i < len; d++, i++)
+        {
+            if (str[i] < '0' || str[i] > '9')
+            {
+                return false;
+            }
+            chunk = chunk * 10 + (uint64_t)(str[i] - '0');
+            scale *= 10;
+        }
+        bigint_mul_add_u64(a, a, scale, chunk);
+    }
+    if (a->size > 0)
+    {
+        a->sign = sign;
+    }
+    return true;
+}
+
+size_t bigint_get_string(const bigint_t *a, char *str, size_t size)
+{
+    if (a->size == 0)
+    {
+        if (str != NULL && size >= 2)
+        {
+            strcpy(str, "0");
+        }
+        return 1;
+    }
+
+    // chunks of 19 digits from the least significant one
+    size_t max_chunks = a->size * 64 / 63 + 1;
+    uint64_t *chunks = malloc(max_chunks * sizeof(uint64_t));
+    if (chunks == NULL)
+    {
+        fprintf(stderr, "bigint - memory allocation error\n");
+        abort();
+    }
+    bigint_t tmp;
+    bigint_init(&tmp);
+    bigint_copy(&tmp, a);
+    size_t count = 0;
+    while (tmp.size > 0)
+    {
+        chunks[count++] = bigint_divmod_u64(&tmp, &tmp, DEC_CHUNK);
+    }
+    bigint_free(&tmp);
+
+    char top[DEC_CHUNK_DIGITS + 1];
+    int top_len = sprintf(top, "%llu", (unsigned long long)chunks[count - 1]);
+    size_t len = (a->sign < 0) + top_len + (count - 1) * DEC_CHUNK_DIGITS;
+    if (str != NULL && len < size)
+    {
+        char *pos = str;
+        if (a->sign < 0)
+        {
+            *pos++ = '-';
+        }
+        memcpy(pos, top, top_len);
+        pos += top_len;
+        for (size_t i = count - 1; i-- > 0;)
+        {
+            pos += sprintf(pos, "%019llu", (unsigned long long)chunks[i]);
+        }
+        *pos = '\0';
+    }
+    free(chunks);
+    return len;
+}
+
+bool bigint_is_zero(const bigint_t *a)
+{
+    return a->size == 0;
+}
+
+size_t bigint_bit_length(const bigint_t *a)
+{
+    if (a->size == 0)
+    {
+        return 0;
+    }
+    return a->size * 64 - __builtin_clzll(a->limbs[a->size - 1]);
+}
+
+int bigint_cmp_abs(const bigint_t *a, const bigint_t *b)
+{
+    return mag_cmp(a->limbs, a->size, b->limbs, b->size);
+}
+
+int bigint_cmp(const bigint_t *a, const bigint_t *b)
+{
+    if (a->sign != b->sign)
+    {
+        return a->sign;
+    }
+    return a->sign * bigint_cmp_abs(a, b);
+}
+
+void bigint_neg(bigint_t *r, const bigint_t *a)
+{
+    bigint_copy(r, a);
+    if (r->size > 0)
+    {
+        r->sign = -r->sign;
+    }
+}
+
+/**
+ * @brief r = a + b_sign*|b|
+ */
+static void bigint_add_signed(bigint_t *r, const bigint_t *a, const bigint_t *b, int b_sign)
+{
+    if (a->sign == b_sign)
+    {
+        const bigint_t *big = (a->size >= b->size) ? a : b;
+        const bigint_t *small = (a->size >= b->size) ? b : a;
+        size_t big_size = big->size, small_size = small->size;
+        bigint_reserve(r, big_size + 1); // r may alias a or b, so limbs are read after reallocation
+        r->size = mag_add(r->limbs, big->limbs, big_size, small->limbs, small_size);
+        r->sign = b_sign;
+        bigint_normalize(r);
+        return;
+    }
+
+    int cmp = bigint_cmp_abs(a, b);
+    if (cmp == 0)
+    {
+        r->size = 0;
+        r->sign = 1;
+        return;
+    }
+    const bigint_t *big = (cmp > 0) ? a : b;
+    const bigint_t *small = (cmp > 0) ? b : a;
+    int sign = (cmp > 0) ? a->sign : b_sign;
+    size_t big_size = big->size, small_size = small->size;
+    bigint_reserve(r, big_size);
+    mag_sub(r->limbs, big->limbs, big_size, small->limbs, small_size);
+    r->size = big_size;
+    r->sign = sign;
+    bigint_normalize(r);
+}
+
+void bigint_add(bigint_t *r, const bigint_t *a, const bigint_t *b)
+{
+    bigint_add_signed(r, a, b, b->sign);
+}
+
+void bigint_sub(bigint_t *r, const bigint_t *a, const bigint_t *b)
+{
+    bigint_add_signed(r, a, b, (b->size == 0) ? 1 : -b->sign);
+}
+
+void bigint_mul(bigint_t *r, const bigint_t *a, const bigint_t *b)
+{
+    if (a->size == 0 || b->size == 0)
+    {
+        r->size = 0;
+        r->sign = 1;
+        return;
+    }
+    bigint_t tmp;
+    bigint_init(&tmp);
+    bigint_reserve(&tmp, a->size + b->size);
+    mag_mul_fast(tmp.limbs, a->limbs, a->size, b->limbs, b->size);
+    tmp.size = a->size + b->size;
+    tmp.sign = a->sign * b->sign;
+    bigint_normalize(&tmp);
+    bigint_swap(r, &tmp);
+    bigint_free(&tmp);
+}
+
+void bigint_mul_add_u64(bigint_t *r, const bigint_t *a, uint64_t x, uint64_t y)
+{
+    size_t n = a->size;
+    int sign = a->sign;
+    bigint_reserve(r, n + 1);
+    // |a| * x + y for a >= 0, -(|a| * x - y) for a < 0
+    uint64_t carry = (sign > 0) ? y : 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        uint128 t = (uint128)a->limbs[i] * x + carry;
+        r->limbs[i] = (uint64_t)t;
+        carry = (uint64_t)(t >> 64);
+    }
+    r->limbs[n] = carry;
+    r->size = n + 1;
+    r->sign = sign;
+    bigint_normalize(r);
+    if (sign > 0 || y == 0)
+    {
+        return;
+    }
+    if (r->size <= 1 && (r->size == 0 || r->limbs[0] < y))
+    {
+        // the result crosses zero
+        bigint_set_u64(r, y - ((r->size == 0) ? 0 : r->limbs[0]));
+        return;
+    }
+    uint64_t borrow = y;
+    for (size_t i = 0; borrow != 0; i++)
+    {
+        uint64_t limb = r->limbs[i];
+        r->limbs[i] = limb - borrow;
+        borrow = (limb < borrow);
+    }
+    bigint_normalize(r);
+}
+
+uint64_t bigint_divmod_u64(bigint_t *q, const bigint_t *a, uint64_t x)
+{
+    uint64_t rem = 0;
+    size_t n = a->size;
+    int sign = a->sign;
+    if (q != NULL)
+    {
+        bigint_reserve(q, n);
+    }
+    for (size_t i = n; i-- > 0;)
+    {
+        uint128 cur = ((uint128)rem << 64) | a->limbs[i];
+        if (q != NULL)
+        {
+            q->limbs[i] = (uint64_t)(cur / x);
+        }
+        rem = (uint64_t)(cur % x);
+    }
+    if (q != NULL)
+    {
+        q->size = n;
+        q->sign = sign;
+        bigint_normalize(q);
+    }
+    return rem;
+}
+
+/**
+ * @brief Long division of magnitudes (Knuth's algorithm D).
+ * @param q quotient, room for an - bn + 1 limbs, may be NULL
+ * @param r remainder, room for bn limbs, may be NULL
+ * @details an >= bn >= 2, b[bn-1] != 0, q and r must not alias a or b.
+ */
+static void mag_divmod(uint64_t *q, uint64_t *r, const uint64_t *a, size_t an, const uint64_t *b, size_t bn)
+{
+    uint64_t *un = malloc((an + 1 + bn) * sizeof(uint64_t));
+    if (un == NULL)
+    {
+        fprintf(stderr, "bigint - memory allocation error\n");
+        abort();
+    }
+    uint64_t *vn = un + an + 1;
+
+    // normalization, the top bit of the divisor has to be set
+    int s = __builtin_clzll(b[bn - 1]);
+    for (size_t i = bn - 1; i > 0; i--)
+    {
+        vn[i] = (s == 0) ? b[i] : (b[i] << s) | (b[i - 1] >> (64 - s));
+    }
+    vn[0] = b[0] << s;
+    un[an] = (s == 0) ? 0 : a[an - 1] >> (64 - s);
+    for (size_t i = an - 1; i > 0; i--)
+    {
+        un[i] = (s == 0) ? a[i] : (a[i] << s) | (a[i - 1] >> (64 - s));
+    }
+    un[0] = a[0] << s;
+
+    for (size_t j = an - bn + 1; j-- > 0;)
+    {
+        // estimate of the quotient digit, too big at most by 2
+        uint128 num = ((uint128)un[j + bn] << 64) | un[j + bn - 1];
+        uint128 qhat = num / vn[bn - 1];
+        uint128 rhat = num % vn[bn - 1];
+        while ((qhat >> 64) != 0 || qhat * vn[bn - 2] > ((rhat << 64) | un[j + bn - 2]))
+        {
+            qhat--;
+            rhat += vn[bn - 1];
+            if ((rhat >> 64) != 0)
+            {
+                break;
+            }
+        }
+
+        // multiply and subtract
+        uint64_t borrow = 0, carry = 0;
+        for (size_t i = 0; i < bn; i++)
+        {
+            uint128 p = qhat * vn[i] + carry;
+            carry = (uint64_t)(p >> 64);
+            uint64_t plo = (uint64_t)p;
+            uint64_t sub = plo + borrow;
+            uint64_t next = (sub < plo) || (un[i + j] < sub);
+            un[i + j] -= sub;
+            borrow = next;
+        }
+        uint64_t sub = carry + borrow;
+        bool negative = (sub < carry) || (un[j + bn] < sub);
+        un[j + bn] -= sub;
+
+        if (negative)
+        {
+            // the estimate was one too big, add the divisor back
+            qhat--;
+            uint64_t c = 0;
+            for (size_t i = 0; i < bn; i++)
+            {
+                uint128 t = (uint128)un[i + j] + vn[i] + c;
+                un[i + j] = (uint64_t)t;
+                c = (uint64_t)(t >> 64);
+            }
+            un[j + bn] += c;
+        }
+        if (q != NULL)
+        {
+            q[j] = (uint64_t)qhat;
+        }
+    }
+
+    if (r != NULL)
+    {
+        for (size_t i = 0; i < bn; i++)
+        {
+            r[i] = (s == 0) ? un[i] : (un[i] >> s) | (un[i + 1] << (64 - s));
+        }
+    }
+    free(un);
+}
+
+void bigint_divmod(bigint_t *q, bigint_t *r, const bigint_t *a, const bigint_t *b)
+{
+    int q_sign = a->sign * b->sign;
+    int r_sign = a->sign;
+
+    if (bigint_cmp_abs(a, b) < 0)
+    {
+        if (r != NULL)
+        {
+            bigint_copy(r, a);
+        }
+        if (q != NULL)
+        {
+            q->size = 0;
+            q->sign = 1;
+        }
+        return;
+    }
+    if (b->size == 1)
+    {
+        uint64_t rem = bigint_divmod_u64(q, a, b->limbs[0]);
+        if (q != NULL && q->size > 0)
+        {
+            q->sign = q_sign;
+        }
+        if (r != NULL)
+        {
+            bigint_set_u64(r, rem);
+            if (r->size > 0)
+            {
+                r->sign = r_sign;
+            }
+        }
+        return;
+    }
+
+    bigint_t tq, tr;
+    bigint_init(&tq);
+    bigint_init(&tr);
+    bigint_reserve(&tq, a->size - b->size + 1);
+    bigint_reserve(&tr, b->size);
+    mag_divmod(tq.limbs, tr.limbs, a->limbs, a->size, b->limbs, b->size);
+    tq.size = a->size - b->size + 1;
+    tr.size = b->size;
+    tq.sign = q_sign;
+    tr.sign = r_sign;
+    bigint_normalize(&tq);
+    bigint_normalize(&tr);
+    if (q != NULL)
+    {
+        bigint_swap(q, &tq);
+    }
+    if (r != NULL)
+    {
+        bigint_swap(r, &tr);
+    }
+    bigint_free(&tq);
+    bigint_free(&tr);
+}
+
+void bigint_shl(bigint_t *r, const bigint_t *a, size_t shift)
+{
+    if (a->size == 0)
+    {
+        r->size = 0;
+        r->sign = 1;
+        return;
+    }
+    size_t limbs = shift / 64;
+    int bits = shift % 64;
+    size_t n = a->size;
+    int sign = a->sign;
+    bigint_reserve(r, n + limbs + 1);
+    // from the top, so that r may alias a
+    r->limbs[n + limbs] = (bits == 0) ? 0 : a->limbs[n - 1] >> (64 - bits);
+    for (size_t i = n; i-- > 1;)
+    {
+        r->limbs[i + limbs] = (bits == 0) ? a->limbs[i] : (a->limbs[i] << bits) | (a->limbs[i - 1] >> (64 - bits));
+    }
+    r->limbs[limbs] = a->limbs[0] << bits;
+    memset(r->limbs, 0, limbs * sizeof(uint64_t));
+    r->size = n + limbs + 1;
+    r->sign = sign;
+    bigint_normalize(r);
+}
+
+void bigint_shr(bigint_t *r, const bigint_t *a, size_t shift)
+{
+    size_t limbs = shift / 64;
+    int bits = shift % 64;
+    if (limbs >= a->size)
+    {
+        r->size = 0;
+        r->sign = 1;
+        return;
+    }
+    size_t n = a->size - limbs;
+    int sign = a->sign;
+    bigint_reserve(r, n);
+    // from the bottom, so that r may alias a
+    for (size_t i = 0; i < n; i++)
+    {
+        uint64_t lo = a->limbs[i + limbs] >> bits;
+        uint64_t hi = (bits == 0 || i + limbs + 1 >= a->size) ? 0 : a->limbs[i + limbs + 1] << (64 - bits);
+        r->limbs[i] = lo | hi;
+    }
+    r->size = n;
+    r->sign = sign;
+    bigint_normalize(r);
+}
+
+void bigint_pow_u64(bigint_t *r, const bigint_t *a, uint64_t e)
+{
+    bigint_t base, result;
+    bigint_init(&base);
+    bigint_init(&result);
+    bigint_copy(&base, a);
+    bigint_set_u64(&result, 1);
+    while (e > 0)
+    {
+        if (e & 1)
+        {
+            bigint_mul(&result, &result, &base);
+        }
+        e >>= 1;
+        if (e > 0)
+        {
+            bigint_mul(&base, &base, &base);
+        }
+    }
+    bigint_swap(r, &result);
+    bigint_free(&base);
+    bigint_free(&result);
+}
+
+void bigint_gcd(bigint_t *r, const bigint_t *a, const bigint_t *b)
+{
+    bigint_t x, y, rem;
+    bigint_init(&x);
+    bigint_init(&y);
+    bigint_init(&rem);
+    bigint_copy(&x, a);
+    bigint_copy(&y, b);
+    x.sign = 1;
+    y.sign = 1;
+    // Euclid's algorithm, each step removes at least one bit
+    while (y.size > 0)
+    {
+        bigint_divmod(NULL, &rem, &x, &y);
+        bigint_swap(&x, &y);
+        bigint_swap(&y, &rem);
+    }
+    bigint_swap(r, &x);
+    bigint_free(&x);
+    bigint_free(&y);
+    bigint_free(&rem);
+}
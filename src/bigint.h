@@ -0,0 +1,194 @@
+/**
+ * @file bigint.h
+ * @brief Arbitrary-precision integers
+ * @date 18.10.2026
+ *
+ * Sign-magnitude representation with 64-bit limbs stored from the least significant one.
+ * All functions allow the result to alias any of the operands.
+ * Every bigint_t has to be initialized with bigint_init and released with bigint_free.
+ * Allocation failure is fatal (the program is aborted), so the arithmetic does not return error codes.
+ */
+
+#ifndef BIGINT_H
+#define BIGINT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** @struct bigint
+ *  @brief Arbitrary-precision integer.
+ *  @param sign -1 for negative numbers, 1 otherwise (zero is always non-negative)
+ *  @param size number of used limbs, 0 for zero
+ *  @param capacity number of allocated limbs
+ *  @param limbs magnitude, least significant limb first
+ */
+struct bigint
+{
+    int sign;
+    size_t size;
+    size_t capacity;
+    uint64_t *limbs;
+};
+
+typedef struct bigint bigint_t;
+
+/**
+ * @brief Initializes the number to zero.
+ * @param a
+ */
+void bigint_init(bigint_t *a);
+
+/**
+ * @brief Frees memory of the number.
+ * @param a
+ */
+void bigint_free(bigint_t *a);
+
+/**
+ * @brief a = b
+ */
+void bigint_copy(bigint_t *a, const bigint_t *b);
+
+/**
+ * @brief Swaps the values of a and b without copying the limbs.
+ */
+void bigint_swap(bigint_t *a, bigint_t *b);
+
+/**
+ * @brief a = x
+ */
+void bigint_set_u64(bigint_t *a, uint64_t x);
+
+/**
+ * @brief a = x
+ */
+void bigint_set_i64(bigint_t *a, int64_t x);
+
+/**
+ * @brief a = x
+ */
+void bigint_set_u128(bigint_t *a, unsigned __int128 x);
+
+/**
+ * @brief a = x
+ */
+void bigint_set_i128(bigint_t *a, __int128 x);
+
+/**
+ * @brief Converts the number to a 128-bit integer.
+ * @param a
+ * @param x receives the value of a
+ * @return false if a does not fit in __int128
+ */
+bool bigint_get_i128(const bigint_t *a, __int128 *x);
+
+/**
+ * @brief Converts the number to long double (inf on overflow).
+ */
+long double bigint_get_ld(const bigint_t *a);
+
+/**
+ * @brief Parses a decimal integer with an optional sign.
+ * @param a receives the value
+ * @param str string containing only an optional '-' or '+' followed by digits
+ * @param len number of characters of str to be read
+ * @return false if str is not a valid integer
+ */
+bool bigint_set_string(bigint_t *a, const char *str, size_t len);
+
+/**
+ * @brief Writes the number in decimal.
+ * @param a
+ * @param str destination, NULL to only compute the length
+ * @param size size of str
+ * @return length of the string (without terminating null character), the string is written only if it fits
+ */
+size_t bigint_get_string(const bigint_t *a, char *str, size_t size);
+
+/**
+ * @brief Tests whether the number is zero.
+ */
+bool bigint_is_zero(const bigint_t *a);
+
+/**
+ * @brief Number of significant bits of |a|, 0 for zero.
+ */
+size_t bigint_bit_length(const bigint_t *a);
+
+/**
+ * @brief Compares a and b.
+ * @return negative if a < b, 0 if a == b, positive if a > b
+ */
+int bigint_cmp(const bigint_t *a, const bigint_t *b);
+
+/**
+ * @brief Compares |a| and |b|.
+ * @return negative if |a| < |b|, 0 if |a| == |b|, positive if |a| > |b|
+ */
+int bigint_cmp_abs(const bigint_t *a, const bigint_t *b);
+
+/**
+ * @brief r = -a
+ */
+void bigint_neg(bigint_t *r, const bigint_t *a);
+
+/**
+ * @brief r = a + b
+ */
+void bigint_add(bigint_t *r, const bigint_t *a, const bigint_t *b);
+
+/**
+ * @brief r = a - b
+ */
+void bigint_sub(bigint_t *r, const bigint_t *a, const bigint_t *b);
+
+/**
+ * @brief r = a * b
+ */
+void bigint_mul(bigint_t *r, const bigint_t *a, const bigint_t *b);
+
+/**
+ * @brief r = a * x + y
+ */
+void bigint_mul_add_u64(bigint_t *r, const bigint_t *a, uint64_t x, uint64_t y);
+
+/**
+ * @brief Truncating division by a 64-bit number.
+ * @param q quotient, may be NULL
+ * @param a dividend
+ * @param x divisor, x != 0
+ * @return |a| mod x
+ */
+uint64_t bigint_divmod_u64(bigint_t *q, const bigint_t *a, uint64_t x);
+
+/**
+ * @brief Truncating division, a = q*b + r, sign of r is the sign of a.
+ * @param q quotient, may be NULL
+ * @param r remainder, may be NULL
+ * @param a dividend
+ * @param b divisor, b != 0
+ */
+void bigint_divmod(bigint_t *q, bigint_t *r, const bigint_t *a, const bigint_t *b);
+
+/**
+ * @brief r = a * 2^shift
+ */
+void bigint_shl(bigint_t *r, const bigint_t *a, size_t shift);
+
+/**
+ * @brief r = a / 2^shift, the magnitude is truncated
+ */
+void bigint_shr(bigint_t *r, const bigint_t *a, size_t shift);
+
+/**
+ * @brief r = a^e
+ */
+void bigint_pow_u64(bigint_t *r, const bigint_t *a, uint64_t e);
+
+/**
+ * @brief r = gcd(|a|, |b|)
+ */
+void bigint_gcd(bigint_t *r, const bigint_t *a, const bigint_t *b);
+
+#endif
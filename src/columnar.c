@@ -0,0 +1,451 @@
+/**
+ * @file columnar.c
+ * @brief Binary columnar files of numbers
+ * @date 18.10.2026
+ */
+
+#define _POSIX_C_SOURCE 200809L // mmap, fstat
+
+#include "columnar.h"
+#include <fcntl.h>
+#include <float.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "columnar files are used in place, a little-endian host is required"
+#endif
+
+#define COL_MAX_EXACT 9007199254740992ULL // 2^53, larger integers are not exact in double
+
+/**
+ * @brief Powers of ten exactly representable in double (and in long double up to 10^27).
+ */
+static const long double POW10[28] = {
+    1e0L,  1e1L,  1e2L,  1e3L,  1e4L,  1e5L,  1e6L,  1e7L,  1e8L,  1e9L,  1e10L, 1e11L, 1e12L, 1e13L,
+    1e14L, 1e15L, 1e16L, 1e17L, 1e18L, 1e19L, 1e20L, 1e21L, 1e22L, 1e23L, 1e24L, 1e25L, 1e26L, 1e27L};
+
+/**
+ * @brief Size of the header of a file with the given number of columns.
+ */
+static size_t header_size(unsigned cols)
+{
+    return (16 + cols + 7) / 8 * 8;
+}
+
+/**
+ * @brief Reads the header and finds the groups of a mapped file.
+ * @return false if the file is not valid
+ */
+static bool col_scan(col_file_t *f)
+{
+    if (f->size < 16 || memcmp(f->data, COL_MAGIC, 8) != 0)
+    {
+        return false;
+    }
+    uint32_t cols, zero;
+    memcpy(&cols, f->data + 8, sizeof(cols));
+    memcpy(&zero, f->data + 12, sizeof(zero));
+    if (cols == 0 || cols > COL_MAX_COLUMNS || zero != 0 || f->size < header_size(cols))
+    {
+        return false;
+    }
+    f->cols = cols;
+    f->types = f->data + 16;
+    for (unsigned c = 0; c < cols; c++)
+    {
+        if (f->types[c] != COL_FLOAT64 && f->types[c] != COL_INT64)
+        {
+            return false;
+        }
+    }
+
+    size_t capacity = 0, offset = header_size(cols);
+    while (offset < f->size)
+    {
+        uint64_t rows;
+        if (f->size - offset < sizeof(rows))
+        {
+            return false;
+        }
+        memcpy(&rows, f->data + offset, sizeof(rows));
+        offset += sizeof(rows);
+        if (rows > (f->size - offset) / 8 / cols)
+        {
+            return false;
+        }
+        if (f->groups == capacity)
+        {
+            capacity = (capacity == 0) ? 16 : 2 * capacity;
+            f->group_offset = realloc(f->group_offset, capacity * sizeof(size_t));
+            f->group_rows = realloc(f->group_rows, capacity * sizeof(size_t));
+            if (f->group_offset == NULL || f->group_rows == NULL)
+            {
+                fprintf(stderr, "columnar - memory allocation error\n");
+                abort();
+            }
+        }
+        f->group_offset[f->groups] = offset;
+        f->group_rows[f->groups++] = (size_t)rows;
+        f->rows += (size_t)rows;
+        offset += (size_t)rows * 8 * cols;
+    }
+    return true;
+}
+
+int col_open(col_file_t *f, const char *path)
+{
+    memset(f, 0, sizeof(col_file_t));
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0)
+    {
+        return COL_IO_ERR;
+    }
+    if (fstat(fd, &st) != 0)
+    {
+        close(fd);
+        return COL_IO_ERR;
+    }
+    f->size = (size_t)st.st_size;
+    if (f->size < 16)
+    {
+        close(fd);
+        return COL_FORMAT_ERR;
+    }
+    void *data = mmap(NULL, f->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        return COL_IO_ERR;
+    }
+    f->data = data;
+    if (!col_scan(f))
+    {
+        col_close(f);
+        return COL_FORMAT_ERR;
+    }
+    return COL_OK;
+}
+
+void col_close(col_file_t *f)
+{
+    if (f->data != NULL)
+    {
+        munmap((void *)f->data, f->size);
+    }
+    free(f->group_offset);
+    free(f->group_rows);
+    memset(f, 0, sizeof(col_file_t));
+}
+
+const void *col_column(const col_file_t *f, size_t group, unsigned column, size_t *rows)
+{
+    *rows = f->group_rows[group];
+    return f->data + f->group_offset[group] + (size_t)column * 8 * f->group_rows[group];
+}
+
+/**
+ * @brief Writes the collected rows as a group.
+ */
+static void col_writer_flush(col_writer_t *w)
+{
+    if (w->filled == 0)
+    {
+        return;
+    }
+    uint64_t rows = w->filled;
+    bool ok = fwrite(&rows, sizeof(rows), 1, w->f) == 1;
+    for (unsigned c = 0; c < w->cols && ok; c++)
+    {
+        ok = fwrite(w->buffer + (size_t)c * COL_GROUP_ROWS, sizeof(col_value_t), w->filled, w->f) == w->filled;
+    }
+    if (!ok)
+    {
+        w->status = COL_IO_ERR;
+    }
+    w->filled = 0;
+}
+
+int col_writer_open(col_writer_t *w, const char *path, unsigned cols, const unsigned char *types)
+{
+    if (cols == 0 || cols > COL_MAX_COLUMNS)
+    {
+        return COL_FORMAT_ERR;
+    }
+    w->f = fopen(path, "wb");
+    if (w->f == NULL)
+    {
+        return COL_IO_ERR;
+    }
+    w->cols = cols;
+    w->filled = 0;
+    w->status = COL_OK;
+    w->buffer = malloc((size_t)cols * COL_GROUP_ROWS * sizeof(col_value_t));
+    if (w->buffer == NULL)
+    {
+        fprintf(stderr, "columnar - memory allocation error\n");
+        abort();
+    }
+
+    unsigned char header[16 + COL_MAX_COLUMNS + 8] = {0};
+    uint32_t count = cols;
+    memcpy(header, COL_MAGIC, 8);
+    memcpy(header + 8, &count, sizeof(count));
+    memcpy(header + 16, types, cols);
+    if (fwrite(header, 1, header_size(cols), w->f) != header_size(cols))
+    {
+        w->status = COL_IO_ERR;
+    }
+    return COL_OK;
+}
+
+int col_writer_row(col_writer_t *w, const col_value_t *row)
+{
+    for (unsigned c = 0; c < w->cols; c++)
+    {
+        w->buffer[(size_t)c * COL_GROUP_ROWS + w->filled] = row[c];
+    }
+    if (++w->filled == COL_GROUP_ROWS)
+    {
+        col_writer_flush(w);
+    }
+    return w->status;
+}
+
+int col_writer_close(col_writer_t *w)
+{
+    col_writer_flush(w);
+    if (fclose(w->f) != 0)
+    {
+        w->status = COL_IO_ERR;
+    }
+    free(w->buffer);
+    w->buffer = NULL;
+    w->f = NULL;
+    return w->status;
+}
+
+/**
+ * @brief Parses a number by strtod, used for the inputs the fast path cannot round correctly.
+ * @return false if [s, end) is not a number
+ */
+static bool parse_double_slow(const char *s, const char *end, double *value)
+{
+    char tmp[COL_MAX_TOKEN + 1];
+    size_t len = (size_t)(end - s);
+    if (len == 0 || len > COL_MAX_TOKEN)
+    {
+        return false;
+    }
+    memcpy(tmp, s, len);
+    tmp[len] = '\0';
+    char *stop;
+    *value = strtod(tmp, &stop);
+    return stop == tmp + len;
+}
+
+bool col_parse_double(const char *s, const char *end, double *value)
+{
+    const char *p = s;
+    bool negative = false;
+    if (p < end && (*p == '+' || *p == '-'))
+    {
+        negative = (*p++ == '-');
+    }
+
+    uint64_t m = 0;
+    int exp10 = 0;
+    bool digits = false, truncated = false;
+    for (; p < end && *p >= '0' && *p <= '9'; p++)
+    {
+        digits = true;
+        if (m < UINT64_MAX / 10)
+        {
+            m = m * 10 + (uint64_t)(*p - '0');
+        }
+        else
+        {
+            exp10++;
+            truncated |= (*p != '0');
+        }
+    }
+    if (p < end && *p == '.')
+    {
+        for (p++; p < end && *p >= '0' && *p <= '9'; p++)
+        {
+            digits = true;
+            if (m < UINT64_MAX / 10)
+            {
+                m = m * 10 + (uint64_t)(*p - '0');
+                exp10--;
+            }
+            else
+            {
+                truncated |= (*p != '0');
+            }
+        }
+    }
+    if (digits && p < end && (*p == 'e' || *p == 'E'))
+    {
+        p++;
+        bool exp_negative = false;
+        if (p < end && (*p == '+' || *p == '-'))
+        {
+            exp_negative = (*p++ == '-');
+        }
+        if (p == end || *p < '0' || *p > '9')
+        {
+            return parse_double_slow(s, end, value);
+        }
+        int e = 0;
+        for (; p < end && *p >= '0' && *p <= '9'; p++)
+        {
+            e = (e < 100000) ? e * 10 + (*p - '0') : e;
+        }
+        exp10 += exp_negative ? -e : e;
+    }
+    if (!digits || p != end || truncated)
+    {
+        return parse_double_slow(s, end, value);
+    }
+
+    double r;
+    if (m == 0)
+    {
+        r = 0.0;
+    }
+    else if (m <= COL_MAX_EXACT && exp10 >= -22 && exp10 <= 22)
+    {
+        r = (exp10 >= 0) ? (double)m * (double)POW10[exp10] : (double)m / (double)POW10[-exp10];
+    }
+#if LDBL_MANT_DIG >= 64
+    else if (exp10 >= -27 && exp10 <= 27)
+    {
+        long double x = (exp10 >= 0) ? (long double)m * POW10[exp10] : (long double)m / POW10[-exp10];
+        // x must not lie halfway between r and its neighbour r + 2 (x - r)
+        r = (double)x;
+        long double half = x - r;
+        long double neighbour = r + 2.0L * half;
+        if (half != 0.0L && (double)neighbour == neighbour)
+        {
+            return parse_double_slow(s, end, value);
+        }
+    }
+#endif
+    else
+    {
+        return parse_double_slow(s, end, value);
+    }
+    *value = negative ? -r : r;
+    return true;
+}
+
+bool col_parse_int64(const char *s, const char *end, long long *value)
+{
+    const char *p = s;
+    bool negative = false;
+    if (p < end && (*p == '+' || *p == '-'))
+    {
+        negative = (*p++ == '-');
+    }
+    if (p == end)
+    {
+        return false;
+    }
+    // the magnitude is accumulated as unsigned, the limit of a negative number is one larger
+    unsigned long long limit = negative ? (unsigned long long)INT64_MAX + 1 : (unsigned long long)INT64_MAX;
+    unsigned long long m = 0;
+    for (; p < end; p++)
+    {
+        if (*p < '0' || *p > '9')
+        {
+            return false;
+        }
+        unsigned d = (unsigned)(*p - '0');
+        if (m > (limit - d) / 10)
+        {
+            return false;
+        }
+        m = m * 10 + d;
+    }
+    *value = !negative ? (long long)m : (m == 0) ? 0 : -(long long)(m - 1) - 1;
+    return true;
+}
+
+typedef unsigned char col_bytes __attribute__((vector_size(16)));      // 16 characters, one SSE2 register
+typedef unsigned long long col_lanes __attribute__((vector_size(16))); // the same register as two integers
+
+/**
+ * @brief Bit mask of the commas and line breaks of 16 characters, bit i for s[i].
+ */
+static inline unsigned csv_mask16(const char *s)
+{
+    const col_bytes comma = {',', ',', ',', ',', ',', ',', ',', ',', ',', ',', ',', ',', ',', ',', ',', ','};
+    const col_bytes newline = {'\n', '\n', '\n', '\n', '\n', '\n', '\n', '\n',
+                               '\n', '\n', '\n', '\n', '\n', '\n', '\n', '\n'};
+    col_bytes v;
+    memcpy(&v, s, sizeof(v));
+    col_lanes m = (col_lanes)((v == comma) | (v == newline));
+    // the top bits of the bytes of a lane are gathered into its top byte, the shifted copies do not overlap
+    unsigned long long lo = ((m[0] & 0x8080808080808080ULL) * 0x0002040810204081ULL) >> 56;
+    unsigned long long hi = ((m[1] & 0x8080808080808080ULL) * 0x0002040810204081ULL) >> 56;
+    return (unsigned)(lo | hi << 8);
+}
+
+size_t col_csv_scan(const char *s, size_t n, unsigned *offsets)
+{
+    size_t count = 0, i = 0;
+    for (; i + 64 <= n; i += 64)
+    {
+        uint64_t mask = (uint64_t)csv_mask16(s + i) | (uint64_t)csv_mask16(s + i + 16) << 16 |
+                        (uint64_t)csv_mask16(s + i + 32) << 32 | (uint64_t)csv_mask16(s + i + 48) << 48;
+        while (mask != 0)
+        {
+            offsets[count++] = (unsigned)(i + __builtin_ctzll(mask));
+            mask &= mask - 1;
+        }
+    }
+    for (; i < n; i++)
+    {
+        if (s[i] == ',' || s[i] == '\n')
+        {
+            offsets[count++] = (unsigned)i;
+        }
+    }
+    return count;
+}
+
+double col_missing(void)
+{
+    uint64_t bits = COL_MISSING_BITS;
+    double x;
+    memcpy(&x, &bits, sizeof(x));
+    return x;
+}
+
+bool col_is_missing(double x)
+{
+    uint64_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    return bits == COL_MISSING_BITS;
+}
+
+size_t col_present_run(const double *x, size_t n, size_t *first)
+{
+    size_t i = 0;
+    while (i < n && col_is_missing(x[i]))
+    {
+        i++;
+    }
+    *first = i;
+    while (i < n && !col_is_missing(x[i]))
+    {
+        i++;
+    }
+    return i - *first;
+}
@@ -0,0 +1,208 @@
+/**
+ * @file columnar.h
+ * @brief Binary columnar files of numbers
+ * @date 18.10.2026
+ *
+ * Layout of a file (all integers little-endian):
+ *
+ * - header: magic "STWCOL01", uint32 number of columns, uint32 zero, one byte per column with its type
+ *   (enum col_types), zero bytes up to a multiple of 8
+ * - groups of rows: uint64 number of rows n, then every column as n float64 or int64 values
+ *
+ * Files are mapped to memory by col_open and the columns are used in place, so a column of a group is an
+ * ordinary array of doubles or long longs aligned to 8 bytes. Only little-endian hosts are supported.
+ * A missing float64 value is the quiet nan COL_MISSING_BITS, other nan values are ordinary values.
+ * The decimal parser and the scanner of CSV separators used by the text readers are also declared here.
+ */
+
+#ifndef COLUMNAR_H
+#define COLUMNAR_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#define COL_MAGIC "STWCOL01"    // first eight bytes of a columnar file
+#define COL_MAX_COLUMNS 4096    // largest accepted number of columns
+#define COL_GROUP_ROWS 65536    // rows of a group written by col_writer_t
+#define COL_MAX_TOKEN 128       // longest number accepted by the parsers
+#define COL_MISSING_BITS 0x7ff800004d495353ull // bits of a missing float64 value, a nan with the payload "MISS"
+
+/**
+ * @brief Types of the columns
+ */
+enum col_types
+{
+    COL_FLOAT64 = 1,
+    COL_INT64 = 2
+};
+
+/**
+ * @brief Results of the operations on columnar files
+ */
+enum col_status
+{
+    COL_OK,
+    COL_IO_ERR,     // the file cannot be opened, mapped or written, errno is set
+    COL_FORMAT_ERR  // the file is not a valid columnar file
+};
+
+/** @struct col_file
+ *  @brief Columnar file mapped to memory.
+ *  @param data mapped file
+ *  @param size size of the file
+ *  @param cols number of columns
+ *  @param types type of every column
+ *  @param groups number of groups of rows
+ *  @param group_offset offset of the values of every group
+ *  @param group_rows number of rows of every group
+ *  @param rows number of rows of all groups
+ */
+struct col_file
+{
+    const unsigned char *data;
+    size_t size;
+    unsigned cols;
+    const unsigned char *types;
+    size_t groups;
+    size_t *group_offset;
+    size_t *group_rows;
+    size_t rows;
+};
+
+typedef struct col_file col_file_t;
+
+/** @union col_value
+ *  @brief Value of one column of a row.
+ */
+union col_value
+{
+    double f;
+    long long i;
+};
+
+typedef union col_value col_value_t;
+
+/** @struct col_writer
+ *  @brief Writer of a columnar file, rows are collected into groups of COL_GROUP_ROWS.
+ *  @param f output file
+ *  @param cols number of columns
+ *  @param filled rows of the current group
+ *  @param buffer current group, column by column
+ *  @param status COL_OK or the first error
+ */
+struct col_writer
+{
+    FILE *f;
+    unsigned cols;
+    size_t filled;
+    col_value_t *buffer;
+    int status;
+};
+
+typedef struct col_writer col_writer_t;
+
+/**
+ * @brief Maps a columnar file to memory and checks its structure.
+ * @param f
+ * @param path
+ * @return COL_OK, or COL_IO_ERR or COL_FORMAT_ERR and f is not opened
+ */
+int col_open(col_file_t *f, const char *path);
+
+/**
+ * @brief Unmaps the file.
+ */
+void col_close(col_file_t *f);
+
+/**
+ * @brief Values of a column in a group of rows.
+ * @param f
+ * @param group index of the group
+ * @param column index of the column
+ * @param rows receives the number of rows of the group
+ * @return array of doubles (COL_FLOAT64) or long longs (COL_INT64)
+ */
+const void *col_column(const col_file_t *f, size_t group, unsigned column, size_t *rows);
+
+/**
+ * @brief Creates a columnar file and writes its header.
+ * @param w
+ * @param path
+ * @param cols number of columns, 1 to COL_MAX_COLUMNS
+ * @param types type of every column
+ * @return COL_OK, or COL_IO_ERR and w is not opened
+ */
+int col_writer_open(col_writer_t *w, const char *path, unsigned cols, const unsigned char *types);
+
+/**
+ * @brief Appends a row.
+ * @param w
+ * @param row value of every column
+ * @return COL_OK or COL_IO_ERR
+ */
+int col_writer_row(col_writer_t *w, const col_value_t *row);
+
+/**
+ * @brief Writes the last group and closes the file.
+ * @return COL_OK or COL_IO_ERR if any write failed
+ */
+int col_writer_close(col_writer_t *w);
+
+/**
+ * @brief Parses a decimal number [+-]digits[.digits][(e|E)[+-]digits] in [s, end), correctly rounded.
+ * @details
+ * Up to 19 significant digits are collected in an integer m and the number is m * 10^e. If m and 10^|e|
+ * are exact in double, a single multiplication or division rounds correctly. Otherwise, it is computed in
+ * long double and rounded to double, which is also correct unless the long double result lies exactly
+ * halfway between two doubles. The remaining cases (more digits, large exponents, inf, nan, hexadecimal
+ * numbers) are left to strtod.
+ * @param s first character
+ * @param end character after the last one
+ * @param value receives the number
+ * @return false if [s, end) is not a number
+ */
+bool col_parse_double(const char *s, const char *end, double *value);
+
+/**
+ * @brief Parses a decimal integer [+-]digits in [s, end).
+ * @param s first character
+ * @param end character after the last one
+ * @param value receives the number
+ * @return false if [s, end) is not an integer or it does not fit in long long
+ */
+bool col_parse_int64(const char *s, const char *end, long long *value);
+
+/**
+ * @brief Finds the commas and line breaks of CSV text in [s, s + n).
+ * @details The characters are compared 16 at a time in vector registers, the results of 64 characters
+ * are packed into a bit mask and the offsets are taken from its set bits, so the text between the
+ * separators is not looked at one character at a time.
+ * @param s first character
+ * @param n number of characters, less than 2^32
+ * @param offsets receives the offsets of the separators from s in increasing order, room for n offsets
+ * @return number of separators
+ */
+size_t col_csv_scan(const char *s, size_t n, unsigned *offsets);
+
+/**
+ * @brief Value stored for a missing float64 value (an empty CSV field).
+ * @return nan with the bits COL_MISSING_BITS
+ */
+double col_missing(void);
+
+/**
+ * @brief Tests whether a float64 value is missing, other nan values are present.
+ */
+bool col_is_missing(double x);
+
+/**
+ * @brief Finds the next run of present values of a float64 column, present nan values are included.
+ * @param x values
+ * @param n number of values
+ * @param first receives the index of the first present value, n if there is none
+ * @return number of present values from first up to the next missing value
+ */
+size_t col_present_run(const double *x, size_t n, size_t *first);
+
+#endif
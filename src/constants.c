@@ -0,0 +1,325 @@
+/**
+ * @file constants.c
+ * @brief Mathematical constants to arbitrary precision
+ * @date 18.10.2026
+ */
+
+#include "constants.h"
+#include <math.h>
+
+#define CONSTANT_GUARD_BITS 32 // extra precision of the computed and cached values
+
+/** @struct series
+ *  @brief Hypergeometric-like series sum_k a(k)/b(k) * prod_{j<=k} p(j)/q(j).
+ *  @param term computes p(k), q(k), a(k) and b(k), p(0) and q(0) are expected to be 1
+ *  @param x parameter of the term function
+ *  @param use_b false if b(k) is always 1
+ */
+struct series
+{
+    void (*term)(long k, long long x, __int128 *p, __int128 *q, __int128 *a, __int128 *b);
+    long long x;
+    bool use_b;
+};
+
+/** @struct bs_state
+ *  @brief Partial result of binary splitting over the terms [lo, hi).
+ *  @details The sum of the terms is T / (B * Q), the product of the ratios is P / Q.
+ */
+struct bs_state
+{
+    bigint_t p;
+    bigint_t q;
+    bigint_t b;
+    bigint_t t;
+};
+
+static bigfloat_t cache[CONSTANT_COUNT];
+static bool cache_valid[CONSTANT_COUNT];
+
+static void bs_init(struct bs_state *s)
+{
+    bigint_init(&s->p);
+    bigint_init(&s->q);
+    bigint_init(&s->b);
+    bigint_init(&s->t);
+}
+
+static void bs_free(struct bs_state *s)
+{
+    bigint_free(&s->p);
+    bigint_free(&s->q);
+    bigint_free(&s->b);
+    bigint_free(&s->t);
+}
+
+/**
+ * @brief Binary splitting of the series over the terms [lo, hi).
+ * @param need_p false if P of the range is not used by the caller
+ */
+static void bs_split(const struct series *ser, long lo, long hi, bool need_p, struct bs_state *s)
+{
+    if (hi - lo == 1)
+    {
+        __int128 p = 1, q = 1, a = 1, b = 1;
+        ser->term(lo, ser->x, &p, &q, &a, &b);
+        bigint_set_i128(&s->p, p);
+        bigint_set_i128(&s->q, q);
+        bigint_set_i128(&s->b, b);
+        bigint_set_i128(&s->t, a);
+        bigint_mul(&s->t, &s->t, &s->p);
+        return;
+    }
+
+    long mid = lo + (hi - lo) / 2;
+    struct bs_state r;
+    bs_init(&r);
+    bs_split(ser, lo, mid, true, s);
+    bs_split(ser, mid, hi, need_p, &r);
+
+    // T = B2 * Q2 * T1 + B1 * P1 * T2
+    bigint_mul(&s->t, &s->t, &r.q);
+    bigint_mul(&r.t, &r.t, &s->p);
+    if (ser->use_b)
+    {
+        bigint_mul(&s->t, &s->t, &r.b);
+        bigint_mul(&r.t, &r.t, &s->b);
+        bigint_mul(&s->b, &s->b, &r.b);
+    }
+    bigint_add(&s->t, &s->t, &r.t);
+    bigint_mul(&s->q, &s->q, &r.q);
+    if (need_p)
+    {
+        bigint_mul(&s->p, &s->p, &r.p);
+    }
+    bs_free(&r);
+}
+
+/**
+ * @brief Sums the first n terms of the series: r = T / (B * Q).
+ */
+static void bs_sum(bigfloat_t *r, const struct series *ser, long n)
+{
+    struct bs_state s;
+    bs_init(&s);
+    bs_split(ser, 0, n, false, &s);
+    if (ser->use_b)
+    {
+        bigint_mul(&s.q, &s.q, &s.b);
+    }
+
+    bigfloat_t t, q;
+    bigfloat_init(&t, r->prec);
+    bigfloat_init(&q, r->prec);
+    bigfloat_set_bigint(&t, &s.t, 0);
+    bigfloat_set_bigint(&q, &s.q, 0);
+    bigfloat_div(r, &t, &q);
+    bigfloat_free(&t);
+    bigfloat_free(&q);
+    bs_free(&s);
+}
+
+/**
+ * @brief Terms of the Chudnovsky series,
+ * 1/pi = 12 / 640320^(3/2) * sum_k (-1)^k (6k)! (13591409 + 545140134k) / ((3k)! (k!)^3 640320^(3k)).
+ */
+static void pi_term(long k, long long x, __int128 *p, __int128 *q, __int128 *a, __int128 *b)
+{
+    (void)x;
+    (void)b;
+    if (k > 0)
+    {
+        *p = -(__int128)(6 * k - 5) * (2 * k - 1) * (6 * k - 1);
+        *q = (__int128)k * k * k * 10939058860032000LL; // 640320^3 / 24
+    }
+    *a = 13591409 + (__int128)545140134 * k;
+}
+
+/**
+ * @brief Terms of e = sum_k 1/k!.
+ */
+static void e_term(long k, long long x, __int128 *p, __int128 *q, __int128 *a, __int128 *b)
+{
+    (void)x;
+    (void)p;
+    (void)a;
+    (void)b;
+    if (k > 0)
+    {
+        *q = k;
+    }
+}
+
+/**
+ * @brief Terms of atanh(1/x) * x = sum_k 1/((2k + 1) x^(2k)).
+ */
+static void atanh_term(long k, long long x, __int128 *p, __int128 *q, __int128 *a, __int128 *b)
+{
+    (void)p;
+    (void)a;
+    if (k > 0)
+    {
+        *q = (__int128)x * x;
+    }
+    *b = 2 * (__int128)k + 1;
+}
+
+/**
+ * @brief Terms of (1 + 1/9800)^(-1/2) = sum_k (-1)^k C(2k, k) / 39200^k.
+ */
+static void sqrt2_term(long k, long long x, __int128 *p, __int128 *q, __int128 *a, __int128 *b)
+{
+    (void)x;
+    (void)a;
+    (void)b;
+    if (k > 0)
+    {
+        *p = -(2 * (__int128)k - 1);
+        *q = 19600 * (__int128)k;
+    }
+}
+
+/**
+ * @brief pi = 426880 * sqrt(10005) / S, every term adds about 47.11 bits.
+ */
+static void compute_pi(bigfloat_t *r)
+{
+    struct series ser = {pi_term, 0, false};
+    bigfloat_t s;
+    bigfloat_init(&s, r->prec);
+    bigfloat_set_i64(r, 10005);
+    bigfloat_root(r, r, 2);
+    bigfloat_set_i64(&s, 426880);
+    bigfloat_mul(r, r, &s);
+    bs_sum(&s, &ser, (long)(r->prec / 47.11) + 2);
+    bigfloat_div(r, r, &s);
+    bigfloat_free(&s);
+}
+
+/**
+ * @brief e = sum_k 1/k!, the number of terms n is the first one with log2(n!) > prec.
+ */
+static void compute_e(bigfloat_t *r)
+{
+    struct series ser = {e_term, 0, false};
+    long n = 1;
+    double bits = 0.0;
+    while (bits <= (double)r->prec + 8.0)
+    {
+        n++;
+        bits += log2((double)n);
+    }
+    bs_sum(r, &ser, n + 1);
+}
+
+/**
+ * @brief Adds coef * atanh(1/x) to r.
+ */
+static void add_atanh_inv(bigfloat_t *r, long long coef, long long x)
+{
+    struct series ser = {atanh_term, x, true};
+    long n = (long)((r->prec + 8) / (2.0 * log2((double)x))) + 2;
+    bigfloat_t s, c;
+    bigfloat_init(&s, r->prec);
+    bigfloat_init(&c, r->prec);
+    bs_sum(&s, &ser, n);
+    bigfloat_div_u64(&s, &s, (uint64_t)x);
+    bigfloat_set_i64(&c, coef);
+    bigfloat_mul(&s, &s, &c);
+    bigfloat_add(r, r, &s);
+    bigfloat_free(&s);
+    bigfloat_free(&c);
+}
+
+/**
+ * @brief ln 2 = 18 atanh(1/26) - 2 atanh(1/4801) + 8 atanh(1/8749).
+ */
+static void compute_ln2(bigfloat_t *r)
+{
+    bigfloat_set_i64(r, 0);
+    add_atanh_inv(r, 18, 26);
+    add_atanh_inv(r, -2, 4801);
+    add_atanh_inv(r, 8, 8749);
+}
+
+/**
+ * @brief sqrt(2) = 99/70 * (1 + 1/9800)^(-1/2), every term adds about 13.26 bits.
+ */
+static void compute_sqrt2(bigfloat_t *r)
+{
+    struct series ser = {sqrt2_term, 0, false};
+    bigfloat_t c;
+    bigfloat_init(&c, r->prec);
+    bs_sum(r, &ser, (long)(r->prec / 13.26) + 2);
+    bigfloat_set_i64(&c, 99);
+    bigfloat_mul(r, r, &c);
+    bigfloat_div_u64(r, r, 70);
+    bigfloat_free(&c);
+}
+
+void constant_get(bigfloat_t *r, int c)
+{
+    if (c < 0 || c >= CONSTANT_COUNT)
+    {
+        bigfloat_set_i64(r, 0);
+        return;
+    }
+
+    size_t prec = r->prec + CONSTANT_GUARD_BITS;
+    if (!cache_valid[c] || cache[c].prec < prec)
+    {
+        if (cache_valid[c])
+        {
+            bigfloat_free(&cache[c]);
+        }
+        bigfloat_init(&cache[c], prec);
+        switch (c)
+        {
+        case CONSTANT_PI:
+            compute_pi(&cache[c]);
+            break;
+        case CONSTANT_E:
+            compute_e(&cache[c]);
+            break;
+        case CONSTANT_LN2:
+            compute_ln2(&cache[c]);
+            break;
+        default:
+            compute_sqrt2(&cache[c]);
+            break;
+        }
+        cache_valid[c] = true;
+    }
+    bigfloat_copy(r, &cache[c]);
+}
+
+long double constant_get_ld(int c)
+{
+    bigfloat_t x;
+    bigfloat_init(&x, 64);
+    constant_get(&x, c);
+    long double v = bigfloat_get_ld(&x);
+    bigfloat_free(&x);
+    return v;
+}
+
+size_t constant_cached_prec(int c)
+{
+    if (c < 0 || c >= CONSTANT_COUNT || !cache_valid[c])
+    {
+        return 0;
+    }
+    return cache[c].prec;
+}
+
+void constants_clear_cache(void)
+{
+    for (int c = 0; c < CONSTANT_COUNT; c++)
+    {
+        if (cache_valid[c])
+        {
+            bigfloat_free(&cache[c]);
+            cache_valid[c] = false;
+        }
+    }
+}
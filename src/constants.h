@@ -0,0 +1,53 @@
+/**
+ * @file constants.h
+ * @brief Mathematical constants to arbitrary precision
+ * @date 18.10.2026
+ *
+ * Constants are summed from their series by binary splitting: pi by the Chudnovsky formula,
+ * e as the sum of 1/k!, ln 2 by a Machin-like atanh formula and sqrt(2) by the binomial series.
+ * The value with the highest precision computed so far is cached, so requests at the same or
+ * lower precision only round it. The cache is not thread-safe.
+ */
+
+#ifndef CONSTANTS_H
+#define CONSTANTS_H
+
+#include "bigfloat.h"
+
+/**
+ * @brief Identifiers of the constants
+ */
+enum math_constants
+{
+    CONSTANT_PI,
+    CONSTANT_E,
+    CONSTANT_LN2,
+    CONSTANT_SQRT2,
+    CONSTANT_COUNT
+};
+
+/**
+ * @brief Computes the constant to the precision of r.
+ * @param r receives the value, rounded to nearest
+ * @param c identifier from enum math_constants
+ */
+void constant_get(bigfloat_t *r, int c);
+
+/**
+ * @brief Returns the constant rounded to long double.
+ * @param c identifier from enum math_constants
+ */
+long double constant_get_ld(int c);
+
+/**
+ * @brief Precision in bits of the cached value of the constant, 0 if it was not computed yet.
+ * @param c identifier from enum math_constants
+ */
+size_t constant_cached_prec(int c);
+
+/**
+ * @brief Frees the cached values.
+ */
+void constants_clear_cache(void);
+
+#endif
@@ -0,0 +1,209 @@
+/**
+ * @file csv2col.c
+ * @brief Converter of CSV files of numbers to columnar files
+ * @date 18.10.2026
+ *
+ * Usage: csv2col [-t types] input.csv output.col
+ *
+ * Fields are separated by commas, spaces around them are ignored. The first line gives the number of
+ * columns and it is skipped if it does not contain numbers (a header). The types are given by a string
+ * with one character per column, 'f' for float64 (the default) and 'i' for int64. Empty float64 fields
+ * are stored as missing values (col_missing), a "nan" field is an ordinary value. The input "-" is the
+ * standard input. The output is removed when the input cannot be converted.
+ */
+
+#define _POSIX_C_SOURCE 200809L // getline
+
+#include "columnar.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Splits a line into fields, the ends of the fields are trimmed.
+ * @param line line without the line break
+ * @param begin receives the first characters of the fields (at most max)
+ * @param end receives the characters after the fields
+ * @param max capacity of begin and end
+ * @return number of fields, max + 1 if there are more
+ */
+static size_t split_line(const char *line, const char **begin, const char **end, size_t max)
+{
+    size_t count = 0;
+    const char *p = line;
+    while (true)
+    {
+        const char *comma = strchr(p, ',');
+        const char *q = (comma != NULL) ? comma : p + strlen(p);
+        if (count == max)
+        {
+            return max + 1;
+        }
+        const char *b = p, *e = q;
+        while (b < e && (*b == ' ' || *b == '\t'))
+        {
+            b++;
+        }
+        while (e > b && (e[-1] == ' ' || e[-1] == '\t' || e[-1] == '\r'))
+        {
+            e--;
+        }
+        begin[count] = b;
+        end[count++] = e;
+        if (comma == NULL)
+        {
+            return count;
+        }
+        p = comma + 1;
+    }
+}
+
+/**
+ * @brief Converts the fields of a line to a row.
+ * @return false if a field is not a number of the type of its column
+ */
+static bool parse_row(const char **begin, const char **end, const unsigned char *types, unsigned cols,
+                      col_value_t *row)
+{
+    for (unsigned c = 0; c < cols; c++)
+    {
+        if (types[c] == COL_INT64)
+        {
+            if (!col_parse_int64(begin[c], end[c], &row[c].i))
+            {
+                return false;
+            }
+        }
+        else if (begin[c] == end[c])
+        {
+            row[c].f = col_missing();
+        }
+        else if (!col_parse_double(begin[c], end[c], &row[c].f))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *type_string = NULL;
+    int arg = 1;
+    if (argc == 5 && strcmp(argv[1], "-t") == 0)
+    {
+        type_string = argv[2];
+        arg = 3;
+    }
+    else if (argc != 3)
+    {
+        fprintf(stderr, "usage: csv2col [-t types] input.csv output.col\n");
+        return 1;
+    }
+
+    FILE *in = (strcmp(argv[arg], "-") == 0) ? stdin : fopen(argv[arg], "r");
+    if (in == NULL)
+    {
+        perror(argv[arg]);
+        return 1;
+    }
+    const char **begin = malloc((COL_MAX_COLUMNS + 1) * sizeof(char *));
+    const char **end = malloc((COL_MAX_COLUMNS + 1) * sizeof(char *));
+    unsigned char *types = malloc(COL_MAX_COLUMNS);
+    col_value_t *row = malloc(COL_MAX_COLUMNS * sizeof(col_value_t));
+    if (begin == NULL || end == NULL || types == NULL || row == NULL)
+    {
+        fprintf(stderr, "csv2col - memory allocation error\n");
+        abort();
+    }
+
+    char *line = NULL;
+    size_t capacity = 0, number = 0;
+    unsigned cols = 0;
+    col_writer_t w;
+    bool opened = false, ok = true;
+    while (ok && getline(&line, &capacity, in) != -1)
+    {
+        number++;
+        line[strcspn(line, "\n")] = '\0';
+        size_t fields = split_line(line, begin, end, COL_MAX_COLUMNS);
+        if (!opened)
+        {
+            if (fields > COL_MAX_COLUMNS || (type_string != NULL && strlen(type_string) != fields))
+            {
+                fprintf(stderr, "csv2col - line 1: the types do not match %zu columns\n", fields);
+                ok = false;
+                break;
+            }
+            cols = (unsigned)fields;
+            for (unsigned c = 0; c < cols; c++)
+            {
+                types[c] = (type_string != NULL && type_string[c] == 'i') ? COL_INT64 : COL_FLOAT64;
+                if (type_string != NULL && type_string[c] != 'i' && type_string[c] != 'f')
+                {
+                    fprintf(stderr, "csv2col - unknown type '%c'\n", type_string[c]);
+                    ok = false;
+                }
+            }
+            if (!ok)
+            {
+                break;
+            }
+            if (col_writer_open(&w, argv[arg + 1], cols, types) != COL_OK)
+            {
+                perror(argv[arg + 1]);
+                ok = false;
+                break;
+            }
+            opened = true;
+            if (!parse_row(begin, end, types, cols, row))
+            {
+                continue; // header
+            }
+        }
+        else if (fields == 1 && begin[0] == end[0])
+        {
+            continue; // empty line
+        }
+        else if (fields != cols)
+        {
+            fprintf(stderr, "csv2col - line %zu: %zu fields instead of %u\n", number, fields, cols);
+            ok = false;
+            break;
+        }
+        else if (!parse_row(begin, end, types, cols, row))
+        {
+            fprintf(stderr, "csv2col - line %zu: invalid number\n", number);
+            ok = false;
+            break;
+        }
+        if (col_writer_row(&w, row) != COL_OK)
+        {
+            perror(argv[arg + 1]);
+            ok = false;
+        }
+    }
+    if (ferror(in))
+    {
+        perror(argv[arg]);
+        ok = false;
+    }
+    if (opened && col_writer_close(&w) != COL_OK && ok)
+    {
+        perror(argv[arg + 1]);
+        ok = false;
+    }
+    if (opened && !ok)
+    {
+        remove(argv[arg + 1]); // no truncated file that looks valid
+    }
+    if (in != stdin)
+    {
+        fclose(in);
+    }
+    free(line);
+    free(begin);
+    free(end);
+    free(types);
+    free(row);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,1083 @@
+/**
+ * @file decimal.c
+ * @brief Decimal floating-point arithmetic (IEEE 754 decimal64 and decimal128, BID encoding)
+ * @date 18.10.2026
+ *
+ * Both formats are unpacked into a common representation with a 128-bit coefficient, the
+ * arithmetic is done on it and the result is rounded and packed back. Intermediate results
+ * that do not fit in 128 bits (decimal128 products and quotients) are computed with bigint.
+ */
+
+#include "decimal.h"
+#include "bigint.h"
+#include <limits.h>
+#include <math.h>
+#include <string.h>
+
+typedef unsigned __int128 uint128;
+
+#define DEC_MAX_U128_DIGITS 38 // 10^38 < 2^128 < 10^39
+#define DEC_LD_DIGITS 19       // significant digits kept when converting from long double
+
+enum dec_class
+{
+    DEC_FINITE,
+    DEC_INF,
+    DEC_NAN
+};
+
+/** @struct dec_format
+ *  @brief Parameters of an interchange format.
+ *  @param digits precision
+ *  @param etiny lowest exponent of the coefficient
+ *  @param emax highest exponent of the coefficient
+ *  @param bias exponent bias of the encoding
+ */
+struct dec_format
+{
+    int digits;
+    long etiny;
+    long emax;
+    long bias;
+};
+
+static const struct dec_format DEC64_FORMAT = {DEC64_DIGITS, -398, 369, 398};
+static const struct dec_format DEC128_FORMAT = {DEC128_DIGITS, -6176, 6111, 6176};
+
+/** @struct dec_number
+ *  @brief Unpacked number (-1)^negative * coeff * 10^exp.
+ */
+struct dec_number
+{
+    bool negative;
+    int cls;
+    long exp;
+    uint128 coeff;
+};
+
+#define DEC_E19 ((uint128)10000000000000000000ULL)
+
+static const uint128 POW10[DEC_MAX_U128_DIGITS + 1] = {
+    1, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL,
+    10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL, 100000000000000ULL,
+    1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL, 1000000000000000000ULL,
+    10000000000000000000ULL, DEC_E19 * 10ULL, DEC_E19 * 100ULL, DEC_E19 * 1000ULL, DEC_E19 * 10000ULL,
+    DEC_E19 * 100000ULL, DEC_E19 * 1000000ULL, DEC_E19 * 10000000ULL, DEC_E19 * 100000000ULL,
+    DEC_E19 * 1000000000ULL, DEC_E19 * 10000000000ULL, DEC_E19 * 100000000000ULL, DEC_E19 * 1000000000000ULL,
+    DEC_E19 * 10000000000000ULL, DEC_E19 * 100000000000000ULL, DEC_E19 * 1000000000000000ULL,
+    DEC_E19 * 10000000000000000ULL, DEC_E19 * 100000000000000000ULL, DEC_E19 * 1000000000000000000ULL,
+    DEC_E19 * 10000000000000000000ULL
+};
+
+static uint128 pow10_u128(int n)
+{
+    return POW10[n];
+}
+
+/**
+ * @brief Number of decimal digits of x, 1 for zero.
+ */
+static int dec_digits(uint128 x)
+{
+    if (x >> 64 == 0)
+    {
+        uint64_t y = (uint64_t)x;
+        int n = 1;
+        while (n < 20 && y >= (uint64_t)pow10_u128(n))
+        {
+            n++;
+        }
+        return n;
+    }
+    int n = 20;
+    while (n <= DEC_MAX_U128_DIGITS && x >= pow10_u128(n))
+    {
+        n++;
+    }
+    return n;
+}
+
+/**
+ * @brief Rounds coeff * 10^exp to the given precision and the exponent range of the format.
+ * @param r receives the result, its sign has to be set already
+ * @param coeff coefficient, at least precision + 1 digits long if sticky is set
+ * @param exp exponent
+ * @param sticky true if the exact value is slightly greater than coeff * 10^exp
+ * @param precision number of significant digits kept
+ * @param f format
+ */
+static void dec_round(struct dec_number *r, uint128 coeff, long exp, bool sticky, int precision,
+                      const struct dec_format *f)
+{
+    r->cls = DEC_FINITE;
+    long drop = dec_digits(coeff) - precision;
+    if (exp + drop < f->etiny)
+    {
+        drop = f->etiny - exp; // subnormal result
+    }
+    if (drop > DEC_MAX_U128_DIGITS)
+    {
+        coeff = 0; // the whole coefficient is below half of the last kept digit
+        exp += drop;
+    }
+    else if (drop > 0)
+    {
+        uint128 p = pow10_u128((int)drop);
+        uint128 q = coeff / p;
+        uint128 rem = coeff % p;
+        uint128 half = p / 2;
+        if (rem > half || (rem == half && (sticky || (q & 1))))
+        {
+            q++;
+            if (q == pow10_u128(precision))
+            {
+                q /= 10;
+                exp++;
+            }
+        }
+        coeff = q;
+        exp += drop;
+    }
+
+    if (coeff == 0)
+    {
+        exp = (exp < f->etiny) ? f->etiny : (exp > f->emax) ? f->emax : exp;
+    }
+    else if (exp > f->emax)
+    {
+        long pad = exp - f->emax;
+        if (dec_digits(coeff) + pad <= f->digits)
+        {
+            coeff *= pow10_u128((int)pad);
+            exp = f->emax;
+        }
+        else
+        {
+            r->cls = DEC_INF;
+        }
+    }
+    r->coeff = coeff;
+    r->exp = exp;
+}
+
+/**
+ * @brief dec_round for a coefficient of any size.
+ */
+static void dec_round_big(struct dec_number *r, const bigint_t *coeff, long exp, bool sticky, int precision,
+                          const struct dec_format *f)
+{
+    __int128 small;
+    if (bigint_get_i128(coeff, &small))
+    {
+        dec_round(r, (uint128)small, exp, sticky, precision, f);
+        return;
+    }
+    // lower bound of the number of digits (30102 / 100000 < log10(2))
+    long digits = (long)((bigint_bit_length(coeff) - 1) * 30102 / 100000) + 1;
+    long cut = digits - precision - 1;
+    bigint_t q, rem, p;
+    bigint_init(&q);
+    bigint_init(&rem);
+    bigint_init(&p);
+    bigint_set_u64(&p, 10);
+    bigint_pow_u64(&p, &p, (uint64_t)cut);
+    bigint_divmod(&q, &rem, coeff, &p);
+    sticky = sticky || !bigint_is_zero(&rem);
+    bigint_get_i128(&q, &small); // at most precision + 3 digits
+    dec_round(r, (uint128)small, exp + cut, sticky, precision, f);
+    bigint_free(&q);
+    bigint_free(&rem);
+    bigint_free(&p);
+}
+
+static void dec64_unpack(decimal64_t x, struct dec_number *u)
+{
+    uint64_t b = x.bits;
+    u->negative = b >> 63;
+    u->cls = DEC_FINITE;
+    if ((b >> 59 & 0xF) == 0xF)
+    {
+        u->cls = (b >> 58 & 1) ? DEC_NAN : DEC_INF;
+        u->coeff = 0;
+        u->exp = 0;
+        return;
+    }
+    if ((b >> 61 & 3) == 3)
+    {
+        u->exp = (long)(b >> 51 & 0x3FF) - DEC64_FORMAT.bias;
+        u->coeff = ((uint64_t)1 << 53) | (b & (((uint64_t)1 << 51) - 1));
+        if (u->coeff >= pow10_u128(DEC64_DIGITS))
+        {
+            u->coeff = 0; // non-canonical encoding
+        }
+    }
+    else
+    {
+        u->exp = (long)(b >> 53 & 0x3FF) - DEC64_FORMAT.bias;
+        u->coeff = b & (((uint64_t)1 << 53) - 1);
+    }
+}
+
+static decimal64_t dec64_pack(const struct dec_number *u)
+{
+    decimal64_t x;
+    uint64_t sign = (uint64_t)u->negative << 63;
+    if (u->cls == DEC_NAN)
+    {
+        x.bits = sign | (uint64_t)0x7C << 56;
+    }
+    else if (u->cls == DEC_INF)
+    {
+        x.bits = sign | (uint64_t)0x78 << 56;
+    }
+    else
+    {
+        uint64_t coeff = (uint64_t)u->coeff;
+        uint64_t exp = (uint64_t)(u->exp + DEC64_FORMAT.bias);
+        if (coeff >> 53 == 0)
+        {
+            x.bits = sign | exp << 53 | coeff;
+        }
+        else
+        {
+            x.bits = sign | (uint64_t)3 << 61 | exp << 51 | (coeff & (((uint64_t)1 << 51) - 1));
+        }
+    }
+    return x;
+}
+
+static void dec128_unpack(decimal128_t x, struct dec_number *u)
+{
+    u->negative = x.hi >> 63;
+    u->cls = DEC_FINITE;
+    if ((x.hi >> 59 & 0xF) == 0xF)
+    {
+        u->cls = (x.hi >> 58 & 1) ? DEC_NAN : DEC_INF;
+        u->coeff = 0;
+        u->exp = 0;
+        return;
+    }
+    if ((x.hi >> 61 & 3) == 3)
+    {
+        // the coefficient would exceed 10^34, non-canonical encoding of zero
+        u->exp = (long)(x.hi >> 47 & 0x3FFF) - DEC128_FORMAT.bias;
+        u->coeff = 0;
+    }
+    else
+    {
+        u->exp = (long)(x.hi >> 49 & 0x3FFF) - DEC128_FORMAT.bias;
+        u->coeff = (uint128)(x.hi & (((uint64_t)1 << 49) - 1)) << 64 | x.lo;
+        if (u->coeff >= pow10_u128(DEC128_DIGITS))
+        {
+            u->coeff = 0;
+        }
+    }
+}
+
+static decimal128_t dec128_pack(const struct dec_number *u)
+{
+    decimal128_t x;
+    uint64_t sign = (uint64_t)u->negative << 63;
+    x.lo = 0;
+    if (u->cls == DEC_NAN)
+    {
+        x.hi = sign | (uint64_t)0x7C << 56;
+    }
+    else if (u->cls == DEC_INF)
+    {
+        x.hi = sign | (uint64_t)0x78 << 56;
+    }
+    else
+    {
+        x.hi = sign | (uint64_t)(u->exp + DEC128_FORMAT.bias) << 49 | (uint64_t)(u->coeff >> 64);
+        x.lo = (uint64_t)u->coeff;
+    }
+    return x;
+}
+
+/**
+ * @brief Handles NaN and infinite operands of an addition.
+ * @return true if the result was stored in r
+ */
+static bool dec_add_special(struct dec_number *r, const struct dec_number *a, const struct dec_number *b)
+{
+    if (a->cls == DEC_FINITE && b->cls == DEC_FINITE)
+    {
+        return false;
+    }
+    r->coeff = 0;
+    r->exp = 0;
+    if (a->cls == DEC_NAN || b->cls == DEC_NAN || (a->cls == DEC_INF && b->cls == DEC_INF && a->negative != b->negative))
+    {
+        r->cls = DEC_NAN;
+        r->negative = false;
+    }
+    else
+    {
+        r->cls = DEC_INF;
+        r->negative = (a->cls == DEC_INF) ? a->negative : b->negative;
+    }
+    return true;
+}
+
+/**
+ * @brief r = a + b, the sign of b has to be flipped by the caller for subtraction.
+ */
+static void dec_add(struct dec_number *r, const struct dec_number *a, const struct dec_number *b,
+                    const struct dec_format *f)
+{
+    if (dec_add_special(r, a, b))
+    {
+        return;
+    }
+    struct dec_number x = *a;
+    struct dec_number y = *b;
+    if (x.coeff == 0 && y.coeff == 0)
+    {
+        r->negative = x.negative && y.negative;
+        dec_round(r, 0, (x.exp < y.exp) ? x.exp : y.exp, false, f->digits, f);
+        return;
+    }
+    if (x.coeff == 0 || y.coeff == 0)
+    {
+        // the nonzero operand, scaled towards the lower exponent as far as the precision allows
+        long ideal = (x.exp < y.exp) ? x.exp : y.exp;
+        if (x.coeff == 0)
+        {
+            x = y;
+        }
+        long shift = x.exp - ideal;
+        if (shift > f->digits - dec_digits(x.coeff))
+        {
+            shift = f->digits - dec_digits(x.coeff);
+        }
+        r->negative = x.negative;
+        dec_round(r, x.coeff * pow10_u128((int)shift), x.exp - shift, false, f->digits, f);
+        return;
+    }
+
+    long msd_x = x.exp + dec_digits(x.coeff) - 1;
+    long msd_y = y.exp + dec_digits(y.coeff) - 1;
+    if (msd_x < msd_y)
+    {
+        struct dec_number t = x;
+        x = y;
+        y = t;
+        long m = msd_x;
+        msd_x = msd_y;
+        msd_y = m;
+    }
+    // an operand entirely below the rounding digit only decides the rounding, replace it with a small one
+    if (msd_y < msd_x - f->digits - 1)
+    {
+        y.coeff = 1;
+        y.exp = msd_x - f->digits - 2;
+    }
+
+    long exp = (x.exp < y.exp) ? x.exp : y.exp;
+    int shift_x = (int)(x.exp - exp);
+    int shift_y = (int)(y.exp - exp);
+    if (dec_digits(x.coeff) + shift_x < DEC_MAX_U128_DIGITS && dec_digits(y.coeff) + shift_y < DEC_MAX_U128_DIGITS)
+    {
+        uint128 cx = x.coeff * pow10_u128(shift_x);
+        uint128 cy = y.coeff * pow10_u128(shift_y);
+        uint128 c;
+        if (x.negative == y.negative)
+        {
+            c = cx + cy;
+            r->negative = x.negative;
+        }
+        else if (cx >= cy)
+        {
+            c = cx - cy;
+            r->negative = x.negative;
+        }
+        else
+        {
+            c = cy - cx;
+            r->negative = y.negative;
+        }
+        if (c == 0)
+        {
+            r->negative = false;
+        }
+        dec_round(r, c, exp, false, f->digits, f);
+        return;
+    }
+
+    bigint_t cx, cy, p;
+    bigint_init(&cx);
+    bigint_init(&cy);
+    bigint_init(&p);
+    bigint_set_u64(&p, 10);
+    bigint_pow_u64(&p, &p, (uint64_t)shift_x);
+    bigint_set_u128(&cx, x.coeff);
+    bigint_mul(&cx, &cx, &p);
+    bigint_set_u64(&p, 10);
+    bigint_pow_u64(&p, &p, (uint64_t)shift_y);
+    bigint_set_u128(&cy, y.coeff);
+    bigint_mul(&cy, &cy, &p);
+    if (x.negative)
+    {
+        bigint_neg(&cx, &cx);
+    }
+    if (y.negative)
+    {
+        bigint_neg(&cy, &cy);
+    }
+    bigint_add(&cx, &cx, &cy);
+    r->negative = cx.sign < 0;
+    cx.sign = 1;
+    dec_round_big(r, &cx, exp, false, f->digits, f);
+    bigint_free(&cx);
+    bigint_free(&cy);
+    bigint_free(&p);
+}
+
+/**
+ * @brief r = a * b
+ */
+static void dec_mul(struct dec_number *r, const struct dec_number *a, const struct dec_number *b,
+                    const struct dec_format *f)
+{
+    r->negative = a->negative != b->negative;
+    if (a->cls == DEC_NAN || b->cls == DEC_NAN ||
+        (a->cls == DEC_INF && b->cls == DEC_FINITE && b->coeff == 0) ||
+        (b->cls == DEC_INF && a->cls == DEC_FINITE && a->coeff == 0))
+    {
+        r->cls = DEC_NAN;
+        r->negative = false;
+        return;
+    }
+    if (a->cls == DEC_INF || b->cls == DEC_INF)
+    {
+        r->cls = DEC_INF;
+        return;
+    }
+    long exp = a->exp + b->exp;
+    uint128 c;
+    if (!__builtin_mul_overflow(a->coeff, b->coeff, &c))
+    {
+        dec_round(r, c, exp, false, f->digits, f);
+        return;
+    }
+    bigint_t x, y;
+    bigint_init(&x);
+    bigint_init(&y);
+    bigint_set_u128(&x, a->coeff);
+    bigint_set_u128(&y, b->coeff);
+    bigint_mul(&x, &x, &y);
+    dec_round_big(r, &x, exp, false, f->digits, f);
+    bigint_free(&x);
+    bigint_free(&y);
+}
+
+/**
+ * @brief r = a / b
+ */
+static void dec_div(struct dec_number *r, const struct dec_number *a, const struct dec_number *b,
+                    const struct dec_format *f)
+{
+    r->negative = a->negative != b->negative;
+    r->coeff = 0;
+    r->exp = 0;
+    if (a->cls == DEC_NAN || b->cls == DEC_NAN || (a->cls == DEC_INF && b->cls == DEC_INF) ||
+        (a->cls == DEC_FINITE && a->coeff == 0 && b->cls == DEC_FINITE && b->coeff == 0))
+    {
+        r->cls = DEC_NAN;
+        r->negative = false;
+        return;
+    }
+    if (b->cls == DEC_INF)
+    {
+        dec_round(r, 0, f->etiny, false, f->digits, f);
+        return;
+    }
+    if (a->cls == DEC_INF || b->coeff == 0)
+    {
+        r->cls = DEC_INF;
+        return;
+    }
+    long ideal = a->exp - b->exp;
+    if (a->coeff == 0)
+    {
+        dec_round(r, 0, ideal, false, f->digits, f);
+        return;
+    }
+
+    // scale the dividend so that the quotient has at least digits + 1 digits
+    int shift = f->digits + dec_digits(b->coeff) - dec_digits(a->coeff) + 1;
+    if (shift < 0)
+    {
+        shift = 0;
+    }
+    uint128 q;
+    bool sticky;
+    if (dec_digits(a->coeff) + shift <= DEC_MAX_U128_DIGITS)
+    {
+        uint128 n = a->coeff * pow10_u128(shift);
+        q = n / b->coeff;
+        sticky = n % b->coeff != 0;
+    }
+    else
+    {
+        bigint_t n, d, p, rem;
+        bigint_init(&n);
+        bigint_init(&d);
+        bigint_init(&p);
+        bigint_init(&rem);
+        bigint_set_u64(&p, 10);
+        bigint_pow_u64(&p, &p, (uint64_t)shift);
+        bigint_set_u128(&n, a->coeff);
+        bigint_mul(&n, &n, &p);
+        bigint_set_u128(&d, b->coeff);
+        bigint_divmod(&p, &rem, &n, &d);
+        sticky = !bigint_is_zero(&rem);
+        __int128 small;
+        bigint_get_i128(&p, &small); // at most digits + 2 digits
+        q = (uint128)small;
+        bigint_free(&n);
+        bigint_free(&d);
+        bigint_free(&p);
+        bigint_free(&rem);
+    }
+    long exp = ideal - shift;
+    if (!sticky)
+    {
+        // exact quotient, use the exponent closest to the ideal one
+        while (exp < ideal && q % 10 == 0)
+        {
+            q /= 10;
+            exp++;
+        }
+    }
+    dec_round(r, q, exp, sticky, f->digits, f);
+}
+
+/**
+ * @brief Parses a number in decimal notation, digits are copied straight into the coefficient.
+ * @return false if str is not a valid number
+ */
+static bool dec_parse(struct dec_number *r, const char *str, char dp_sep, const struct dec_format *f)
+{
+    const char *s = str;
+    r->negative = false;
+    if (*s == '-' || *s == '+')
+    {
+        r->negative = (*s == '-');
+        s++;
+    }
+    uint128 coeff = 0;
+    int kept = 0;         // significant digits stored in coeff
+    long exp = 0;
+    bool sticky = false;  // nonzero digits were dropped
+    bool any_digit = false;
+    bool after_point = false;
+    for (;; s++)
+    {
+        if (*s >= '0' && *s <= '9')
+        {
+            any_digit = true;
+            if (kept < DEC_MAX_U128_DIGITS - 1)
+            {
+                if (coeff != 0 || *s != '0')
+                {
+                    kept++;
+                }
+                coeff = coeff * 10 + (uint128)(*s - '0');
+                if (after_point)
+                {
+                    exp--;
+                }
+            }
+            else
+            {
+                sticky = sticky || *s != '0';
+                if (!after_point)
+                {
+                    exp++;
+                }
+            }
+        }
+        else if (*s == dp_sep && !after_point)
+        {
+            after_point = true;
+        }
+        else
+        {
+            break;
+        }
+    }
+    if (!any_digit)
+    {
+        return false;
+    }
+    if (*s == 'e' || *s == 'E')
+    {
+        s++;
+        bool exp_negative = false;
+        if (*s == '-' || *s == '+')
+        {
+            exp_negative = (*s == '-');
+            s++;
+        }
+        if (*s < '0' || *s > '9')
+        {
+            return false;
+        }
+        long e = 0;
+        for (; *s >= '0' && *s <= '9'; s++)
+        {
+            if (e < 1000000)
+            {
+                e = e * 10 + (*s - '0');
+            }
+        }
+        exp += exp_negative ? -e : e;
+    }
+    if (*s != '\0')
+    {
+        return false;
+    }
+    dec_round(r, coeff, exp, sticky, f->digits, f);
+    return true;
+}
+
+/**
+ * @brief Formats the number, see dec64_to_string.
+ */
+static void dec_format(const struct dec_number *u, char *str, char dp_sep, const struct dec_format *f)
+{
+    char *s = str;
+    if (u->negative)
+    {
+        *s++ = '-';
+    }
+    if (u->cls != DEC_FINITE)
+    {
+        strcpy(s, (u->cls == DEC_INF) ? "inf" : "nan");
+        return;
+    }
+
+    char digits[DEC_MAX_U128_DIGITS + 2];
+    int n = 0;
+    uint128 c = u->coeff;
+    do
+    {
+        digits[n++] = (char)('0' + (int)(c % 10));
+        c /= 10;
+    } while (c != 0);
+    for (int i = 0; i < n / 2; i++)
+    {
+        char t = digits[i];
+        digits[i] = digits[n - 1 - i];
+        digits[n - 1 - i] = t;
+    }
+
+    long adjusted = u->exp + n - 1;
+    if (u->exp <= 0 && adjusted >= -6)
+    {
+        long point = n + u->exp; // number of digits before the decimal point
+        if (point <= 0)
+        {
+            *s++ = '0';
+            *s++ = dp_sep;
+            for (long i = 0; i < -point; i++)
+            {
+                *s++ = '0';
+            }
+            memcpy(s, digits, (size_t)n);
+            s += n;
+        }
+        else
+        {
+            memcpy(s, digits, (size_t)point);
+            s += point;
+            if (point < n)
+            {
+                *s++ = dp_sep;
+                memcpy(s, digits + point, (size_t)(n - point));
+                s += n - point;
+            }
+        }
+    }
+    else if (u->exp > 0 && adjusted < f->digits)
+    {
+        memcpy(s, digits, (size_t)n);
+        s += n;
+        for (long i = 0; i < u->exp; i++)
+        {
+            *s++ = '0';
+        }
+    }
+    else
+    {
+        *s++ = digits[0];
+        if (n > 1)
+        {
+            *s++ = dp_sep;
+            memcpy(s, digits + 1, (size_t)(n - 1));
+            s += n - 1;
+        }
+        *s++ = 'e';
+        *s++ = (adjusted < 0) ? '-' : '+';
+        long e = (adjusted < 0) ? -adjusted : adjusted;
+        char exp_digits[8];
+        int m = 0;
+        do
+        {
+            exp_digits[m++] = (char)('0' + e % 10);
+            e /= 10;
+        } while (e != 0);
+        if (m < 2)
+        {
+            exp_digits[m++] = '0';
+        }
+        while (m > 0)
+        {
+            *s++ = exp_digits[--m];
+        }
+    }
+    *s = '\0';
+}
+
+/**
+ * @brief Converts x exactly and rounds it to DEC_LD_DIGITS digits, trailing zeros are removed.
+ */
+static void dec_from_ld(struct dec_number *r, long double x, const struct dec_format *f)
+{
+    r->negative = signbit(x);
+    r->coeff = 0;
+    r->exp = 0;
+    if (isnan(x))
+    {
+        r->cls = DEC_NAN;
+        r->negative = false;
+        return;
+    }
+    if (isinf(x))
+    {
+        r->cls = DEC_INF;
+        return;
+    }
+    r->cls = DEC_FINITE;
+    if (x == 0)
+    {
+        return;
+    }
+    int e;
+    long double m = frexpl(fabsl(x), &e);
+    uint64_t mant = (uint64_t)ldexpl(m, 64);
+    e -= 64;
+    while ((mant & 1) == 0)
+    {
+        mant >>= 1;
+        e++;
+    }
+    // mant * 2^e is an integer for e >= 0, otherwise it equals mant * 5^-e * 10^e
+    bigint_t c, p;
+    bigint_init(&c);
+    bigint_init(&p);
+    bigint_set_u64(&c, mant);
+    long exp = 0;
+    if (e >= 0)
+    {
+        bigint_shl(&c, &c, (size_t)e);
+    }
+    else
+    {
+        bigint_set_u64(&p, 5);
+        bigint_pow_u64(&p, &p, (uint64_t)-e);
+        bigint_mul(&c, &c, &p);
+        exp = e;
+    }
+    dec_round_big(r, &c, exp, false, (DEC_LD_DIGITS < f->digits) ? DEC_LD_DIGITS : f->digits, f);
+    while (r->cls == DEC_FINITE && r->coeff != 0 && r->coeff % 10 == 0 && r->exp < f->emax)
+    {
+        r->coeff /= 10;
+        r->exp++;
+    }
+    bigint_free(&c);
+    bigint_free(&p);
+}
+
+static long double dec_to_ld(const struct dec_number *u)
+{
+    long double x;
+    if (u->cls == DEC_NAN)
+    {
+        return NAN;
+    }
+    if (u->cls == DEC_INF)
+    {
+        x = INFINITY;
+    }
+    else if (u->exp >= 0)
+    {
+        x = (long double)u->coeff * powl(10.0L, (long double)u->exp);
+    }
+    else
+    {
+        x = (long double)u->coeff / powl(10.0L, (long double)-u->exp);
+    }
+    return u->negative ? -x : x;
+}
+
+bool dec64_from_string(decimal64_t *r, const char *str, char dp_sep)
+{
+    struct dec_number u;
+    if (!dec_parse(&u, str, dp_sep, &DEC64_FORMAT))
+    {
+        return false;
+    }
+    *r = dec64_pack(&u);
+    return true;
+}
+
+bool dec128_from_string(decimal128_t *r, const char *str, char dp_sep)
+{
+    struct dec_number u;
+    if (!dec_parse(&u, str, dp_sep, &DEC128_FORMAT))
+    {
+        return false;
+    }
+    *r = dec128_pack(&u);
+    return true;
+}
+
+void dec64_to_string(decimal64_t x, char *str, char dp_sep)
+{
+    struct dec_number u;
+    dec64_unpack(x, &u);
+    dec_format(&u, str, dp_sep, &DEC64_FORMAT);
+}
+
+void dec128_to_string(decimal128_t x, char *str, char dp_sep)
+{
+    struct dec_number u;
+    dec128_unpack(x, &u);
+    dec_format(&u, str, dp_sep, &DEC128_FORMAT);
+}
+
+decimal64_t dec64_from_ld(long double x)
+{
+    struct dec_number u;
+    dec_from_ld(&u, x, &DEC64_FORMAT);
+    return dec64_pack(&u);
+}
+
+decimal128_t dec128_from_ld(long double x)
+{
+    struct dec_number u;
+    dec_from_ld(&u, x, &DEC128_FORMAT);
+    return dec128_pack(&u);
+}
+
+long double dec64_to_ld(decimal64_t x)
+{
+    struct dec_number u;
+    dec64_unpack(x, &u);
+    return dec_to_ld(&u);
+}
+
+long double dec128_to_ld(decimal128_t x)
+{
+    struct dec_number u;
+    dec128_unpack(x, &u);
+    return dec_to_ld(&u);
+}
+
+bool dec64_is_zero(decimal64_t x)
+{
+    struct dec_number u;
+    dec64_unpack(x, &u);
+    return u.cls == DEC_FINITE && u.coeff == 0;
+}
+
+bool dec128_is_zero(decimal128_t x)
+{
+    struct dec_number u;
+    dec128_unpack(x, &u);
+    return u.cls == DEC_FINITE && u.coeff == 0;
+}
+
+bool dec128_is_finite(decimal128_t x)
+{
+    struct dec_number u;
+    dec128_unpack(x, &u);
+    return u.cls == DEC_FINITE;
+}
+
+/**
+ * @brief Fast path of decimal64 addition: small coefficients of equal exponents, no rounding needed.
+ * @return true if the result was stored in r
+ */
+static bool dec64_add_fast(decimal64_t *r, decimal64_t a, decimal64_t b, bool subtract)
+{
+    // both numbers in the short-coefficient form and with the same exponent field
+    const uint64_t coeff_mask = ((uint64_t)1 << 53) - 1;
+    const uint64_t exp_mask = (uint64_t)0x3FF << 53;
+    if ((a.bits >> 61 & 3) == 3 || (b.bits >> 61 & 3) == 3 || (a.bits & exp_mask) != (b.bits & exp_mask))
+    {
+        return false;
+    }
+    uint64_t ca = a.bits & coeff_mask;
+    uint64_t cb = b.bits & coeff_mask;
+    bool na = a.bits >> 63;
+    bool nb = (b.bits >> 63) != subtract;
+    uint64_t c;
+    bool negative;
+    if (na == nb)
+    {
+        c = ca + cb;
+        negative = na;
+    }
+    else if (ca >= cb)
+    {
+        c = ca - cb;
+        negative = na && c != 0;
+    }
+    else
+    {
+        c = cb - ca;
+        negative = nb;
+    }
+    if (c >> 53 != 0)
+    {
+        return false;
+    }
+    r->bits = (uint64_t)negative << 63 | (a.bits & exp_mask) | c;
+    return true;
+}
+
+decimal64_t dec64_add(decimal64_t a, decimal64_t b)
+{
+    decimal64_t r;
+    if (dec64_add_fast(&r, a, b, false))
+    {
+        return r;
+    }
+    struct dec_number x, y, z;
+    dec64_unpack(a, &x);
+    dec64_unpack(b, &y);
+    dec_add(&z, &x, &y, &DEC64_FORMAT);
+    return dec64_pack(&z);
+}
+
+decimal64_t dec64_sub(decimal64_t a, decimal64_t b)
+{
+    decimal64_t r;
+    if (dec64_add_fast(&r, a, b, true))
+    {
+        return r;
+    }
+    struct dec_number x, y, z;
+    dec64_unpack(a, &x);
+    dec64_unpack(b, &y);
+    y.negative = !y.negative;
+    dec_add(&z, &x, &y, &DEC64_FORMAT);
+    return dec64_pack(&z);
+}
+
+decimal64_t dec64_mul(decimal64_t a, decimal64_t b)
+{
+    struct dec_number x, y, z;
+    dec64_unpack(a, &x);
+    dec64_unpack(b, &y);
+    dec_mul(&z, &x, &y, &DEC64_FORMAT);
+    return dec64_pack(&z);
+}
+
+decimal64_t dec64_div(decimal64_t a, decimal64_t b)
+{
+    struct dec_number x, y, z;
+    dec64_unpack(a, &x);
+    dec64_unpack(b, &y);
+    dec_div(&z, &x, &y, &DEC64_FORMAT);
+    return dec64_pack(&z);
+}
+
+/**
+ * @brief Fast path of decimal128 addition: coefficients below 2^63 with equal exponents.
+ * @return true if the result was stored in r
+ */
+static bool dec128_add_fast(decimal128_t *r, decimal128_t a, decimal128_t b, bool subtract)
+{
+    // upper 49 bits of the coefficients are zero and the exponent fields are equal
+    const uint64_t coeff_mask = ((uint64_t)1 << 49) - 1;
+    const uint64_t exp_mask = (uint64_t)0x3FFF << 49;
+    if ((a.hi >> 61 & 3) == 3 || (b.hi >> 61 & 3) == 3 || (a.hi & exp_mask) != (b.hi & exp_mask) ||
+        (a.hi & coeff_mask) != 0 || (b.hi & coeff_mask) != 0 || (a.lo | b.lo) >> 63 != 0)
+    {
+        return false;
+    }
+    bool na = a.hi >> 63;
+    bool nb = (b.hi >> 63) != subtract;
+    uint64_t c;
+    bool negative;
+    if (na == nb)
+    {
+        c = a.lo + b.lo;
+        negative = na;
+    }
+    else if (a.lo >= b.lo)
+    {
+        c = a.lo - b.lo;
+        negative = na && c != 0;
+    }
+    else
+    {
+        c = b.lo - a.lo;
+        negative = nb;
+    }
+    r->hi = (uint64_t)negative << 63 | (a.hi & exp_mask);
+    r->lo = c;
+    return true;
+}
+
+decimal128_t dec128_add(decimal128_t a, decimal128_t b)
+{
+    decimal128_t r;
+    if (dec128_add_fast(&r, a, b, false))
+    {
+        return r;
+    }
+    struct dec_number x, y, z;
+    dec128_unpack(a, &x);
+    dec128_unpack(b, &y);
+    dec_add(&z, &x, &y, &DEC128_FORMAT);
+    return dec128_pack(&z);
+}
+
+decimal128_t dec128_sub(decimal128_t a, decimal128_t b)
+{
+    decimal128_t r;
+    if (dec128_add_fast(&r, a, b, true))
+    {
+        return r;
+    }
+    struct dec_number x, y, z;
+    dec128_unpack(a, &x);
+    dec128_unpack(b, &y);
+    y.negative = !y.negative;
+    dec_add(&z, &x, &y, &DEC128_FORMAT);
+    return dec128_pack(&z);
+}
+
+decimal128_t dec128_mul(decimal128_t a, decimal128_t b)
+{
+    struct dec_number x, y, z;
+    dec128_unpack(a, &x);
+    dec128_unpack(b, &y);
+    dec_mul(&z, &x, &y, &DEC128_FORMAT);
+    return dec128_pack(&z);
+}
+
+decimal128_t dec128_div(decimal128_t a, decimal128_t b)
+{
+    struct dec_number x, y, z;
+    dec128_unpack(a, &x);
+    dec128_unpack(b, &y);
+    dec_div(&z, &x, &y, &DEC128_FORMAT);
+    return dec128_pack(&z);
+}
@@ -0,0 +1,157 @@
+/**
+ * @file decimal.h
+ * @brief Decimal floating-point arithmetic (IEEE 754 decimal64 and decimal128, BID encoding)
+ * @date 18.10.2026
+ *
+ * Values are stored in the binary integer decimal (BID) encoding, i.e. sign * coefficient * 10^exponent
+ * with an integer coefficient, so decimal fractions like 0.1 are represented exactly.
+ * Results are rounded half to even. Operations on coefficients that fit in 64 bits never touch
+ * the multi-limb code path.
+ */
+
+#ifndef DECIMAL_H
+#define DECIMAL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define DEC64_DIGITS 16  // precision of decimal64 in decimal digits
+#define DEC128_DIGITS 34 // precision of decimal128 in decimal digits
+#define DEC_STRING_SIZE 64 // size of a buffer sufficient for any decimal64 or decimal128 string
+
+/** @struct decimal64
+ *  @brief decimal64 number in BID encoding.
+ *  @param bits encoded value
+ */
+struct decimal64
+{
+    uint64_t bits;
+};
+
+/** @struct decimal128
+ *  @brief decimal128 number in BID encoding.
+ *  @param lo lower half of the encoded value
+ *  @param hi upper half of the encoded value (contains sign, exponent and top of the coefficient)
+ */
+struct decimal128
+{
+    uint64_t lo;
+    uint64_t hi;
+};
+
+typedef struct decimal64 decimal64_t;
+typedef struct decimal128 decimal128_t;
+
+/**
+ * @brief Parses a number in decimal notation, e.g. "-12.5e-3".
+ * @param r receives the value, rounded to DEC64_DIGITS digits
+ * @param str string to be parsed
+ * @param dp_sep decimal point character
+ * @return false if str is not a valid number
+ */
+bool dec64_from_string(decimal64_t *r, const char *str, char dp_sep);
+
+/**
+ * @brief Parses a number in decimal notation, e.g. "-12.5e-3".
+ * @param r receives the value, rounded to DEC128_DIGITS digits
+ * @param str string to be parsed
+ * @param dp_sep decimal point character
+ * @return false if str is not a valid number
+ */
+bool dec128_from_string(decimal128_t *r, const char *str, char dp_sep);
+
+/**
+ * @brief Writes the number to a string.
+ * @details Plain notation is used for numbers with a small exponent ("0.3", "1200"), scientific
+ * notation otherwise ("1.5e+40"). Trailing zeros of the coefficient are kept ("1.50").
+ * @param x
+ * @param str destination, at least DEC_STRING_SIZE characters
+ * @param dp_sep decimal point character
+ */
+void dec64_to_string(decimal64_t x, char *str, char dp_sep);
+
+/**
+ * @brief Writes the number to a string, see dec64_to_string.
+ * @param x
+ * @param str destination, at least DEC_STRING_SIZE characters
+ * @param dp_sep decimal point character
+ */
+void dec128_to_string(decimal128_t x, char *str, char dp_sep);
+
+/**
+ * @brief Converts a binary floating-point number (rounded to 19 significant digits).
+ */
+decimal64_t dec64_from_ld(long double x);
+
+/**
+ * @brief Converts a binary floating-point number (rounded to 19 significant digits).
+ */
+decimal128_t dec128_from_ld(long double x);
+
+/**
+ * @brief Converts the number to binary floating-point.
+ */
+long double dec64_to_ld(decimal64_t x);
+
+/**
+ * @brief Converts the number to binary floating-point.
+ */
+long double dec128_to_ld(decimal128_t x);
+
+/**
+ * @brief Tests whether the number is (positive or negative) zero.
+ */
+bool dec64_is_zero(decimal64_t x);
+
+/**
+ * @brief Tests whether the number is (positive or negative) zero.
+ */
+bool dec128_is_zero(decimal128_t x);
+
+/**
+ * @brief Tests whether the number is neither infinite nor NaN.
+ */
+bool dec128_is_finite(decimal128_t x);
+
+/**
+ * @brief a + b
+ */
+decimal64_t dec64_add(decimal64_t a, decimal64_t b);
+
+/**
+ * @brief a - b
+ */
+decimal64_t dec64_sub(decimal64_t a, decimal64_t b);
+
+/**
+ * @brief a * b
+ */
+decimal64_t dec64_mul(decimal64_t a, decimal64_t b);
+
+/**
+ * @brief a / b (infinity for b = 0, NaN for 0/0)
+ */
+decimal64_t dec64_div(decimal64_t a, decimal64_t b);
+
+/**
+ * @brief a + b
+ */
+decimal128_t dec128_add(decimal128_t a, decimal128_t b);
+
+/**
+ * @brief a - b
+ */
+decimal128_t dec128_sub(decimal128_t a, decimal128_t b);
+
+/**
+ * @brief a * b
+ */
+decimal128_t dec128_mul(decimal128_t a, decimal128_t b);
+
+/**
+ * @brief a / b (infinity for b = 0, NaN for 0/0)
+ */
+decimal128_t dec128_div(decimal128_t a, decimal128_t b);
+
+#endif
@@ -85,6 +85,42 @@ void caleng_format_display_input(char *str)
     }
 }
 
+/**
+ * @brief Sets the operand of the current mode to the constant shown in the input buffer.
+ * @details The rounded digits in the buffer are ignored, only its sign is used.
+ * @param eng Pointer to the engine.
+ * @return Value of the constant in long double.
+ */
+long double caleng_process_constant(engine_t *eng)
+{
+    bool negative = (eng->input_buffer[0] == '-');
+    long double num = constant_get_ld(eng->const_operand);
+    num = negative ? -num : num;
+    if (eng->mode == RATIONAL_MODE)
+    {
+        rational_set_ld(&eng->roperand, num);
+    }
+    else if (eng->mode == DECIMAL_MODE)
+    {
+        char str[DEC_STRING_SIZE] = "-";
+        bigfloat_t c;
+        bigfloat_init(&c, bigfloat_digits_to_prec(DEC128_DIGITS));
+        constant_get(&c, eng->const_operand);
+        bigfloat_get_string(&c, str + 1, sizeof(str) - 1, DEC128_DIGITS, '.');
+        dec128_from_string(&eng->doperand, negative ? str : str + 1, '.');
+        bigfloat_free(&c);
+    }
+    else if (eng->mode == BIGFLOAT_MODE)
+    {
+        constant_get(&eng->foperand, eng->const_operand);
+        if (negative)
+        {
+            bigfloat_neg(&eng->foperand, &eng->foperand);
+        }
+    }
+    return num;
+}
+
 /**
  * @brief Processes the input buffer and returns a long double. Buffer is set to an empty string.
  * @details
@@ -111,10 +147,248 @@ long double caleng_process_input_buffer(engine_t *eng)
     
     long double num;
     assert(1 == sscanf(eng->input_buffer, "%Lf", &num));
+    if (eng->mode == RATIONAL_MODE && !rational_set_decimal(&eng->roperand, eng->input_buffer, eng->dp_sep))
+    {
+        rational_set_ld(&eng->roperand, num);
+    }
+    if (eng->mode == DECIMAL_MODE && !dec128_from_string(&eng->doperand, eng->input_buffer, eng->dp_sep))
+    {
+        eng->doperand = dec128_from_ld(num);
+    }
+    if (eng->mode == BIGFLOAT_MODE && !bigfloat_set_string(&eng->foperand, eng->input_buffer, eng->dp_sep))
+    {
+        bigfloat_set_ld(&eng->foperand, num);
+    }
+    if (eng->const_operand != NO_CONSTANT)
+    {
+        num = caleng_process_constant(eng);
+        eng->const_operand = NO_CONSTANT;
+    }
     eng->input_buffer[0] = '\0';
     return num;
 }
 
+/**
+ * @brief Processes the input buffer and stores the number in engine's memory.
+ * @param eng Pointer to the engine.
+ */
+void caleng_store_input_buffer(engine_t *eng)
+{
+    eng->memory = caleng_process_input_buffer(eng);
+    if (eng->mode == RATIONAL_MODE)
+    {
+        rational_copy(&eng->rmemory, &eng->roperand);
+    }
+    else if (eng->mode == DECIMAL_MODE)
+    {
+        eng->dmemory = eng->doperand;
+    }
+    else if (eng->mode == BIGFLOAT_MODE)
+    {
+        bigfloat_copy(&eng->fmemory, &eng->foperand);
+    }
+}
+
+/**
+ * @brief Converts the value in memory to the representation of the current mode (rmemory or dmemory).
+ * @details Used after an operation that was evaluated in long double only.
+ * @param eng Pointer to the engine.
+ */
+void caleng_sync_memory(engine_t *eng)
+{
+    if (eng->mode == RATIONAL_MODE)
+    {
+        rational_set_ld(&eng->rmemory, eng->memory);
+    }
+    else if (eng->mode == DECIMAL_MODE)
+    {
+        eng->dmemory = dec128_from_ld(eng->memory);
+    }
+    else if (eng->mode == BIGFLOAT_MODE)
+    {
+        bigfloat_set_ld(&eng->fmemory, eng->memory);
+    }
+}
+
+/**
+ * @brief Checks whether the value in memory can be displayed.
+ * @param eng Pointer to the engine.
+ * @return OVERFLOW_ERR if the value is out of range, OK otherwise.
+ */
+int caleng_check_overflow(engine_t *eng)
+{
+    if (eng->memory > 9.999999999e99 || eng->memory < -9.999999999e99)
+    {
+        return OVERFLOW_ERR;
+    }
+    return OK;
+}
+
+/**
+ * @brief Evaluates the selected binary operation exactly (RATIONAL_MODE).
+ * @details Operands are eng->rmemory and eng->roperand, the result is saved into eng->rmemory and
+ * its approximation into eng->memory.
+ * @param eng Pointer to the engine.
+ * @param rtn_code Receives the return code (from enum result_rtn_types).
+ * @return false if the selected operation has no exact implementation.
+ */
+bool caleng_eval_rational_bi_op(engine_t *eng, int *rtn_code)
+{
+    long double exponent;
+    switch (eng->sel_op)
+    {
+    case ADD:
+        rational_add(&eng->rmemory, &eng->rmemory, &eng->roperand);
+        break;
+    case SUB:
+        rational_sub(&eng->rmemory, &eng->rmemory, &eng->roperand);
+        break;
+    case MUL:
+        rational_mul(&eng->rmemory, &eng->rmemory, &eng->roperand);
+        break;
+    case DIV:
+        if (!rational_div(&eng->rmemory, &eng->rmemory, &eng->roperand))
+        {
+            *rtn_code = MATH_ERR;
+            return true;
+        }
+        break;
+    case POW:
+        exponent = rational_get_ld(&eng->roperand);
+        if (exponent < 0.0L)
+        {
+            *rtn_code = MATH_ERR;
+            return true;
+        }
+        if (!rational_is_integer(&eng->roperand) || exponent > 65536.0L)
+        {
+            return false;
+        }
+        rational_pow(&eng->rmemory, &eng->rmemory, exponent);
+        break;
+    default:
+        return false;
+    }
+    eng->memory = rational_get_ld(&eng->rmemory);
+    *rtn_code = caleng_check_overflow(eng);
+    return true;
+}
+
+/**
+ * @brief Evaluates the selected binary operation in decimal128 (DECIMAL_MODE).
+ * @details Operands are eng->dmemory and eng->doperand, the result is saved into eng->dmemory and
+ * its approximation into eng->memory.
+ * @param eng Pointer to the engine.
+ * @param rtn_code Receives the return code (from enum result_rtn_types).
+ * @return false if the selected operation has no decimal implementation.
+ */
+bool caleng_eval_decimal_bi_op(engine_t *eng, int *rtn_code)
+{
+    switch (eng->sel_op)
+    {
+    case ADD:
+        eng->dmemory = dec128_add(eng->dmemory, eng->doperand);
+        break;
+    case SUB:
+        eng->dmemory = dec128_sub(eng->dmemory, eng->doperand);
+        break;
+    case MUL:
+        eng->dmemory = dec128_mul(eng->dmemory, eng->doperand);
+        break;
+    case DIV:
+        if (dec128_is_zero(eng->doperand))
+        {
+            *rtn_code = MATH_ERR;
+            return true;
+        }
+        eng->dmemory = dec128_div(eng->dmemory, eng->doperand);
+        break;
+    default:
+        return false;
+    }
+    eng->memory = dec128_to_ld(eng->dmemory);
+    *rtn_code = dec128_is_finite(eng->dmemory) ? caleng_check_overflow(eng) : OVERFLOW_ERR;
+    return true;
+}
+
+/**
+ * @brief Evaluates the selected binary operation with eng->precision digits (BIGFLOAT_MODE).
+ * @details Operands are eng->fmemory and eng->foperand, the result is saved into eng->fmemory and
+ * its approximation into eng->memory.
+ * @param eng Pointer to the engine.
+ * @param rtn_code Receives the return code (from enum result_rtn_types).
+ * @return false if the selected operation has no arbitrary-precision implementation.
+ */
+bool caleng_eval_bigfloat_bi_op(engine_t *eng, int *rtn_code)
+{
+    long double degree;
+    switch (eng->sel_op)
+    {
+    case ADD:
+        bigfloat_add(&eng->fmemory, &eng->fmemory, &eng->foperand);
+        break;
+    case SUB:
+        bigfloat_sub(&eng->fmemory, &eng->fmemory, &eng->foperand);
+        break;
+    case MUL:
+        bigfloat_mul(&eng->fmemory, &eng->fmemory, &eng->foperand);
+        break;
+    case DIV:
+        if (!bigfloat_div(&eng->fmemory, &eng->fmemory, &eng->foperand))
+        {
+            *rtn_code = MATH_ERR;
+            return true;
+        }
+        break;
+    case ROOT:
+        degree = bigfloat_get_ld(&eng->foperand);
+        if (degree < 1.0L)
+        {
+            *rtn_code = MATH_ERR;
+            return true;
+        }
+        if (degree > 4294967295.0L || degree != (long double)(unsigned long)degree)
+        {
+            return false;
+        }
+        if (!bigfloat_root(&eng->fmemory, &eng->fmemory, (unsigned long)degree))
+        {
+            *rtn_code = MATH_ERR;
+            return true;
+        }
+        break;
+    default:
+        return false;
+    }
+    eng->memory = bigfloat_get_ld(&eng->fmemory);
+    *rtn_code = caleng_check_overflow(eng);
+    return true;
+}
+
+/**
+ * @brief Converts an integral value to its absolute value as a 64-bit integer.
+ * @param num Converted value.
+ * @param x Destination of the converted value.
+ * @return Return code informing about success or error (from enum result_rtn_types).
+ */
+int caleng_to_integer(long double num, unsigned long long *x)
+{
+    if (num < 0.0L)
+    {
+        num = -num;
+    }
+    if (num >= 18446744073709551616.0L) // 2^64
+    {
+        return OVERFLOW_ERR;
+    }
+    *x = num;
+    if ((long double)*x != num)
+    {
+        return MATH_ERR;
+    }
+    return OK;
+}
+
 /**
  * @brief Evaluates the selected binary operation (based on eng->sel_op), where the first operand is engine's memory.
  * Result is saved into engine's memory.
@@ -125,6 +399,20 @@ long double caleng_process_input_buffer(engine_t *eng)
 int caleng_eval_bi_op(engine_t *eng, long double num)
 {
     long num_long, num_long2;
+    unsigned long long x, y;
+    int rtn;
+    if (eng->mode == RATIONAL_MODE && caleng_eval_rational_bi_op(eng, &rtn))
+    {
+        return rtn;
+    }
+    if (eng->mode == DECIMAL_MODE && caleng_eval_decimal_bi_op(eng, &rtn))
+    {
+        return rtn;
+    }
+    if (eng->mode == BIGFLOAT_MODE && caleng_eval_bigfloat_bi_op(eng, &rtn))
+    {
+        return rtn;
+    }
     switch (eng->sel_op)
     {
     case ADD:
@@ -174,17 +462,128 @@ int caleng_eval_bi_op(engine_t *eng, long double num)
         eng->memory = comb(num_long, num_long2);
         break;
 
+    case GCD:
+        if ((rtn = caleng_to_integer(eng->memory, &x)) != OK || (rtn = caleng_to_integer(num, &y)) != OK)
+        {
+            return rtn;
+        }
+        eng->memory = gcd(x, y);
+        break;
+    case LCM:
+        if ((rtn = caleng_to_integer(eng->memory, &x)) != OK || (rtn = caleng_to_integer(num, &y)) != OK)
+        {
+            return rtn;
+        }
+        eng->memory = lcm_u128(x, y);
+        break;
+    case FIBONACCI_MOD:
+    case LUCAS_MOD:
+        if (eng->memory < 0.0L || (rtn = caleng_to_integer(eng->memory, &x)) != OK ||
+            (rtn = caleng_to_integer(num, &y)) != OK)
+        {
+            return (eng->memory < 0.0L) ? MATH_ERR : rtn;
+        }
+        if (y == 0)
+        {
+            return MATH_ERR;
+        }
+        eng->memory = (eng->sel_op == FIBONACCI_MOD) ? fibonacci_mod(x, y) : lucas_mod(x, y);
+        break;
+
     default:
         fprintf(stderr, "WARNING: caleng_eval_bi_op - invalid identifier\n");
         break;
     }
-    if (eng->memory > 9.999999999e99 || eng->memory < -9.999999999e99)
+    if ((rtn = caleng_check_overflow(eng)) == OK)
+    {
+        caleng_sync_memory(eng);
+    }
+    return rtn;
+}
+
+/**
+ * @brief Writes the prime factorization of num as a string, e.g. "2^3*3*5".
+ * @param num Number to be factorized, has to be a natural number lower than 2^64.
+ * @param str Destination string, at least BUFFER_SIZE + 1 characters long.
+ * @return Return code informing about success or error (from enum result_rtn_types).
+ */
+int caleng_factorization_string(long double num, char *str)
+{
+    if (num < 1.0L)
+    {
+        return MATH_ERR;
+    }
+    if (num >= 18446744073709551616.0L) // 2^64
     {
         return OVERFLOW_ERR;
     }
+    unsigned long long x = num;
+    if ((long double)x != num)
+    {
+        return MATH_ERR;
+    }
+    if (x == 1)
+    {
+        strcpy(str, "1");
+        return OK;
+    }
+
+    unsigned long long factors[MAX_PRIME_FACTORS];
+    int count = factorize(x, factors);
+    int len = 0;
+    for (int i = 0; i < count;)
+    {
+        int j = i;
+        while (j < count && factors[j] == factors[i])
+        {
+            j++;
+        }
+        len += sprintf(str + len, (i == 0) ? "%llu" : "*%llu", factors[i]);
+        if (j - i > 1)
+        {
+            len += sprintf(str + len, "^%d", j - i);
+        }
+        i = j;
+    }
+    return OK;
+}
+
+/**
+ * @brief Moves the operand of an unary operation to memory.
+ * @details If no operator is selected, the input buffer is stored. If the last operation was evaluate
+ * '=' and the buffer is empty, memory is kept. Otherwise the previous expression is evaluated.
+ * @param eng Pointer to the engine.
+ * @return Return code (from enum result_rtn_types).
+ */
+int caleng_take_operand(engine_t *eng)
+{
+    if (eng->sel_op == NONE)
+    {
+        caleng_store_input_buffer(eng);
+    }
+    else if (eng->sel_op != EVAL || eng->input_buffer[0] != '\0')
+    {
+        return caleng_evaluate(eng).rtn_code;
+    }
     return OK;
 }
 
+/**
+ * @brief Copies the entered polynomial to coef from the constant term.
+ * @param eng Pointer to the engine.
+ * @param coef Destination of at least POLY_MAX_DEGREE + 1 items.
+ * @return Degree of the polynomial.
+ */
+int caleng_poly_coefficients(engine_t *eng, long double *coef)
+{
+    int degree = eng->poly_count - 1;
+    for (int k = 0; k <= degree; k++)
+    {
+        coef[k] = eng->poly_coef[degree - k];
+    }
+    return degree;
+}
+
 engine_t *caleng_init()
 {
     engine_t *eng = malloc(sizeof(engine_t));
@@ -197,12 +596,35 @@ engine_t *caleng_init()
         eng->exponent_length_limit = DEFAULT_EXPONENT_LENGTH_LIMIT;
         eng->status = OK;
         eng->dp_sep = localeconv()->decimal_point[0];
+        eng->mode = REAL_MODE;
+        rational_init(&eng->rmemory);
+        rational_init(&eng->roperand);
+        eng->dmemory = dec128_from_ld(0.0L);
+        eng->doperand = eng->dmemory;
+        eng->precision = BIGFLOAT_DEFAULT_DIGITS;
+        bigfloat_init(&eng->fmemory, bigfloat_digits_to_prec(BIGFLOAT_DEFAULT_DIGITS));
+        bigfloat_init(&eng->foperand, bigfloat_digits_to_prec(BIGFLOAT_DEFAULT_DIGITS));
+        eng->const_operand = NO_CONSTANT;
+        eng->poly_count = 0;
+        eng->root_count = 0;
+        matrix_init(&eng->matrix, 0, 0);
+        matrix_init(&eng->matrix_prev, 0, 0);
+        eng->matrix_fill = 0;
     }
     return eng;
 }
 
 void caleng_free(engine_t *eng)
 {
+    if (eng != NULL)
+    {
+        rational_free(&eng->rmemory);
+        rational_free(&eng->roperand);
+        bigfloat_free(&eng->fmemory);
+        bigfloat_free(&eng->foperand);
+        matrix_free(&eng->matrix);
+        matrix_free(&eng->matrix_prev);
+    }
     free(eng);
 }
 
@@ -212,6 +634,15 @@ result_t caleng_cancel(engine_t *eng)
     result_t r = {OK, "0"};
     eng->input_buffer[0] = '\0';
     eng->memory = 0.0;
+    rational_set_i64(&eng->rmemory, 0, 1);
+    eng->dmemory = dec128_from_ld(0.0L);
+    bigfloat_set_i64(&eng->fmemory, 0);
+    eng->const_operand = NO_CONSTANT;
+    eng->poly_count = 0;
+    eng->root_count = 0;
+    matrix_resize(&eng->matrix, 0, 0);
+    matrix_resize(&eng->matrix_prev, 0, 0);
+    eng->matrix_fill = 0;
     eng->sel_op = NONE;
     eng->status = OK;
     return r;
@@ -227,6 +658,7 @@ result_t caleng_backspace(engine_t *eng)
         return r;
     }
 
+    eng->const_operand = NO_CONSTANT; // the shown digits become a typed number
     if (eng->input_buffer[0] == '\0')
     {
         strcpy(r.to_display, "0");
@@ -262,6 +694,11 @@ result_t caleng_insert_digit(engine_t *eng, char digit)
         return r;
     }
 
+    if (eng->const_operand != NO_CONSTANT) // typing after a constant starts a new number
+    {
+        eng->const_operand = NO_CONSTANT;
+        eng->input_buffer[0] = '\0';
+    }
     bool minus_inserted = false;
     bool exponent_mode = false;
     bool dpoint_inserted = false;
@@ -335,6 +772,7 @@ result_t caleng_insert_exp(engine_t *eng)
         return r;
     }
 
+    eng->const_operand = NO_CONSTANT; // the shown digits become a typed number
     int non_zero_digits_detected = 0;
     // Check whether decimal point is followed by no digit.
     for(int i = 0; i < BUFFER_SIZE || eng->input_buffer[i] != '\0'; i++)
@@ -391,6 +829,11 @@ result_t caleng_insert_decimal_point(engine_t *eng)
         return r;
     }
 
+    if (eng->const_operand != NO_CONSTANT) // typing after a constant starts a new number
+    {
+        eng->const_operand = NO_CONSTANT;
+        eng->input_buffer[0] = '\0';
+    }
     int non_zero_digits_detected = 0;
     for (int i = 0; i < BUFFER_SIZE; i++)
     {
@@ -473,6 +916,31 @@ result_t caleng_negate(engine_t *eng)
     return r;
 }
 
+result_t caleng_insert_constant(engine_t *eng, int constant)
+{
+    assert(eng != NULL);
+    assert(constant >= 0 && constant < CONSTANT_COUNT);
+    result_t r = {OK, ""};
+    if (eng->status != OK)
+    {
+        r.rtn_code = eng->status;
+        return r;
+    }
+
+    bigfloat_t c;
+    bigfloat_init(&c, bigfloat_digits_to_prec(eng->mantissa_length_limit));
+    constant_get(&c, constant);
+    bigfloat_get_string(&c, eng->input_buffer, BUFFER_SIZE + 1, eng->mantissa_length_limit, eng->dp_sep);
+    bigfloat_free(&c);
+    eng->const_operand = constant;
+    if (eng->sel_op == EVAL) // last processed value is thrown away when user inputs something into the input buffer
+    {
+        eng->sel_op = NONE;
+    }
+    strcpy(r.to_display, eng->input_buffer);
+    return r;
+}
+
 result_t caleng_evaluate(engine_t *eng)
 {
     assert(eng != NULL);
@@ -487,12 +955,25 @@ result_t caleng_evaluate(engine_t *eng)
     {
         if (eng->sel_op == NONE)
         {
-            eng->memory = caleng_process_input_buffer(eng);
+            caleng_store_input_buffer(eng);
         }
         caleng_get_memory_string(eng, r.to_display);
     }
     else if (eng->input_buffer[0] == '\0')
     {
+        // memory is also the second operand
+        if (eng->mode == RATIONAL_MODE)
+        {
+            rational_copy(&eng->roperand, &eng->rmemory);
+        }
+        else if (eng->mode == DECIMAL_MODE)
+        {
+            eng->doperand = eng->dmemory;
+        }
+        else if (eng->mode == BIGFLOAT_MODE)
+        {
+            bigfloat_copy(&eng->foperand, &eng->fmemory);
+        }
         r.rtn_code = caleng_eval_bi_op(eng, eng->memory);
         if (r.rtn_code != OK)
         {
@@ -525,21 +1006,7 @@ result_t caleng_eval_un_op(engine_t *eng, int op)
         return r;
     }
 
-    if (eng->sel_op == NONE)
-    {
-        // use value from the input buffer
-        eng->memory = caleng_process_input_buffer(eng);
-    }
-    else if (eng->sel_op == EVAL && eng->input_buffer[0] == '\0')
-    {
-        // use memory
-    }
-    else
-    {
-        // evaluate previous expression
-        r = caleng_evaluate(eng);
-    }
-    
+    r.rtn_code = caleng_take_operand(eng);
     if (r.rtn_code == OK)
     {
         switch (op)
@@ -558,19 +1025,51 @@ result_t caleng_eval_un_op(engine_t *eng, int op)
             }
             eng->memory = factorial(num);
             break;
-        default:
-            fprintf(stderr, "WARNING: caleng_eval_un_op - invalid identifier\n");
+        case FACTORIZATION:
+            r.rtn_code = caleng_factorization_string(eng->memory, r.to_display);
             break;
-        }
-    }
-
-    if (r.rtn_code != OK)
-    {
-        eng->status = r.rtn_code;
+        case FIBONACCI:
+        case LUCAS:
+        {
+            unsigned long long n;
+            if (eng->memory < 0.0L || caleng_to_integer(eng->memory, &n) != OK)
+            {
+                r.rtn_code = MATH_ERR;
+                break;
+            }
+            if (n > (op == FIBONACCI ? FIBONACCI_DIGITS100_MAX : LUCAS_DIGITS100_MAX)) // longer than the display
+            {
+                r.rtn_code = OVERFLOW_ERR;
+                break;
+            }
+            unsigned __int128 exact;
+            if (op == FIBONACCI)
+            {
+                eng->memory = fibonacci_exact(n, &exact) ? (long double)exact : fibonacci(n);
+            }
+            else
+            {
+                eng->memory = lucas_exact(n, &exact) ? (long double)exact : lucas(n);
+            }
+            break;
+        }
+        default:
+            fprintf(stderr, "WARNING: caleng_eval_un_op - invalid identifier\n");
+            break;
+        }
+    }
+
+    if (r.rtn_code != OK)
+    {
+        eng->status = r.rtn_code;
     }
     else
     {
-        caleng_get_memory_string(eng, r.to_display);
+        if (op != FACTORIZATION)
+        {
+            caleng_sync_memory(eng);
+            caleng_get_memory_string(eng, r.to_display);
+        }
         eng->sel_op = EVAL;
     }
 
@@ -589,7 +1088,7 @@ result_t caleng_select_bi_op(engine_t *eng, int op)
     if (eng->sel_op == NONE)
     {
         eng->sel_op = op;
-        eng->memory = caleng_process_input_buffer(eng);
+        caleng_store_input_buffer(eng);
     }
     else if (eng->sel_op == EVAL)
     {
@@ -611,8 +1110,434 @@ result_t caleng_select_bi_op(engine_t *eng, int op)
     return r;
 }
 
+result_t caleng_set_mode(engine_t *eng, int mode)
+{
+    assert(eng != NULL);
+    result_t r = {OK, ""};
+    if (eng->status != OK)
+    {
+        r.rtn_code = eng->status;
+        return r;
+    }
+
+    // exact value is kept if the memory was not modified in the meantime
+    if (mode == RATIONAL_MODE && eng->mode != RATIONAL_MODE && rational_get_ld(&eng->rmemory) != eng->memory)
+    {
+        rational_set_ld(&eng->rmemory, eng->memory);
+    }
+    if (mode == DECIMAL_MODE && eng->mode != DECIMAL_MODE && dec128_to_ld(eng->dmemory) != eng->memory)
+    {
+        eng->dmemory = dec128_from_ld(eng->memory);
+    }
+    if (mode == BIGFLOAT_MODE && eng->mode != BIGFLOAT_MODE && bigfloat_get_ld(&eng->fmemory) != eng->memory)
+    {
+        bigfloat_set_ld(&eng->fmemory, eng->memory);
+    }
+    eng->mode = mode;
+
+    if (eng->input_buffer[0] != '\0' || eng->sel_op == NONE)
+    {
+        strcpy(r.to_display, eng->input_buffer);
+        caleng_format_display_input(r.to_display);
+    }
+    else
+    {
+        caleng_get_memory_string(eng, r.to_display);
+    }
+    return r;
+}
+
+result_t caleng_set_precision(engine_t *eng, int digits)
+{
+    assert(eng != NULL);
+    result_t r = {OK, ""};
+    if (eng->status != OK)
+    {
+        r.rtn_code = eng->status;
+        return r;
+    }
+    eng->precision = (digits < 1) ? 1 : (digits > BIGFLOAT_MAX_DIGITS) ? BIGFLOAT_MAX_DIGITS : digits;
+    bigfloat_set_prec(&eng->fmemory, bigfloat_digits_to_prec(eng->precision));
+    bigfloat_set_prec(&eng->foperand, bigfloat_digits_to_prec(eng->precision));
+
+    if (eng->input_buffer[0] != '\0' || eng->sel_op == NONE)
+    {
+        strcpy(r.to_display, eng->input_buffer);
+        caleng_format_display_input(r.to_display);
+    }
+    else
+    {
+        caleng_get_memory_string(eng, r.to_display);
+    }
+    return r;
+}
+
+result_t caleng_poly_push(engine_t *eng)
+{
+    assert(eng != NULL);
+    result_t r = {OK, ""};
+    if (eng->status != OK)
+    {
+        r.rtn_code = eng->status;
+        return r;
+    }
+
+    r.rtn_code = caleng_take_operand(eng);
+    if (r.rtn_code == OK && eng->poly_count > POLY_MAX_DEGREE)
+    {
+        r.rtn_code = SYNTAX_ERR;
+    }
+    if (r.rtn_code != OK)
+    {
+        eng->status = r.rtn_code;
+        return r;
+    }
+    eng->poly_coef[eng->poly_count++] = eng->memory;
+    eng->root_count = 0;
+    eng->sel_op = EVAL;
+    caleng_get_memory_string(eng, r.to_display);
+    return r;
+}
+
+result_t caleng_poly_clear(engine_t *eng)
+{
+    assert(eng != NULL);
+    result_t r = {OK, ""};
+    if (eng->status != OK)
+    {
+        r.rtn_code = eng->status;
+        return r;
+    }
+    eng->poly_count = 0;
+    eng->root_count = 0;
+
+    if (eng->input_buffer[0] != '\0' || eng->sel_op == NONE)
+    {
+        strcpy(r.to_display, eng->input_buffer);
+        caleng_format_display_input(r.to_display);
+    }
+    else
+    {
+        caleng_get_memory_string(eng, r.to_display);
+    }
+    return r;
+}
+
+result_t caleng_poly_eval(engine_t *eng)
+{
+    assert(eng != NULL);
+    result_t r = {OK, ""};
+    if (eng->status != OK)
+    {
+        r.rtn_code = eng->status;
+        return r;
+    }
+
+    r.rtn_code = (eng->poly_count == 0) ? SYNTAX_ERR : caleng_take_operand(eng);
+    if (r.rtn_code == OK)
+    {
+        long double coef[POLY_MAX_DEGREE + 1];
+        int degree = caleng_poly_coefficients(eng, coef);
+        eng->memory = poly_eval(coef, degree, eng->memory);
+        r.rtn_code = caleng_check_overflow(eng);
+    }
+    if (r.rtn_code != OK)
+    {
+        eng->status = r.rtn_code;
+        return r;
+    }
+    caleng_sync_memory(eng);
+    caleng_get_memory_string(eng, r.to_display);
+    eng->sel_op = EVAL;
+    return r;
+}
+
+result_t caleng_poly_solve(engine_t *eng)
+{
+    assert(eng != NULL);
+    result_t r = {OK, ""};
+    if (eng->status != OK)
+    {
+        r.rtn_code = eng->status;
+        return r;
+    }
+    if (eng->poly_count == 0)
+    {
+        r.rtn_code = eng->status = SYNTAX_ERR;
+        return r;
+    }
+
+    long double coef[POLY_MAX_DEGREE + 1];
+    int degree = caleng_poly_coefficients(eng, coef);
+    int count = poly_roots(coef, degree, eng->root_re, eng->root_im);
+    if (count < 1)
+    {
+        r.rtn_code = eng->status = MATH_ERR;
+        return r;
+    }
+    eng->root_count = count;
+    return caleng_poly_root(eng, 0);
+}
+
+result_t caleng_poly_root(engine_t *eng, int index)
+{
+    assert(eng != NULL);
+    result_t r = {OK, ""};
+    if (eng->status != OK)
+    {
+        r.rtn_code = eng->status;
+        return r;
+    }
+    if (index < 0 || index >= eng->root_count)
+    {
+        r.rtn_code = eng->status = SYNTAX_ERR;
+        return r;
+    }
+
+    long double re = eng->root_re[index], im = eng->root_im[index];
+    if (im == 0.0L)
+    {
+        eng->memory = re;
+        if ((r.rtn_code = caleng_check_overflow(eng)) != OK)
+        {
+            eng->status = r.rtn_code;
+            return r;
+        }
+        eng->input_buffer[0] = '\0';
+        eng->const_operand = NO_CONSTANT;
+        eng->sel_op = EVAL;
+        caleng_sync_memory(eng);
+        caleng_get_memory_string(eng, r.to_display);
+    }
+    else if (re == 0.0L)
+    {
+        snprintf(r.to_display, BUFFER_SIZE + 1, "%.*Lgi", eng->mantissa_length_limit, im);
+    }
+    else
+    {
+        snprintf(r.to_display, BUFFER_SIZE + 1, "%.*Lg%+.*Lgi", eng->mantissa_length_limit, re,
+                 eng->mantissa_length_limit, im);
+    }
+    return r;
+}
+
+int caleng_poly_root_count(engine_t *eng)
+{
+    assert(eng != NULL);
+    return eng->root_count;
+}
+
+/**
+ * @brief Writes the dimensions of the current matrix, e.g. "[3x3]".
+ * @param eng Pointer to the engine.
+ * @param str Destination of at least BUFFER_SIZE + 1 characters.
+ */
+void caleng_matrix_string(engine_t *eng, char *str)
+{
+    snprintf(str, BUFFER_SIZE + 1, "[%zux%zu]", eng->matrix.rows, eng->matrix.cols);
+}
+
+result_t caleng_matrix_new(engine_t *eng, int rows, int cols)
+{
+    assert(eng != NULL);
+    result_t r = {OK, ""};
+    if (eng->status != OK)
+    {
+        r.rtn_code = eng->status;
+        return r;
+    }
+    if (rows < 1 || cols < 1 || rows > MATRIX_MAX_SIZE || cols > MATRIX_MAX_SIZE)
+    {
+        r.rtn_code = eng->status = SYNTAX_ERR;
+        return r;
+    }
+
+    matrix_t tmp = eng->matrix_prev;
+    eng->matrix_prev = eng->matrix;
+    eng->matrix = tmp;
+    matrix_resize(&eng->matrix, rows, cols);
+    eng->matrix_fill = 0;
+    caleng_matrix_string(eng, r.to_display);
+    return r;
+}
+
+result_t caleng_matrix_load(engine_t *eng, int rows, int cols, const double *data)
+{
+    assert(eng != NULL);
+    result_t r = caleng_matrix_new(eng, rows, cols);
+    if (r.rtn_code == OK)
+    {
+        memcpy(eng->matrix.data, data, (size_t)rows * cols * sizeof(double));
+        eng->matrix_fill = (size_t)rows * cols;
+    }
+    return r;
+}
+
+result_t caleng_matrix_push(engine_t *eng)
+{
+    assert(eng != NULL);
+    result_t r = {OK, ""};
+    if (eng->status != OK)
+    {
+        r.rtn_code = eng->status;
+        return r;
+    }
+
+    r.rtn_code = caleng_take_operand(eng);
+    if (r.rtn_code == OK && eng->matrix_fill >= eng->matrix.rows * eng->matrix.cols)
+    {
+        r.rtn_code = SYNTAX_ERR;
+    }
+    if (r.rtn_code != OK)
+    {
+        eng->status = r.rtn_code;
+        return r;
+    }
+    eng->matrix.data[eng->matrix_fill++] = (double)eng->memory;
+    eng->sel_op = EVAL;
+    caleng_get_memory_string(eng, r.to_display);
+    return r;
+}
+
+result_t caleng_matrix_eval(engine_t *eng, int op)
+{
+    assert(eng != NULL);
+    result_t r = {OK, ""};
+    if (eng->status != OK)
+    {
+        r.rtn_code = eng->status;
+        return r;
+    }
+
+    const matrix_t *a = &eng->matrix_prev, *b = &eng->matrix;
+    switch (op)
+    {
+    case MATRIX_DET:
+        if (b->rows != b->cols || b->rows == 0)
+        {
+            r.rtn_code = SYNTAX_ERR;
+            break;
+        }
+        eng->memory = matrix_det(b);
+        if ((r.rtn_code = caleng_check_overflow(eng)) == OK)
+        {
+            caleng_sync_memory(eng);
+            caleng_get_memory_string(eng, r.to_display);
+            eng->sel_op = EVAL;
+        }
+        break;
+    case MATRIX_INVERSE:
+        if (b->rows != b->cols || b->rows == 0)
+        {
+            r.rtn_code = SYNTAX_ERR;
+        }
+        else if (!matrix_inverse(&eng->matrix, b))
+        {
+            r.rtn_code = MATH_ERR;
+        }
+        break;
+    case MATRIX_MUL:
+        if (a->rows == 0 || !matrix_mul(&eng->matrix, a, b))
+        {
+            r.rtn_code = SYNTAX_ERR;
+        }
+        break;
+    case MATRIX_SOLVE:
+        if (a->rows != a->cols || a->rows != b->rows || a->rows == 0)
+        {
+            r.rtn_code = SYNTAX_ERR;
+        }
+        else if (!matrix_solve(&eng->matrix, a, b))
+        {
+            r.rtn_code = MATH_ERR;
+        }
+        break;
+    default:
+        fprintf(stderr, "WARNING: caleng_matrix_eval - invalid identifier\n");
+        break;
+    }
+
+    if (r.rtn_code != OK)
+    {
+        eng->status = r.rtn_code;
+    }
+    else if (op != MATRIX_DET)
+    {
+        eng->matrix_fill = eng->matrix.rows * eng->matrix.cols;
+        caleng_matrix_string(eng, r.to_display);
+    }
+    return r;
+}
+
+result_t caleng_matrix_get(engine_t *eng, int row, int col)
+{
+    assert(eng != NULL);
+    result_t r = {OK, ""};
+    if (eng->status != OK)
+    {
+        r.rtn_code = eng->status;
+        return r;
+    }
+    if (row < 0 || col < 0 || (size_t)row >= eng->matrix.rows || (size_t)col >= eng->matrix.cols)
+    {
+        r.rtn_code = eng->status = SYNTAX_ERR;
+        return r;
+    }
+
+    eng->memory = eng->matrix.data[(size_t)row * eng->matrix.cols + col];
+    if ((r.rtn_code = caleng_check_overflow(eng)) != OK)
+    {
+        eng->status = r.rtn_code;
+        return r;
+    }
+    eng->input_buffer[0] = '\0';
+    eng->const_operand = NO_CONSTANT;
+    eng->sel_op = EVAL;
+    caleng_sync_memory(eng);
+    caleng_get_memory_string(eng, r.to_display);
+    return r;
+}
+
+const matrix_t *caleng_get_matrix(engine_t *eng)
+{
+    assert(eng != NULL);
+    return &eng->matrix;
+}
+
+size_t caleng_get_memory_digits(engine_t *eng, char *str, size_t size)
+{
+    if (eng->mode == BIGFLOAT_MODE)
+    {
+        return bigfloat_get_string(&eng->fmemory, str, size, eng->precision, eng->dp_sep);
+    }
+    char str_mem[BUFFER_SIZE + 1];
+    caleng_get_memory_string(eng, str_mem);
+    size_t len = strlen(str_mem);
+    if (str != NULL && len < size)
+    {
+        strcpy(str, str_mem);
+    }
+    return len;
+}
+
 void caleng_get_memory_string(engine_t *eng, char *str_mem)
 {
+    if (eng->mode == RATIONAL_MODE &&
+        rational_get_string(&eng->rmemory, str_mem, RATIONAL_DISPLAY_LENGTH_LIMIT + 1) <= RATIONAL_DISPLAY_LENGTH_LIMIT)
+    {
+        return;
+    }
+    if (eng->mode == DECIMAL_MODE)
+    {
+        dec128_to_string(eng->dmemory, str_mem, eng->dp_sep);
+        return;
+    }
+    if (eng->mode == BIGFLOAT_MODE)
+    {
+        int digits = (eng->precision < BIGFLOAT_DISPLAY_DIGITS) ? eng->precision : BIGFLOAT_DISPLAY_DIGITS;
+        bigfloat_get_string(&eng->fmemory, str_mem, BUFFER_SIZE + 1, digits, eng->dp_sep);
+        return;
+    }
     double num = eng->memory;
     sprintf(str_mem, "%g", num);
 }
\ No newline at end of file
@@ -15,6 +15,13 @@
  * should show its own error message based on the return code.
  */
 
+#include "bigfloat.h"
+#include "constants.h"
+#include "decimal.h"
+#include "matrix.h"
+#include "polynomial.h"
+#include "rational.h"
+
 #define CANCEL_CHAR 'C'
 #define BACKSPACE_CHAR 'B'
 #define POWER_TO_CHAR '^'
@@ -25,6 +32,13 @@
 #define BUFFER_SIZE 100 // LENGTH of a regular buffer for number input
 #define DEFAULT_MANTISSA_LENGTH_LIMIT 9
 #define DEFAULT_EXPONENT_LENGTH_LIMIT 2
+#define RATIONAL_DISPLAY_LENGTH_LIMIT 25 // longer fractions are displayed in decimal notation
+#define BIGFLOAT_DEFAULT_DIGITS 50 // default precision of BIGFLOAT_MODE in decimal digits
+#define BIGFLOAT_MAX_DIGITS 100000 // highest selectable precision of BIGFLOAT_MODE
+#define BIGFLOAT_DISPLAY_DIGITS 80 // longest mantissa that is displayed in BIGFLOAT_MODE
+#define NO_CONSTANT -1 // value of const_operand when the input buffer holds a typed number
+#define POLY_MAX_DEGREE 32 // highest degree of a polynomial entered in the engine
+#define MATRIX_MAX_SIZE 4096 // highest number of rows or columns of a matrix in the engine
 
 /**
  * @brief Identifiers for binary operations
@@ -39,14 +53,55 @@ enum binary_ops
     DIV,
     POW,
     ROOT,
-    COMBINATIONAL
+    COMBINATIONAL,
+    GCD,
+    LCM,
+    FIBONACCI_MOD,
+    LUCAS_MOD
 };
 /**
  * @brief Identifiers for unary operations
  */
 enum unary_ops
 {
-    FACT
+    FACT,
+    FACTORIZATION,
+    FIBONACCI,
+    LUCAS
+};
+/**
+ * @brief Number representations used by the engine
+ * @details
+ * REAL_MODE - long double arithmetic
+ * RATIONAL_MODE - exact fractions for ADD, SUB, MUL, DIV and POW with an integer exponent,
+ * other operations are evaluated in long double and their result is converted to a fraction
+ * DECIMAL_MODE - decimal128 arithmetic (34 significant digits, decimal fractions are exact) for
+ * ADD, SUB, MUL and DIV, other operations are evaluated in long double
+ * BIGFLOAT_MODE - binary floating-point with a selectable precision for ADD, SUB, MUL, DIV and ROOT
+ * with an integer degree, other operations are evaluated in long double
+ */
+enum number_modes
+{
+    REAL_MODE,
+    RATIONAL_MODE,
+    DECIMAL_MODE,
+    BIGFLOAT_MODE
+};
+/**
+ * @brief Identifiers for matrix operations
+ * @details
+ * MATRIX_DET - determinant of the current matrix, stored in memory
+ * MATRIX_INVERSE - the current matrix is replaced by its inverse
+ * MATRIX_MUL - the current matrix is replaced by the product of the previous and the current one
+ * MATRIX_SOLVE - the current matrix B is replaced by the solution X of A * X = B, where A is the
+ * previous matrix
+ */
+enum matrix_ops
+{
+    MATRIX_DET,
+    MATRIX_INVERSE,
+    MATRIX_MUL,
+    MATRIX_SOLVE
 };
 /**
  * @brief Possible outcomes of all public methods of the engine
@@ -68,6 +123,23 @@ enum result_rtn_types
  *  @param exponent_length_limit maximum displayed length of exponent
  *  @param status return code of the last operation
  *  @param dp_sep decimal point character (based on user's current localisation settings)
+ *  @param mode number representation, possible values from number_modes
+ *  @param rmemory exact value of memory in RATIONAL_MODE (memory holds its approximation)
+ *  @param roperand exact value of the last processed operand in RATIONAL_MODE
+ *  @param dmemory value of memory in DECIMAL_MODE
+ *  @param doperand value of the last processed operand in DECIMAL_MODE
+ *  @param fmemory value of memory in BIGFLOAT_MODE
+ *  @param foperand value of the last processed operand in BIGFLOAT_MODE
+ *  @param precision precision of BIGFLOAT_MODE in decimal digits
+ *  @param const_operand constant shown in the input buffer (from math_constants) or NO_CONSTANT
+ *  @param poly_coef entered coefficients of the polynomial, the highest power first
+ *  @param poly_count number of entered coefficients
+ *  @param root_re real parts of the roots of the polynomial
+ *  @param root_im imaginary parts of the roots of the polynomial
+ *  @param root_count number of roots, 0 if the polynomial was not solved yet
+ *  @param matrix current matrix value
+ *  @param matrix_prev previous matrix value, the first operand of binary matrix operations
+ *  @param matrix_fill number of elements of the current matrix entered by caleng_matrix_push
  */
 struct cal_engine
 {
@@ -78,6 +150,23 @@ struct cal_engine
     int exponent_length_limit;
     int status;
     char dp_sep;
+    int mode;
+    rational_t rmemory;
+    rational_t roperand;
+    decimal128_t dmemory;
+    decimal128_t doperand;
+    bigfloat_t fmemory;
+    bigfloat_t foperand;
+    int precision;
+    int const_operand;
+    long double poly_coef[POLY_MAX_DEGREE + 1];
+    int poly_count;
+    long double root_re[POLY_MAX_DEGREE];
+    long double root_im[POLY_MAX_DEGREE];
+    int root_count;
+    matrix_t matrix;
+    matrix_t matrix_prev;
+    size_t matrix_fill;
 };
 
 /**
@@ -167,6 +256,19 @@ result_t caleng_insert_decimal_point(engine_t *eng);
  */
 result_t caleng_negate(engine_t *eng);
 
+/**
+ * @brief Inserts a mathematical constant in the input buffer.
+ * @details
+ * The buffer is replaced by the constant rounded to mantissa_length_limit digits, but the operand
+ * gets its value to the full precision of the current mode. Typing a digit or decimal point starts
+ * a new number, backspace or 'e' turn the shown digits into an ordinary typed number.
+ * Last processed value is thrown away when user inputs something into the input buffer.
+ * @param eng Pointer to the engine.
+ * @param constant Identifier of the constant (from enum math_constants).
+ * @return struct action_result
+ */
+result_t caleng_insert_constant(engine_t *eng, int constant);
+
 /**
  * @brief Evaluates the current given expression (based on eng->sel_op).
  * @details
@@ -186,6 +288,7 @@ result_t caleng_evaluate(engine_t *eng);
  * If an binary operator is already selected, the previous expresion will be evaluated first.
  * Otherwise the value in the input buffer will be used.
  * If the operation is succesful, sel_op is set to EVAL.
+ * FACTORIZATION leaves the value in memory unchanged and displays its prime factors instead, e.g. "2^3*3*5".
  * @param eng Pointer to the engine.
  * @param op Identifier of the operation (from enum unary_ops).
  * @return struct action_result
@@ -204,8 +307,151 @@ result_t caleng_eval_un_op(engine_t *eng, int op);
  */
 result_t caleng_select_bi_op(engine_t *eng, int op);
 
+/**
+ * @brief Switches the number representation used by the engine.
+ * @details The value in memory is converted to the new representation. Switching to REAL_MODE
+ * keeps the long double approximation of the value. Switching back to RATIONAL_MODE or DECIMAL_MODE
+ * restores the exact value if the memory was not changed in the meantime.
+ * @param eng Pointer to the engine.
+ * @param mode Identifier of the mode (from enum number_modes).
+ * @return struct action_result
+ */
+result_t caleng_set_mode(engine_t *eng, int mode);
+
+/**
+ * @brief Sets the precision of BIGFLOAT_MODE.
+ * @details The value in memory is rounded to the new precision, its digits beyond the old precision
+ * are not recovered by increasing it.
+ * @param eng Pointer to the engine.
+ * @param digits Number of significant decimal digits, clamped to 1 .. BIGFLOAT_MAX_DIGITS.
+ * @return struct action_result
+ */
+result_t caleng_set_precision(engine_t *eng, int digits);
+
+/**
+ * @brief Appends a coefficient to the polynomial, coefficients are entered from the highest power.
+ * @details
+ * The operand is taken like in caleng_eval_un_op and stays in memory, sel_op is set to EVAL.
+ * The polynomial is kept in long double in every mode. Previously found roots are forgotten.
+ * SYNTAX_ERR is returned if the polynomial already has POLY_MAX_DEGREE + 1 coefficients.
+ * @param eng Pointer to the engine.
+ * @return struct action_result
+ */
+result_t caleng_poly_push(engine_t *eng);
+
+/**
+ * @brief Removes all coefficients and roots of the polynomial.
+ * @param eng Pointer to the engine.
+ * @return struct action_result
+ */
+result_t caleng_poly_clear(engine_t *eng);
+
+/**
+ * @brief Evaluates the polynomial at the operand (taken like in caleng_eval_un_op).
+ * @details The value is stored in memory and sel_op is set to EVAL. SYNTAX_ERR is returned if no
+ * coefficient was entered.
+ * @param eng Pointer to the engine.
+ * @return struct action_result
+ */
+result_t caleng_poly_eval(engine_t *eng);
+
+/**
+ * @brief Finds all roots of the polynomial and displays the first one (see caleng_poly_root).
+ * @details MATH_ERR is returned if the polynomial is constant, SYNTAX_ERR if no coefficient was entered.
+ * @param eng Pointer to the engine.
+ * @return struct action_result
+ */
+result_t caleng_poly_solve(engine_t *eng);
+
+/**
+ * @brief Displays a root of the solved polynomial.
+ * @details Roots are sorted by the real parts and then by the imaginary parts. A real root is stored
+ * in memory (sel_op is set to EVAL), so the calculation can continue with it. A complex root is only
+ * displayed, e.g. "-0.5+0.866025404i".
+ * @param eng Pointer to the engine.
+ * @param index Index of the root from 0 to caleng_poly_root_count() - 1, SYNTAX_ERR otherwise.
+ * @return struct action_result
+ */
+result_t caleng_poly_root(engine_t *eng, int index);
+
+/**
+ * @brief Number of roots found by the last caleng_poly_solve, 0 if the polynomial was changed since.
+ * @param eng Pointer to the engine.
+ */
+int caleng_poly_root_count(engine_t *eng);
+
+/**
+ * @brief Starts a new zero matrix, the current matrix becomes the previous one.
+ * @details Elements are then entered by rows with caleng_matrix_push. The display shows the
+ * dimensions, e.g. "[3x3]".
+ * @param eng Pointer to the engine.
+ * @param rows Number of rows from 1 to MATRIX_MAX_SIZE, SYNTAX_ERR otherwise.
+ * @param cols Number of columns from 1 to MATRIX_MAX_SIZE, SYNTAX_ERR otherwise.
+ * @return struct action_result
+ */
+result_t caleng_matrix_new(engine_t *eng, int rows, int cols);
+
+/**
+ * @brief Like caleng_matrix_new, but all elements are copied from data.
+ * @param eng Pointer to the engine.
+ * @param rows Number of rows from 1 to MATRIX_MAX_SIZE, SYNTAX_ERR otherwise.
+ * @param cols Number of columns from 1 to MATRIX_MAX_SIZE, SYNTAX_ERR otherwise.
+ * @param data Elements by rows.
+ * @return struct action_result
+ */
+result_t caleng_matrix_load(engine_t *eng, int rows, int cols, const double *data);
+
+/**
+ * @brief Sets the next element of the current matrix (by rows).
+ * @details The operand is taken like in caleng_eval_un_op and stays in memory, sel_op is set to EVAL.
+ * SYNTAX_ERR is returned if all elements were already entered.
+ * @param eng Pointer to the engine.
+ * @return struct action_result
+ */
+result_t caleng_matrix_push(engine_t *eng);
+
+/**
+ * @brief Performs a matrix operation (from enum matrix_ops).
+ * @details MATH_ERR is returned for a singular matrix, SYNTAX_ERR for dimensions that do not fit the
+ * operation. The determinant is displayed and stored in memory, other operations display the dimensions
+ * of the resulting current matrix.
+ * @param eng Pointer to the engine.
+ * @param op Identifier of the operation.
+ * @return struct action_result
+ */
+result_t caleng_matrix_eval(engine_t *eng, int op);
+
+/**
+ * @brief Displays an element of the current matrix and stores it in memory (sel_op is set to EVAL).
+ * @param eng Pointer to the engine.
+ * @param row Row from 0, SYNTAX_ERR if it is out of range.
+ * @param col Column from 0, SYNTAX_ERR if it is out of range.
+ * @return struct action_result
+ */
+result_t caleng_matrix_get(engine_t *eng, int row, int col);
+
+/**
+ * @brief Returns the current matrix, e.g. to export all its elements.
+ * @param eng Pointer to the engine.
+ */
+const matrix_t *caleng_get_matrix(engine_t *eng);
+
+/**
+ * @brief Writes the value in engine's memory with all its digits.
+ * @details In BIGFLOAT_MODE all eng->precision digits are written (the display shows at most
+ * BIGFLOAT_DISPLAY_DIGITS of them), in the other modes the result equals caleng_get_memory_string.
+ * @param eng Pointer to the engine.
+ * @param str Destination, NULL to only compute the length.
+ * @param size Size of str.
+ * @return Length of the string, the string is written only if it is lower than size.
+ */
+size_t caleng_get_memory_digits(engine_t *eng, char *str, size_t size);
+
 /**
  * @brief Writes the value in engine's memory as a string to str_mem.
+ * @details In RATIONAL_MODE the reduced fraction is written if it is not longer than RATIONAL_DISPLAY_LENGTH_LIMIT.
+ * In DECIMAL_MODE all significant digits of the decimal128 value are written.
+ * In BIGFLOAT_MODE at most BIGFLOAT_DISPLAY_DIGITS significant digits are written.
  * @param eng Pointer to the engine.
  * @param str_mem Position where the memory value should be written.
  */
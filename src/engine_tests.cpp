@@ -186,4 +186,287 @@ TEST_F(EngineTest, caleng_select_bi_op)
     EXPECT_STREQ("-55", caleng_select_bi_op(eng, DIV).to_display);
     EXPECT_STREQ("0", caleng_insert_digit(eng, '0').to_display);
     EXPECT_EQ(MATH_ERR, caleng_select_bi_op(eng, SUB).rtn_code);
-}
\ No newline at end of file
+}
+TEST_F(EngineTest, caleng_factorization)
+{
+    caleng_insert_digit(eng, '3');
+    caleng_insert_digit(eng, '6');
+    caleng_insert_digit(eng, '0');
+    EXPECT_STREQ("2^3*3^2*5", caleng_eval_un_op(eng, FACTORIZATION).to_display);
+    EXPECT_EQ(eng->memory, 360.0);
+    EXPECT_STREQ("360", caleng_select_bi_op(eng, ADD).to_display);
+    EXPECT_STREQ("720", caleng_evaluate(eng).to_display);
+    caleng_cancel(eng);
+    caleng_insert_digit(eng, '9');
+    caleng_insert_digit(eng, '7');
+    EXPECT_STREQ("97", caleng_eval_un_op(eng, FACTORIZATION).to_display);
+    caleng_cancel(eng);
+    caleng_insert_digit(eng, '1');
+    caleng_insert_decimal_point(eng);
+    caleng_insert_digit(eng, '5');
+    EXPECT_EQ(MATH_ERR, caleng_eval_un_op(eng, FACTORIZATION).rtn_code);
+}
+
+TEST_F(EngineTest, caleng_gcd_lcm)
+{
+    caleng_insert_digit(eng, '8');
+    caleng_insert_digit(eng, '4');
+    caleng_select_bi_op(eng, GCD);
+    caleng_insert_digit(eng, '3');
+    caleng_insert_digit(eng, '6');
+    EXPECT_STREQ("12", caleng_evaluate(eng).to_display);
+    caleng_select_bi_op(eng, LCM);
+    caleng_insert_digit(eng, '1');
+    caleng_insert_digit(eng, '0');
+    EXPECT_STREQ("60", caleng_evaluate(eng).to_display);
+    caleng_select_bi_op(eng, GCD);
+    caleng_insert_digit(eng, '2');
+    caleng_insert_decimal_point(eng);
+    caleng_insert_digit(eng, '5');
+    EXPECT_EQ(MATH_ERR, caleng_evaluate(eng).rtn_code);
+}
+
+TEST_F(EngineTest, caleng_fibonacci)
+{
+    caleng_insert_digit(eng, '1');
+    caleng_insert_digit(eng, '0');
+    EXPECT_STREQ("55", caleng_eval_un_op(eng, FIBONACCI).to_display);
+    caleng_cancel(eng);
+    caleng_insert_digit(eng, '1');
+    caleng_insert_digit(eng, '0');
+    EXPECT_STREQ("123", caleng_eval_un_op(eng, LUCAS).to_display);
+    caleng_cancel(eng);
+    caleng_insert_digit(eng, '5');
+    caleng_insert_digit(eng, '0');
+    caleng_insert_digit(eng, '0');
+    EXPECT_EQ(OVERFLOW_ERR, caleng_eval_un_op(eng, FIBONACCI).rtn_code);
+    caleng_cancel(eng);
+
+    // F(10^6) mod 1000
+    caleng_insert_digit(eng, '1');
+    caleng_insert_exp(eng);
+    caleng_insert_digit(eng, '6');
+    caleng_select_bi_op(eng, FIBONACCI_MOD);
+    caleng_insert_digit(eng, '1');
+    caleng_insert_digit(eng, '0');
+    caleng_insert_digit(eng, '0');
+    caleng_insert_digit(eng, '0');
+    EXPECT_STREQ("875", caleng_evaluate(eng).to_display);
+}
+
+TEST_F(EngineTest, caleng_rational_mode)
+{
+    EXPECT_STREQ("0", caleng_set_mode(eng, RATIONAL_MODE).to_display);
+    // 1 / 3 * 3 =
+    caleng_insert_digit(eng, '1');
+    caleng_select_bi_op(eng, DIV);
+    caleng_insert_digit(eng, '3');
+    EXPECT_STREQ("1/3", caleng_select_bi_op(eng, MUL).to_display);
+    caleng_insert_digit(eng, '3');
+    EXPECT_STREQ("1", caleng_evaluate(eng).to_display);
+    // 0.1 + 0.2 =
+    caleng_insert_decimal_point(eng);
+    caleng_insert_digit(eng, '1');
+    caleng_select_bi_op(eng, ADD);
+    caleng_insert_decimal_point(eng);
+    caleng_insert_digit(eng, '2');
+    EXPECT_STREQ("3/10", caleng_evaluate(eng).to_display);
+    // memory is used as the second operand
+    caleng_select_bi_op(eng, MUL);
+    EXPECT_STREQ("9/100", caleng_evaluate(eng).to_display);
+    caleng_select_bi_op(eng, POW);
+    caleng_insert_digit(eng, '3');
+    EXPECT_STREQ("729/1000000", caleng_evaluate(eng).to_display);
+    caleng_select_bi_op(eng, DIV);
+    caleng_insert_digit(eng, '8');
+    caleng_insert_digit(eng, '1');
+    EXPECT_STREQ("9/1000000", caleng_evaluate(eng).to_display);
+    EXPECT_STREQ("9e-06", caleng_set_mode(eng, REAL_MODE).to_display);
+    EXPECT_STREQ("9/1000000", caleng_set_mode(eng, RATIONAL_MODE).to_display);
+    // an operation without an exact implementation refreshes the exact memory: 8 R 3 + 1 =
+    caleng_cancel(eng);
+    caleng_insert_digit(eng, '8');
+    caleng_select_bi_op(eng, ROOT);
+    caleng_insert_digit(eng, '3');
+    EXPECT_STREQ("2", caleng_select_bi_op(eng, ADD).to_display);
+    caleng_insert_digit(eng, '1');
+    EXPECT_STREQ("3", caleng_evaluate(eng).to_display);
+    // long fractions are displayed in decimal notation: (1/3)^60
+    caleng_cancel(eng);
+    caleng_insert_digit(eng, '1');
+    caleng_select_bi_op(eng, DIV);
+    caleng_insert_digit(eng, '3');
+    caleng_select_bi_op(eng, POW);
+    caleng_insert_digit(eng, '6');
+    caleng_insert_digit(eng, '0');
+    EXPECT_STREQ("2.35898e-29", caleng_evaluate(eng).to_display);
+    caleng_cancel(eng);
+    caleng_insert_digit(eng, '1');
+    caleng_select_bi_op(eng, DIV);
+    caleng_insert_digit(eng, '0');
+    EXPECT_EQ(MATH_ERR, caleng_evaluate(eng).rtn_code);
+}
+
+TEST_F(EngineTest, caleng_decimal_mode)
+{
+    EXPECT_STREQ("0", caleng_set_mode(eng, DECIMAL_MODE).to_display);
+    // 0.1 + 0.2 - 0.3 =
+    caleng_insert_decimal_point(eng);
+    caleng_insert_digit(eng, '1');
+    caleng_select_bi_op(eng, ADD);
+    caleng_insert_decimal_point(eng);
+    caleng_insert_digit(eng, '2');
+    EXPECT_STREQ("0.3", caleng_select_bi_op(eng, SUB).to_display);
+    caleng_insert_decimal_point(eng);
+    caleng_insert_digit(eng, '3');
+    EXPECT_STREQ("0.0", caleng_evaluate(eng).to_display);
+    // 2 / 3 * 3 =
+    caleng_cancel(eng);
+    caleng_insert_digit(eng, '2');
+    caleng_select_bi_op(eng, DIV);
+    caleng_insert_digit(eng, '3');
+    EXPECT_STREQ("0.6666666666666666666666666666666667", caleng_select_bi_op(eng, MUL).to_display);
+    caleng_insert_digit(eng, '3');
+    EXPECT_STREQ("2.000000000000000000000000000000000", caleng_evaluate(eng).to_display);
+    EXPECT_STREQ("2", caleng_set_mode(eng, REAL_MODE).to_display);
+    EXPECT_STREQ("2.000000000000000000000000000000000", caleng_set_mode(eng, DECIMAL_MODE).to_display);
+    // operations without a decimal implementation go through long double
+    caleng_select_bi_op(eng, ROOT);
+    caleng_insert_digit(eng, '2');
+    EXPECT_STREQ("1.414213562373095049", caleng_evaluate(eng).to_display);
+    caleng_select_bi_op(eng, DIV);
+    caleng_insert_digit(eng, '0');
+    EXPECT_EQ(MATH_ERR, caleng_evaluate(eng).rtn_code);
+}
+
+TEST_F(EngineTest, caleng_bigfloat_mode)
+{
+    caleng_set_mode(eng, BIGFLOAT_MODE);
+    EXPECT_STREQ("0", caleng_set_precision(eng, 30).to_display);
+    // 2 R 2 / 7 =
+    caleng_insert_digit(eng, '2');
+    caleng_select_bi_op(eng, ROOT);
+    caleng_insert_digit(eng, '2');
+    EXPECT_STREQ("1.41421356237309504880168872421", caleng_select_bi_op(eng, DIV).to_display);
+    caleng_insert_digit(eng, '7');
+    EXPECT_STREQ("0.202030508910442149828812674887", caleng_evaluate(eng).to_display);
+    // full precision is available beyond the display
+    caleng_set_precision(eng, 100);
+    caleng_cancel(eng);
+    caleng_insert_digit(eng, '1');
+    caleng_select_bi_op(eng, DIV);
+    caleng_insert_digit(eng, '3');
+    EXPECT_EQ(82u, strlen(caleng_evaluate(eng).to_display));
+    char digits[200];
+    EXPECT_EQ(102u, caleng_get_memory_digits(eng, digits, sizeof(digits)));
+    EXPECT_EQ(102u, strspn(digits, "0.3"));
+    EXPECT_STREQ("0.333333", caleng_set_mode(eng, REAL_MODE).to_display);
+    caleng_select_bi_op(eng, ROOT);
+    caleng_insert_digit(eng, '0');
+    EXPECT_EQ(MATH_ERR, caleng_evaluate(eng).rtn_code);
+}
+
+TEST_F(EngineTest, caleng_constants)
+{
+    EXPECT_STREQ("3.14159265", caleng_insert_constant(eng, CONSTANT_PI).to_display);
+    caleng_select_bi_op(eng, MUL);
+    caleng_insert_digit(eng, '2');
+    EXPECT_STREQ("6.28319", caleng_evaluate(eng).to_display);
+    // the operand has full precision, only the shown digits are rounded
+    caleng_set_mode(eng, BIGFLOAT_MODE);
+    caleng_set_precision(eng, 60);
+    caleng_insert_constant(eng, CONSTANT_PI);
+    caleng_select_bi_op(eng, MUL);
+    caleng_insert_digit(eng, '2');
+    EXPECT_STREQ("6.28318530717958647692528676655900576839433879875021164194989",
+                 caleng_evaluate(eng).to_display);
+    caleng_insert_constant(eng, CONSTANT_E);
+    EXPECT_STREQ("-2.71828183", caleng_negate(eng).to_display);
+    EXPECT_STREQ("-2.71828182845904523536028747135266249775724709369995957496697",
+                 caleng_evaluate(eng).to_display);
+    // typing after a constant starts a new number, backspace keeps the shown digits
+    caleng_insert_constant(eng, CONSTANT_SQRT2);
+    EXPECT_STREQ("7", caleng_insert_digit(eng, '7').to_display);
+    caleng_insert_constant(eng, CONSTANT_LN2);
+    EXPECT_STREQ("0.69314718", caleng_backspace(eng).to_display);
+    EXPECT_STREQ("0.69314718", caleng_evaluate(eng).to_display);
+    caleng_set_mode(eng, DECIMAL_MODE);
+    caleng_insert_constant(eng, CONSTANT_PI);
+    caleng_select_bi_op(eng, ADD);
+    caleng_insert_digit(eng, '1');
+    EXPECT_STREQ("4.141592653589793238462643383279503", caleng_evaluate(eng).to_display);
+}
+
+TEST_F(EngineTest, caleng_polynomial)
+{
+    EXPECT_EQ(SYNTAX_ERR, caleng_poly_solve(eng).rtn_code);
+    caleng_cancel(eng);
+    // x^2 - 3x + 2
+    caleng_insert_digit(eng, '1');
+    caleng_poly_push(eng);
+    caleng_insert_digit(eng, '3');
+    caleng_negate(eng);
+    EXPECT_STREQ("-3", caleng_poly_push(eng).to_display);
+    caleng_insert_digit(eng, '2');
+    caleng_poly_push(eng);
+    caleng_insert_digit(eng, '5');
+    EXPECT_STREQ("12", caleng_poly_eval(eng).to_display);
+    EXPECT_STREQ("1", caleng_poly_solve(eng).to_display);
+    EXPECT_EQ(2, caleng_poly_root_count(eng));
+    EXPECT_STREQ("2", caleng_poly_root(eng, 1).to_display);
+    // the real root stays in memory
+    caleng_select_bi_op(eng, MUL);
+    caleng_insert_digit(eng, '3');
+    EXPECT_STREQ("6", caleng_evaluate(eng).to_display);
+
+    // x^2 + x + 1
+    caleng_poly_clear(eng);
+    EXPECT_EQ(0, caleng_poly_root_count(eng));
+    for (int i = 0; i < 3; i++)
+    {
+        caleng_insert_digit(eng, '1');
+        caleng_poly_push(eng);
+    }
+    EXPECT_STREQ("-0.5-0.866025404i", caleng_poly_solve(eng).to_display);
+    EXPECT_STREQ("-0.5+0.866025404i", caleng_poly_root(eng, 1).to_display);
+    EXPECT_EQ(SYNTAX_ERR, caleng_poly_root(eng, 2).rtn_code);
+
+    // a constant has no roots
+    caleng_cancel(eng);
+    caleng_insert_digit(eng, '4');
+    caleng_poly_push(eng);
+    EXPECT_EQ(MATH_ERR, caleng_poly_solve(eng).rtn_code);
+}
+
+TEST_F(EngineTest, caleng_matrix)
+{
+    // A = [2 1; 1 3], entered element by element
+    EXPECT_STREQ("[2x2]", caleng_matrix_new(eng, 2, 2).to_display);
+    const char digits[4] = {'2', '1', '1', '3'};
+    for (int i = 0; i < 4; i++)
+    {
+        caleng_insert_digit(eng, digits[i]);
+        caleng_matrix_push(eng);
+    }
+    EXPECT_STREQ("5", caleng_matrix_eval(eng, MATRIX_DET).to_display);
+    EXPECT_STREQ("[2x2]", caleng_matrix_eval(eng, MATRIX_INVERSE).to_display);
+    EXPECT_STREQ("0.6", caleng_matrix_get(eng, 0, 0).to_display);
+    EXPECT_STREQ("-0.2", caleng_matrix_get(eng, 1, 0).to_display);
+
+    // A * X = [3; 4] with the inverse as A
+    double rhs[2] = {3.0, 4.0};
+    EXPECT_STREQ("[2x1]", caleng_matrix_load(eng, 2, 1, rhs).to_display);
+    EXPECT_STREQ("[2x1]", caleng_matrix_eval(eng, MATRIX_SOLVE).to_display);
+    EXPECT_STREQ("10", caleng_matrix_get(eng, 0, 0).to_display);
+    EXPECT_STREQ("15", caleng_matrix_get(eng, 1, 0).to_display);
+    EXPECT_EQ(2u, caleng_get_matrix(eng)->rows);
+    EXPECT_EQ(SYNTAX_ERR, caleng_matrix_eval(eng, MATRIX_DET).rtn_code);
+
+    caleng_cancel(eng);
+    double singular[4] = {1.0, 2.0, 2.0, 4.0};
+    caleng_matrix_load(eng, 2, 2, singular);
+    EXPECT_STREQ("0", caleng_matrix_eval(eng, MATRIX_DET).to_display);
+    EXPECT_EQ(MATH_ERR, caleng_matrix_eval(eng, MATRIX_INVERSE).rtn_code);
+    caleng_cancel(eng);
+    EXPECT_EQ(SYNTAX_ERR, caleng_matrix_new(eng, 0, 3).rtn_code);
+}
@@ -0,0 +1,395 @@
+/**
+ * @file extsort.c
+ * @brief Exact quantiles of more numbers than fit into memory
+ * @date 18.10.2026
+ */
+
+#define _POSIX_C_SOURCE 200809L // mkstemp, fdopen, pread
+
+#include "extsort.h"
+#include "math_library.h"
+#include <errno.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/** @struct run_reader
+ *  @brief Position of the merge in one sorted run.
+ *  @param offset index in the file of the first value not read yet
+ *  @param left values of the run not read yet
+ *  @param values values read from the run
+ *  @param pos next value to merge
+ *  @param len number of the read values
+ */
+struct run_reader
+{
+    size_t offset;
+    size_t left;
+    double *values;
+    size_t pos;
+    size_t len;
+};
+
+/** @struct order_need
+ *  @brief Order statistic needed by a quantile.
+ *  @param rank rank of the number
+ *  @param slot index of the result, 2 * query for the lower number and 2 * query + 1 for the upper one
+ */
+struct order_need
+{
+    unsigned long long rank;
+    size_t slot;
+};
+
+/**
+ * @brief Creates a temporary file in $TMPDIR or /tmp, it is removed when it is closed.
+ * @return file or NULL with errno set
+ */
+static FILE *temporary_file(void)
+{
+    const char *dir = getenv("TMPDIR");
+    if (dir == NULL || dir[0] == '\0')
+    {
+        dir = "/tmp";
+    }
+    char *path = malloc(strlen(dir) + 32);
+    if (path == NULL)
+    {
+        fprintf(stderr, "extsort - memory allocation error\n");
+        abort();
+    }
+    sprintf(path, "%s/extsort-XXXXXX", dir);
+    int fd = mkstemp(path);
+    if (fd >= 0)
+    {
+        unlink(path);
+    }
+    free(path);
+    FILE *f = (fd >= 0) ? fdopen(fd, "w+b") : NULL;
+    if (f == NULL && fd >= 0)
+    {
+        close(fd);
+    }
+    return f;
+}
+
+/**
+ * @brief Sorts the values and appends them to the file as a new run.
+ * @details Only one thread writes a run at a time (extsort_t.spilling), it does not hold the lock.
+ * @return EXTSORT_OK or EXTSORT_IO_ERR
+ */
+static int extsort_spill(extsort_t *e, double *values, size_t len)
+{
+    if (e->file == NULL && (e->file = temporary_file()) == NULL)
+    {
+        return EXTSORT_IO_ERR;
+    }
+    if (e->runs == e->run_capacity)
+    {
+        size_t capacity = (e->run_capacity == 0) ? 16 : 2 * e->run_capacity;
+        size_t *run_length = realloc(e->run_length, capacity * sizeof(size_t));
+        if (run_length == NULL)
+        {
+            fprintf(stderr, "extsort - memory allocation error\n");
+            abort();
+        }
+        e->run_length = run_length;
+        e->run_capacity = capacity;
+    }
+    sort_array(values, len);
+    if (fwrite(values, sizeof(double), len, e->file) != len)
+    {
+        return EXTSORT_IO_ERR;
+    }
+    e->run_length[e->runs++] = len;
+    return EXTSORT_OK;
+}
+
+void extsort_init(extsort_t *e, size_t budget)
+{
+    budget = (budget < EXTSORT_MIN_BUDGET) ? EXTSORT_MIN_BUDGET : budget;
+    pthread_mutex_init(&e->lock, NULL);
+    pthread_cond_init(&e->spilled, NULL);
+    e->spilling = false;
+    e->capacity = budget / 3 / sizeof(double);
+    e->buffer = malloc(e->capacity * sizeof(double));
+    e->spare = malloc(e->capacity * sizeof(double));
+    if (e->buffer == NULL || e->spare == NULL)
+    {
+        fprintf(stderr, "extsort - memory allocation error\n");
+        abort();
+    }
+    e->filled = 0;
+    e->file = NULL;
+    e->runs = 0;
+    e->run_length = NULL;
+    e->run_capacity = 0;
+    e->count = 0;
+    e->status = EXTSORT_OK;
+}
+
+int extsort_add(extsort_t *e, const double *x, size_t n)
+{
+    pthread_mutex_lock(&e->lock);
+    for (size_t i = 0; i < n && e->status == EXTSORT_OK; i++)
+    {
+        if (isnan(x[i]))
+        {
+            continue;
+        }
+        // the other threads may fill the buffer again while a run is written without the lock
+        while (e->filled == e->capacity && e->status == EXTSORT_OK)
+        {
+            if (e->spilling)
+            {
+                pthread_cond_wait(&e->spilled, &e->lock); // the spare buffer is still being written
+                continue;
+            }
+            double *full = e->buffer;
+            e->buffer = e->spare;
+            e->filled = 0;
+            e->spilling = true;
+            pthread_mutex_unlock(&e->lock);
+            int status = extsort_spill(e, full, e->capacity);
+            pthread_mutex_lock(&e->lock);
+            e->spare = full;
+            e->spilling = false;
+            e->status = (e->status == EXTSORT_OK) ? status : e->status;
+            pthread_cond_broadcast(&e->spilled);
+        }
+        if (e->status != EXTSORT_OK)
+        {
+            break;
+        }
+        e->buffer[e->filled++] = x[i];
+        e->count++;
+    }
+    int status = e->status;
+    pthread_mutex_unlock(&e->lock);
+    return status;
+}
+
+unsigned long long extsort_count(const extsort_t *e)
+{
+    return e->count;
+}
+
+/**
+ * @brief Reads the next values of a run.
+ * @return false if the file cannot be read
+ */
+static bool run_refill(FILE *file, struct run_reader *r, size_t share)
+{
+    r->len = (r->left < share) ? r->left : share;
+    r->pos = 0;
+    size_t done = 0;
+    while (done < r->len * sizeof(double))
+    {
+        ssize_t got = pread(fileno(file), (char *)r->values + done, r->len * sizeof(double) - done,
+                            (off_t)(r->offset * sizeof(double) + done));
+        if (got <= 0)
+        {
+            errno = (got == 0) ? EIO : errno;
+            return false;
+        }
+        done += (size_t)got;
+    }
+    r->offset += r->len;
+    r->left -= r->len;
+    return true;
+}
+
+/**
+ * @brief Restores the heap of the runs ordered by their next values, the run at i may be out of place.
+ */
+static void run_sift_down(const struct run_reader *readers, size_t *heap, size_t size, size_t i)
+{
+    while (true)
+    {
+        size_t smallest = i, left = 2 * i + 1, right = 2 * i + 2;
+        if (left < size && readers[heap[left]].values[readers[heap[left]].pos] <
+                               readers[heap[smallest]].values[readers[heap[smallest]].pos])
+        {
+            smallest = left;
+        }
+        if (right < size && readers[heap[right]].values[readers[heap[right]].pos] <
+                                readers[heap[smallest]].values[readers[heap[smallest]].pos])
+        {
+            smallest = right;
+        }
+        if (smallest == i)
+        {
+            return;
+        }
+        size_t t = heap[i];
+        heap[i] = heap[smallest];
+        heap[smallest] = t;
+        i = smallest;
+    }
+}
+
+/**
+ * @brief Compares the needed order statistics by their ranks for qsort.
+ */
+static int need_cmp(const void *a, const void *b)
+{
+    unsigned long long x = ((const struct order_need *)a)->rank, y = ((const struct order_need *)b)->rank;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Merges the runs and stores the numbers at the needed ranks.
+ * @param needs needed ranks in increasing order
+ * @param values receives the numbers, indexed by the slots of the needs
+ * @return false if the file cannot be read
+ */
+static bool merge_runs(extsort_t *e, const struct order_need *needs, size_t count, double *values)
+{
+    // every run reads through its share of the buffer, or through EXTSORT_MIN_READ values of extra memory
+    size_t share = e->capacity / e->runs;
+    bool small = share < EXTSORT_MIN_READ;
+    share = small ? EXTSORT_MIN_READ : share;
+    double *extra = small ? malloc(e->runs * share * sizeof(double)) : NULL;
+    struct run_reader *readers = malloc(e->runs * sizeof(struct run_reader));
+    size_t *heap = malloc(e->runs * sizeof(size_t));
+    if (readers == NULL || heap == NULL || (small && extra == NULL))
+    {
+        fprintf(stderr, "extsort - memory allocation error\n");
+        abort();
+    }
+    bool ok = true;
+    size_t size = 0, offset = 0;
+    for (size_t i = 0; i < e->runs && ok; i++)
+    {
+        readers[i].offset = offset;
+        readers[i].left = e->run_length[i];
+        readers[i].values = (small ? extra : e->buffer) + i * share;
+        offset += e->run_length[i];
+        ok = run_refill(e->file, &readers[i], share);
+        heap[size++] = i;
+    }
+    for (size_t i = size / 2; ok && i-- > 0;)
+    {
+        run_sift_down(readers, heap, size, i);
+    }
+
+    unsigned long long rank = 0;
+    size_t next = 0;
+    while (ok && next < count && size > 0)
+    {
+        struct run_reader *r = &readers[heap[0]];
+        double v = r->values[r->pos++];
+        for (; next < count && needs[next].rank == rank; next++)
+        {
+            values[needs[next].slot] = v;
+        }
+        rank++;
+        if (r->pos == r->len)
+        {
+            if (r->left > 0)
+            {
+                ok = run_refill(e->file, r, share);
+            }
+            else
+            {
+                heap[0] = heap[--size];
+            }
+        }
+        run_sift_down(readers, heap, size, 0);
+    }
+    free(extra);
+    free(readers);
+    free(heap);
+    return ok;
+}
+
+int extsort_quantiles(extsort_t *e, const double *q, size_t count, double *result)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        result[i] = NAN;
+    }
+    unsigned long long m = e->count;
+    if (e->status != EXTSORT_OK || m == 0 || count == 0)
+    {
+        return e->status;
+    }
+
+    // the lower and upper order statistics of every valid quantile
+    struct order_need *needs = malloc(2 * count * sizeof(struct order_need));
+    double *values = malloc(2 * count * sizeof(double));
+    if (needs == NULL || values == NULL)
+    {
+        fprintf(stderr, "extsort - memory allocation error\n");
+        abort();
+    }
+    size_t used = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (q[i] >= 0.0 && q[i] <= 1.0)
+        {
+            unsigned long long r = (unsigned long long)(q[i] * (double)(m - 1));
+            struct order_need lo = {r, 2 * i}, hi = {(r + 1 < m) ? r + 1 : r, 2 * i + 1};
+            needs[used++] = lo;
+            needs[used++] = hi;
+        }
+    }
+    qsort(needs, used, sizeof(struct order_need), need_cmp);
+
+    if (e->file == NULL)
+    {
+        sort_array(e->buffer, e->filled);
+        for (size_t i = 0; i < used; i++)
+        {
+            values[needs[i].slot] = e->buffer[needs[i].rank];
+        }
+    }
+    else
+    {
+        if (e->filled > 0)
+        {
+            e->status = extsort_spill(e, e->buffer, e->filled);
+            e->filled = 0;
+        }
+        if (e->status == EXTSORT_OK && fflush(e->file) != 0)
+        {
+            e->status = EXTSORT_IO_ERR;
+        }
+        if (e->status == EXTSORT_OK && !merge_runs(e, needs, used, values))
+        {
+            e->status = EXTSORT_IO_ERR;
+        }
+    }
+
+    for (size_t i = 0; i < count && e->status == EXTSORT_OK; i++)
+    {
+        if (!(q[i] >= 0.0 && q[i] <= 1.0))
+        {
+            continue;
+        }
+        double lo = values[2 * i], hi = values[2 * i + 1];
+        double position = q[i] * (double)(m - 1);
+        double fraction = position - floor(position);
+        double d = hi - lo;
+        result[i] = (fraction == 0.0 || lo == hi) ? lo
+                    : isfinite(d)                 ? lo + fraction * d
+                                                  : (1.0 - fraction) * lo + fraction * hi;
+    }
+    free(needs);
+    free(values);
+    return e->status;
+}
+
+void extsort_free(extsort_t *e)
+{
+    if (e->file != NULL)
+    {
+        fclose(e->file);
+    }
+    free(e->buffer);
+    free(e->spare);
+    free(e->run_length);
+    pthread_cond_destroy(&e->spilled);
+    pthread_mutex_destroy(&e->lock);
+}
@@ -0,0 +1,108 @@
+/**
+ * @file extsort.h
+ * @brief Exact quantiles of more numbers than fit into memory
+ * @date 18.10.2026
+ *
+ * Numbers are collected in one of two buffers of a third of the memory budget. A full buffer is swapped
+ * for the other one, so the adding threads go on while it is sorted by sort_array (its scratch array takes
+ * the last third) and appended to a temporary file as a sorted run outside the lock. Quantiles are found
+ * by a k-way merge of the runs, every run is read through its share of the buffer. The
+ * temporary file is created in $TMPDIR (/tmp by default) and removed right away, so it disappears with
+ * the process.
+ */
+
+#ifndef EXTSORT_H
+#define EXTSORT_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#define EXTSORT_MIN_BUDGET (1 << 20) // smallest memory budget in bytes
+#define EXTSORT_MIN_READ 512         // fewest values read from a run at once
+
+/**
+ * @brief Results of the operations on the runs
+ */
+enum extsort_status
+{
+    EXTSORT_OK,
+    EXTSORT_IO_ERR // the temporary file cannot be created, written or read, errno is set
+};
+
+/** @struct extsort
+ *  @brief Numbers collected for exact quantiles.
+ *  @param lock guards the other members in extsort_add, except the runs written by the spilling thread
+ *  @param spilled signaled when a run has been written
+ *  @param spilling a full buffer is being written, the spare buffer is in use
+ *  @param buffer numbers of the current run
+ *  @param spare the other buffer
+ *  @param capacity size of each buffer
+ *  @param filled numbers in the buffer
+ *  @param file temporary file of the sorted runs, NULL before the first run is written
+ *  @param runs number of the runs in the file
+ *  @param run_length number of the numbers of every run
+ *  @param run_capacity size of run_length
+ *  @param count number of all numbers
+ *  @param status EXTSORT_OK or the first error
+ */
+struct extsort
+{
+    pthread_mutex_t lock;
+    pthread_cond_t spilled;
+    bool spilling;
+    double *buffer;
+    double *spare;
+    size_t capacity;
+    size_t filled;
+    FILE *file;
+    size_t runs;
+    size_t *run_length;
+    size_t run_capacity;
+    unsigned long long count;
+    int status;
+};
+
+typedef struct extsort extsort_t;
+
+/**
+ * @brief Initializes an empty collection.
+ * @param e
+ * @param budget memory for the buffer and the sorting in bytes, at least EXTSORT_MIN_BUDGET is used
+ */
+void extsort_init(extsort_t *e, size_t budget);
+
+/**
+ * @brief Adds numbers, nan values are ignored. Several threads may add at once, a full buffer is sorted
+ * and written by the thread that filled it while the others go on with the spare buffer.
+ * @param e
+ * @param x values
+ * @param n number of values
+ * @return EXTSORT_OK or EXTSORT_IO_ERR if a run cannot be written
+ */
+int extsort_add(extsort_t *e, const double *x, size_t n);
+
+/**
+ * @brief Number of the collected numbers.
+ */
+unsigned long long extsort_count(const extsort_t *e);
+
+/**
+ * @brief Exact quantiles, interpolated linearly between the order statistics like quantile_array.
+ * @details The numbers in the buffer are written as the last run first, unless there are no runs in the
+ * file yet. More numbers may be added afterwards.
+ * @param e
+ * @param q probabilities from [0, 1]
+ * @param count number of the probabilities
+ * @param result receives the quantiles, NAN if there are no numbers or q is outside [0, 1]
+ * @return EXTSORT_OK or EXTSORT_IO_ERR
+ */
+int extsort_quantiles(extsort_t *e, const double *q, size_t count, double *result);
+
+/**
+ * @brief Frees the buffer and closes the temporary file.
+ */
+void extsort_free(extsort_t *e);
+
+#endif
@@ -1,115 +1,3963 @@
-/**
- * @file math_library.c
- * @author František Holáň
- * @brief Math library implementation
- * @date 28.3.2023
- */
-
-#include "math_library.h"
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-
-long double add(long double x, long double y)
-{
-    long double result = x + y;
-
-    return result;
-}
-
-long double sub(long double x, long double y)
-{
-    long double result = x - y;
-
-    return result;
-}
-
-long double mul(long double x, long double y)
-{
-    long double result = x * y;
-
-    return result;
-}
-
-long double divide(long double x, long double y)
-{
-    long double result = x / y;
-
-    return result;
-}
-
-unsigned long long factorial(unsigned long x)
-{
-
-    unsigned long result = 1;
-
-    for (unsigned long i = 1; i <= x; i++)
-    {
-        result *= i;
-    }
-
-    return result;
-}
-
-long double power(long double x, unsigned long y)
-{
-    long double result = 1;
-    for (unsigned long i = 0; i < y; i++)
-    {
-        result = result * x;
-    }
-
-    return result;
-}
-
-long double root(long double x, unsigned long y)
-{
-    /*
-        Newton-rapshon's method
-        x(n+1) = x(n) - f(x)/f'(x)
-        Next value:
-        k(n+1) = 1/y*[(y-1)*k(n) + x/k(n)^(y-1)]
-    */
-    long double num = x / y; // initial value k
-    long double var = 1.0L;
-
-    if (x == 0)
-    {
-        return 0.0L;
-    }
-
-    while (var > 1e-8)
-    {
-        long double new_num = (((y - 1.0L) * num) + x / power(num, y - 1)) / y;
-        var = num - new_num;
-
-        if (var < 0.0)
-        {
-            var = var * (-1.0L);
-        }
-
-        num = new_num;
-    }
-
-    return num;
-}
-
-unsigned long comb(unsigned long x, unsigned long y)
-{
-    unsigned int comb_num[y + 1];
-
-    memset(comb_num, 0, sizeof(comb_num)); // initialization
-
-    comb_num[0] = 1;
-    for (unsigned long j = 1; j <= x; j++)
-    {
-        int min = (j < y) ? j : y;
-
-        // Calculation of another line of Pascal's triangle
-        for (int k = min; k > 0; k--)
-        {
-            comb_num[k] += comb_num[k - 1];
-        }
-    }
-    return comb_num[y];
-}
\ No newline at end of file
+/**
+ * @file math_library.c
+ * @author František Holáň
+ * @brief Math library implementation
+ * @date 28.3.2023
+ */
+
+#define _POSIX_C_SOURCE 200809L // sysconf
+
+#include "math_library.h"
+#include "bigint.h"
+#include <float.h>
+#include <limits.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+long double add(long double x, long double y)
+{
+    long double result = x + y;
+
+    return result;
+}
+
+long double sub(long double x, long double y)
+{
+    long double result = x - y;
+
+    return result;
+}
+
+long double mul(long double x, long double y)
+{
+    long double result = x * y;
+
+    return result;
+}
+
+long double divide(long double x, long double y)
+{
+    long double result = x / y;
+
+    return result;
+}
+
+unsigned long long factorial(unsigned long x)
+{
+
+    unsigned long result = 1;
+
+    for (unsigned long i = 1; i <= x; i++)
+    {
+        result *= i;
+    }
+
+    return result;
+}
+
+long double power(long double x, unsigned long y)
+{
+    long double result = 1;
+    for (unsigned long i = 0; i < y; i++)
+    {
+        result = result * x;
+    }
+
+    return result;
+}
+
+long double root(long double x, unsigned long y)
+{
+    /*
+        Newton-rapshon's method
+        x(n+1) = x(n) - f(x)/f'(x)
+        Next value:
+        k(n+1) = 1/y*[(y-1)*k(n) + x/k(n)^(y-1)]
+    */
+    long double num = x / y; // initial value k
+    long double var = 1.0L;
+
+    if (x == 0)
+    {
+        return 0.0L;
+    }
+
+    while (var > 1e-8)
+    {
+        long double new_num = (((y - 1.0L) * num) + x / power(num, y - 1)) / y;
+        var = num - new_num;
+
+        if (var < 0.0)
+        {
+            var = var * (-1.0L);
+        }
+
+        num = new_num;
+    }
+
+    return num;
+}
+
+unsigned long comb(unsigned long x, unsigned long y)
+{
+    unsigned int comb_num[y + 1];
+
+    memset(comb_num, 0, sizeof(comb_num)); // initialization
+
+    comb_num[0] = 1;
+    for (unsigned long j = 1; j <= x; j++)
+    {
+        int min = (j < y) ? j : y;
+
+        // Calculation of another line of Pascal's triangle
+        for (int k = min; k > 0; k--)
+        {
+            comb_num[k] += comb_num[k - 1];
+        }
+    }
+    return comb_num[y];
+}
+
+typedef unsigned __int128 uint128;
+
+/**
+ * @brief Context for Montgomery multiplication modulo an odd 64-bit number
+ * @param n modulus
+ * @param ninv inverse of n modulo 2^64
+ * @param r2 2^128 mod n, used for conversion into Montgomery form
+ */
+struct montgomery
+{
+    unsigned long long n;
+    unsigned long long ninv;
+    unsigned long long r2;
+};
+
+static void mont_init(struct montgomery *m, unsigned long long n)
+{
+    unsigned long long inv = n; // n*n = 1 (mod 8), correct to 3 bits
+    for (int i = 0; i < 5; i++)
+    {
+        inv *= 2 - n * inv; // Newton's iteration doubles the number of correct bits
+    }
+    m->n = n;
+    m->ninv = inv;
+    uint128 r = (((uint128)1) << 64) % n;
+    m->r2 = (r * r) % n;
+}
+
+/**
+ * @brief Montgomery reduction, returns t/2^64 mod n
+ * @details t has to be lower than n*2^64. The low halves of t and q*n are equal,
+ * so only the high halves are subtracted, which cannot overflow.
+ */
+static inline unsigned long long mont_reduce(const struct montgomery *m, uint128 t)
+{
+    unsigned long long q = (unsigned long long)t * m->ninv;
+    unsigned long long h = (unsigned long long)(((uint128)q * m->n) >> 64);
+    unsigned long long th = (unsigned long long)(t >> 64);
+    return (th >= h) ? th - h : th - h + m->n;
+}
+
+static inline unsigned long long mont_mul(const struct montgomery *m, unsigned long long a, unsigned long long b)
+{
+    return mont_reduce(m, (uint128)a * b);
+}
+
+static inline unsigned long long mont_from(const struct montgomery *m, unsigned long long a)
+{
+    return mont_mul(m, a % m->n, m->r2);
+}
+
+static inline unsigned long long mont_add(const struct montgomery *m, unsigned long long a, unsigned long long b)
+{
+    return (a >= m->n - b) ? a - (m->n - b) : a + b;
+}
+
+static unsigned long long mont_pow(const struct montgomery *m, unsigned long long base, unsigned long long e)
+{
+    unsigned long long result = mont_from(m, 1);
+    while (e > 0)
+    {
+        if (e & 1)
+        {
+            result = mont_mul(m, result, base);
+        }
+        base = mont_mul(m, base, base);
+        e >>= 1;
+    }
+    return result;
+}
+
+bool is_prime(unsigned long long x)
+{
+    static const unsigned long long small_primes[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+    // bases giving a deterministic test for all 64-bit integers (Jim Sinclair)
+    static const unsigned long long bases[] = {2, 325, 9375, 28178, 450775, 9780504, 1795265022};
+
+    if (x < 2)
+    {
+        return false;
+    }
+    for (unsigned i = 0; i < sizeof(small_primes) / sizeof(small_primes[0]); i++)
+    {
+        if (x == small_primes[i])
+        {
+            return true;
+        }
+        if (x % small_primes[i] == 0)
+        {
+            return false;
+        }
+    }
+    if (x < 37 * 37)
+    {
+        return true;
+    }
+
+    // x - 1 = d * 2^s
+    int s = __builtin_ctzll(x - 1);
+    unsigned long long d = (x - 1) >> s;
+
+    struct montgomery m;
+    mont_init(&m, x);
+    unsigned long long one = mont_from(&m, 1);
+    unsigned long long minus_one = x - one;
+
+    for (unsigned i = 0; i < sizeof(bases) / sizeof(bases[0]); i++)
+    {
+        unsigned long long a = bases[i] % x;
+        if (a == 0)
+        {
+            continue;
+        }
+        unsigned long long y = mont_pow(&m, mont_from(&m, a), d);
+        if (y == one || y == minus_one)
+        {
+            continue;
+        }
+        int r = 1;
+        for (; r < s; r++)
+        {
+            y = mont_mul(&m, y, y);
+            if (y == minus_one)
+            {
+                break;
+            }
+        }
+        if (r == s)
+        {
+            return false; // a is a witness of compositeness
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Finds a non-trivial divisor of an odd composite number (Pollard-Brent rho).
+ * @details
+ * Iterates f(y) = y^2 + c in Montgomery form and accumulates products of differences,
+ * so that gcd is computed only once per block of steps.
+ */
+static unsigned long long pollard_brent(unsigned long long n)
+{
+    const unsigned long long block = 128;
+    struct montgomery m;
+    mont_init(&m, n);
+
+    for (unsigned long long c0 = 1;; c0++)
+    {
+        unsigned long long c = mont_from(&m, c0);
+        unsigned long long y = mont_from(&m, 2);
+        unsigned long long x = y, ys = y;
+        unsigned long long q = mont_from(&m, 1);
+        unsigned long long g = 1;
+
+        for (unsigned long long r = 1; g == 1; r <<= 1)
+        {
+            x = y;
+            for (unsigned long long i = 0; i < r; i++)
+            {
+                y = mont_add(&m, mont_mul(&m, y, y), c);
+            }
+            for (unsigned long long k = 0; k < r && g == 1; k += block)
+            {
+                ys = y;
+                unsigned long long steps = (r - k < block) ? r - k : block;
+                for (unsigned long long i = 0; i < steps; i++)
+                {
+                    y = mont_add(&m, mont_mul(&m, y, y), c);
+                    q = mont_mul(&m, q, (x > y) ? x - y : y - x);
+                }
+                g = gcd(q, n);
+            }
+        }
+
+        if (g == n)
+        {
+            // the block overshot, repeat its steps one by one
+            do
+            {
+                ys = mont_add(&m, mont_mul(&m, ys, ys), c);
+                g = gcd((x > ys) ? x - ys : ys - x, n);
+            } while (g == 1);
+        }
+        if (g != n)
+        {
+            return g;
+        }
+    }
+}
+
+static void factorize_rec(unsigned long long x, unsigned long long *factors, int *count)
+{
+    if (x == 1)
+    {
+        return;
+    }
+    if (is_prime(x))
+    {
+        factors[(*count)++] = x;
+        return;
+    }
+    unsigned long long d = pollard_brent(x);
+    factorize_rec(d, factors, count);
+    factorize_rec(x / d, factors, count);
+}
+
+int factorize(unsigned long long x, unsigned long long *factors)
+{
+    int count = 0;
+    if (x < 2)
+    {
+        return 0;
+    }
+
+    int twos = __builtin_ctzll(x);
+    for (int i = 0; i < twos; i++)
+    {
+        factors[count++] = 2;
+    }
+    x >>= twos;
+
+    // trial division by small odd numbers is faster than rho for tiny factors
+    for (unsigned long long d = 3; d < 100 && d * d <= x; d += 2)
+    {
+        while (x % d == 0)
+        {
+            factors[count++] = d;
+            x /= d;
+        }
+    }
+
+    int first_big = count;
+    factorize_rec(x, factors, &count);
+
+    // factors found by rho are not ordered
+    for (int i = first_big + 1; i < count; i++)
+    {
+        unsigned long long key = factors[i];
+        int j = i - 1;
+        for (; j >= first_big && factors[j] > key; j--)
+        {
+            factors[j + 1] = factors[j];
+        }
+        factors[j + 1] = key;
+    }
+    return count;
+}
+
+unsigned long long gcd(unsigned long long x, unsigned long long y)
+{
+    if (x == 0 || y == 0)
+    {
+        return x | y;
+    }
+    int shift = __builtin_ctzll(x | y); // common power of two
+    x >>= __builtin_ctzll(x);
+    while (y != 0)
+    {
+        // x is odd, min and absolute difference compile to conditional moves
+        y >>= __builtin_ctzll(y);
+        unsigned long long min = (x < y) ? x : y;
+        y = (x < y) ? y - x : x - y;
+        x = min;
+    }
+    return x << shift;
+}
+
+static inline int ctz_u128(uint128 x)
+{
+    unsigned long long lo = (unsigned long long)x;
+    return (lo != 0) ? __builtin_ctzll(lo) : 64 + __builtin_ctzll((unsigned long long)(x >> 64));
+}
+
+uint128 gcd_u128(uint128 x, uint128 y)
+{
+    if (x == 0 || y == 0)
+    {
+        return x | y;
+    }
+    int shift = ctz_u128(x | y);
+    x >>= ctz_u128(x);
+    while (y != 0)
+    {
+        if ((x >> 64) == 0 && (y >> 64) == 0)
+        {
+            // both operands fit in 64 bits, finish with the cheaper version
+            return ((uint128)gcd((unsigned long long)x, (unsigned long long)y)) << shift;
+        }
+        y >>= ctz_u128(y);
+        uint128 min = (x < y) ? x : y;
+        y = (x < y) ? y - x : x - y;
+        x = min;
+    }
+    return x << shift;
+}
+
+unsigned long long lcm(unsigned long long x, unsigned long long y)
+{
+    if (x == 0 || y == 0)
+    {
+        return 0;
+    }
+    unsigned long long result;
+    if (__builtin_mul_overflow(x / gcd(x, y), y, &result))
+    {
+        return 0;
+    }
+    return result;
+}
+
+uint128 lcm_u128(uint128 x, uint128 y)
+{
+    if (x == 0 || y == 0)
+    {
+        return 0;
+    }
+    uint128 result;
+    if (__builtin_mul_overflow(x / gcd_u128(x, y), y, &result))
+    {
+        return 0;
+    }
+    return result;
+}
+
+unsigned long long gcd_array(const unsigned long long *arr, size_t n)
+{
+    unsigned long long result = 0;
+    for (size_t i = 0; i < n && result != 1; i++)
+    {
+        result = gcd(result, arr[i]);
+    }
+    return result;
+}
+
+unsigned long long lcm_array(const unsigned long long *arr, size_t n)
+{
+    unsigned long long result = 1;
+    for (size_t i = 0; i < n && result != 0; i++)
+    {
+        result = lcm(result, arr[i]);
+    }
+    return result;
+}
+
+void reduce_ratio(unsigned long long *arr, size_t n)
+{
+    unsigned long long divisor = gcd_array(arr, n);
+    if (divisor <= 1)
+    {
+        return;
+    }
+    for (size_t i = 0; i < n; i++)
+    {
+        arr[i] /= divisor;
+    }
+}
+
+void reduce_fractions(long long *num, long long *den, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        if (den[i] == 0)
+        {
+            continue;
+        }
+        // magnitudes as unsigned, so that LLONG_MIN does not overflow
+        unsigned long long a = (num[i] < 0) ? 0ull - (unsigned long long)num[i] : (unsigned long long)num[i];
+        unsigned long long b = (den[i] < 0) ? 0ull - (unsigned long long)den[i] : (unsigned long long)den[i];
+        unsigned long long g = gcd(a, b);
+        a /= g;
+        b /= g;
+        bool negative = (num[i] < 0) != (den[i] < 0);
+        if (b > LLONG_MAX || (a > LLONG_MAX && !negative))
+        {
+            continue; // 2^63 does not fit as a positive denominator or numerator
+        }
+        num[i] = !negative ? (long long)a : (a > LLONG_MAX) ? LLONG_MIN : -(long long)a;
+        den[i] = (long long)b;
+    }
+}
+
+/*
+    Fast doubling:
+    F(2k) = F(k) * (2F(k+1) - F(k))
+    F(2k+1) = F(k)^2 + F(k+1)^2
+    L(n) = 2F(n+1) - F(n)
+*/
+
+/**
+ * @brief Computes the pair F(n), F(n+1) in long double
+ */
+static void fibonacci_pair(unsigned long n, long double *fn, long double *fn1)
+{
+    long double a = 0.0L, b = 1.0L; // F(k), F(k+1)
+    for (int bit = 63 - __builtin_clzl(n | 1); bit >= 0; bit--)
+    {
+        long double c = a * (2.0L * b - a);
+        long double d = a * a + b * b;
+        if ((n >> bit) & 1)
+        {
+            a = d;
+            b = c + d;
+        }
+        else
+        {
+            a = c;
+            b = d;
+        }
+    }
+    *fn = a;
+    *fn1 = b;
+}
+
+/**
+ * @brief Computes the pair F(n), F(n+1) modulo 2^128
+ */
+static void fibonacci_pair_u128(unsigned long n, uint128 *fn, uint128 *fn1)
+{
+    uint128 a = 0, b = 1;
+    for (int bit = 63 - __builtin_clzl(n | 1); bit >= 0; bit--)
+    {
+        uint128 c = a * (2 * b - a);
+        uint128 d = a * a + b * b;
+        if ((n >> bit) & 1)
+        {
+            a = d;
+            b = c + d;
+        }
+        else
+        {
+            a = c;
+            b = d;
+        }
+    }
+    *fn = a;
+    *fn1 = b;
+}
+
+static inline unsigned long long mulmod(unsigned long long a, unsigned long long b, unsigned long long m)
+{
+    return (uint128)a * b % m;
+}
+
+static inline unsigned long long addmod(unsigned long long a, unsigned long long b, unsigned long long m)
+{
+    return (a >= m - b) ? a - (m - b) : a + b;
+}
+
+/**
+ * @brief Computes the pair F(n), F(n+1) modulo m
+ */
+static void fibonacci_pair_mod(unsigned long long n, unsigned long long m, unsigned long long *fn, unsigned long long *fn1)
+{
+    unsigned long long a = 0, b = 1 % m;
+    for (int bit = 63 - __builtin_clzll(n | 1); bit >= 0; bit--)
+    {
+        unsigned long long t = addmod(addmod(b, b, m), m - a, m); // 2F(k+1) - F(k)
+        unsigned long long c = mulmod(a, t, m);
+        unsigned long long d = addmod(mulmod(a, a, m), mulmod(b, b, m), m);
+        if ((n >> bit) & 1)
+        {
+            a = d;
+            b = addmod(c, d, m);
+        }
+        else
+        {
+            a = c;
+            b = d;
+        }
+    }
+    *fn = a;
+    *fn1 = b;
+}
+
+long double fibonacci(unsigned long n)
+{
+    long double fn, fn1;
+    fibonacci_pair(n, &fn, &fn1);
+    return fn;
+}
+
+long double lucas(unsigned long n)
+{
+    long double fn, fn1;
+    fibonacci_pair(n, &fn, &fn1);
+    return 2.0L * fn1 - fn;
+}
+
+bool fibonacci_exact(unsigned long n, unsigned __int128 *result)
+{
+    if (n > FIBONACCI_EXACT_MAX)
+    {
+        return false;
+    }
+    // arithmetic modulo 2^128 gives the exact value when the result fits
+    uint128 fn, fn1;
+    fibonacci_pair_u128(n, &fn, &fn1);
+    *result = fn;
+    return true;
+}
+
+bool lucas_exact(unsigned long n, unsigned __int128 *result)
+{
+    if (n > LUCAS_EXACT_MAX)
+    {
+        return false;
+    }
+    uint128 fn, fn1;
+    fibonacci_pair_u128(n, &fn, &fn1);
+    *result = 2 * fn1 - fn;
+    return true;
+}
+
+unsigned long long fibonacci_mod(unsigned long long n, unsigned long long m)
+{
+    unsigned long long fn, fn1;
+    fibonacci_pair_mod(n, m, &fn, &fn1);
+    return fn;
+}
+
+unsigned long long lucas_mod(unsigned long long n, unsigned long long m)
+{
+    unsigned long long fn, fn1;
+    fibonacci_pair_mod(n, m, &fn, &fn1);
+    return addmod(addmod(fn1, fn1, m), m - fn, m);
+}
+
+/**
+ * @brief Computes the pair F(n), F(n+1) exactly
+ */
+static void fibonacci_pair_big(unsigned long long n, bigint_t *fn, bigint_t *fn1)
+{
+    bigint_t c, d;
+    bigint_init(&c);
+    bigint_init(&d);
+    bigint_set_u64(fn, 0);
+    bigint_set_u64(fn1, 1);
+    for (int bit = 63 - __builtin_clzll(n | 1); bit >= 0; bit--)
+    {
+        // c = F(2k) = F(k) * (2F(k+1) - F(k)), d = F(2k+1) = F(k)^2 + F(k+1)^2
+        bigint_add(&c, fn1, fn1);
+        bigint_sub(&c, &c, fn);
+        bigint_mul(&c, &c, fn);
+        bigint_mul(&d, fn, fn);
+        bigint_mul(fn1, fn1, fn1);
+        bigint_add(&d, &d, fn1);
+        if ((n >> bit) & 1)
+        {
+            bigint_add(fn1, &c, &d);
+            bigint_swap(fn, &d);
+        }
+        else
+        {
+            bigint_swap(fn, &c);
+            bigint_swap(fn1, &d);
+        }
+    }
+    bigint_free(&c);
+    bigint_free(&d);
+}
+
+void fibonacci_big(unsigned long long n, bigint_t *result)
+{
+    bigint_t fn1;
+    bigint_init(&fn1);
+    fibonacci_pair_big(n, result, &fn1);
+    bigint_free(&fn1);
+}
+
+void lucas_big(unsigned long long n, bigint_t *result)
+{
+    bigint_t fn, fn1;
+    bigint_init(&fn);
+    bigint_init(&fn1);
+    fibonacci_pair_big(n, &fn, &fn1);
+    bigint_add(result, &fn1, &fn1);
+    bigint_sub(result, result, &fn);
+    bigint_free(&fn);
+    bigint_free(&fn1);
+}
+
+bool comb_row_u64(unsigned long n, unsigned long long *row)
+{
+    if (n > COMB_ROW_U64_MAX)
+    {
+        return false;
+    }
+    row[0] = 1;
+    for (unsigned long k = 0; k < n / 2; k++)
+    {
+        row[k + 1] = (uint128)row[k] * (n - k) / (k + 1);
+    }
+    // the second half mirrors the first
+    for (unsigned long k = n / 2 + 1; k <= n; k++)
+    {
+        row[k] = row[n - k];
+    }
+    return true;
+}
+
+bool comb_row_exact(unsigned long n, unsigned __int128 *row)
+{
+    if (n > COMB_ROW_EXACT_MAX)
+    {
+        return false;
+    }
+    row[0] = 1;
+    for (unsigned long k = 0; k < n / 2; k++)
+    {
+        // (k+1) / g divides n-k, so the product is the result and does not overflow
+        unsigned long long g = gcd(row[k] % (k + 1), k + 1);
+        row[k + 1] = row[k] / g * ((n - k) / ((k + 1) / g));
+    }
+    for (unsigned long k = n / 2 + 1; k <= n; k++)
+    {
+        row[k] = row[n - k];
+    }
+    return true;
+}
+
+void comb_row(unsigned long n, long double *row)
+{
+    row[0] = 1.0L;
+    if (n <= COMB_ROW_U64_MAX)
+    {
+        unsigned long long c = 1;
+        for (unsigned long k = 0; k < n / 2; k++)
+        {
+            c = (uint128)c * (n - k) / (k + 1);
+            row[k + 1] = c;
+        }
+    }
+    else
+    {
+        for (unsigned long k = 0; k < n / 2; k++)
+        {
+            row[k + 1] = row[k] * (n - k) / (k + 1);
+        }
+    }
+    for (unsigned long k = n / 2 + 1; k <= n; k++)
+    {
+        row[k] = row[n - k];
+    }
+}
+
+bool comb_row_mod(unsigned long n, unsigned long long m, unsigned long long *row)
+{
+    if (!is_prime(m))
+    {
+        return false;
+    }
+
+    if (n >= m)
+    {
+        // C(n, k) = C(n mod m, k mod m) * C(n / m, k / m) mod m
+        unsigned long low = n % m, high = n / m;
+        unsigned long long *low_row = malloc((low + 1) * sizeof(unsigned long long));
+        unsigned long long *high_row = malloc((high + 1) * sizeof(unsigned long long));
+        if (low_row == NULL || high_row == NULL)
+        {
+            fprintf(stderr, "math_library - memory allocation error\n");
+            abort();
+        }
+        comb_row_mod(low, m, low_row);
+        comb_row_mod(high, m, high_row);
+        for (unsigned long k = 0; k <= n; k++)
+        {
+            unsigned long digit = k % m;
+            row[k] = (digit <= low) ? mulmod(low_row[digit], high_row[k / m], m) : 0;
+        }
+        free(low_row);
+        free(high_row);
+        return true;
+    }
+
+    // inverses of 1 to n/2, inv(i) = -(m / i) * inv(m mod i), kept in the second half of the row until it is
+    // mirrored, inv(i) at row[n + 1 - i]
+    unsigned long half = n / 2;
+    for (unsigned long i = 1; i <= half; i++)
+    {
+        row[n + 1 - i] = (i == 1) ? 1 : mulmod(m - m / i, row[n + 1 - m % i], m);
+    }
+    row[0] = 1 % m;
+    for (unsigned long k = 0; k < half; k++)
+    {
+        row[k + 1] = mulmod(mulmod(row[k], n - k, m), row[n - k], m);
+    }
+    for (unsigned long k = n / 2 + 1; k <= n; k++)
+    {
+        row[k] = row[n - k];
+    }
+    return true;
+}
+
+/**
+ * @brief c = a*b for square matrices of size k stored by rows, c must not alias a or b
+ */
+static void matmul_ld(const long double *a, const long double *b, long double *c, int k)
+{
+    for (int i = 0; i < k; i++)
+    {
+        for (int j = 0; j < k; j++)
+        {
+            long double sum = 0.0L;
+            for (int l = 0; l < k; l++)
+            {
+                sum += a[i * k + l] * b[l * k + j];
+            }
+            c[i * k + j] = sum;
+        }
+    }
+}
+
+static void matmul_mod(const unsigned long long *a, const unsigned long long *b, unsigned long long *c, int k,
+                       unsigned long long m)
+{
+    for (int i = 0; i < k; i++)
+    {
+        for (int j = 0; j < k; j++)
+        {
+            unsigned long long sum = 0;
+            for (int l = 0; l < k; l++)
+            {
+                sum = addmod(sum, mulmod(a[i * k + l], b[l * k + j], m), m);
+            }
+            c[i * k + j] = sum;
+        }
+    }
+}
+
+/*
+    Companion matrix of the recurrence transforms the state vector
+    (a(i+k-1), ..., a(i))^T to (a(i+k), ..., a(i+1))^T:
+    | c0 c1 ... ck-1 |
+    | 1  0  ... 0    |
+    | 0  1  ... 0    |
+*/
+
+long double linear_recurrence(const long double *coef, const long double *init, int order, unsigned long n)
+{
+    const int k = order;
+    if (n < (unsigned long)k)
+    {
+        return init[n];
+    }
+
+    long double mat[LINREC_MAX_ORDER * LINREC_MAX_ORDER] = {0};
+    long double res[LINREC_MAX_ORDER * LINREC_MAX_ORDER] = {0};
+    long double tmp[LINREC_MAX_ORDER * LINREC_MAX_ORDER];
+    for (int j = 0; j < k; j++)
+    {
+        mat[j] = coef[j];
+    }
+    for (int i = 1; i < k; i++)
+    {
+        mat[i * k + i - 1] = 1.0L;
+    }
+    for (int i = 0; i < k; i++)
+    {
+        res[i * k + i] = 1.0L;
+    }
+
+    // res = mat^(n-k+1)
+    for (unsigned long e = n - k + 1; e > 0; e >>= 1)
+    {
+        if (e & 1)
+        {
+            matmul_ld(res, mat, tmp, k);
+            memcpy(res, tmp, sizeof(long double) * k * k);
+        }
+        if (e > 1)
+        {
+            matmul_ld(mat, mat, tmp, k);
+            memcpy(mat, tmp, sizeof(long double) * k * k);
+        }
+    }
+
+    // first row of res applied to the state (a(k-1), ..., a(0))
+    long double result = 0.0L;
+    for (int j = 0; j < k; j++)
+    {
+        result += res[j] * init[k - 1 - j];
+    }
+    return result;
+}
+
+unsigned long long linear_recurrence_mod(const unsigned long long *coef, const unsigned long long *init, int order,
+                                         unsigned long long n, unsigned long long m)
+{
+    const int k = order;
+    if (n < (unsigned long long)k)
+    {
+        return init[n] % m;
+    }
+
+    unsigned long long mat[LINREC_MAX_ORDER * LINREC_MAX_ORDER] = {0};
+    unsigned long long res[LINREC_MAX_ORDER * LINREC_MAX_ORDER] = {0};
+    unsigned long long tmp[LINREC_MAX_ORDER * LINREC_MAX_ORDER];
+    for (int j = 0; j < k; j++)
+    {
+        mat[j] = coef[j] % m;
+    }
+    for (int i = 1; i < k; i++)
+    {
+        mat[i * k + i - 1] = 1 % m;
+    }
+    for (int i = 0; i < k; i++)
+    {
+        res[i * k + i] = 1 % m;
+    }
+
+    for (unsigned long long e = n - k + 1; e > 0; e >>= 1)
+    {
+        if (e & 1)
+        {
+            matmul_mod(res, mat, tmp, k, m);
+            memcpy(res, tmp, sizeof(unsigned long long) * k * k);
+        }
+        if (e > 1)
+        {
+            matmul_mod(mat, mat, tmp, k, m);
+            memcpy(mat, tmp, sizeof(unsigned long long) * k * k);
+        }
+    }
+
+    unsigned long long result = 0;
+    for (int j = 0; j < k; j++)
+    {
+        result = addmod(result, mulmod(res[j], init[k - 1 - j] % m, m), m);
+    }
+    return result;
+}
+
+/**
+ * @brief c = a*b for square matrices of big integers of size k stored by rows, c must not alias a or b
+ */
+static void matmul_big(const bigint_t *a, const bigint_t *b, bigint_t *c, int k, bigint_t *t)
+{
+    for (int i = 0; i < k; i++)
+    {
+        for (int j = 0; j < k; j++)
+        {
+            bigint_set_u64(&c[i * k + j], 0);
+            for (int l = 0; l < k; l++)
+            {
+                bigint_mul(t, &a[i * k + l], &b[l * k + j]);
+                bigint_add(&c[i * k + j], &c[i * k + j], t);
+            }
+        }
+    }
+}
+
+void linear_recurrence_big(const long long *coef, const long long *init, int order, unsigned long long n,
+                           bigint_t *result)
+{
+    const int k = order;
+    if (n < (unsigned long long)k)
+    {
+        bigint_set_i64(result, init[n]);
+        return;
+    }
+
+    bigint_t mat[LINREC_MAX_ORDER * LINREC_MAX_ORDER], res[LINREC_MAX_ORDER * LINREC_MAX_ORDER];
+    bigint_t tmp[LINREC_MAX_ORDER * LINREC_MAX_ORDER], t;
+    bigint_init(&t);
+    for (int i = 0; i < k * k; i++)
+    {
+        bigint_init(&mat[i]);
+        bigint_init(&res[i]);
+        bigint_init(&tmp[i]);
+    }
+    for (int j = 0; j < k; j++)
+    {
+        bigint_set_i64(&mat[j], coef[j]);
+    }
+    for (int i = 1; i < k; i++)
+    {
+        bigint_set_u64(&mat[i * k + i - 1], 1);
+    }
+    for (int i = 0; i < k; i++)
+    {
+        bigint_set_u64(&res[i * k + i], 1);
+    }
+
+    // res = mat^(n-k+1), the products are swapped in instead of copied
+    for (unsigned long long e = n - k + 1; e > 0; e >>= 1)
+    {
+        if (e & 1)
+        {
+            matmul_big(res, mat, tmp, k, &t);
+            for (int i = 0; i < k * k; i++)
+            {
+                bigint_swap(&res[i], &tmp[i]);
+            }
+        }
+        if (e > 1)
+        {
+            matmul_big(mat, mat, tmp, k, &t);
+            for (int i = 0; i < k * k; i++)
+            {
+                bigint_swap(&mat[i], &tmp[i]);
+            }
+        }
+    }
+
+    // first row of res applied to the state (a(k-1), ..., a(0))
+    bigint_set_u64(result, 0);
+    for (int j = 0; j < k; j++)
+    {
+        bigint_set_i64(&t, init[k - 1 - j]);
+        bigint_mul(&t, &res[j], &t);
+        bigint_add(result, result, &t);
+    }
+    for (int i = 0; i < k * k; i++)
+    {
+        bigint_free(&mat[i]);
+        bigint_free(&res[i]);
+        bigint_free(&tmp[i]);
+    }
+    bigint_free(&t);
+}
+
+#define SUM_BLOCK 256 // elements summed in vector registers, larger arrays are split in halves
+
+typedef double sum_vec __attribute__((vector_size(16)));    // two doubles, one SSE2 register
+typedef long long sum_mask __attribute__((vector_size(16))); // result of a comparison of sum_vec
+
+/**
+ * @brief Loads two doubles from a possibly unaligned address.
+ */
+static inline sum_vec sum_load(const double *x)
+{
+    sum_vec v;
+    memcpy(&v, x, sizeof(v));
+    return v;
+}
+
+/**
+ * @brief Sum of at most SUM_BLOCK elements in four independent vector accumulators.
+ */
+static double sum_block(const double *x, size_t n)
+{
+    sum_vec a0 = {0.0, 0.0}, a1 = a0, a2 = a0, a3 = a0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        a0 += sum_load(x + i);
+        a1 += sum_load(x + i + 2);
+        a2 += sum_load(x + i + 4);
+        a3 += sum_load(x + i + 6);
+    }
+    a0 = (a0 + a1) + (a2 + a3);
+    double r = a0[0] + a0[1];
+    for (; i < n; i++)
+    {
+        r += x[i];
+    }
+    return r;
+}
+
+/**
+ * @brief Sums of (x[i] - mean) and (x[i] - mean)^2 of at most SUM_BLOCK elements.
+ */
+static void deviation_block(const double *x, size_t n, double mean, double *sum, double *sum_sq)
+{
+    sum_vec s0 = {0.0, 0.0}, s1 = s0, q0 = s0, q1 = s0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        sum_vec d0 = sum_load(x + i) - mean;
+        sum_vec d1 = sum_load(x + i + 2) - mean;
+        s0 += d0;
+        s1 += d1;
+        q0 += d0 * d0;
+        q1 += d1 * d1;
+    }
+    s0 += s1;
+    q0 += q1;
+    double s = s0[0] + s0[1], q = q0[0] + q0[1];
+    for (; i < n; i++)
+    {
+        double d = x[i] - mean;
+        s += d;
+        q += d * d;
+    }
+    *sum = s;
+    *sum_sq = q;
+}
+
+/**
+ * @brief Splits the array at a multiple of the vector length near its half.
+ */
+static inline size_t sum_split(size_t n)
+{
+    return n / 2 / 8 * 8;
+}
+
+double sum_array(const double *arr, size_t n)
+{
+    if (n <= SUM_BLOCK)
+    {
+        return sum_block(arr, n);
+    }
+    size_t h = sum_split(n);
+    return sum_array(arr, h) + sum_array(arr + h, n - h);
+}
+
+/**
+ * @brief Pairwise sums of the deviations from the mean and of their squares.
+ */
+static void deviation_sums(const double *x, size_t n, double mean, double *sum, double *sum_sq)
+{
+    if (n <= SUM_BLOCK)
+    {
+        deviation_block(x, n, mean, sum, sum_sq);
+        return;
+    }
+    size_t h = sum_split(n);
+    double s1, q1, s2, q2;
+    deviation_sums(x, h, mean, &s1, &q1);
+    deviation_sums(x + h, n - h, mean, &s2, &q2);
+    *sum = s1 + s2;
+    *sum_sq = q1 + q2;
+}
+
+double sum_array_compensated(const double *arr, size_t n)
+{
+    // every lane keeps its sum and the sum of the rounding errors of its additions (Fast2Sum without branches)
+    sum_vec s0 = {0.0, 0.0}, s1 = s0, c0 = s0, c1 = s0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        sum_vec x0 = sum_load(arr + i), x1 = sum_load(arr + i + 2);
+        sum_vec t0 = s0 + x0, t1 = s1 + x1;
+        sum_vec z0 = t0 - s0, z1 = t1 - s1;
+        c0 += (s0 - (t0 - z0)) + (x0 - z0);
+        c1 += (s1 - (t1 - z1)) + (x1 - z1);
+        s0 = t0;
+        s1 = t1;
+    }
+    double s = 0.0, c = 0.0;
+    double parts[8] = {s0[0], s0[1], s1[0], s1[1], c0[0] + c0[1] + c1[0] + c1[1], 0.0, 0.0, 0.0};
+    size_t count = 5;
+    for (; i < n; i++)
+    {
+        parts[count++] = arr[i];
+    }
+    for (size_t k = 0; k < count; k++)
+    {
+        double t = s + parts[k];
+        double z = t - s;
+        c += (s - (t - z)) + (parts[k] - z);
+        s = t;
+    }
+    return s + c;
+}
+
+double mean_array(const double *arr, size_t n)
+{
+    return (n == 0) ? NAN : sum_array(arr, n) / n;
+}
+
+double variance_array(const double *arr, size_t n)
+{
+    if (n < 2)
+    {
+        return NAN;
+    }
+    double mean = sum_array(arr, n) / n;
+    double sum, sum_sq;
+    deviation_sums(arr, n, mean, &sum, &sum_sq);
+    // the sum of the deviations corrects the rounding error of the mean
+    return (sum_sq - sum * sum / n) / (n - 1);
+}
+
+#define STATS_BLOCK 1024 // values summarized at once by stats_add_array
+
+void stats_init(stats_t *s)
+{
+    s->count = 0;
+    s->mean = 0.0L;
+    s->m2 = 0.0L;
+    s->min = INFINITY;
+    s->max = -INFINITY;
+}
+
+void stats_add(stats_t *s, long double x)
+{
+    s->count++;
+    long double delta = x - s->mean;
+    s->mean += delta / s->count;
+    s->m2 += delta * (x - s->mean);
+    s->min = (x < s->min) ? x : s->min;
+    s->max = (x > s->max) ? x : s->max;
+}
+
+/**
+ * @brief Elementwise minimum of two vectors, b is kept where a is nan.
+ */
+static inline sum_vec sum_min(sum_vec a, sum_vec b)
+{
+    sum_mask less = a < b;
+    return (sum_vec)((less & (sum_mask)a) | (~less & (sum_mask)b));
+}
+
+/**
+ * @brief Elementwise maximum of two vectors, b is kept where a is nan.
+ */
+static inline sum_vec sum_max(sum_vec a, sum_vec b)
+{
+    sum_mask greater = a > b;
+    return (sum_vec)((greater & (sum_mask)a) | (~greater & (sum_mask)b));
+}
+
+/**
+ * @brief Elementwise minimum and maximum of two vectors.
+ */
+static inline void sum_minmax(sum_vec v, sum_vec *lo, sum_vec *hi)
+{
+    *lo = sum_min(v, *lo);
+    *hi = sum_max(v, *hi);
+}
+
+/**
+ * @brief Smallest and largest element of an array in four independent vector accumulators.
+ * @details The accumulators start from infinity and -infinity like stats_add, so nan values are ignored
+ * wherever they are. An array without numbers gives infinity and -infinity.
+ */
+static void minmax_array(const double *x, size_t n, long double *min, long double *max)
+{
+    sum_vec lo0 = {INFINITY, INFINITY}, lo1 = lo0, lo2 = lo0, lo3 = lo0;
+    sum_vec hi0 = -lo0, hi1 = hi0, hi2 = hi0, hi3 = hi0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        sum_minmax(sum_load(x + i), &lo0, &hi0);
+        sum_minmax(sum_load(x + i + 2), &lo1, &hi1);
+        sum_minmax(sum_load(x + i + 4), &lo2, &hi2);
+        sum_minmax(sum_load(x + i + 6), &lo3, &hi3);
+    }
+    lo0 = sum_min(sum_min(lo0, lo1), sum_min(lo2, lo3));
+    hi0 = sum_max(sum_max(hi0, hi1), sum_max(hi2, hi3));
+    double l = (lo0[1] < lo0[0]) ? lo0[1] : lo0[0], h = (hi0[1] > hi0[0]) ? hi0[1] : hi0[0];
+    for (; i < n; i++)
+    {
+        l = (x[i] < l) ? x[i] : l;
+        h = (x[i] > h) ? x[i] : h;
+    }
+    *min = l;
+    *max = h;
+}
+
+void stats_add_array(stats_t *s, const double *x, size_t n)
+{
+    for (size_t start = 0; start < n; start += STATS_BLOCK)
+    {
+        size_t len = (n - start < STATS_BLOCK) ? n - start : STATS_BLOCK;
+        const double *b = x + start;
+        stats_t block;
+        stats_init(&block);
+        block.count = len;
+
+        minmax_array(b, len, &block.min, &block.max);
+        double mean = sum_array(b, len) / len;
+        double sum, sum_sq;
+        deviation_sums(b, len, mean, &sum, &sum_sq);
+        block.mean = mean + sum / len;
+        block.m2 = sum_sq - (long double)sum * sum / len;
+        stats_merge(s, &block);
+    }
+}
+
+void stats_merge(stats_t *s, const stats_t *t)
+{
+    if (t->count == 0)
+    {
+        return;
+    }
+    if (s->count == 0)
+    {
+        *s = *t;
+        return;
+    }
+    long double n = (long double)s->count + t->count;
+    long double delta = t->mean - s->mean;
+    s->mean += delta * (t->count / n);
+    s->m2 += t->m2 + delta * delta * ((long double)s->count * t->count / n);
+    s->count += t->count;
+    s->min = (t->min < s->min) ? t->min : s->min;
+    s->max = (t->max > s->max) ? t->max : s->max;
+}
+
+long double stats_mean(const stats_t *s)
+{
+    return (s->count == 0) ? NAN : s->mean;
+}
+
+long double stats_variance(const stats_t *s)
+{
+    return (s->count < 2) ? NAN : s->m2 / (s->count - 1);
+}
+
+long double stats_population_variance(const stats_t *s)
+{
+    return (s->count == 0) ? NAN : s->m2 / s->count;
+}
+
+long double stats_stddev(const stats_t *s)
+{
+    return sqrtl(stats_variance(s));
+}
+
+long double stats_min(const stats_t *s)
+{
+    return (s->count == 0) ? NAN : s->min;
+}
+
+long double stats_max(const stats_t *s)
+{
+    return (s->count == 0) ? NAN : s->max;
+}
+
+void stats_pair_init(stats_pair_t *s)
+{
+    s->count = 0;
+    s->mean_x = 0.0L;
+    s->mean_y = 0.0L;
+    s->m2_x = 0.0L;
+    s->m2_y = 0.0L;
+    s->c = 0.0L;
+}
+
+void stats_pair_add(stats_pair_t *s, long double x, long double y)
+{
+    s->count++;
+    long double dx = x - s->mean_x, dy = y - s->mean_y;
+    s->mean_x += dx / s->count;
+    s->mean_y += dy / s->count;
+    s->m2_x += dx * (x - s->mean_x);
+    s->m2_y += dy * (y - s->mean_y);
+    s->c += dx * (y - s->mean_y);
+}
+
+/**
+ * @brief Sums of the deviations of pairs from the means, of their squares and of their products, of at
+ * most STATS_BLOCK pairs.
+ * @param sums receives the sums of dx, dy, dx^2, dy^2 and dx dy
+ */
+static void codeviation_block(const double *x, const double *y, size_t n, double mean_x, double mean_y,
+                              double *sums)
+{
+    sum_vec sx = {0.0, 0.0}, sy = sx, qx = sx, qy = sx, c = sx;
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2)
+    {
+        sum_vec dx = sum_load(x + i) - mean_x, dy = sum_load(y + i) - mean_y;
+        sx += dx;
+        sy += dy;
+        qx += dx * dx;
+        qy += dy * dy;
+        c += dx * dy;
+    }
+    double r[5] = {sx[0] + sx[1], sy[0] + sy[1], qx[0] + qx[1], qy[0] + qy[1], c[0] + c[1]};
+    for (; i < n; i++)
+    {
+        double dx = x[i] - mean_x, dy = y[i] - mean_y;
+        r[0] += dx;
+        r[1] += dy;
+        r[2] += dx * dx;
+        r[3] += dy * dy;
+        r[4] += dx * dy;
+    }
+    memcpy(sums, r, sizeof(r));
+}
+
+void stats_pair_add_array(stats_pair_t *s, const double *x, const double *y, size_t n)
+{
+    for (size_t start = 0; start < n; start += STATS_BLOCK)
+    {
+        size_t len = (n - start < STATS_BLOCK) ? n - start : STATS_BLOCK;
+        double mean_x = sum_array(x + start, len) / len, mean_y = sum_array(y + start, len) / len;
+        double sums[5];
+        codeviation_block(x + start, y + start, len, mean_x, mean_y, sums);
+        // the sums of the deviations correct the rounding errors of the means
+        stats_pair_t block;
+        block.count = len;
+        block.mean_x = mean_x + sums[0] / len;
+        block.mean_y = mean_y + sums[1] / len;
+        block.m2_x = sums[2] - (long double)sums[0] * sums[0] / len;
+        block.m2_y = sums[3] - (long double)sums[1] * sums[1] / len;
+        block.c = sums[4] - (long double)sums[0] * sums[1] / len;
+        stats_pair_merge(s, &block);
+    }
+}
+
+void stats_pair_merge(stats_pair_t *s, const stats_pair_t *t)
+{
+    if (t->count == 0)
+    {
+        return;
+    }
+    if (s->count == 0)
+    {
+        *s = *t;
+        return;
+    }
+    long double n = (long double)s->count + t->count;
+    long double dx = t->mean_x - s->mean_x, dy = t->mean_y - s->mean_y;
+    long double w = (long double)s->count * t->count / n;
+    s->mean_x += dx * (t->count / n);
+    s->mean_y += dy * (t->count / n);
+    s->m2_x += t->m2_x + dx * dx * w;
+    s->m2_y += t->m2_y + dy * dy * w;
+    s->c += t->c + dx * dy * w;
+    s->count += t->count;
+}
+
+long double stats_pair_covariance(const stats_pair_t *s)
+{
+    return (s->count < 2) ? NAN : s->c / (s->count - 1);
+}
+
+long double stats_pair_correlation(const stats_pair_t *s)
+{
+    if (s->count < 2 || s->m2_x <= 0.0L || s->m2_y <= 0.0L)
+    {
+        return NAN;
+    }
+    long double r = s->c / sqrtl(s->m2_x * s->m2_y);
+    return (r > 1.0L) ? 1.0L : (r < -1.0L) ? -1.0L : r;
+}
+
+long double stats_pair_slope(const stats_pair_t *s)
+{
+    return (s->count < 2 || s->m2_x <= 0.0L) ? NAN : s->c / s->m2_x;
+}
+
+long double stats_pair_intercept(const stats_pair_t *s)
+{
+    return s->mean_y - stats_pair_slope(s) * s->mean_x;
+}
+
+#define REPRO_MAX_PENDING (1UL << 30) // additions before the digits could overflow
+#define REPRO_SPLIT 134217729.0       // 2^27 + 1, splits a double into two halves (Dekker)
+
+/**
+ * @brief Propagates the carries, all digits except the highest one get into [0, 2^32).
+ */
+static void repro_normalize(long long *bin)
+{
+    for (int i = 0; i + 1 < REPRO_BINS; i++)
+    {
+        long long low = bin[i] & 0xFFFFFFFFLL;
+        bin[i + 1] += (bin[i] - low) / 4294967296LL;
+        bin[i] = low;
+    }
+}
+
+void repro_sum_init(repro_sum_t *r)
+{
+    memset(r, 0, sizeof(repro_sum_t));
+}
+
+void repro_sum_add(repro_sum_t *r, double x)
+{
+    unsigned long long u;
+    memcpy(&u, &x, sizeof(u));
+    int e = (int)((u >> 52) & 0x7FF);
+    if (e == 0x7FF)
+    {
+        r->special |= ((u & 0xFFFFFFFFFFFFFULL) != 0) ? 4u : ((u >> 63) ? 2u : 1u);
+        return;
+    }
+    // x = m * 2^(pos - 1074), the 53 bits of m shifted by pos span three digits
+    unsigned long long m = u & 0xFFFFFFFFFFFFFULL;
+    int pos = 0;
+    if (e != 0)
+    {
+        m |= 1ULL << 52;
+        pos = e - 1;
+    }
+    uint128 v = (uint128)m << (pos & 31);
+    long long *bin = r->bin + (pos >> 5);
+    long long d0 = (long long)(v & 0xFFFFFFFFu), d1 = (long long)((v >> 32) & 0xFFFFFFFFu), d2 = (long long)(v >> 64);
+    if (u >> 63)
+    {
+        bin[0] -= d0;
+        bin[1] -= d1;
+        bin[2] -= d2;
+    }
+    else
+    {
+        bin[0] += d0;
+        bin[1] += d1;
+        bin[2] += d2;
+    }
+    if (++r->pending == REPRO_MAX_PENDING)
+    {
+        repro_normalize(r->bin);
+        r->pending = 0;
+    }
+}
+
+void repro_sum_add_array(repro_sum_t *r, const double *arr, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        repro_sum_add(r, arr[i]);
+    }
+}
+
+void repro_sum_merge(repro_sum_t *r, const repro_sum_t *t)
+{
+    if (r->pending + t->pending >= REPRO_MAX_PENDING)
+    {
+        repro_normalize(r->bin);
+        r->pending = 0;
+    }
+    for (int i = 0; i < REPRO_BINS; i++)
+    {
+        r->bin[i] += t->bin[i];
+    }
+    r->pending += t->pending;
+    r->special |= t->special;
+}
+
+double repro_sum_get(const repro_sum_t *r)
+{
+    if ((r->special & 4u) || r->special == 3u)
+    {
+        return NAN;
+    }
+    if (r->special != 0)
+    {
+        return (r->special == 1u) ? INFINITY : -INFINITY;
+    }
+
+    long long bin[REPRO_BINS];
+    memcpy(bin, r->bin, sizeof(bin));
+    repro_normalize(bin);
+    bool negative = bin[REPRO_BINS - 1] < 0;
+    if (negative)
+    {
+        for (int i = 0; i < REPRO_BINS; i++)
+        {
+            bin[i] = -bin[i];
+        }
+        repro_normalize(bin);
+    }
+    int h = REPRO_BINS - 1;
+    while (h >= 0 && bin[h] == 0)
+    {
+        h--;
+    }
+    if (h < 0)
+    {
+        return 0.0;
+    }
+
+    // the three highest digits and a sticky bit for the rest round correctly to 53 bits
+    int lo = (h >= 2) ? h - 2 : 0;
+    uint128 v = 0;
+    for (int i = h; i >= lo; i--)
+    {
+        v = (v << 32) | (uint128)bin[i];
+    }
+    for (int i = 0; i < lo; i++)
+    {
+        v |= (bin[i] != 0);
+    }
+    double x = ldexp((double)v, 32 * lo - 1074);
+    return negative ? -x : x;
+}
+
+double sum_array_reproducible(const double *arr, size_t n)
+{
+    repro_sum_t r;
+    repro_sum_init(&r);
+    repro_sum_add_array(&r, arr, n);
+    return repro_sum_get(&r);
+}
+
+void stats_repro_init(stats_repro_t *s, double shift)
+{
+    s->count = 0;
+    s->shift = shift;
+    repro_sum_init(&s->sum);
+    repro_sum_init(&s->sum_sq);
+    s->min = INFINITY;
+    s->max = -INFINITY;
+}
+
+void stats_repro_add_array(stats_repro_t *s, const double *x, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        double d = x[i] - s->shift;
+        // d^2 = hi + lo exactly
+        double hi = d * d;
+        double t = REPRO_SPLIT * d;
+        double dh = t - (t - d), dl = d - dh;
+        double lo = ((dh * dh - hi) + 2.0 * dh * dl) + dl * dl;
+        repro_sum_add(&s->sum, d);
+        repro_sum_add(&s->sum_sq, hi);
+        repro_sum_add(&s->sum_sq, lo);
+        s->min = (x[i] < s->min) ? x[i] : s->min;
+        s->max = (x[i] > s->max) ? x[i] : s->max;
+    }
+    s->count += n;
+}
+
+void stats_repro_merge(stats_repro_t *s, const stats_repro_t *t)
+{
+    s->count += t->count;
+    repro_sum_merge(&s->sum, &t->sum);
+    repro_sum_merge(&s->sum_sq, &t->sum_sq);
+    s->min = (t->min < s->min) ? t->min : s->min;
+    s->max = (t->max > s->max) ? t->max : s->max;
+}
+
+void stats_repro_get(const stats_repro_t *s, stats_t *r)
+{
+    stats_init(r);
+    if (s->count == 0)
+    {
+        return;
+    }
+    long double sum = repro_sum_get(&s->sum), sum_sq = repro_sum_get(&s->sum_sq);
+    r->count = s->count;
+    r->mean = s->shift + sum / s->count;
+    r->m2 = sum_sq - sum * sum / s->count;
+    r->m2 = (r->m2 < 0.0L) ? 0.0L : r->m2;
+    r->min = s->min;
+    r->max = s->max;
+}
+
+#define TDIGEST_PI 3.14159265358979323846
+
+/**
+ * @brief Scale function k1 of the t-digest, a centroid may span at most one unit of k.
+ */
+static double tdigest_k(double q)
+{
+    return TDIGEST_COMPRESSION / (2.0 * TDIGEST_PI) * asin(2.0 * q - 1.0);
+}
+
+/**
+ * @brief Inverse of tdigest_k, 1 beyond the largest k.
+ */
+static double tdigest_q(double k)
+{
+    if (k >= TDIGEST_COMPRESSION / 4.0)
+    {
+        return 1.0;
+    }
+    return (sin(k * (2.0 * TDIGEST_PI) / TDIGEST_COMPRESSION) + 1.0) / 2.0;
+}
+
+/**
+ * @brief Sorts doubles without nan in increasing order, quicksort with insertion sort of short ranges.
+ */
+static void sort_doubles(double *x, size_t n)
+{
+    while (n > 16)
+    {
+        // median of three as the pivot, then Hoare partition
+        double a = x[0], b = x[n / 2], c = x[n - 1];
+        double pivot = (a < b) ? ((b < c) ? b : (a < c) ? c : a) : ((a < c) ? a : (b < c) ? c : b);
+        size_t i = 0, j = n - 1;
+        while (true)
+        {
+            while (x[i] < pivot)
+            {
+                i++;
+            }
+            while (x[j] > pivot)
+            {
+                j--;
+            }
+            if (i >= j)
+            {
+                break;
+            }
+            double tmp = x[i];
+            x[i++] = x[j];
+            x[j--] = tmp;
+        }
+        // recursion on the shorter part keeps the depth logarithmic
+        size_t left = j + 1;
+        if (left < n - left)
+        {
+            sort_doubles(x, left);
+            x += left;
+            n -= left;
+        }
+        else
+        {
+            sort_doubles(x + left, n - left);
+            n = left;
+        }
+    }
+    for (size_t i = 1; i < n; i++)
+    {
+        double v = x[i];
+        size_t j = i;
+        while (j > 0 && x[j - 1] > v)
+        {
+            x[j] = x[j - 1];
+            j--;
+        }
+        x[j] = v;
+    }
+}
+
+/**
+ * @brief Merges the buffer and extra sorted centroids into the centroids of t.
+ * @param mean means of the extra centroids in increasing order
+ * @param weight weights of the extra centroids
+ * @param n number of the extra centroids, at most TDIGEST_CENTROIDS
+ */
+static void tdigest_compress(tdigest_t *t, const double *mean, const double *weight, size_t n)
+{
+    if (t->buffered == 0 && n == 0)
+    {
+        return;
+    }
+    sort_doubles(t->buffer, t->buffered);
+
+    // three sorted lists merged into one: centroids, buffer (weight 1) and extra centroids
+    size_t count = t->centroids + t->buffered + n;
+    double m[2 * TDIGEST_CENTROIDS + TDIGEST_BUFFER], w[2 * TDIGEST_CENTROIDS + TDIGEST_BUFFER];
+    size_t a = 0, b = 0, c = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        double ma = (a < t->centroids) ? t->mean[a] : INFINITY;
+        double mb = (b < t->buffered) ? t->buffer[b] : INFINITY;
+        double mc = (c < n) ? mean[c] : INFINITY;
+        if (a < t->centroids && ma <= mb && ma <= mc)
+        {
+            m[i] = ma;
+            w[i] = t->weight[a++];
+        }
+        else if (b < t->buffered && mb <= mc)
+        {
+            m[i] = mb;
+            w[i] = 1.0;
+            b++;
+        }
+        else
+        {
+            m[i] = mc;
+            w[i] = weight[c++];
+        }
+    }
+    double total = 0.0;
+    for (size_t i = 0; i < count; i++)
+    {
+        total += w[i];
+    }
+
+    // greedy sweep, neighbours are merged while the centroid spans at most one unit of k
+    size_t r = 0;        // centroids written so far
+    double before = 0.0; // weight of the centroids before the current one
+    double limit = total * tdigest_q(tdigest_k(0.0) + 1.0);
+    for (size_t i = 0; i < count; i++)
+    {
+        if (i > 0 && before + t->weight[r - 1] + w[i] <= limit)
+        {
+            t->weight[r - 1] += w[i];
+            t->mean[r - 1] += (m[i] - t->mean[r - 1]) * w[i] / t->weight[r - 1];
+            continue;
+        }
+        if (i > 0)
+        {
+            before += t->weight[r - 1];
+            limit = total * tdigest_q(tdigest_k(before / total) + 1.0);
+        }
+        t->mean[r] = m[i];
+        t->weight[r++] = w[i];
+    }
+    t->centroids = r;
+    t->total = total;
+    t->buffered = 0;
+}
+
+void tdigest_init(tdigest_t *t)
+{
+    t->centroids = 0;
+    t->buffered = 0;
+    t->total = 0.0;
+    t->min = INFINITY;
+    t->max = -INFINITY;
+}
+
+void tdigest_add(tdigest_t *t, double x)
+{
+    if (isnan(x))
+    {
+        return;
+    }
+    t->min = (x < t->min) ? x : t->min;
+    t->max = (x > t->max) ? x : t->max;
+    t->buffer[t->buffered++] = x;
+    if (t->buffered == TDIGEST_BUFFER)
+    {
+        tdigest_compress(t, NULL, NULL, 0);
+    }
+}
+
+void tdigest_add_array(tdigest_t *t, const double *x, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        tdigest_add(t, x[i]);
+    }
+}
+
+void tdigest_merge(tdigest_t *t, const tdigest_t *u)
+{
+    tdigest_t v = *u;
+    tdigest_compress(&v, NULL, NULL, 0);
+    if (v.centroids == 0)
+    {
+        return;
+    }
+    t->min = (v.min < t->min) ? v.min : t->min;
+    t->max = (v.max > t->max) ? v.max : t->max;
+    tdigest_compress(t, v.mean, v.weight, v.centroids);
+}
+
+unsigned long long tdigest_count(const tdigest_t *t)
+{
+    return (unsigned long long)t->total + t->buffered;
+}
+
+double tdigest_quantile(const tdigest_t *t, double q)
+{
+    if (!(q >= 0.0 && q <= 1.0) || tdigest_count(t) == 0)
+    {
+        return NAN;
+    }
+    tdigest_t v = *t;
+    tdigest_compress(&v, NULL, NULL, 0);
+    if (q == 0.0 || v.centroids == 1)
+    {
+        return (q == 1.0) ? v.max : (q == 0.0) ? v.min : v.mean[0];
+    }
+
+    // the values of a centroid are spread around its mean, the extremes are at the ends
+    double index = q * v.total;
+    double r;
+    size_t last = v.centroids - 1;
+    if (index <= v.weight[0] / 2.0)
+    {
+        r = v.min + (v.mean[0] - v.min) * index / (v.weight[0] / 2.0);
+    }
+    else if (index >= v.total - v.weight[last] / 2.0)
+    {
+        double tail = v.total - index;
+        r = v.max - (v.max - v.mean[last]) * tail / (v.weight[last] / 2.0);
+    }
+    else
+    {
+        double before = v.weight[0] / 2.0;
+        size_t i = 0;
+        while (before + (v.weight[i] + v.weight[i + 1]) / 2.0 < index)
+        {
+            before += (v.weight[i] + v.weight[i + 1]) / 2.0;
+            i++;
+        }
+        double span = (v.weight[i] + v.weight[i + 1]) / 2.0;
+        double z = (index - before) / span;
+        r = v.mean[i] + (v.mean[i + 1] - v.mean[i]) * z;
+    }
+    return (r < v.min) ? v.min : (r > v.max) ? v.max : r;
+}
+
+#define SELECT_SMALL 600                // longest range partitioned without selecting in a sample first
+#define SELECT_PARALLEL_MIN (1 << 22)   // shortest array whose numbers are collected by several threads
+#define SELECT_MIN_PER_THREAD (1 << 20) // fewest values scanned by one thread
+#define SELECT_SAMPLE_MAX (1 << 20)     // largest sample for the pivots of the parallel selection
+#define SELECT_SAMPLE_GAP 3.0           // distance of the pivots from the rank, in standard deviations
+
+static int select_threads = 0;
+
+void select_set_threads(int threads)
+{
+    select_threads = (threads < 0) ? 0 : threads;
+}
+
+static inline void swap_doubles(double *x, ptrdiff_t i, ptrdiff_t j)
+{
+    double t = x[i];
+    x[i] = x[j];
+    x[j] = t;
+}
+
+static void select_range(double *x, ptrdiff_t left, ptrdiff_t right, ptrdiff_t k, int budget);
+
+/**
+ * @brief Moves the median of the medians of groups of five values to x[0].
+ * @details At least 30 % of the values are on each side of it, so partitions around it shrink the range.
+ */
+static void median_of_medians(double *x, ptrdiff_t n)
+{
+    ptrdiff_t groups = 0;
+    for (ptrdiff_t i = 0; i + 5 <= n; i += 5)
+    {
+        sort_doubles(x + i, 5);
+        swap_doubles(x, groups++, i + 2);
+    }
+    if (groups > 1)
+    {
+        select_range(x, 0, groups - 1, groups / 2, 0);
+        swap_doubles(x, 0, groups / 2);
+    }
+}
+
+/**
+ * @brief Moves the k-th smallest value of x[left..right] to x[k], smaller values before it and larger after.
+ * @details Floyd-Rivest selection: the pivot is the k-th value of a sample, selected recursively, so the
+ * range shrinks to about its square root after one partition. Once budget partitions are used, the pivots
+ * are medians of medians, which keeps the worst case linear.
+ * @param x values without nan
+ * @param budget partitions left before the medians of medians are used
+ */
+static void select_range(double *x, ptrdiff_t left, ptrdiff_t right, ptrdiff_t k, int budget)
+{
+    while (right > left)
+    {
+        ptrdiff_t n = right - left + 1;
+        if (budget <= 0)
+        {
+            median_of_medians(x + left, n);
+            swap_doubles(x, left, k);
+        }
+        else if (n > SELECT_SMALL)
+        {
+            // sample of about n^(2/3) values around k, its selected value is close to the k-th one
+            double i = (double)(k - left + 1);
+            double z = log((double)n);
+            double size = 0.5 * exp(2.0 * z / 3.0);
+            double gap = 0.5 * sqrt(z * size * (n - size) / n) * ((i < n / 2.0) ? -1.0 : 1.0);
+            double sample_left = k - i * size / n + gap;
+            double sample_right = k + (n - i) * size / n + gap;
+            select_range(x, (sample_left > left) ? (ptrdiff_t)sample_left : left,
+                         (sample_right < right) ? (ptrdiff_t)sample_right : right, k, budget - 1);
+        }
+        budget--;
+
+        // partition around t = x[k], the ends are sentinels of the scans
+        double t = x[k];
+        ptrdiff_t i = left, j = right;
+        swap_doubles(x, left, k);
+        if (x[right] > t)
+        {
+            swap_doubles(x, right, left);
+        }
+        while (i < j)
+        {
+            swap_doubles(x, i++, j--);
+            while (x[i] < t)
+            {
+                i++;
+            }
+            while (x[j] > t)
+            {
+                j--;
+            }
+        }
+        if (x[left] == t)
+        {
+            swap_doubles(x, left, j);
+        }
+        else
+        {
+            swap_doubles(x, ++j, right);
+        }
+        if (j <= k)
+        {
+            left = j + 1;
+        }
+        if (k <= j)
+        {
+            right = j - 1;
+        }
+    }
+}
+
+/**
+ * @brief Partitions allowed to select_range before the medians of medians are used.
+ */
+static int select_budget(size_t n)
+{
+    int bits = 0;
+    while (n >>= 1)
+    {
+        bits++;
+    }
+    return 2 * bits + 4;
+}
+
+/**
+ * @brief Moves the nan values to the end of x.
+ * @return number of the other values
+ */
+static size_t move_nan_back(double *x, size_t n)
+{
+    size_t m = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        if (!isnan(x[i]))
+        {
+            swap_doubles(x, (ptrdiff_t)m++, (ptrdiff_t)i);
+        }
+    }
+    return m;
+}
+
+/**
+ * @brief Selects the values at ranks r and r + 1 of m numbers.
+ * @param hi receives the value at rank r + 1 (at rank r for the maximum), NULL if it is not needed
+ */
+static void select_pair(double *x, size_t m, size_t r, double *lo, double *hi)
+{
+    select_range(x, 0, (ptrdiff_t)m - 1, (ptrdiff_t)r, select_budget(m));
+    *lo = x[r];
+    if (hi != NULL)
+    {
+        long double min = x[r], max;
+        if (r + 1 < m)
+        {
+            minmax_array(x + r + 1, m - r - 1, &min, &max);
+        }
+        *hi = (double)min;
+    }
+}
+
+/**
+ * @brief Rank of the order statistic, floor(q * (m - 1)) for a probability q or k if q is nan.
+ */
+static inline size_t select_rank(size_t m, double q, size_t k)
+{
+    return isnan(q) ? k : (size_t)(q * (double)(m - 1));
+}
+
+/** @struct select_shared
+ *  @brief State of the parallel selection shared by its threads.
+ *  @param lock guards collected and overflow
+ *  @param collected capacity of the buffers of all threads
+ *  @param limit largest allowed collected
+ *  @param overflow true if the pivots keep too many values and the buffers were not enlarged
+ */
+struct select_shared
+{
+    pthread_mutex_t lock;
+    size_t collected;
+    size_t limit;
+    bool overflow;
+};
+
+/** @struct select_part
+ *  @brief Part of an array scanned by one thread of the parallel selection.
+ *  @param x values of the part
+ *  @param n number of values
+ *  @param low lower pivot
+ *  @param high upper pivot
+ *  @param shared state of all threads
+ *  @param below receives the number of values smaller than low
+ *  @param nan receives the number of nan values
+ *  @param mid receives the values from [low, high], allocated by the thread
+ *  @param mid_count receives the number of values in mid
+ *  @param complete receives false if the values did not fit into mid
+ */
+struct select_part
+{
+    const double *x;
+    size_t n;
+    double low, high;
+    struct select_shared *shared;
+    size_t below, nan;
+    double *mid;
+    size_t mid_count;
+    bool complete;
+};
+
+/**
+ * @brief Enlarges the buffer of a part, unless the parts together reached the limit.
+ * @return false if the buffer was not enlarged
+ */
+static bool select_part_grow(struct select_part *p, size_t *capacity)
+{
+    size_t extra = (*capacity < 4096) ? 4096 : *capacity;
+    pthread_mutex_lock(&p->shared->lock);
+    bool allowed = !p->shared->overflow && p->shared->collected + extra <= p->shared->limit;
+    p->shared->collected += allowed ? extra : 0;
+    p->shared->overflow = !allowed;
+    pthread_mutex_unlock(&p->shared->lock);
+    if (!allowed)
+    {
+        return false;
+    }
+    double *mid = realloc(p->mid, (*capacity + extra) * sizeof(double));
+    if (mid == NULL)
+    {
+        fprintf(stderr, "math_library - memory allocation error\n");
+        abort();
+    }
+    p->mid = mid;
+    *capacity += extra;
+    return true;
+}
+
+/**
+ * @brief Counts the values of a part below the pivots and collects the values between them.
+ */
+static void *select_part_thread(void *arg)
+{
+    struct select_part *p = arg;
+    size_t capacity = 0, below = 0, nan = 0, count = 0;
+    p->complete = true;
+    for (size_t i = 0; i < p->n; i++)
+    {
+        // every value is written, only those between the pivots are kept
+        if (count == capacity && !select_part_grow(p, &capacity))
+        {
+            p->complete = false;
+            break;
+        }
+        double v = p->x[i];
+        p->mid[count] = v;
+        count += (v >= p->low) & (v <= p->high);
+        below += v < p->low;
+        nan += v != v;
+    }
+    p->below = below;
+    p->nan = nan;
+    p->mid_count = count;
+    return NULL;
+}
+
+/**
+ * @brief Number of threads for the selection or sorting in an array of n values.
+ */
+static size_t select_thread_count(size_t n)
+{
+    if (n < SELECT_PARALLEL_MIN)
+    {
+        return 1;
+    }
+    long threads = select_threads;
+    if (threads == 0)
+    {
+        threads = sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    size_t max = n / SELECT_MIN_PER_THREAD;
+    if (threads < 1)
+    {
+        return 1;
+    }
+    return ((size_t)threads < max) ? (size_t)threads : max;
+}
+
+/**
+ * @brief Runs the thread function on every task, the last task in the calling thread.
+ * @param thread thread function
+ * @param tasks array of count tasks of task_size bytes
+ */
+static void run_threads(void *(*thread)(void *), void *tasks, size_t task_size, size_t count)
+{
+    pthread_t *ids = malloc(count * sizeof(pthread_t));
+    bool *started = calloc(count, sizeof(bool));
+    if (ids == NULL || started == NULL)
+    {
+        fprintf(stderr, "math_library - memory allocation error\n");
+        abort();
+    }
+    for (size_t i = 0; i + 1 < count; i++)
+    {
+        started[i] = (pthread_create(&ids[i], NULL, thread, (char *)tasks + i * task_size) == 0);
+        if (!started[i])
+        {
+            thread((char *)tasks + i * task_size);
+        }
+    }
+    thread((char *)tasks + (count - 1) * task_size);
+    for (size_t i = 0; i + 1 < count; i++)
+    {
+        if (started[i])
+        {
+            pthread_join(ids[i], NULL);
+        }
+    }
+    free(ids);
+    free(started);
+}
+
+/**
+ * @brief Order statistics of a large array found by several threads, x is not changed.
+ * @details The pivots are values of a sorted random sample a few standard deviations of the sample rank
+ * below and above the wanted rank. The threads count the values below the lower pivot and collect the
+ * values between the pivots, which are then selected serially. If the wanted ranks are not between the
+ * pivots or too many values are, the selection fails and the caller selects in the whole array.
+ * @param count receives the number of numbers, the values at the ranks are found only if there are such
+ * @return false if the selection failed
+ */
+static bool select_parallel(const double *x, size_t n, size_t threads, double q, size_t k, double *lo,
+                            double *hi, size_t *count)
+{
+    // sample of the numbers at pseudo-random positions
+    size_t size = n / 64 < SELECT_SAMPLE_MAX ? n / 64 : SELECT_SAMPLE_MAX;
+    double *sample = malloc(size * sizeof(double));
+    if (sample == NULL)
+    {
+        fprintf(stderr, "math_library - memory allocation error\n");
+        abort();
+    }
+    size_t numbers = 0;
+    unsigned long long seed = 1;
+    for (size_t i = 0; i < size; i++)
+    {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        double v = x[(seed >> 11) % n];
+        sample[numbers] = v;
+        numbers += !isnan(v);
+    }
+    if (numbers == 0)
+    {
+        free(sample);
+        return false;
+    }
+    sort_doubles(sample, numbers);
+    double fraction = isnan(q) ? (double)k / ((double)n * numbers / size) : q;
+    double center = (fraction < 1.0) ? fraction * (numbers - 1) : numbers - 1.0;
+    double gap = SELECT_SAMPLE_GAP * sqrt((double)numbers) + 1.0;
+    struct select_shared shared = {.collected = 0, .overflow = false};
+    pthread_mutex_init(&shared.lock, NULL);
+    double low = (center - gap <= 0.0) ? -INFINITY : sample[(size_t)(center - gap)];
+    double high = (center + gap >= numbers - 1) ? INFINITY : sample[(size_t)(center + gap)];
+    double expected = (center + gap >= numbers - 1 ? numbers : center + gap + 1.0) -
+                      (center - gap <= 0.0 ? 0.0 : center - gap);
+    shared.limit = (size_t)(4.0 * expected / numbers * n) + threads * 8192;
+    free(sample);
+
+    // parts of the array scanned by the threads
+    struct select_part *parts = malloc(threads * sizeof(struct select_part));
+    if (parts == NULL)
+    {
+        fprintf(stderr, "math_library - memory allocation error\n");
+        abort();
+    }
+    size_t step = (n + threads - 1) / threads;
+    for (size_t i = 0; i < threads; i++)
+    {
+        size_t begin = (i * step < n) ? i * step : n;
+        size_t end = (begin + step < n) ? begin + step : n;
+        struct select_part p = {x + begin, end - begin, low, high, &shared, 0, 0, NULL, 0, false};
+        parts[i] = p;
+    }
+    run_threads(select_part_thread, parts, sizeof(struct select_part), threads);
+    pthread_mutex_destroy(&shared.lock);
+
+    // the ranks must be among the collected values, the maximum if it is needed too
+    bool complete = true;
+    size_t below = 0, nan = 0, mid = 0;
+    for (size_t i = 0; i < threads; i++)
+    {
+        complete = complete && parts[i].complete;
+        below += parts[i].below;
+        nan += parts[i].nan;
+        mid += parts[i].mid_count;
+    }
+    size_t m = n - nan;
+    size_t r = select_rank(m, q, k);
+    bool ok = complete && (m == 0 || r >= m || (below <= r && r < below + mid &&
+                                                 (hi == NULL || r + 1 == m || r + 1 < below + mid)));
+    *count = m;
+    if (ok && m > 0 && r < m)
+    {
+        double *values = malloc(mid * sizeof(double));
+        if (values == NULL)
+        {
+            fprintf(stderr, "math_library - memory allocation error\n");
+            abort();
+        }
+        size_t filled = 0;
+        for (size_t i = 0; i < threads; i++)
+        {
+            memcpy(values + filled, parts[i].mid, parts[i].mid_count * sizeof(double));
+            filled += parts[i].mid_count;
+        }
+        select_pair(values, mid, r - below, lo, hi);
+        free(values);
+    }
+    for (size_t i = 0; i < threads; i++)
+    {
+        free(parts[i].mid);
+    }
+    free(parts);
+    return ok;
+}
+
+/**
+ * @brief Order statistics of the m numbers of x at rank r = select_rank(m, q, k) and r + 1.
+ * @param hi receives the value at rank r + 1 (at rank r for the maximum), NULL if it is not needed
+ * @param count receives m
+ * @return false if there is no number at rank r
+ */
+static bool order_statistics(double *x, size_t n, double q, size_t k, double *lo, double *hi, size_t *count)
+{
+    size_t threads = select_thread_count(n);
+    if (threads <= 1 || !select_parallel(x, n, threads, q, k, lo, hi, count))
+    {
+        *count = move_nan_back(x, n);
+        if (*count > 0 && select_rank(*count, q, k) < *count)
+        {
+            select_pair(x, *count, select_rank(*count, q, k), lo, hi);
+        }
+    }
+    return *count > 0 && select_rank(*count, q, k) < *count;
+}
+
+double select_kth(double *x, size_t n, size_t k)
+{
+    double lo;
+    size_t count;
+    return order_statistics(x, n, NAN, k, &lo, NULL, &count) ? lo : NAN;
+}
+
+double median_array(double *x, size_t n)
+{
+    return quantile_array(x, n, 0.5);
+}
+
+double quantile_array(double *x, size_t n, double q)
+{
+    double lo, hi;
+    size_t count;
+    if (!(q >= 0.0 && q <= 1.0) || !order_statistics(x, n, q, 0, &lo, &hi, &count))
+    {
+        return NAN;
+    }
+    double position = q * (double)(count - 1);
+    double fraction = position - floor(position);
+    if (fraction == 0.0 || lo == hi)
+    {
+        return lo;
+    }
+    double d = hi - lo;
+    return isfinite(d) ? lo + fraction * d : (1.0 - fraction) * lo + fraction * hi;
+}
+
+#define SORT_RADIX_BITS 11 // bits of a digit of the radix sort
+#define SORT_RADIX (1 << SORT_RADIX_BITS)
+#define SORT_PASSES 6      // digits of a 64-bit key
+#define SORT_SMALL 256     // longest array sorted by comparisons
+
+/** @struct sort_part
+ *  @brief Part of an array counted and scattered by one thread of the radix sort.
+ *  @param src values of the current pass
+ *  @param dst receives the values ordered by the digit of the pass
+ *  @param begin first value of the part
+ *  @param end value after the last one
+ *  @param pass index of the digit, from the least significant one
+ *  @param count number of values of the part with every digit, for every pass
+ *  @param offset position in dst of the next value of the part with every digit
+ */
+struct sort_part
+{
+    const double *src;
+    double *dst;
+    size_t begin, end;
+    int pass;
+    size_t count[SORT_PASSES][SORT_RADIX];
+    size_t offset[SORT_RADIX];
+};
+
+/**
+ * @brief Key ordered as the number: the sign bit is flipped for positive numbers, all bits for negative ones.
+ */
+static inline unsigned long long sort_key(double v)
+{
+    unsigned long long bits;
+    memcpy(&bits, &v, sizeof(bits));
+    return (bits >> 63) ? ~bits : bits | (1ULL << 63);
+}
+
+/**
+ * @brief Thread function, counts the digits in a part (struct sort_part), of all passes if pass is negative.
+ */
+static void *sort_count_thread(void *arg)
+{
+    struct sort_part *p = arg;
+    if (p->pass >= 0)
+    {
+        int shift = p->pass * SORT_RADIX_BITS;
+        memset(p->count[p->pass], 0, sizeof(p->count[p->pass]));
+        for (size_t i = p->begin; i < p->end; i++)
+        {
+            p->count[p->pass][(sort_key(p->src[i]) >> shift) & (SORT_RADIX - 1)]++;
+        }
+        return NULL;
+    }
+    for (size_t i = p->begin; i < p->end; i++)
+    {
+        unsigned long long key = sort_key(p->src[i]);
+        for (int d = 0; d < SORT_PASSES; d++)
+        {
+            p->count[d][(key >> (d * SORT_RADIX_BITS)) & (SORT_RADIX - 1)]++;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Thread function, moves the values of a part to their places for the digit of the pass.
+ */
+static void *sort_scatter_thread(void *arg)
+{
+    struct sort_part *p = arg;
+    int shift = p->pass * SORT_RADIX_BITS;
+    for (size_t i = p->begin; i < p->end; i++)
+    {
+        double v = p->src[i];
+        p->dst[p->offset[(sort_key(v) >> shift) & (SORT_RADIX - 1)]++] = v;
+    }
+    return NULL;
+}
+
+void sort_array(double *x, size_t n)
+{
+    size_t m = move_nan_back(x, n);
+    if (m <= SORT_SMALL)
+    {
+        sort_doubles(x, m);
+        return;
+    }
+    size_t threads = select_thread_count(m);
+    struct sort_part *parts = calloc(threads, sizeof(struct sort_part));
+    double *scratch = malloc(m * sizeof(double));
+    if (parts == NULL || scratch == NULL)
+    {
+        fprintf(stderr, "math_library - memory allocation error\n");
+        abort();
+    }
+    for (size_t i = 0; i < threads; i++)
+    {
+        parts[i].src = x;
+        parts[i].begin = m / threads * i;
+        parts[i].end = (i + 1 == threads) ? m : m / threads * (i + 1);
+        parts[i].pass = -1;
+    }
+    run_threads(sort_count_thread, parts, sizeof(struct sort_part), threads);
+
+    double *src = x, *dst = scratch;
+    bool scattered = false;
+    for (int d = 0; d < SORT_PASSES; d++)
+    {
+        // a digit shared by all numbers does not change the order
+        bool shared = false;
+        for (size_t digit = 0; digit < SORT_RADIX && !shared; digit++)
+        {
+            size_t total = 0;
+            for (size_t i = 0; i < threads; i++)
+            {
+                total += parts[i].count[d][digit];
+            }
+            shared = (total == m);
+        }
+        if (shared)
+        {
+            continue;
+        }
+        for (size_t i = 0; i < threads; i++)
+        {
+            parts[i].src = src;
+            parts[i].dst = dst;
+            parts[i].pass = d;
+        }
+        // the parts hold other values after the first scatter, their digits are counted again
+        if (threads > 1 && scattered)
+        {
+            run_threads(sort_count_thread, parts, sizeof(struct sort_part), threads);
+        }
+        // digits in increasing order and parts in order within a digit, so every pass is stable
+        size_t total = 0;
+        for (size_t digit = 0; digit < SORT_RADIX; digit++)
+        {
+            for (size_t i = 0; i < threads; i++)
+            {
+                parts[i].offset[digit] = total;
+                total += parts[i].count[d][digit];
+            }
+        }
+        run_threads(sort_scatter_thread, parts, sizeof(struct sort_part), threads);
+        scattered = true;
+        double *t = src;
+        src = dst;
+        dst = t;
+    }
+    if (src != x)
+    {
+        memcpy(x, src, m * sizeof(double));
+    }
+    free(parts);
+    free(scratch);
+}
+
+#define HIST_BLOCK 4096 // values whose bins are computed at once
+#define HIST_TABLES 4   // count tables of a block, consecutive values go to different tables
+
+typedef int hist_index __attribute__((vector_size(8))); // slots of two values of a sum_vec
+
+bool histogram_init(histogram_t *h, int mode, size_t bins, double low, double high)
+{
+    if (bins < 1 || bins > HIST_MAX_BINS || mode < HIST_LINEAR || mode > HIST_ADAPTIVE)
+    {
+        return false;
+    }
+    h->mode = mode;
+    h->bins = bins;
+    h->low = 0.0;
+    h->width = 0.0;
+    if (mode != HIST_ADAPTIVE)
+    {
+        if (!(low < high) || !isfinite(low) || !isfinite(high) || (mode == HIST_LOG && !(low > 0.0)))
+        {
+            return false;
+        }
+        h->low = (mode == HIST_LOG) ? log2(low) : low;
+        h->width = ((mode == HIST_LOG) ? log2(high) - h->low : high - low) / bins;
+        if (!isfinite(h->width) || !(h->width > 0.0))
+        {
+            return false;
+        }
+    }
+    h->below = 0;
+    h->above = 0;
+    memset(h->count, 0, sizeof(h->count));
+    return true;
+}
+
+/**
+ * @brief Doubles the width of the bins of an adaptive histogram, the first bin starts at a multiple of it.
+ */
+static void histogram_widen(histogram_t *h)
+{
+    double width = 2.0 * h->width;
+    double low = floor(h->low / width) * width;
+    size_t shift = (low < h->low); // the first bin becomes the upper half of a new one
+    unsigned long long count[HIST_MAX_BINS] = {0};
+    for (size_t i = 0; i < h->bins; i++)
+    {
+        count[(i + shift) / 2] += h->count[i];
+    }
+    memcpy(h->count, count, sizeof(count));
+    h->low = low;
+    h->width = width;
+}
+
+/**
+ * @brief Finds the first and one past the last nonempty bins, they are equal for an empty histogram.
+ */
+static void histogram_used(const histogram_t *h, size_t *first, size_t *last)
+{
+    for (*first = 0; *first < h->bins && h->count[*first] == 0; (*first)++)
+    {
+    }
+    for (*last = h->bins; *last > *first && h->count[*last - 1] == 0; (*last)--)
+    {
+    }
+}
+
+/**
+ * @brief Moves the bins of an adaptive histogram by whole bins to cover the finite values from min to max
+ * along with its nonempty bins.
+ * @details The test of the upper end uses the same rounding as histogram_slots, so no covered value is
+ * counted above the bins.
+ * @return false if the values and the nonempty bins do not fit into the bins of the current width
+ */
+static bool histogram_place(histogram_t *h, double min, double max)
+{
+    size_t first, last;
+    histogram_used(h, &first, &last);
+    if (first < last)
+    {
+        min = fmin(min, h->low + first * h->width);
+        max = fmax(max, h->low + (last - 1) * h->width);
+    }
+    double scale = 1.0 / h->width;
+    double low = (min < h->low || (max - h->low) * scale + 1.0 >= h->bins + 1.0) ? floor(min * scale) * h->width
+                                                                                  : h->low;
+    if ((max - low) * scale + 1.0 >= h->bins + 1.0)
+    {
+        return false;
+    }
+    if (low != h->low && first < last)
+    {
+        // the nonempty bins stay inside the moved ones, first + offset is not negative
+        long long offset = llround((h->low - low) * scale);
+        unsigned long long count[HIST_MAX_BINS] = {0};
+        memcpy(count + first + offset, h->count + first, (last - first) * sizeof(count[0]));
+        memcpy(h->count, count, sizeof(count));
+    }
+    h->low = low;
+    return true;
+}
+
+/**
+ * @brief Widens an adaptive histogram until its bins cover the finite values from min to max.
+ */
+static void histogram_cover(histogram_t *h, double min, double max)
+{
+    if (h->width == 0.0)
+    {
+        // the first values give a power of two near their spread per bin
+        double spread = max / h->bins - min / h->bins;
+        double scale = (fabs(min) > fabs(max)) ? fabs(min) : fabs(max);
+        double width = (spread > 0.0) ? spread : ((scale > 0.0) ? scale : 1.0) / (1 << 20);
+        int exponent = ilogb(width) + 1;
+        h->width = ldexp(1.0, (exponent > DBL_MAX_EXP - 12) ? DBL_MAX_EXP - 12 : exponent);
+        h->low = floor(min / h->width) * h->width;
+    }
+    while (!histogram_place(h, min, max) && isfinite(4.0 * h->bins * h->width))
+    {
+        histogram_widen(h);
+    }
+}
+
+/**
+ * @brief Slots of values in the count tables: 0 below the bins, 1 to bins the bins, bins + 1 above them
+ * and bins + 2 for nan.
+ * @param scale reciprocal of the width of a bin
+ */
+static void histogram_slots(const double *x, size_t n, double low, double scale, size_t bins, int *slots)
+{
+    sum_vec lo = {low, low}, sc = {scale, scale}, one = {1.0, 1.0};
+    sum_vec top = {bins + 1.0, bins + 1.0}, nan_slot = {bins + 2.0, bins + 2.0};
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2)
+    {
+        sum_vec t = (sum_load(x + i) - lo) * sc + one;
+        sum_mask below = t < one, above = t >= top, nan = t != t;
+        t = (sum_vec)(~below & (sum_mask)t);
+        t = (sum_vec)((above & (sum_mask)top) | (~above & (sum_mask)t));
+        t = (sum_vec)((nan & (sum_mask)nan_slot) | (~nan & (sum_mask)t));
+        hist_index k = __builtin_convertvector(t, hist_index);
+        memcpy(slots + i, &k, sizeof(k));
+    }
+    for (; i < n; i++)
+    {
+        double t = (x[i] - low) * scale + 1.0;
+        slots[i] = (t != t) ? (int)bins + 2 : (t < 1.0) ? 0 : (t >= bins + 1.0) ? (int)bins + 1 : (int)t;
+    }
+}
+
+/**
+ * @brief Finds the smallest and largest finite values.
+ * @return false if there are no finite values
+ */
+static bool finite_range(const double *x, size_t n, double *min, double *max)
+{
+    long double lo, hi;
+    minmax_array(x, n, &lo, &hi);
+    if (isfinite(lo) && isfinite(hi))
+    {
+        *min = (double)lo;
+        *max = (double)hi;
+        return true;
+    }
+    // infinite values or no numbers, the rare case is scanned again
+    bool found = false;
+    for (size_t i = 0; i < n; i++)
+    {
+        if (isfinite(x[i]))
+        {
+            *min = (!found || x[i] < *min) ? x[i] : *min;
+            *max = (!found || x[i] > *max) ? x[i] : *max;
+            found = true;
+        }
+    }
+    return found;
+}
+
+void histogram_add_array(histogram_t *h, const double *x, size_t n)
+{
+    unsigned tables[HIST_TABLES][HIST_MAX_BINS + 3];
+    int slots[HIST_BLOCK];
+    double logs[HIST_BLOCK];
+    for (size_t start = 0; start < n; start += HIST_BLOCK)
+    {
+        size_t len = (n - start < HIST_BLOCK) ? n - start : HIST_BLOCK;
+        const double *b = x + start;
+        double min = 0.0, max = 0.0;
+        if (h->mode == HIST_LOG)
+        {
+            for (size_t i = 0; i < len; i++)
+            {
+                logs[i] = (b[i] > 0.0) ? log2(b[i]) : (b[i] <= 0.0) ? -INFINITY : b[i];
+            }
+            b = logs;
+        }
+        else if (h->mode == HIST_ADAPTIVE && finite_range(b, len, &min, &max))
+        {
+            histogram_cover(h, min, max);
+        }
+        if (h->width == 0.0)
+        {
+            // an adaptive histogram without finite values counts only the infinities
+            for (size_t i = 0; i < len; i++)
+            {
+                h->below += (b[i] == -INFINITY);
+                h->above += (b[i] == INFINITY);
+            }
+            continue;
+        }
+
+        histogram_slots(b, len, h->low, 1.0 / h->width, h->bins, slots);
+        for (int t = 0; t < HIST_TABLES; t++)
+        {
+            memset(tables[t], 0, (h->bins + 3) * sizeof(unsigned));
+        }
+        size_t i = 0;
+        for (; i + HIST_TABLES <= len; i += HIST_TABLES)
+        {
+            tables[0][slots[i]]++;
+            tables[1][slots[i + 1]]++;
+            tables[2][slots[i + 2]]++;
+            tables[3][slots[i + 3]]++;
+        }
+        for (; i < len; i++)
+        {
+            tables[0][slots[i]]++;
+        }
+        for (size_t j = 0; j < h->bins + 2; j++)
+        {
+            unsigned long long c = (unsigned long long)tables[0][j] + tables[1][j] + tables[2][j] + tables[3][j];
+            if (j == 0)
+            {
+                h->below += c;
+            }
+            else if (j <= h->bins)
+            {
+                h->count[j - 1] += c;
+            }
+            else
+            {
+                h->above += c;
+            }
+        }
+    }
+}
+
+bool histogram_merge(histogram_t *h, const histogram_t *u)
+{
+    if (h->mode != u->mode || h->bins != u->bins ||
+        (h->mode != HIST_ADAPTIVE && (h->low != u->low || h->width != u->width)))
+    {
+        return false;
+    }
+    h->below += u->below;
+    h->above += u->above;
+    if (h->mode != HIST_ADAPTIVE)
+    {
+        for (size_t i = 0; i < h->bins; i++)
+        {
+            h->count[i] += u->count[i];
+        }
+        return true;
+    }
+    if (u->width == 0.0)
+    {
+        return true;
+    }
+    if (h->width == 0.0)
+    {
+        h->low = u->low;
+        h->width = u->width;
+        memcpy(h->count, u->count, sizeof(h->count));
+        return true;
+    }
+
+    // both get the same width and the bins of h are moved or widened to cover the nonempty bins of u
+    histogram_t v = *u;
+    size_t first, last;
+    while (true)
+    {
+        while (v.width < h->width)
+        {
+            histogram_widen(&v);
+        }
+        histogram_used(&v, &first, &last);
+        if (first == last)
+        {
+            return true;
+        }
+        if ((h->width == v.width &&
+             histogram_place(h, v.low + first * v.width, v.low + (last - 1) * v.width)) ||
+            !isfinite(4.0 * h->bins * h->width))
+        {
+            break;
+        }
+        histogram_widen(h);
+    }
+    long long offset = llround((v.low - h->low) / h->width);
+    for (size_t i = first; i < last; i++)
+    {
+        long long j = (long long)i + offset;
+        if (j < 0)
+        {
+            h->below += v.count[i];
+        }
+        else if (j >= (long long)h->bins)
+        {
+            h->above += v.count[i];
+        }
+        else
+        {
+            h->count[j] += v.count[i];
+        }
+    }
+    return true;
+}
+
+double histogram_edge(const histogram_t *h, size_t i)
+{
+    if (h->width == 0.0)
+    {
+        return NAN;
+    }
+    double edge = h->low + i * h->width;
+    return (h->mode == HIST_LOG) ? exp2(edge) : edge;
+}
+
+unsigned long long histogram_count(const histogram_t *h)
+{
+    unsigned long long count = h->below + h->above;
+    for (size_t i = 0; i < h->bins; i++)
+    {
+        count += h->count[i];
+    }
+    return count;
+}
+
+bool window_init(window_t *w, size_t size)
+{
+    if (size == 0)
+    {
+        return false;
+    }
+    w->size = size;
+    w->added = 0;
+    w->next = 0;
+    w->values = malloc(size * sizeof(double));
+    w->low = malloc(size * sizeof(size_t));
+    w->high = malloc(size * sizeof(size_t));
+    if (w->values == NULL || w->low == NULL || w->high == NULL)
+    {
+        fprintf(stderr, "math_library - memory allocation error\n");
+        abort();
+    }
+    w->low_head = 0;
+    w->low_len = 0;
+    w->high_head = 0;
+    w->high_len = 0;
+    w->finite = 0;
+    w->mean = 0.0L;
+    w->m2 = 0.0L;
+    w->peak = 0.0L;
+    return true;
+}
+
+/**
+ * @brief Index of a monotonic queue i places after its oldest slot.
+ */
+static inline size_t window_index(const window_t *w, size_t head, size_t i)
+{
+    return (head + i < w->size) ? head + i : head + i - w->size;
+}
+
+/**
+ * @brief Removes the oldest slot of a monotonic queue if it is the slot of the value leaving the window.
+ */
+static inline void window_expire(const window_t *w, const size_t *queue, size_t *head, size_t *len)
+{
+    if (*len > 0 && queue[*head] == w->next)
+    {
+        *head = window_index(w, *head, 1);
+        (*len)--;
+    }
+}
+
+/**
+ * @brief Appends the slot of the new value to a monotonic queue, the slots of the values it dominates are
+ * removed from the back first.
+ * @param greater true for the queue of the maximum, false for the minimum
+ */
+static inline void window_push(const window_t *w, size_t *queue, size_t head, size_t *len, bool greater)
+{
+    double x = w->values[w->next];
+    while (*len > 0)
+    {
+        double back = w->values[queue[window_index(w, head, *len - 1)]];
+        if (greater ? back > x : back < x)
+        {
+            break;
+        }
+        (*len)--;
+    }
+    queue[window_index(w, head, *len)] = w->next;
+    (*len)++;
+}
+
+/**
+ * @brief Recomputes the moments of the finite values of the window in two passes.
+ */
+static void window_recompute(window_t *w)
+{
+    size_t n = (w->added < w->size) ? (size_t)w->added : w->size;
+    long double sum = 0.0L;
+    size_t finite = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        if (isfinite(w->values[i]))
+        {
+            sum += w->values[i];
+            finite++;
+        }
+    }
+    long double mean = (finite > 0) ? sum / finite : 0.0L, m2 = 0.0L;
+    for (size_t i = 0; i < n; i++)
+    {
+        if (isfinite(w->values[i]))
+        {
+            m2 += (w->values[i] - mean) * (w->values[i] - mean);
+        }
+    }
+    w->finite = finite;
+    w->mean = mean;
+    w->m2 = m2;
+    w->peak = m2;
+}
+
+void window_add(window_t *w, double x)
+{
+    bool full = (w->added >= w->size);
+    double y = full ? w->values[w->next] : NAN;
+    if (full)
+    {
+        window_expire(w, w->low, &w->low_head, &w->low_len);
+        window_expire(w, w->high, &w->high_head, &w->high_len);
+    }
+    if (isfinite(x) && isfinite(y))
+    {
+        // the new value replaces the oldest one
+        long double delta = (long double)x - y, mean = w->mean;
+        w->mean += delta / w->finite;
+        w->m2 += delta * ((x - w->mean) + (y - mean));
+        w->m2 = (w->m2 < 0.0L) ? 0.0L : w->m2;
+    }
+    else if (isfinite(y))
+    {
+        w->finite--;
+        long double delta = y - w->mean;
+        w->mean -= (w->finite > 0) ? delta / w->finite : w->mean;
+        w->m2 -= delta * (y - w->mean);
+        w->m2 = (w->m2 < 0.0L || w->finite == 0) ? 0.0L : w->m2;
+    }
+    else if (isfinite(x))
+    {
+        w->finite++;
+        long double delta = x - w->mean;
+        w->mean += delta / w->finite;
+        w->m2 += delta * (x - w->mean);
+    }
+    w->peak = (w->m2 > w->peak) ? w->m2 : w->peak;
+
+    w->values[w->next] = x;
+    if (!isnan(x))
+    {
+        window_push(w, w->low, w->low_head, &w->low_len, false);
+        window_push(w, w->high, w->high_head, &w->high_len, true);
+    }
+    w->added++;
+    w->next = (w->next + 1 < w->size) ? w->next + 1 : 0;
+    // the rounding errors of the removals are relative to the largest m2
+    if (w->next == 0 || w->m2 * WINDOW_DRIFT < w->peak)
+    {
+        window_recompute(w);
+    }
+}
+
+void window_get(const window_t *w, stats_t *r)
+{
+    stats_init(r);
+    r->count = (w->added < w->size) ? w->added : w->size;
+    r->mean = (w->finite == r->count) ? w->mean : NAN;
+    r->m2 = (w->finite == r->count) ? w->m2 : NAN;
+    r->min = (w->low_len > 0) ? w->values[w->low[w->low_head]] : NAN;
+    r->max = (w->high_len > 0) ? w->values[w->high[w->high_head]] : NAN;
+}
+
+void window_free(window_t *w)
+{
+    free(w->values);
+    free(w->low);
+    free(w->high);
+}
+
+#define DIST_PI 3.141592653589793238462643383279502884L
+#define DIST_SQRT_2PI 2.506628274631000502415765284811045253L // sqrt(2 * pi)
+#define DIST_SQRT_HALF 0.707106781186547524400844362104849039L // sqrt(1 / 2)
+#define DIST_QUANTILE_STEPS 2 // Halley steps that refine the approximation of the normal quantile
+#define DIST_STIRLING_MIN 15  // largest n whose Stirling error is computed from lgamma instead of the series
+
+/**
+ * @brief Error of Stirling's formula, ln(n!) - (n + 1/2) ln(n) + n - ln(sqrt(2 pi)), for n > 0
+ */
+static long double stirling_error(unsigned long n)
+{
+    if (n <= DIST_STIRLING_MIN)
+    {
+        return lgammal(n + 1.0L) - (n + 0.5L) * logl(n) + n - 0.5L * logl(2.0L * DIST_PI);
+    }
+    long double nn = (long double)n * n;
+    return (1.0L / 12 - (1.0L / 360 - (1.0L / 1260 - (1.0L / 1680 - 1.0L / (1188 * nn)) / nn) / nn) / nn) / n;
+}
+
+/**
+ * @brief Deviance term x ln(x / m) + m - x, by a series when x is close to m to avoid the cancellation
+ */
+static long double deviance_term(long double x, long double m)
+{
+    if (fabsl(x - m) < 0.1L * (x + m))
+    {
+        long double v = (x - m) / (x + m);
+        long double sum = (x - m) * v;
+        long double term = 2.0L * x * v;
+        v *= v;
+        for (int j = 1;; j++)
+        {
+            term *= v;
+            long double next = sum + term / (2 * j + 1);
+            if (next == sum)
+            {
+                return sum;
+            }
+            sum = next;
+        }
+    }
+    return x * logl(x / m) + m - x;
+}
+
+long double log_comb(unsigned long n, unsigned long k)
+{
+    if (k > n)
+    {
+        return -INFINITY;
+    }
+    if (k == 0 || k == n)
+    {
+        return 0.0L;
+    }
+    // Stirling's formula with its error, the logarithms of n! do not cancel
+    unsigned long rest = n - k;
+    return k * logl((long double)n / k) + rest * logl((long double)n / rest) +
+           0.5L * logl(n / (2.0L * DIST_PI * k * rest)) + stirling_error(n) - stirling_error(k) -
+           stirling_error(rest);
+}
+
+/**
+ * @brief Checks a probability, false for nan
+ */
+static bool probability_valid(long double p)
+{
+    return p >= 0.0L && p <= 1.0L;
+}
+
+/**
+ * @brief Most probable number of successes, the terms grow up to it and fall after it
+ */
+static unsigned long binomial_mode(unsigned long n, long double p)
+{
+    long double mode = floorl((n + 1.0L) * p);
+    return (mode >= n) ? n : (unsigned long)mode;
+}
+
+/**
+ * @brief Logarithm of the binomial pmf for 0 < p < 1 and k <= n
+ * @details The saddle point form of C. Loader, the large terms of the logarithm cancel exactly.
+ */
+static long double binomial_log_pmf(unsigned long k, unsigned long n, long double p)
+{
+    if (k == 0 || k == n)
+    {
+        return n * ((k == 0) ? log1pl(-p) : logl(p));
+    }
+    unsigned long rest = n - k;
+    return stirling_error(n) - stirling_error(k) - stirling_error(rest) - deviance_term(k, n * p) -
+           deviance_term(rest, n * (1.0L - p)) + 0.5L * logl(n / (2.0L * DIST_PI * k * rest));
+}
+
+/**
+ * @brief P(X <= k) for 0 < p < 1 and k below the mode, summed from k down while the terms matter
+ */
+static long double binomial_lower(unsigned long k, unsigned long n, long double p)
+{
+    long double odds = p / (1.0L - p);
+    long double term = 1.0L; // relative to P(X = k)
+    long double sum = 1.0L;
+    for (unsigned long j = k; j > 0 && term > sum * LDBL_EPSILON; j--)
+    {
+        term *= j / ((n - j + 1.0L) * odds);
+        sum += term;
+    }
+    return expl(binomial_log_pmf(k, n, p)) * sum;
+}
+
+/**
+ * @brief P(X > k) for 0 < p < 1 and k from the mode to n - 1, summed from k + 1 up while the terms matter
+ */
+static long double binomial_upper(unsigned long k, unsigned long n, long double p)
+{
+    long double odds = p / (1.0L - p);
+    long double term = 1.0L; // relative to P(X = k + 1)
+    long double sum = 1.0L;
+    for (unsigned long j = k + 1; j < n && term > sum * LDBL_EPSILON; j++)
+    {
+        term *= (n - j) * odds / (j + 1.0L);
+        sum += term;
+    }
+    return expl(binomial_log_pmf(k + 1, n, p)) * sum;
+}
+
+long double binomial_pmf(unsigned long k, unsigned long n, long double p)
+{
+    if (!probability_valid(p))
+    {
+        return NAN;
+    }
+    if (k > n)
+    {
+        return 0.0L;
+    }
+    if (p == 0.0L || p == 1.0L)
+    {
+        return (k == ((p == 0.0L) ? 0 : n)) ? 1.0L : 0.0L;
+    }
+    return expl(binomial_log_pmf(k, n, p));
+}
+
+long double binomial_cdf(unsigned long k, unsigned long n, long double p)
+{
+    if (!probability_valid(p))
+    {
+        return NAN;
+    }
+    if (k >= n || p == 0.0L)
+    {
+        return 1.0L;
+    }
+    if (p == 1.0L)
+    {
+        return 0.0L;
+    }
+    return (k < binomial_mode(n, p)) ? binomial_lower(k, n, p) : 1.0L - binomial_upper(k, n, p);
+}
+
+long double binomial_quantile(long double q, unsigned long n, long double p)
+{
+    if (!probability_valid(q) || !probability_valid(p))
+    {
+        return NAN;
+    }
+    if (q == 0.0L || p == 0.0L)
+    {
+        return 0.0L;
+    }
+    if (q == 1.0L || p == 1.0L)
+    {
+        return n;
+    }
+
+    // the normal approximation is a few steps from the result
+    long double mean = n * p;
+    long double guess = floorl(mean + sqrtl(mean * (1.0L - p)) * normal_quantile(q, 0.0L, 1.0L) + 0.5L);
+    unsigned long k = (guess <= 0.0L) ? 0 : (guess >= n) ? n : (unsigned long)guess;
+    long double odds = p / (1.0L - p);
+    long double cdf = binomial_cdf(k, n, p);
+    long double term = binomial_pmf(k, n, p);
+    if (cdf >= q)
+    {
+        while (k > 0 && cdf - term >= q)
+        {
+            cdf -= term;
+            term *= k / ((n - k + 1.0L) * odds);
+            k--;
+        }
+    }
+    else
+    {
+        while (cdf < q && k < n)
+        {
+            term *= (n - k) * odds / (k + 1.0L);
+            cdf += term;
+            k++;
+        }
+    }
+    return k;
+}
+
+void binomial_pmf_array(unsigned long n, long double p, double *out)
+{
+    if (!probability_valid(p) || p == 0.0L || p == 1.0L)
+    {
+        for (unsigned long k = 0; k <= n; k++)
+        {
+            out[k] = binomial_pmf(k, n, p);
+        }
+        return;
+    }
+
+    long double odds = p / (1.0L - p);
+    unsigned long mode = binomial_mode(n, p);
+    long double top = expl(binomial_log_pmf(mode, n, p));
+    out[mode] = top;
+    // once a term underflows in double the rest are 0, storing them would be slow
+    long double term = top;
+    unsigned long k = mode;
+    for (; k < n && out[k] != 0.0; k++)
+    {
+        term *= (n - k) * odds / (k + 1.0L);
+        out[k + 1] = term;
+    }
+    for (; k < n; k++)
+    {
+        out[k + 1] = 0.0;
+    }
+    term = top;
+    for (k = mode; k > 0 && out[k] != 0.0; k--)
+    {
+        term *= k / ((n - k + 1.0L) * odds);
+        out[k - 1] = term;
+    }
+    for (; k > 0; k--)
+    {
+        out[k - 1] = 0.0;
+    }
+}
+
+void binomial_cdf_array(unsigned long n, long double p, double *out)
+{
+    binomial_pmf_array(n, p, out);
+    if (!probability_valid(p))
+    {
+        return;
+    }
+
+    // sums from both ends, so that each cdf is summed from its smaller tail
+    unsigned long mode = binomial_mode(n, p);
+    long double sum = 0.0L;
+    for (unsigned long k = n; k > mode; k--)
+    {
+        long double term = out[k];
+        out[k] = 1.0L - sum;
+        sum += term;
+    }
+    out[mode] = 1.0L - sum;
+    sum = 0.0L;
+    for (unsigned long k = 0; k < mode; k++)
+    {
+        sum += out[k];
+        out[k] = sum;
+    }
+}
+
+/**
+ * @brief Checks the mean of a Poisson distribution, false for nan
+ */
+static bool poisson_valid(long double lambda)
+{
+    return lambda >= 0.0L && isfinite(lambda);
+}
+
+/**
+ * @brief Most probable number of events
+ */
+static unsigned long poisson_mode(long double lambda)
+{
+    return (lambda >= ULONG_MAX) ? ULONG_MAX : (unsigned long)lambda;
+}
+
+/**
+ * @brief Logarithm of the Poisson pmf for lambda > 0, in the saddle point form
+ */
+static long double poisson_log_pmf(unsigned long k, long double lambda)
+{
+    if (k == 0)
+    {
+        return -lambda;
+    }
+    return -stirling_error(k) - deviance_term(k, lambda) - 0.5L * logl(2.0L * DIST_PI * k);
+}
+
+/**
+ * @brief P(X <= k) for lambda > 0 and k below the mode
+ */
+static long double poisson_lower(unsigned long k, long double lambda)
+{
+    long double term = 1.0L; // relative to P(X = k)
+    long double sum = 1.0L;
+    for (unsigned long j = k; j > 0 && term > sum * LDBL_EPSILON; j--)
+    {
+        term *= j / lambda;
+        sum += term;
+    }
+    return expl(poisson_log_pmf(k, lambda)) * sum;
+}
+
+/**
+ * @brief P(X > k) for lambda > 0 and k from the mode up
+ */
+static long double poisson_upper(unsigned long k, long double lambda)
+{
+    if (k == ULONG_MAX)
+    {
+        return 0.0L;
+    }
+    long double term = 1.0L; // relative to P(X = k + 1)
+    long double sum = 1.0L;
+    for (unsigned long j = k + 1; j < ULONG_MAX && term > sum * LDBL_EPSILON; j++)
+    {
+        term *= lambda / (j + 1.0L);
+        sum += term;
+    }
+    return expl(poisson_log_pmf(k + 1, lambda)) * sum;
+}
+
+long double poisson_pmf(unsigned long k, long double lambda)
+{
+    if (!poisson_valid(lambda))
+    {
+        return NAN;
+    }
+    if (lambda == 0.0L)
+    {
+        return (k == 0) ? 1.0L : 0.0L;
+    }
+    return expl(poisson_log_pmf(k, lambda));
+}
+
+long double poisson_cdf(unsigned long k, long double lambda)
+{
+    if (!poisson_valid(lambda))
+    {
+        return NAN;
+    }
+    if (lambda == 0.0L)
+    {
+        return 1.0L;
+    }
+    return (k < poisson_mode(lambda)) ? poisson_lower(k, lambda) : 1.0L - poisson_upper(k, lambda);
+}
+
+long double poisson_quantile(long double q, long double lambda)
+{
+    if (!probability_valid(q) || !poisson_valid(lambda))
+    {
+        return NAN;
+    }
+    if (q == 0.0L || lambda == 0.0L)
+    {
+        return 0.0L;
+    }
+    if (q == 1.0L)
+    {
+        return INFINITY;
+    }
+
+    long double guess = floorl(lambda + sqrtl(lambda) * normal_quantile(q, 0.0L, 1.0L) + 0.5L);
+    unsigned long k = (guess <= 0.0L) ? 0 : (guess >= ULONG_MAX) ? ULONG_MAX : (unsigned long)guess;
+    long double cdf = poisson_cdf(k, lambda);
+    long double term = poisson_pmf(k, lambda);
+    if (cdf >= q)
+    {
+        while (k > 0 && cdf - term >= q)
+        {
+            cdf -= term;
+            term *= k / lambda;
+            k--;
+        }
+    }
+    else
+    {
+        while (cdf < q && k < ULONG_MAX)
+        {
+            term *= lambda / (k + 1.0L);
+            cdf += term;
+            k++;
+        }
+    }
+    return k;
+}
+
+void poisson_pmf_array(long double lambda, size_t n, double *out)
+{
+    if (n == 0)
+    {
+        return;
+    }
+    if (!poisson_valid(lambda) || lambda == 0.0L)
+    {
+        for (size_t k = 0; k < n; k++)
+        {
+            out[k] = poisson_pmf(k, lambda);
+        }
+        return;
+    }
+
+    size_t start = (poisson_mode(lambda) < n) ? poisson_mode(lambda) : n - 1;
+    long double top = expl(poisson_log_pmf(start, lambda));
+    out[start] = top;
+    long double term = top;
+    size_t k = start;
+    for (; k + 1 < n && out[k] != 0.0; k++)
+    {
+        term *= lambda / (k + 1.0L);
+        out[k + 1] = term;
+    }
+    for (; k + 1 < n; k++)
+    {
+        out[k + 1] = 0.0;
+    }
+    term = top;
+    for (k = start; k > 0 && out[k] != 0.0; k--)
+    {
+        term *= k / lambda;
+        out[k - 1] = term;
+    }
+    for (; k > 0; k--)
+    {
+        out[k - 1] = 0.0;
+    }
+}
+
+void poisson_cdf_array(long double lambda, size_t n, double *out)
+{
+    poisson_pmf_array(lambda, n, out);
+    if (n == 0 || !poisson_valid(lambda))
+    {
+        return;
+    }
+
+    // the upper tail starts with the probability beyond the table
+    size_t mode = (lambda == 0.0L) ? 0 : poisson_mode(lambda);
+    size_t split = (mode < n) ? mode : n;
+    long double sum = (lambda == 0.0L || split == n) ? 0.0L : poisson_upper(n - 1, lambda);
+    for (size_t k = n; k > split; k--)
+    {
+        long double term = out[k - 1];
+        out[k - 1] = 1.0L - sum;
+        sum += term;
+    }
+    sum = 0.0L;
+    for (size_t k = 0; k < split; k++)
+    {
+        sum += out[k];
+        out[k] = sum;
+    }
+}
+
+/**
+ * @brief Checks a standard deviation, false for nan
+ */
+static bool normal_valid(long double sigma)
+{
+    return sigma > 0.0L && isfinite(sigma);
+}
+
+long double normal_pdf(long double x, long double mu, long double sigma)
+{
+    if (!normal_valid(sigma))
+    {
+        return NAN;
+    }
+    long double z = (x - mu) / sigma;
+    return expl(-0.5L * z * z) / (sigma * DIST_SQRT_2PI);
+}
+
+long double normal_cdf(long double x, long double mu, long double sigma)
+{
+    if (!normal_valid(sigma))
+    {
+        return NAN;
+    }
+    return 0.5L * erfcl((mu - x) / sigma * DIST_SQRT_HALF);
+}
+
+/**
+ * @brief Standard normal quantile of 0 < q <= 0.5
+ * @details Rational approximation by P. J. Acklam (relative error 1.15e-9), refined by Halley's method.
+ */
+static long double normal_lower_quantile(long double q)
+{
+    static const long double a[] = {-3.969683028665376e+01L, 2.209460984245205e+02L, -2.759285104469687e+02L,
+                                    1.383577518672690e+02L,  -3.066479806614716e+01L, 2.506628277459239e+00L};
+    static const long double b[] = {-5.447609879822406e+01L, 1.615858368580409e+02L, -1.556989798598866e+02L,
+                                    6.680131188771972e+01L, -1.328068155288572e+01L};
+    static const long double c[] = {-7.784894002430293e-03L, -3.223964580411365e-01L, -2.400758277161838e+00L,
+                                    -2.549732539343734e+00L, 4.374664141464968e+00L,  2.938163982698783e+00L};
+    static const long double d[] = {7.784695709041462e-03L, 3.224671290700398e-01L, 2.445134137142996e+00L,
+                                    3.754408661907416e+00L};
+
+    long double x;
+    if (q < 0.02425L)
+    {
+        long double t = sqrtl(-2.0L * logl(q));
+        x = (((((c[0] * t + c[1]) * t + c[2]) * t + c[3]) * t + c[4]) * t + c[5]) /
+            ((((d[0] * t + d[1]) * t + d[2]) * t + d[3]) * t + 1.0L);
+    }
+    else
+    {
+        long double r = q - 0.5L;
+        long double s = r * r;
+        x = (((((a[0] * s + a[1]) * s + a[2]) * s + a[3]) * s + a[4]) * s + a[5]) * r /
+            (((((b[0] * s + b[1]) * s + b[2]) * s + b[3]) * s + b[4]) * s + 1.0L);
+    }
+
+    for (int i = 0; i < DIST_QUANTILE_STEPS; i++)
+    {
+        long double e = 0.5L * erfcl(-x * DIST_SQRT_HALF) - q;
+        long double u = e * DIST_SQRT_2PI * expl(0.5L * x * x);
+        x -= u / (1.0L + 0.5L * x * u);
+    }
+    return x;
+}
+
+long double normal_quantile(long double q, long double mu, long double sigma)
+{
+    if (!probability_valid(q) || !normal_valid(sigma))
+    {
+        return NAN;
+    }
+    if (q == 0.0L || q == 1.0L)
+    {
+        return (q == 0.0L) ? -INFINITY : INFINITY;
+    }
+    return (q <= 0.5L) ? mu + sigma * normal_lower_quantile(q) : mu - sigma * normal_lower_quantile(1.0L - q);
+}
+
+void normal_pdf_array(const double *x, size_t n, double mu, double sigma, double *out)
+{
+    bool valid = normal_valid(sigma);
+    double scale = 1.0 / (sigma * (double)DIST_SQRT_2PI);
+    for (size_t i = 0; i < n; i++)
+    {
+        double z = (x[i] - mu) / sigma;
+        out[i] = valid ? exp(-0.5 * z * z) * scale : NAN;
+    }
+}
+
+void normal_cdf_array(const double *x, size_t n, double mu, double sigma, double *out)
+{
+    bool valid = normal_valid(sigma);
+    double scale = (double)DIST_SQRT_HALF / sigma;
+    for (size_t i = 0; i < n; i++)
+    {
+        out[i] = valid ? 0.5 * erfc((mu - x[i]) * scale) : NAN;
+    }
+}
+
+#define RNG_BLOCK 256                 // bits generated at once for normal numbers
+#define ZIG_LAYERS 256                // layers of the ziggurat, one byte of the bits selects the layer
+#define ZIG_R 3.6541528853610088      // start of the tail of the ziggurat (Marsaglia and Tsang)
+#define ZIG_AREA 4.92867323399e-3     // area of a layer
+#define MC_MIN_SAMPLES (1ULL << 16)   // fewest samples of a part of a Monte Carlo estimate
+
+typedef unsigned long long rng_vec __attribute__((vector_size(8 * RNG_LANES))); // a word of every lane
+typedef long long rng_ivec __attribute__((vector_size(8 * RNG_LANES)));
+typedef double rng_dvec __attribute__((vector_size(8 * RNG_LANES)));
+
+static const unsigned long long rng_jump_poly[4] = {0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+                                                    0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL};
+static const unsigned long long rng_long_jump_poly[4] = {0x76e15d3efefdcbbfULL, 0xc5004e441c522fb3ULL,
+                                                         0x77710069854ee241ULL, 0x39109bb02acbe635ULL};
+
+static inline unsigned long long rng_rotl(unsigned long long x, int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+/**
+ * @brief Advances one lane of the generator
+ * @return output of the lane
+ */
+static inline unsigned long long rng_step(unsigned long long s[4][RNG_LANES], unsigned lane)
+{
+    unsigned long long result = rng_rotl(s[1][lane] * 5, 7) * 9;
+    unsigned long long t = s[1][lane] << 17;
+    s[2][lane] ^= s[0][lane];
+    s[3][lane] ^= s[1][lane];
+    s[1][lane] ^= s[2][lane];
+    s[0][lane] ^= s[3][lane];
+    s[2][lane] ^= t;
+    s[3][lane] = rng_rotl(s[3][lane], 45);
+    return result;
+}
+
+/**
+ * @brief Advances every lane of the generator, the same steps as rng_step in vector registers
+ * @param result receives the outputs of the lanes
+ */
+static inline void rng_step_vec(rng_vec *s, rng_vec *result)
+{
+    rng_vec x = s[1] * 5;
+    *result = ((x << 7) | (x >> 57)) * 9;
+    rng_vec t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = (s[3] << 45) | (s[3] >> 19);
+}
+
+/**
+ * @brief Moves one lane by the jump polynomial
+ */
+static void rng_jump_lane(unsigned long long s[4][RNG_LANES], unsigned lane, const unsigned long long *poly)
+{
+    unsigned long long jumped[4] = {0, 0, 0, 0};
+    for (int i = 0; i < 4; i++)
+    {
+        for (int bit = 0; bit < 64; bit++)
+        {
+            if ((poly[i] >> bit) & 1)
+            {
+                for (int w = 0; w < 4; w++)
+                {
+                    jumped[w] ^= s[w][lane];
+                }
+            }
+            rng_step(s, lane);
+        }
+    }
+    for (int w = 0; w < 4; w++)
+    {
+        s[w][lane] = jumped[w];
+    }
+}
+
+void rng_seed(rng_t *r, unsigned long long seed)
+{
+    // splitmix64
+    for (int w = 0; w < 4; w++)
+    {
+        seed += 0x9e3779b97f4a7c15ULL;
+        unsigned long long z = seed;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        r->s[w][0] = z ^ (z >> 31);
+    }
+    for (unsigned lane = 1; lane < RNG_LANES; lane++)
+    {
+        for (int w = 0; w < 4; w++)
+        {
+            r->s[w][lane] = r->s[w][lane - 1];
+        }
+        rng_jump_lane(r->s, lane, rng_jump_poly);
+    }
+    r->lane = 0;
+}
+
+unsigned long long rng_next(rng_t *r)
+{
+    unsigned long long result = rng_step(r->s, r->lane);
+    r->lane = (r->lane + 1) % RNG_LANES;
+    return result;
+}
+
+void rng_jump(rng_t *r)
+{
+    for (unsigned lane = 0; lane < RNG_LANES; lane++)
+    {
+        for (int i = 0; i < RNG_LANES; i++)
+        {
+            rng_jump_lane(r->s, lane, rng_jump_poly);
+        }
+    }
+}
+
+void rng_long_jump(rng_t *r)
+{
+    for (unsigned lane = 0; lane < RNG_LANES; lane++)
+    {
+        rng_jump_lane(r->s, lane, rng_long_jump_poly);
+    }
+}
+
+double rng_uniform(rng_t *r)
+{
+    return (long long)(rng_next(r) >> 11) * 0x1.0p-53;
+}
+
+/**
+ * @brief Fills an array with the values of the generator, a value of every lane at a time
+ */
+static void rng_bits_array(rng_t *r, unsigned long long *out, size_t n)
+{
+    size_t i = 0;
+    for (; i < n && r->lane != 0; i++)
+    {
+        out[i] = rng_next(r);
+    }
+    rng_vec s[4];
+    memcpy(s, r->s, sizeof(s));
+    for (; i + RNG_LANES <= n; i += RNG_LANES)
+    {
+        rng_vec x;
+        rng_step_vec(s, &x);
+        memcpy(out + i, &x, sizeof(x));
+    }
+    memcpy(r->s, s, sizeof(s));
+    for (; i < n; i++)
+    {
+        out[i] = rng_next(r);
+    }
+}
+
+void rng_uniform_array(rng_t *r, double *out, size_t n)
+{
+    size_t i = 0;
+    for (; i < n && r->lane != 0; i++)
+    {
+        out[i] = rng_uniform(r);
+    }
+    rng_vec s[4];
+    memcpy(s, r->s, sizeof(s));
+    for (; i + RNG_LANES <= n; i += RNG_LANES)
+    {
+        // the top 53 bits are a positive signed integer, which converts without the unsigned corrections
+        rng_vec x;
+        rng_step_vec(s, &x);
+        rng_dvec u = __builtin_convertvector((rng_ivec)(x >> 11), rng_dvec) * 0x1.0p-53;
+        memcpy(out + i, &u, sizeof(u));
+    }
+    memcpy(r->s, s, sizeof(s));
+    for (; i < n; i++)
+    {
+        out[i] = rng_uniform(r);
+    }
+}
+
+static pthread_once_t zig_once = PTHREAD_ONCE_INIT;
+static double zig_x[ZIG_LAYERS + 1]; // right ends of the layers, zig_x[0] is the base with the tail
+static double zig_f[ZIG_LAYERS + 1]; // density at the ends
+
+/**
+ * @brief Computes the layers of the ziggurat, each has the area ZIG_AREA
+ */
+static void zig_init(void)
+{
+    zig_x[0] = ZIG_AREA / exp(-0.5 * ZIG_R * ZIG_R);
+    zig_x[1] = ZIG_R;
+    for (int i = 2; i < ZIG_LAYERS; i++)
+    {
+        zig_x[i] = sqrt(-2.0 * log(ZIG_AREA / zig_x[i - 1] + exp(-0.5 * zig_x[i - 1] * zig_x[i - 1])));
+    }
+    zig_x[ZIG_LAYERS] = 0.0;
+    for (int i = 0; i <= ZIG_LAYERS; i++)
+    {
+        zig_f[i] = exp(-0.5 * zig_x[i] * zig_x[i]);
+    }
+}
+
+/**
+ * @brief Standard normal number from the given bits, further bits are drawn from r if the point is rejected
+ * @details The lowest byte selects a layer, the next bit the sign and the top 53 bits the position in the
+ * layer.
+ */
+static double zig_sample_slow(rng_t *r, unsigned long long bits)
+{
+    for (;;)
+    {
+        int layer = bits & (ZIG_LAYERS - 1);
+        double sign = 1.0 - 2.0 * (double)((bits >> 8) & 1);
+        double x = (long long)(bits >> 11) * 0x1.0p-53 * zig_x[layer];
+        if (x < zig_x[layer + 1])
+        {
+            return sign * x;
+        }
+        if (layer == 0)
+        {
+            // tail beyond ZIG_R (Marsaglia)
+            double a, b;
+            do
+            {
+                a = -log1p(-rng_uniform(r)) / ZIG_R;
+                b = -log1p(-rng_uniform(r));
+            } while (b + b < a * a);
+            return sign * (ZIG_R + a);
+        }
+        if (zig_f[layer] + (zig_f[layer + 1] - zig_f[layer]) * rng_uniform(r) < exp(-0.5 * x * x))
+        {
+            return sign * x;
+        }
+        bits = rng_next(r);
+    }
+}
+
+/**
+ * @brief Standard normal number from the given bits, points inside the layer above are accepted inline
+ */
+static inline double zig_sample(rng_t *r, unsigned long long bits)
+{
+    int layer = bits & (ZIG_LAYERS - 1);
+    double x = (long long)(bits >> 11) * 0x1.0p-53 * zig_x[layer];
+    if (x < zig_x[layer + 1])
+    {
+        // the sign is arithmetic, a branch on a random bit would be mispredicted
+        return (1.0 - 2.0 * (double)((bits >> 8) & 1)) * x;
+    }
+    return zig_sample_slow(r, bits);
+}
+
+double rng_normal(rng_t *r, double mu, double sigma)
+{
+    pthread_once(&zig_once, zig_init);
+    return mu + sigma * zig_sample(r, rng_next(r));
+}
+
+void rng_normal_array(rng_t *r, double *out, size_t n, double mu, double sigma)
+{
+    pthread_once(&zig_once, zig_init);
+    unsigned long long bits[RNG_BLOCK];
+    for (size_t i = 0; i < n; i += RNG_BLOCK)
+    {
+        size_t m = (n - i < RNG_BLOCK) ? n - i : RNG_BLOCK;
+        rng_bits_array(r, bits, m);
+        for (size_t j = 0; j < m; j++)
+        {
+            out[i + j] = mu + sigma * zig_sample(r, bits[j]);
+        }
+    }
+}
+
+/** @struct mc_task
+ *  @brief Parts of a Monte Carlo estimate summarized by one thread
+ *  @param sample sampling function
+ *  @param arg argument of sample
+ *  @param streams generators of all parts
+ *  @param bounds first sample of every part and the number of samples at the end
+ *  @param parts number of parts
+ *  @param first first part of the thread, it takes every step-th part
+ *  @param step number of threads
+ *  @param results summaries of all parts
+ */
+struct mc_task
+{
+    monte_carlo_f sample;
+    void *arg;
+    rng_t *streams;
+    unsigned long long *bounds;
+    size_t parts;
+    size_t first;
+    size_t step;
+    stats_t *results;
+};
+
+static void *mc_thread(void *arg)
+{
+    struct mc_task *t = arg;
+    double block[MC_BLOCK];
+    for (size_t part = t->first; part < t->parts; part += t->step)
+    {
+        stats_init(&t->results[part]);
+        for (unsigned long long i = t->bounds[part]; i < t->bounds[part + 1]; i += MC_BLOCK)
+        {
+            size_t m = (t->bounds[part + 1] - i < MC_BLOCK) ? t->bounds[part + 1] - i : MC_BLOCK;
+            t->sample(&t->streams[part], t->arg, block, m);
+            stats_add_array(&t->results[part], block, m);
+        }
+    }
+    return NULL;
+}
+
+void monte_carlo(monte_carlo_f sample, void *arg, unsigned long long samples, unsigned long long seed,
+                 int threads, stats_t *result)
+{
+    stats_init(result);
+    if (samples == 0)
+    {
+        return;
+    }
+
+    // the parts depend only on the number of samples
+    unsigned long long parts = (samples + MC_MIN_SAMPLES - 1) / MC_MIN_SAMPLES;
+    parts = (parts < MC_STREAMS) ? parts : MC_STREAMS;
+    long count = (threads > 0) ? threads : sysconf(_SC_NPROCESSORS_ONLN);
+    count = (count < 1) ? 1 : ((unsigned long long)count > parts) ? (long)parts : count;
+
+    rng_t *streams = malloc(parts * sizeof(rng_t));
+    unsigned long long *bounds = malloc((parts + 1) * sizeof(unsigned long long));
+    stats_t *results = malloc(parts * sizeof(stats_t));
+    struct mc_task *tasks = malloc(count * sizeof(struct mc_task));
+    if (streams == NULL || bounds == NULL || results == NULL || tasks == NULL)
+    {
+        fprintf(stderr, "math_library - memory allocation error\n");
+        abort();
+    }
+    rng_seed(&streams[0], seed);
+    for (size_t i = 0; i < parts; i++)
+    {
+        if (i > 0)
+        {
+            streams[i] = streams[i - 1];
+            rng_jump(&streams[i]);
+        }
+        bounds[i] = (unsigned long long)((unsigned __int128)samples * i / parts);
+    }
+    bounds[parts] = samples;
+
+    for (long i = 0; i < count; i++)
+    {
+        tasks[i] = (struct mc_task){.sample = sample, .arg = arg, .streams = streams, .bounds = bounds,
+                                    .parts = parts, .first = i, .step = count, .results = results};
+    }
+    run_threads(mc_thread, tasks, sizeof(struct mc_task), count);
+    for (size_t i = 0; i < parts; i++)
+    {
+        stats_merge(result, &results[i]);
+    }
+
+    free(streams);
+    free(bounds);
+    free(results);
+    free(tasks);
+}
@@ -1,74 +1,1157 @@
-/**
- * @file math_library.h
- * @author Stanislav Letaši
- * @brief Header file for functions of math library
- * @date 20.3.2023
- */
-
-#ifndef MATH_LIBRARY_H
-#define MATH_LIBRARY_H
-
-/**
- * @brief Sums up two numbers
- * @param x
- * @param y
- * @return x+y
- */
-long double add(long double x, long double y);
-
-/**
- * @brief Subtraction
- * @param x
- * @param y
- * @return x-y
- */
-long double sub(long double x, long double y);
-
-/**
- * @brief Product
- * @param x
- * @param y
- * @return x*y
- */
-long double mul(long double x, long double y);
-
-/**
- * @brief Decimal division
- * @param x
- * @param y
- * @return x/y
- */
-long double divide(long double x, long double y);
-
-/**
- * @brief Factorial
- * @param x
- * @return x!
- */
-unsigned long long factorial(unsigned long x);
-
-/**
- * @brief y-th power of x
- * @param x decimal number
- * @param y natural number
- * @return x**y
- */
-long double power(long double x, unsigned long y);
-
-/**
- * @brief y-th root of x
- * @param x decimal number
- * @param y natural number
- * @return y√x
- */
-long double root(long double x, unsigned long y);
-
-/**
- * @brief Binomial coefficient
- * @param x
- * @param y
- * @return xCy
- */
-unsigned long comb(unsigned long x, unsigned long y);
-
-#endif
\ No newline at end of file
+/**
+ * @file math_library.h
+ * @author Stanislav Letaši
+ * @brief Header file for functions of math library
+ * @date 20.3.2023
+ */
+
+#ifndef MATH_LIBRARY_H
+#define MATH_LIBRARY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define MAX_PRIME_FACTORS 64 // maximum number of prime factors of a 64-bit integer
+#define FIBONACCI_EXACT_MAX 186 // largest n for which F(n) fits in 128 bits, fibonacci_big has no limit
+#define LUCAS_EXACT_MAX 184 // largest n for which L(n) fits in 128 bits, lucas_big has no limit
+#define FIBONACCI_DIGITS100_MAX 480 // largest n for which F(n) has at most 100 decimal digits
+#define LUCAS_DIGITS100_MAX 478 // largest n for which L(n) has at most 100 decimal digits
+#define COMB_ROW_U64_MAX 67 // largest n for which C(n, k) fits in 64 bits for every k
+#define COMB_ROW_EXACT_MAX 131 // largest n for which C(n, k) fits in 128 bits for every k
+#define LINREC_MAX_ORDER 16 // maximum order of a linear recurrence
+#define REPRO_BINS 70 // 32-bit digits of the exact sum of doubles, with room for 2^64 terms
+#define TDIGEST_COMPRESSION 200 // scale of the t-digest, it keeps about half as many centroids
+#define TDIGEST_CENTROIDS 256 // upper bound of the number of centroids of the t-digest (k1 scale)
+#define TDIGEST_BUFFER 512 // values of the t-digest collected before they are merged into the centroids
+#define HIST_MAX_BINS 1024 // largest number of bins of a histogram
+#define WINDOW_DRIFT 1024 // drop of the variance of a sliding window that causes a recomputation
+#define RNG_LANES 4 // xoshiro256** streams of a generator, advanced together in vector registers
+#define MC_STREAMS 256 // most generator streams of a Monte Carlo estimate, whole streams go to the threads
+#define MC_BLOCK 1024 // samples requested from the sampling function at once
+
+struct bigint; // arbitrary-precision integer of the exact sequences (bigint.h)
+
+/** @struct stats
+ *  @brief Streaming summary of a sample in O(1) memory (Welford's algorithm).
+ *  @param count number of values
+ *  @param mean mean of the values
+ *  @param m2 sum of squared deviations from the mean
+ *  @param min smallest value
+ *  @param max largest value
+ */
+struct stats
+{
+    unsigned long long count;
+    long double mean;
+    long double m2;
+    long double min;
+    long double max;
+};
+
+typedef struct stats stats_t;
+
+/** @struct stats_pair
+ *  @brief Streaming summary of a sample of pairs (x, y) in O(1) memory, the co-moment is updated like the
+ *  sums of squared deviations of Welford's algorithm.
+ *  @param count number of pairs
+ *  @param mean_x mean of x
+ *  @param mean_y mean of y
+ *  @param m2_x sum of squared deviations of x from its mean
+ *  @param m2_y sum of squared deviations of y from its mean
+ *  @param c sum of the products of the deviations of x and y
+ */
+struct stats_pair
+{
+    unsigned long long count;
+    long double mean_x;
+    long double mean_y;
+    long double m2_x;
+    long double m2_y;
+    long double c;
+};
+
+typedef struct stats_pair stats_pair_t;
+
+/** @struct repro_sum
+ *  @brief Exact sum of doubles as a fixed-point number in 32-bit digits with 32 bits of headroom for carries.
+ *  @details The result does not depend on the order of the additions, so sums of the same values split in
+ *  any way among threads and merged are identical to the last bit.
+ *  @param bin digits, bin[i] has the weight 2^(32 i - 1074)
+ *  @param pending additions since the last propagation of the carries
+ *  @param special bit 0 for +inf, bit 1 for -inf, bit 2 for nan
+ */
+struct repro_sum
+{
+    long long bin[REPRO_BINS];
+    unsigned long pending;
+    unsigned special;
+};
+
+typedef struct repro_sum repro_sum_t;
+
+/** @struct stats_repro
+ *  @brief Reproducible summary, the sums of d = x - shift and d^2 are kept exactly.
+ *  @param count number of values
+ *  @param shift value subtracted from all values, should be close to their mean (e.g. the first value)
+ *  @param sum sum of the differences
+ *  @param sum_sq sum of the squared differences
+ *  @param min smallest value
+ *  @param max largest value
+ */
+struct stats_repro
+{
+    unsigned long long count;
+    double shift;
+    repro_sum_t sum;
+    repro_sum_t sum_sq;
+    double min;
+    double max;
+};
+
+typedef struct stats_repro stats_repro_t;
+
+/** @struct tdigest
+ *  @brief Mergeable sketch of the distribution of a sample for approximate quantiles (merging t-digest).
+ *  @details Sorted centroids cover few values near the extremes and many values in the middle, so the
+ *  tail quantiles are accurate. The memory use is fixed (a few KB).
+ *  @param centroids number of centroids
+ *  @param buffered number of values in the buffer
+ *  @param total number of values in the centroids
+ *  @param min smallest value
+ *  @param max largest value
+ *  @param mean means of the centroids in increasing order
+ *  @param weight numbers of values of the centroids
+ *  @param buffer values not merged yet
+ */
+struct tdigest
+{
+    size_t centroids;
+    size_t buffered;
+    double total;
+    double min;
+    double max;
+    double mean[TDIGEST_CENTROIDS];
+    double weight[TDIGEST_CENTROIDS];
+    double buffer[TDIGEST_BUFFER];
+};
+
+typedef struct tdigest tdigest_t;
+
+/**
+ * @brief Kinds of the bins of a histogram
+ */
+enum hist_modes
+{
+    HIST_LINEAR,   // bins of the same width between given bounds
+    HIST_LOG,      // bins of the same ratio of their ends between given positive bounds
+    HIST_ADAPTIVE  // bins of the same width, doubled whenever the values do not fit
+};
+
+/** @struct histogram
+ *  @brief Mergeable histogram of a sample in fixed memory.
+ *  @details Bins of an adaptive histogram are 2^k wide and start at multiples of their width, so two
+ *  histograms are merged by doubling the width of the narrower one. For logarithmic bins, low and width
+ *  apply to the binary logarithms of the values.
+ *  @param mode enum hist_modes
+ *  @param bins number of bins
+ *  @param low lower end of the first bin
+ *  @param width width of a bin, 0 for an adaptive histogram without values
+ *  @param below number of values below the first bin (all values that are not positive in HIST_LOG)
+ *  @param above number of values above the last bin
+ *  @param count number of values of every bin
+ */
+struct histogram
+{
+    int mode;
+    size_t bins;
+    double low;
+    double width;
+    unsigned long long below;
+    unsigned long long above;
+    unsigned long long count[HIST_MAX_BINS];
+};
+
+typedef struct histogram histogram_t;
+
+/** @struct window
+ *  @brief Summary of the last values of a stream (sliding window), updated in O(1) per value.
+ *  @details The values are kept in a ring buffer. The moments of the finite values are updated by adding
+ *  the new value and removing the oldest one (Welford's update and its inverse). They are recomputed from
+ *  the ring after every size values and whenever m2 falls far below its largest value since the last
+ *  recomputation (large values left the window), so rounding errors do not accumulate. The slots of the
+ *  candidates for the minimum and maximum are kept in monotonic queues, the oldest one is the result.
+ *  @param size number of the values in the window
+ *  @param added number of all added values
+ *  @param next slot of the next value, the slot of the oldest value of a full window
+ *  @param values ring buffer of the values
+ *  @param low slots of increasing values from the oldest one, ring buffer of size slots
+ *  @param high slots of decreasing values from the oldest one, ring buffer of size slots
+ *  @param low_head index of the oldest slot in low
+ *  @param low_len number of slots in low
+ *  @param high_head index of the oldest slot in high
+ *  @param high_len number of slots in high
+ *  @param finite number of finite values in the window
+ *  @param mean mean of the finite values
+ *  @param m2 sum of squared deviations of the finite values from the mean
+ *  @param peak largest m2 since the moments were recomputed
+ */
+struct window
+{
+    size_t size;
+    unsigned long long added;
+    size_t next;
+    double *values;
+    size_t *low;
+    size_t *high;
+    size_t low_head;
+    size_t low_len;
+    size_t high_head;
+    size_t high_len;
+    size_t finite;
+    long double mean;
+    long double m2;
+    long double peak;
+};
+
+typedef struct window window_t;
+
+/** @struct rng
+ *  @brief Pseudo-random generator of RNG_LANES interleaved xoshiro256** streams.
+ *  @details Lane i starts 2^128 values (i jumps) after lane 0 and the values are taken from the lanes in
+ *  turn, so arrays are generated a value of every lane at a time and equal the values of single calls.
+ *  @param s word of the state of every lane, s[word][lane]
+ *  @param lane lane of the next value
+ */
+struct rng
+{
+    unsigned long long s[4][RNG_LANES];
+    unsigned lane;
+};
+
+typedef struct rng rng_t;
+
+/**
+ * @brief Sampling function of a Monte Carlo estimate, called from several threads at once
+ * @param r generator of the calling stream
+ * @param arg argument passed to monte_carlo
+ * @param out receives n samples
+ * @param n number of samples, at most MC_BLOCK
+ */
+typedef void (*monte_carlo_f)(rng_t *r, void *arg, double *out, size_t n);
+
+/**
+ * @brief Sums up two numbers
+ * @param x
+ * @param y
+ * @return x+y
+ */
+long double add(long double x, long double y);
+
+/**
+ * @brief Subtraction
+ * @param x
+ * @param y
+ * @return x-y
+ */
+long double sub(long double x, long double y);
+
+/**
+ * @brief Product
+ * @param x
+ * @param y
+ * @return x*y
+ */
+long double mul(long double x, long double y);
+
+/**
+ * @brief Decimal division
+ * @param x
+ * @param y
+ * @return x/y
+ */
+long double divide(long double x, long double y);
+
+/**
+ * @brief Factorial
+ * @param x
+ * @return x!
+ */
+unsigned long long factorial(unsigned long x);
+
+/**
+ * @brief y-th power of x
+ * @param x decimal number
+ * @param y natural number
+ * @return x**y
+ */
+long double power(long double x, unsigned long y);
+
+/**
+ * @brief y-th root of x
+ * @param x decimal number
+ * @param y natural number
+ * @return y√x
+ */
+long double root(long double x, unsigned long y);
+
+/**
+ * @brief Binomial coefficient
+ * @param x
+ * @param y
+ * @return xCy
+ */
+unsigned long comb(unsigned long x, unsigned long y);
+
+/**
+ * @brief Row of Pascal's triangle in 64 bits
+ * @details C(n, k+1) = C(n, k) * (n-k) / (k+1) up to the middle, the rest is mirrored, O(n).
+ * @param n n <= COMB_ROW_U64_MAX
+ * @param row receives C(n, 0), ..., C(n, n)
+ * @return false if the row does not fit in 64 bits
+ */
+bool comb_row_u64(unsigned long n, unsigned long long *row);
+
+/**
+ * @brief Exact row of Pascal's triangle
+ * @param n n <= COMB_ROW_EXACT_MAX
+ * @param row receives C(n, 0), ..., C(n, n)
+ * @return false if the row does not fit in 128 bits
+ */
+bool comb_row_exact(unsigned long n, unsigned __int128 *row);
+
+/**
+ * @brief Row of Pascal's triangle in long double, O(n)
+ * @param n
+ * @param row receives C(n, 0), ..., C(n, n), exact up to COMB_ROW_U64_MAX, the relative error grows
+ * about as n * LDBL_EPSILON and the middle overflows to inf beyond n of about 16400
+ */
+void comb_row(unsigned long n, long double *row);
+
+/**
+ * @brief Row of Pascal's triangle modulo a prime, O(n)
+ * @details The recurrence divides by k+1 with inverses modulo m, for n >= m the row is combined from
+ * rows of the base m digits of n (Lucas' theorem).
+ * @param n
+ * @param m prime modulus
+ * @param row receives C(n, 0) mod m, ..., C(n, n) mod m
+ * @return false if m is not a prime
+ */
+bool comb_row_mod(unsigned long n, unsigned long long m, unsigned long long *row);
+
+/**
+ * @brief Deterministic Miller-Rabin primality test
+ * @param x 64-bit integer
+ * @return true if x is a prime number
+ */
+bool is_prime(unsigned long long x);
+
+/**
+ * @brief Prime factorization using trial division and Pollard-Brent rho
+ * @param x 64-bit integer
+ * @param factors array of at least MAX_PRIME_FACTORS elements, receives the prime factors
+ * in ascending order (repeated according to their multiplicity)
+ * @return number of prime factors written to factors, 0 for x < 2
+ */
+int factorize(unsigned long long x, unsigned long long *factors);
+
+/**
+ * @brief Greatest common divisor (binary Stein's algorithm)
+ * @param x
+ * @param y
+ * @return gcd(x, y), gcd(x, 0) = x
+ */
+unsigned long long gcd(unsigned long long x, unsigned long long y);
+
+/**
+ * @brief Greatest common divisor of 128-bit integers (binary Stein's algorithm)
+ * @param x
+ * @param y
+ * @return gcd(x, y), gcd(x, 0) = x
+ */
+unsigned __int128 gcd_u128(unsigned __int128 x, unsigned __int128 y);
+
+/**
+ * @brief Least common multiple
+ * @param x
+ * @param y
+ * @return lcm(x, y), 0 if any of the arguments is 0 or the result does not fit in 64 bits
+ */
+unsigned long long lcm(unsigned long long x, unsigned long long y);
+
+/**
+ * @brief Least common multiple of 128-bit integers
+ * @param x
+ * @param y
+ * @return lcm(x, y), 0 if any of the arguments is 0 or the result does not fit in 128 bits
+ */
+unsigned __int128 lcm_u128(unsigned __int128 x, unsigned __int128 y);
+
+/**
+ * @brief Greatest common divisor of all numbers in the array
+ * @param arr
+ * @param n number of elements
+ * @return gcd(arr[0], ..., arr[n-1]), 0 for an empty array
+ */
+unsigned long long gcd_array(const unsigned long long *arr, size_t n);
+
+/**
+ * @brief Least common multiple of all numbers in the array
+ * @param arr
+ * @param n number of elements
+ * @return lcm(arr[0], ..., arr[n-1]), 1 for an empty array, 0 if any element is 0 or on overflow
+ */
+unsigned long long lcm_array(const unsigned long long *arr, size_t n);
+
+/**
+ * @brief Divides all numbers in the array by their greatest common divisor
+ * @param arr ratio arr[0] : ... : arr[n-1], modified in place
+ * @param n number of elements
+ */
+void reduce_ratio(unsigned long long *arr, size_t n);
+
+/**
+ * @brief Reduces fractions num[i]/den[i] to their lowest terms
+ * @details Denominators are made positive. Fractions with zero denominator are left unchanged, and so are
+ * fractions whose reduced denominator or positive numerator would be 2^63 (e.g. 1/LLONG_MIN).
+ * @param num numerators, modified in place
+ * @param den denominators, modified in place
+ * @param n number of fractions
+ */
+void reduce_fractions(long long *num, long long *den, size_t n);
+
+/**
+ * @brief n-th Fibonacci number (fast doubling)
+ * @param n
+ * @return F(n), exact as long as it fits in the mantissa of long double
+ */
+long double fibonacci(unsigned long n);
+
+/**
+ * @brief n-th Lucas number (fast doubling)
+ * @param n
+ * @return L(n), exact as long as it fits in the mantissa of long double
+ */
+long double lucas(unsigned long n);
+
+/**
+ * @brief Exact n-th Fibonacci number
+ * @param n n <= FIBONACCI_EXACT_MAX
+ * @param result receives F(n)
+ * @return false if F(n) does not fit in 128 bits
+ */
+bool fibonacci_exact(unsigned long n, unsigned __int128 *result);
+
+/**
+ * @brief Exact n-th Lucas number
+ * @param n n <= LUCAS_EXACT_MAX
+ * @param result receives L(n)
+ * @return false if L(n) does not fit in 128 bits
+ */
+bool lucas_exact(unsigned long n, unsigned __int128 *result);
+
+/**
+ * @brief Exact n-th Fibonacci number of any size (fast doubling on big integers)
+ * @details F(n) has about 0.694 * n bits, so n in the millions takes a few Karatsuba squarings of
+ * millions of bits.
+ * @param n
+ * @param result receives F(n), an initialized bigint_t
+ */
+void fibonacci_big(unsigned long long n, struct bigint *result);
+
+/**
+ * @brief Exact n-th Lucas number of any size (fast doubling on big integers)
+ * @param n
+ * @param result receives L(n), an initialized bigint_t
+ */
+void lucas_big(unsigned long long n, struct bigint *result);
+
+/**
+ * @brief n-th Fibonacci number modulo m (fast doubling)
+ * @param n
+ * @param m modulus, m > 0
+ * @return F(n) mod m
+ */
+unsigned long long fibonacci_mod(unsigned long long n, unsigned long long m);
+
+/**
+ * @brief n-th Lucas number modulo m (fast doubling)
+ * @param n
+ * @param m modulus, m > 0
+ * @return L(n) mod m
+ */
+unsigned long long lucas_mod(unsigned long long n, unsigned long long m);
+
+/**
+ * @brief n-th term of a linear recurrence (matrix exponentiation)
+ * @details a(i) = coef[0]*a(i-1) + coef[1]*a(i-2) + ... + coef[order-1]*a(i-order)
+ * @param coef coefficients of the recurrence
+ * @param init initial terms a(0), ..., a(order-1)
+ * @param order order of the recurrence, 1 <= order <= LINREC_MAX_ORDER
+ * @param n
+ * @return a(n)
+ */
+long double linear_recurrence(const long double *coef, const long double *init, int order, unsigned long n);
+
+/**
+ * @brief n-th term of a linear recurrence modulo m (matrix exponentiation)
+ * @details a(i) = coef[0]*a(i-1) + coef[1]*a(i-2) + ... + coef[order-1]*a(i-order) (mod m)
+ * @param coef coefficients of the recurrence
+ * @param init initial terms a(0), ..., a(order-1)
+ * @param order order of the recurrence, 1 <= order <= LINREC_MAX_ORDER
+ * @param n
+ * @param m modulus, m > 0
+ * @return a(n) mod m
+ */
+unsigned long long linear_recurrence_mod(const unsigned long long *coef, const unsigned long long *init, int order,
+                                         unsigned long long n, unsigned long long m);
+
+/**
+ * @brief Exact n-th term of a linear recurrence with integer coefficients (matrix exponentiation on big integers)
+ * @details a(i) = coef[0]*a(i-1) + coef[1]*a(i-2) + ... + coef[order-1]*a(i-order)
+ * @param coef coefficients of the recurrence
+ * @param init initial terms a(0), ..., a(order-1)
+ * @param order order of the recurrence, 1 <= order <= LINREC_MAX_ORDER
+ * @param n
+ * @param result receives a(n), an initialized bigint_t
+ */
+void linear_recurrence_big(const long long *coef, const long long *init, int order, unsigned long long n,
+                           struct bigint *result);
+
+/**
+ * @brief Sum of the array by pairwise summation
+ * @details Blocks of the array are summed in vector registers and the block sums are added pairwise, so
+ * the rounding error grows with log(n) instead of n.
+ * @param arr
+ * @param n number of elements
+ * @return arr[0] + ... + arr[n-1], 0 for an empty array
+ */
+double sum_array(const double *arr, size_t n);
+
+/**
+ * @brief Sum of the array with compensation of rounding errors (Neumaier's summation)
+ * @details Slower than sum_array, the error is about one rounding of the result unless the sum cancels
+ * heavily.
+ * @param arr
+ * @param n number of elements
+ * @return arr[0] + ... + arr[n-1], 0 for an empty array
+ */
+double sum_array_compensated(const double *arr, size_t n);
+
+/**
+ * @brief Mean of the array, computed by sum_array
+ * @param arr
+ * @param n number of elements
+ * @return mean, NAN for an empty array
+ */
+double mean_array(const double *arr, size_t n);
+
+/**
+ * @brief Sample variance of the array (divided by n - 1)
+ * @details Corrected two-pass algorithm, the squared deviations from the mean are summed pairwise.
+ * @param arr
+ * @param n number of elements
+ * @return variance, NAN for fewer than two elements
+ */
+double variance_array(const double *arr, size_t n);
+
+/**
+ * @brief Initializes an empty summary
+ * @param s
+ */
+void stats_init(stats_t *s);
+
+/**
+ * @brief Adds a value to the summary (Welford's update)
+ * @param s
+ * @param x
+ */
+void stats_add(stats_t *s, long double x);
+
+/**
+ * @brief Adds an array of values to the summary
+ * @details Blocks of the array are summarized in two vectorized passes (mean, then squared deviations)
+ * and merged into s, which avoids a division per value.
+ * @param s
+ * @param x values
+ * @param n number of values
+ */
+void stats_add_array(stats_t *s, const double *x, size_t n);
+
+/**
+ * @brief Merges summary t into s (Chan et al.), the result equals the summary of both samples
+ * @param s
+ * @param t
+ */
+void stats_merge(stats_t *s, const stats_t *t);
+
+/**
+ * @brief Mean of the sample
+ * @param s
+ * @return mean, NAN for an empty sample
+ */
+long double stats_mean(const stats_t *s);
+
+/**
+ * @brief Sample variance (divided by count - 1)
+ * @param s
+ * @return variance, NAN for fewer than two values
+ */
+long double stats_variance(const stats_t *s);
+
+/**
+ * @brief Population variance (divided by count)
+ * @param s
+ * @return variance, NAN for an empty sample
+ */
+long double stats_population_variance(const stats_t *s);
+
+/**
+ * @brief Sample standard deviation, square root of stats_variance
+ * @param s
+ * @return standard deviation, NAN for fewer than two values
+ */
+long double stats_stddev(const stats_t *s);
+
+/**
+ * @brief Smallest value of the sample
+ * @param s
+ * @return minimum, NAN for an empty sample
+ */
+long double stats_min(const stats_t *s);
+
+/**
+ * @brief Largest value of the sample
+ * @param s
+ * @return maximum, NAN for an empty sample
+ */
+long double stats_max(const stats_t *s);
+
+/**
+ * @brief Initializes an empty summary of pairs
+ * @param s
+ */
+void stats_pair_init(stats_pair_t *s);
+
+/**
+ * @brief Adds a pair to the summary (Welford's update of the means, the squared deviations and the co-moment)
+ * @param s
+ * @param x
+ * @param y
+ */
+void stats_pair_add(stats_pair_t *s, long double x, long double y);
+
+/**
+ * @brief Adds arrays of pairs to the summary
+ * @details Blocks of the arrays are summarized in two vectorized passes (means, then the sums of the
+ * deviations, their squares and products) and merged into s.
+ * @param s
+ * @param x first values of the pairs
+ * @param y second values of the pairs
+ * @param n number of pairs
+ */
+void stats_pair_add_array(stats_pair_t *s, const double *x, const double *y, size_t n);
+
+/**
+ * @brief Merges summary t into s, the result equals the summary of both samples
+ * @param s
+ * @param t
+ */
+void stats_pair_merge(stats_pair_t *s, const stats_pair_t *t);
+
+/**
+ * @brief Sample covariance of x and y (divided by count - 1)
+ * @param s
+ * @return covariance, NAN for fewer than two pairs
+ */
+long double stats_pair_covariance(const stats_pair_t *s);
+
+/**
+ * @brief Pearson correlation coefficient of x and y
+ * @param s
+ * @return correlation from [-1, 1], NAN for fewer than two pairs or if x or y is constant
+ */
+long double stats_pair_correlation(const stats_pair_t *s);
+
+/**
+ * @brief Slope of the least-squares line y = slope * x + intercept
+ * @param s
+ * @return slope, NAN for fewer than two pairs or if x is constant
+ */
+long double stats_pair_slope(const stats_pair_t *s);
+
+/**
+ * @brief Intercept of the least-squares line y = slope * x + intercept
+ * @param s
+ * @return intercept, NAN for fewer than two pairs or if x is constant
+ */
+long double stats_pair_intercept(const stats_pair_t *s);
+
+/**
+ * @brief Initializes an empty exact sum
+ * @param r
+ */
+void repro_sum_init(repro_sum_t *r);
+
+/**
+ * @brief Adds a value to the exact sum
+ * @param r
+ * @param x
+ */
+void repro_sum_add(repro_sum_t *r, double x);
+
+/**
+ * @brief Adds all elements of the array to the exact sum
+ * @param r
+ * @param arr
+ * @param n number of elements
+ */
+void repro_sum_add_array(repro_sum_t *r, const double *arr, size_t n);
+
+/**
+ * @brief Adds the exact sum t to r
+ * @param r
+ * @param t
+ */
+void repro_sum_merge(repro_sum_t *r, const repro_sum_t *t);
+
+/**
+ * @brief Exact sum rounded to the nearest double
+ * @param r
+ * @return sum, +-inf if it overflows or an infinity was added, nan after a nan or infinities of both signs
+ */
+double repro_sum_get(const repro_sum_t *r);
+
+/**
+ * @brief Sum of the array, correctly rounded and independent of the order of the elements
+ * @param arr
+ * @param n number of elements
+ * @return arr[0] + ... + arr[n-1], 0 for an empty array
+ */
+double sum_array_reproducible(const double *arr, size_t n);
+
+/**
+ * @brief Initializes an empty reproducible summary
+ * @details Summaries merged together must have the same shift. Values far from the shift lower the accuracy
+ * of the variance, not its reproducibility.
+ * @param s
+ * @param shift value subtracted from all values
+ */
+void stats_repro_init(stats_repro_t *s, double shift);
+
+/**
+ * @brief Adds an array of values to the reproducible summary
+ * @details Every difference from the shift is rounded to double, its square is split into two doubles
+ * without rounding (Dekker's product) and both sums are kept exactly.
+ * @param s
+ * @param x values
+ * @param n number of values
+ */
+void stats_repro_add_array(stats_repro_t *s, const double *x, size_t n);
+
+/**
+ * @brief Merges summary t into s, both must have the same shift
+ * @param s
+ * @param t
+ */
+void stats_repro_merge(stats_repro_t *s, const stats_repro_t *t);
+
+/**
+ * @brief Converts the reproducible summary to a summary for the queries of stats_t
+ * @details The result depends only on the multiset of the added values (and the shift), not on the order
+ * of the additions or merges.
+ * @param s
+ * @param r receives the summary
+ */
+void stats_repro_get(const stats_repro_t *s, stats_t *r);
+
+/**
+ * @brief Initializes an empty t-digest
+ * @param t
+ */
+void tdigest_init(tdigest_t *t);
+
+/**
+ * @brief Adds a value to the t-digest, nan is ignored
+ * @param t
+ * @param x
+ */
+void tdigest_add(tdigest_t *t, double x);
+
+/**
+ * @brief Adds an array of values to the t-digest
+ * @param t
+ * @param x values
+ * @param n number of values
+ */
+void tdigest_add_array(tdigest_t *t, const double *x, size_t n);
+
+/**
+ * @brief Merges t-digest u into t, the result approximates the union of both samples
+ * @param t
+ * @param u
+ */
+void tdigest_merge(tdigest_t *t, const tdigest_t *u);
+
+/**
+ * @brief Number of values in the t-digest
+ * @param t
+ * @return count
+ */
+unsigned long long tdigest_count(const tdigest_t *t);
+
+/**
+ * @brief Approximate quantile, interpolated between the centroids
+ * @param t
+ * @param q probability from [0, 1], 0 gives the minimum and 1 the maximum
+ * @return quantile, NAN for an empty t-digest or q outside [0, 1]
+ */
+double tdigest_quantile(const tdigest_t *t, double q);
+
+/**
+ * @brief Sets the number of threads used by the selection of order statistics and the sorting of large arrays
+ * @param threads number of threads, 0 for the number of online processors (the default)
+ */
+void select_set_threads(int threads);
+
+/**
+ * @brief Exact k-th smallest number of an array, nan values are ignored
+ * @details Floyd-Rivest selection in expected linear time, with pivots from the median of medians when
+ * the ranges do not shrink (introselect), so the worst case is linear too. Large arrays are sampled
+ * for two pivots around the k-th number, the numbers between them are collected by several threads and
+ * the selection continues in them.
+ * @param x numbers, their order is changed
+ * @param n number of values
+ * @param k rank from 0 (the minimum)
+ * @return k-th smallest number, NAN if there are at most k numbers
+ */
+double select_kth(double *x, size_t n, size_t k);
+
+/**
+ * @brief Exact median of an array, the mean of the two middle numbers for an even count
+ * @param x numbers, their order is changed, nan values are ignored
+ * @param n number of values
+ * @return median, NAN if there are no numbers
+ */
+double median_array(double *x, size_t n);
+
+/**
+ * @brief Exact quantile of an array, interpolated linearly between the order statistics
+ * @details The quantile lies at the position q * (m - 1) of the m numbers in increasing order.
+ * @param x numbers, their order is changed, nan values are ignored
+ * @param n number of values
+ * @param q probability from [0, 1], 0 gives the minimum and 1 the maximum
+ * @return quantile, NAN if there are no numbers or q is outside [0, 1]
+ */
+double quantile_array(double *x, size_t n, double q);
+
+/**
+ * @brief Sorts an array in increasing order, nan values are moved to the end
+ * @details LSD radix sort of the bits of the numbers in digits of 11 bits, digits shared by all numbers
+ * are skipped. The digits of parts of large arrays are counted and the parts are scattered by several
+ * threads (select_set_threads). A scratch array of the same size is allocated.
+ * @param x values
+ * @param n number of values
+ */
+void sort_array(double *x, size_t n);
+
+/**
+ * @brief Initializes an empty histogram
+ * @param h
+ * @param mode enum hist_modes
+ * @param bins number of bins, 1 to HIST_MAX_BINS
+ * @param low lower end of the first bin, positive for HIST_LOG, ignored for HIST_ADAPTIVE
+ * @param high upper end of the last bin, larger than low, ignored for HIST_ADAPTIVE
+ * @return false if the parameters are not valid
+ */
+bool histogram_init(histogram_t *h, int mode, size_t bins, double low, double high);
+
+/**
+ * @brief Adds an array of values to the histogram, nan values are ignored
+ * @details The bins of blocks of values are computed two at a time in vector registers and counted in
+ * several tables, so repeated bins do not wait for each other. An adaptive histogram is widened to the
+ * finite values of a block before the block is counted, infinite values are counted below and above.
+ * @param h
+ * @param x values
+ * @param n number of values
+ */
+void histogram_add_array(histogram_t *h, const double *x, size_t n);
+
+/**
+ * @brief Merges histogram u into h
+ * @param h
+ * @param u histogram of the same mode, bins, low and high (any low and high for HIST_ADAPTIVE)
+ * @return false if the histograms have different bins
+ */
+bool histogram_merge(histogram_t *h, const histogram_t *u);
+
+/**
+ * @brief Lower end of a bin
+ * @param h
+ * @param i index of the bin, bins gives the upper end of the last bin
+ * @return end of the bin, NAN for an adaptive histogram without values
+ */
+double histogram_edge(const histogram_t *h, size_t i);
+
+/**
+ * @brief Number of the values in the histogram, with those below and above the bins
+ * @param h
+ * @return count
+ */
+unsigned long long histogram_count(const histogram_t *h);
+
+/**
+ * @brief Initializes an empty sliding window
+ * @param w
+ * @param size number of the last values summarized
+ * @return false if size is 0
+ */
+bool window_init(window_t *w, size_t size);
+
+/**
+ * @brief Adds a value to the window, the oldest value leaves a full window
+ * @details Amortized O(1), the moments are recomputed from the window once per size values and after
+ * the variance drops by a factor of WINDOW_DRIFT.
+ * @param w
+ * @param x
+ */
+void window_add(window_t *w, double x);
+
+/**
+ * @brief Summary of the values in the window for the queries of stats_t
+ * @details The mean and m2 are nan while the window holds a value that is not finite, the minimum and
+ * maximum ignore nan.
+ * @param w
+ * @param r receives the summary
+ */
+void window_get(const window_t *w, stats_t *r);
+
+/**
+ * @brief Frees the buffers of the window
+ * @param w
+ */
+void window_free(window_t *w);
+
+/**
+ * @brief Natural logarithm of the binomial coefficient, without overflow for any n
+ * @param n
+ * @param k
+ * @return ln(nCk), -inf if k > n
+ */
+long double log_comb(unsigned long n, unsigned long k);
+
+/**
+ * @brief Probability of k successes in n trials with the success probability p
+ * @param k
+ * @param n
+ * @param p 0 to 1
+ * @return P(X = k), nan if p is not valid
+ */
+long double binomial_pmf(unsigned long k, unsigned long n, long double p);
+
+/**
+ * @brief Probability of at most k successes in n trials with the success probability p
+ * @details Only the logarithm of one term is computed, the other terms follow from the ratio of
+ * neighbouring terms while they are not negligible. Above the mode the upper tail is summed instead.
+ * @param k
+ * @param n
+ * @param p 0 to 1
+ * @return P(X <= k), nan if p is not valid
+ */
+long double binomial_cdf(unsigned long k, unsigned long n, long double p);
+
+/**
+ * @brief Smallest number of successes whose binomial cdf reaches q
+ * @param q probability, 0 to 1
+ * @param n
+ * @param p 0 to 1
+ * @return k, nan if q or p is not valid
+ */
+long double binomial_quantile(long double q, unsigned long n, long double p);
+
+/**
+ * @brief Binomial probabilities of 0 to n successes
+ * @details Computed outwards from the mode by the ratio of neighbouring terms, O(n).
+ * @param n
+ * @param p 0 to 1
+ * @param out n + 1 probabilities, nan if p is not valid
+ */
+void binomial_pmf_array(unsigned long n, long double p, double *out);
+
+/**
+ * @brief Binomial cdf of 0 to n successes
+ * @param n
+ * @param p 0 to 1
+ * @param out n + 1 probabilities, nan if p is not valid
+ */
+void binomial_cdf_array(unsigned long n, long double p, double *out);
+
+/**
+ * @brief Probability of k events of a Poisson distribution with the mean lambda
+ * @param k
+ * @param lambda mean, finite and not negative
+ * @return P(X = k), nan if lambda is not valid
+ */
+long double poisson_pmf(unsigned long k, long double lambda);
+
+/**
+ * @brief Probability of at most k events of a Poisson distribution with the mean lambda
+ * @details Summed from one term in log space like binomial_cdf.
+ * @param k
+ * @param lambda mean, finite and not negative
+ * @return P(X <= k), nan if lambda is not valid
+ */
+long double poisson_cdf(unsigned long k, long double lambda);
+
+/**
+ * @brief Smallest number of events whose Poisson cdf reaches q
+ * @param q probability, 0 to 1
+ * @param lambda mean, finite and not negative
+ * @return k, inf for q = 1 and lambda > 0, nan if q or lambda is not valid
+ */
+long double poisson_quantile(long double q, long double lambda);
+
+/**
+ * @brief Poisson probabilities of 0 to n - 1 events
+ * @param lambda mean, finite and not negative
+ * @param n number of probabilities
+ * @param out probabilities, nan if lambda is not valid
+ */
+void poisson_pmf_array(long double lambda, size_t n, double *out);
+
+/**
+ * @brief Poisson cdf of 0 to n - 1 events
+ * @param lambda mean, finite and not negative
+ * @param n number of probabilities
+ * @param out probabilities, nan if lambda is not valid
+ */
+void poisson_cdf_array(long double lambda, size_t n, double *out);
+
+/**
+ * @brief Density of the normal distribution
+ * @param x
+ * @param mu mean
+ * @param sigma standard deviation, positive
+ * @return density, nan if sigma is not valid
+ */
+long double normal_pdf(long double x, long double mu, long double sigma);
+
+/**
+ * @brief Cumulative distribution function of the normal distribution
+ * @param x
+ * @param mu mean
+ * @param sigma standard deviation, positive
+ * @return P(X <= x), nan if sigma is not valid
+ */
+long double normal_cdf(long double x, long double mu, long double sigma);
+
+/**
+ * @brief Quantile function of the normal distribution
+ * @details A rational approximation refined by Halley steps, the upper half is mirrored so that the
+ * tails keep their relative precision.
+ * @param q probability, 0 to 1
+ * @param mu mean
+ * @param sigma standard deviation, positive
+ * @return x such that P(X <= x) = q, -inf and inf for q of 0 and 1, nan if q or sigma is not valid
+ */
+long double normal_quantile(long double q, long double mu, long double sigma);
+
+/**
+ * @brief Normal density of an array of values
+ * @param x values
+ * @param n number of values
+ * @param mu mean
+ * @param sigma standard deviation, positive
+ * @param out n densities, nan if sigma is not valid
+ */
+void normal_pdf_array(const double *x, size_t n, double mu, double sigma, double *out);
+
+/**
+ * @brief Normal cdf of an array of values
+ * @param x values
+ * @param n number of values
+ * @param mu mean
+ * @param sigma standard deviation, positive
+ * @param out n probabilities, nan if sigma is not valid
+ */
+void normal_cdf_array(const double *x, size_t n, double mu, double sigma, double *out);
+
+/**
+ * @brief Seeds the generator, the state of lane 0 is expanded from the seed by splitmix64
+ * @param r
+ * @param seed
+ */
+void rng_seed(rng_t *r, unsigned long long seed);
+
+/**
+ * @brief Next 64-bit value of the generator
+ * @param r
+ * @return value
+ */
+unsigned long long rng_next(rng_t *r);
+
+/**
+ * @brief Moves the generator to the next of 2^126 non-overlapping streams
+ * @details Every lane jumps RNG_LANES times 2^128 values, past the lanes of the current stream.
+ * @param r
+ */
+void rng_jump(rng_t *r);
+
+/**
+ * @brief Moves the generator by 2^192 values in every lane, to the next of 2^64 groups of streams
+ * @param r
+ */
+void rng_long_jump(rng_t *r);
+
+/**
+ * @brief Uniformly distributed number
+ * @param r
+ * @return multiple of 2^-53 in [0, 1)
+ */
+double rng_uniform(rng_t *r);
+
+/**
+ * @brief Array of uniformly distributed numbers, the same as n calls of rng_uniform
+ * @param r
+ * @param out receives n numbers in [0, 1)
+ * @param n
+ */
+void rng_uniform_array(rng_t *r, double *out, size_t n);
+
+/**
+ * @brief Normally distributed number (ziggurat method with 256 layers)
+ * @param r
+ * @param mu mean
+ * @param sigma standard deviation
+ * @return number
+ */
+double rng_normal(rng_t *r, double mu, double sigma);
+
+/**
+ * @brief Array of normally distributed numbers
+ * @details The bits are generated in blocks, so the numbers differ from those of n calls of rng_normal
+ * once a number is rejected, both are reproducible.
+ * @param r
+ * @param out receives n numbers
+ * @param n
+ * @param mu mean
+ * @param sigma standard deviation
+ */
+void rng_normal_array(rng_t *r, double *out, size_t n, double mu, double sigma);
+
+/**
+ * @brief Monte Carlo estimate of the mean of a random quantity, using several threads
+ * @details The samples are split into at most MC_STREAMS parts of consecutive samples, part i is drawn by
+ * the generator seeded by seed and jumped i times. The threads take whole parts and the summaries are
+ * merged in the order of the parts, so the result does not depend on the number of threads.
+ * @param sample fills blocks of samples
+ * @param arg argument of sample
+ * @param samples number of samples
+ * @param seed seed of the generator
+ * @param threads number of threads, 0 for one per processor
+ * @param result receives the summary of the samples, the estimate is the mean and its standard error the
+ * standard deviation divided by the square root of the count
+ */
+void monte_carlo(monte_carlo_f sample, void *arg, unsigned long long samples, unsigned long long seed,
+                 int threads, stats_t *result);
+
+#endif
@@ -1,121 +1,2226 @@
-/**
- * @file mathlib_tests.cpp
- * @author Stanislav Letaši
- * @brief Tests for math library
- * @date 24.3.2023
- */
-
-#include "googletest-main/googletest/include/gtest/gtest.h"
-#include <math.h>
-
-extern "C"
-{
-#include "math_library.h"
-}
-
-using namespace ::testing;
-
-class BasicTests : public Test
-{
-};
-
-TEST_F(BasicTests, add)
-{
-
-    EXPECT_EQ(add(13, 0), 13);
-    EXPECT_EQ(add(45, 28), 73);
-    EXPECT_EQ(add(0, 0), 0);
-    EXPECT_EQ(add(-77, -69), -146);
-    EXPECT_EQ(add(-77, 69), -8);
-    ASSERT_NEAR(9896.70434, add(42.25847L, 9854.44587L), 1e-8);
-    ASSERT_NEAR(-709.89744, add(-13.89745L, -695.99999L), 1e-8);
-    ASSERT_NEAR(-305.43198, add(28.4569L, -333.88888L), 1e-8);
-    ASSERT_NEAR(23.3223344412L, add(11.12345678945876126L, 12.1988776517894278L), 1e-8);
-}
-
-TEST_F(BasicTests, sub)
-{
-
-    EXPECT_EQ(sub(13, 0), 13);
-    EXPECT_EQ(sub(45, 28), 17);
-    EXPECT_EQ(sub(0, 0), 0);
-    EXPECT_EQ(sub(-77, -69), -8);
-    EXPECT_EQ(sub(-77, 69), -146);
-    ASSERT_NEAR(-9812.1874, sub(42.25847L, 9854.44587L), 1e-8);
-    ASSERT_NEAR(682.10254, sub(-13.89745L, -695.99999L), 1e-8);
-    ASSERT_NEAR(362.34578, sub(28.4569L, -333.88888L), 1e-8);
-    ASSERT_NEAR(-1.07542086233L, sub(11.12345678945876126L, 12.1988776517894278L), 1e-8);
-}
-
-TEST_F(BasicTests, mul)
-{
-
-    EXPECT_EQ(mul(13, 0), 0);
-    EXPECT_EQ(mul(45, 28), 1260);
-    EXPECT_EQ(mul(0, 0), 0);
-    EXPECT_EQ(mul(-77, -69), 5313);
-    EXPECT_EQ(mul(-77, 69), -5313);
-    ASSERT_NEAR(39065.6033528L, mul(42.2584L, 924.44587L), 1e-8);
-    ASSERT_NEAR(9672.62506103L, mul(-13.89745L, -695.99999L), 1e-8);
-    ASSERT_NEAR(-9501.44246927L, mul(28.4569L, -333.88888L), 1e-8);
-    ASSERT_NEAR(135.69368844L, mul(11.12345678945876126L, 12.1988776517894278L), 1e-8);
-}
-
-TEST_F(BasicTests, div)
-{
-
-    EXPECT_EQ(divide(0.0, 96.0), 0);
-    ASSERT_NEAR(1.60714285714L, divide(45, 28), 1e-8);
-    ASSERT_NEAR(1.11594202899L, divide(-77, -69), 1e-8);
-    ASSERT_NEAR(-1.11594202899L, divide(-77, 69), 1e-8);
-    ASSERT_NEAR(0.00428826446L, divide(42.25847L, 9854.44587L), 1e-8);
-    ASSERT_NEAR(0.01996760086L, divide(-13.89745L, -695.99999L), 1e-8);
-    ASSERT_NEAR(-0.08522865451L, divide(28.4569L, -333.88888L), 1e-8);
-    ASSERT_NEAR(0.91184263888L, divide(11.12345678945876126L, 12.1988776517894278L), 1e-8);
-}
-
-TEST_F(BasicTests, factorial)
-{
-
-    EXPECT_EQ(factorial(1), 1);
-    EXPECT_EQ(factorial(0), 1);
-    EXPECT_EQ(factorial(5), 120);
-    EXPECT_EQ(factorial(7), 5040);
-    EXPECT_EQ(factorial(15), 1307674368000);
-    EXPECT_EQ(factorial(20), 2432902008176640000ul);
-}
-
-TEST_F(BasicTests, power)
-{
-
-    EXPECT_EQ(power(45, 2), 2025);
-    EXPECT_EQ(power(-77, 5), -2706784157);
-    EXPECT_EQ(power(-77, 4), 35153041);
-    ASSERT_NEAR(0.00025005294L, power(0.12575L, 4L), 1e-8);
-    ASSERT_NEAR(-23044.2598206L, power(-28.4569L, 3L), 1e-8);
-    EXPECT_EQ(power(1, 200), 1);
-    EXPECT_EQ(power(48, 0), 1);
-}
-
-TEST_F(BasicTests, root)
-{
-
-    EXPECT_EQ(root(1, 10), 1);
-    EXPECT_EQ(root(0, 5), 0);
-    ASSERT_NEAR(6.7082039325L, root(45, 2), 1e-8);
-    ASSERT_NEAR(-1.44224957031L, root(-3, 3), 1e-8);
-    ASSERT_NEAR(-2.38395550345L, root(-77, 5), 1e-8);
-    ASSERT_NEAR(0.59549346304L, root(0.12575, 4), 1e-8);
-    ASSERT_NEAR(-1.61339640149L, root(-28.4569, 7), 1e-8);
-}
-
-TEST_F(BasicTests, comb)
-{
-
-    EXPECT_EQ(comb(45, 2), 990);
-    EXPECT_EQ(comb(77, 5), 19757815);
-    EXPECT_EQ(comb(6, 6), 1);
-    EXPECT_EQ(comb(25, 1), 25);
-    EXPECT_EQ(comb(15, 0), 1);
-    EXPECT_EQ(comb(0, 0), 1);
-}
\ No newline at end of file
+/**
+ * @file mathlib_tests.cpp
+ * @author Stanislav Letaši
+ * @brief Tests for math library
+ * @date 24.3.2023
+ */
+
+#include "googletest-main/googletest/include/gtest/gtest.h"
+#include <algorithm>
+#include <limits.h>
+#include <math.h>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+
+extern "C"
+{
+#include "math_library.h"
+#include "bigint.h"
+#include "rational.h"
+#include "decimal.h"
+#include "bigfloat.h"
+#include "constants.h"
+#include "polynomial.h"
+#include "matrix.h"
+#include "columnar.h"
+#include "extsort.h"
+}
+
+using namespace ::testing;
+
+class BasicTests : public Test
+{
+};
+
+TEST_F(BasicTests, add)
+{
+
+    EXPECT_EQ(add(13, 0), 13);
+    EXPECT_EQ(add(45, 28), 73);
+    EXPECT_EQ(add(0, 0), 0);
+    EXPECT_EQ(add(-77, -69), -146);
+    EXPECT_EQ(add(-77, 69), -8);
+    ASSERT_NEAR(9896.70434, add(42.25847L, 9854.44587L), 1e-8);
+    ASSERT_NEAR(-709.89744, add(-13.89745L, -695.99999L), 1e-8);
+    ASSERT_NEAR(-305.43198, add(28.4569L, -333.88888L), 1e-8);
+    ASSERT_NEAR(23.3223344412L, add(11.12345678945876126L, 12.1988776517894278L), 1e-8);
+}
+
+TEST_F(BasicTests, sub)
+{
+
+    EXPECT_EQ(sub(13, 0), 13);
+    EXPECT_EQ(sub(45, 28), 17);
+    EXPECT_EQ(sub(0, 0), 0);
+    EXPECT_EQ(sub(-77, -69), -8);
+    EXPECT_EQ(sub(-77, 69), -146);
+    ASSERT_NEAR(-9812.1874, sub(42.25847L, 9854.44587L), 1e-8);
+    ASSERT_NEAR(682.10254, sub(-13.89745L, -695.99999L), 1e-8);
+    ASSERT_NEAR(362.34578, sub(28.4569L, -333.88888L), 1e-8);
+    ASSERT_NEAR(-1.07542086233L, sub(11.12345678945876126L, 12.1988776517894278L), 1e-8);
+}
+
+TEST_F(BasicTests, mul)
+{
+
+    EXPECT_EQ(mul(13, 0), 0);
+    EXPECT_EQ(mul(45, 28), 1260);
+    EXPECT_EQ(mul(0, 0), 0);
+    EXPECT_EQ(mul(-77, -69), 5313);
+    EXPECT_EQ(mul(-77, 69), -5313);
+    ASSERT_NEAR(39065.6033528L, mul(42.2584L, 924.44587L), 1e-8);
+    ASSERT_NEAR(9672.62506103L, mul(-13.89745L, -695.99999L), 1e-8);
+    ASSERT_NEAR(-9501.44246927L, mul(28.4569L, -333.88888L), 1e-8);
+    ASSERT_NEAR(135.69368844L, mul(11.12345678945876126L, 12.1988776517894278L), 1e-8);
+}
+
+TEST_F(BasicTests, div)
+{
+
+    EXPECT_EQ(divide(0.0, 96.0), 0);
+    ASSERT_NEAR(1.60714285714L, divide(45, 28), 1e-8);
+    ASSERT_NEAR(1.11594202899L, divide(-77, -69), 1e-8);
+    ASSERT_NEAR(-1.11594202899L, divide(-77, 69), 1e-8);
+    ASSERT_NEAR(0.00428826446L, divide(42.25847L, 9854.44587L), 1e-8);
+    ASSERT_NEAR(0.01996760086L, divide(-13.89745L, -695.99999L), 1e-8);
+    ASSERT_NEAR(-0.08522865451L, divide(28.4569L, -333.88888L), 1e-8);
+    ASSERT_NEAR(0.91184263888L, divide(11.12345678945876126L, 12.1988776517894278L), 1e-8);
+}
+
+TEST_F(BasicTests, factorial)
+{
+
+    EXPECT_EQ(factorial(1), 1);
+    EXPECT_EQ(factorial(0), 1);
+    EXPECT_EQ(factorial(5), 120);
+    EXPECT_EQ(factorial(7), 5040);
+    EXPECT_EQ(factorial(15), 1307674368000);
+    EXPECT_EQ(factorial(20), 2432902008176640000ul);
+}
+
+TEST_F(BasicTests, power)
+{
+
+    EXPECT_EQ(power(45, 2), 2025);
+    EXPECT_EQ(power(-77, 5), -2706784157);
+    EXPECT_EQ(power(-77, 4), 35153041);
+    ASSERT_NEAR(0.00025005294L, power(0.12575L, 4L), 1e-8);
+    ASSERT_NEAR(-23044.2598206L, power(-28.4569L, 3L), 1e-8);
+    EXPECT_EQ(power(1, 200), 1);
+    EXPECT_EQ(power(48, 0), 1);
+}
+
+TEST_F(BasicTests, root)
+{
+
+    EXPECT_EQ(root(1, 10), 1);
+    EXPECT_EQ(root(0, 5), 0);
+    ASSERT_NEAR(6.7082039325L, root(45, 2), 1e-8);
+    ASSERT_NEAR(-1.44224957031L, root(-3, 3), 1e-8);
+    ASSERT_NEAR(-2.38395550345L, root(-77, 5), 1e-8);
+    ASSERT_NEAR(0.59549346304L, root(0.12575, 4), 1e-8);
+    ASSERT_NEAR(-1.61339640149L, root(-28.4569, 7), 1e-8);
+}
+
+TEST_F(BasicTests, comb)
+{
+
+    EXPECT_EQ(comb(45, 2), 990);
+    EXPECT_EQ(comb(77, 5), 19757815);
+    EXPECT_EQ(comb(6, 6), 1);
+    EXPECT_EQ(comb(25, 1), 25);
+    EXPECT_EQ(comb(15, 0), 1);
+    EXPECT_EQ(comb(0, 0), 1);
+}
+class NumberTheoryTests : public Test
+{
+};
+
+TEST_F(NumberTheoryTests, is_prime)
+{
+    EXPECT_FALSE(is_prime(0));
+    EXPECT_FALSE(is_prime(1));
+    EXPECT_TRUE(is_prime(2));
+    EXPECT_TRUE(is_prime(37));
+    EXPECT_FALSE(is_prime(1369));
+    EXPECT_TRUE(is_prime(1000000007ull));
+    EXPECT_FALSE(is_prime(3215031751ull)); // strong pseudoprime to bases 2, 3, 5, 7
+    EXPECT_TRUE(is_prime(18446744073709551557ull)); // largest 64-bit prime
+    EXPECT_FALSE(is_prime(18446744073709551615ull));
+    EXPECT_FALSE(is_prime(4294967291ull * 4294967291ull));
+}
+
+TEST_F(NumberTheoryTests, factorize)
+{
+    unsigned long long f[MAX_PRIME_FACTORS];
+
+    EXPECT_EQ(factorize(1, f), 0);
+    ASSERT_EQ(factorize(360, f), 6);
+    EXPECT_EQ(f[0], 2ull);
+    EXPECT_EQ(f[2], 2ull);
+    EXPECT_EQ(f[3], 3ull);
+    EXPECT_EQ(f[5], 5ull);
+
+    ASSERT_EQ(factorize(1ull << 63, f), 63);
+    EXPECT_EQ(f[62], 2ull);
+
+    ASSERT_EQ(factorize(4294967291ull * 4294967279ull, f), 2);
+    EXPECT_EQ(f[0], 4294967279ull);
+    EXPECT_EQ(f[1], 4294967291ull);
+
+    ASSERT_EQ(factorize(4294967291ull * 4294967291ull, f), 2);
+    EXPECT_EQ(f[0], 4294967291ull);
+    EXPECT_EQ(f[1], 4294967291ull);
+
+    ASSERT_EQ(factorize(18446744073709551615ull, f), 7); // 3*5*17*257*641*65537*6700417
+    EXPECT_EQ(f[0], 3ull);
+    EXPECT_EQ(f[6], 6700417ull);
+
+    ASSERT_EQ(factorize(18446744073709551557ull, f), 1);
+    EXPECT_EQ(f[0], 18446744073709551557ull);
+}
+
+TEST_F(NumberTheoryTests, gcd)
+{
+    EXPECT_EQ(gcd(0, 0), 0ull);
+    EXPECT_EQ(gcd(0, 7), 7ull);
+    EXPECT_EQ(gcd(12, 0), 12ull);
+    EXPECT_EQ(gcd(12, 18), 6ull);
+    EXPECT_EQ(gcd(17, 5), 1ull);
+    EXPECT_EQ(gcd(1ull << 40, 3ull << 20), 1ull << 20);
+    EXPECT_EQ(gcd(18446744073709551615ull, 6700417ull * 641), 6700417ull * 641);
+
+    unsigned __int128 big = ((unsigned __int128)1 << 100) * 3;
+    EXPECT_TRUE(gcd_u128(big, (unsigned __int128)9 << 90) == ((unsigned __int128)3 << 90));
+    EXPECT_TRUE(gcd_u128(big, 0) == big);
+}
+
+TEST_F(NumberTheoryTests, lcm)
+{
+    EXPECT_EQ(lcm(0, 5), 0ull);
+    EXPECT_EQ(lcm(4, 6), 12ull);
+    EXPECT_EQ(lcm(21, 6), 42ull);
+    EXPECT_EQ(lcm(1ull << 63, 3), 0ull); // overflow
+    EXPECT_TRUE(lcm_u128(1ull << 63, 3) == ((unsigned __int128)3 << 63));
+}
+
+TEST_F(NumberTheoryTests, gcd_array)
+{
+    unsigned long long arr[] = {84, 126, 210, 294};
+    EXPECT_EQ(gcd_array(arr, 4), 42ull);
+    EXPECT_EQ(gcd_array(arr, 0), 0ull);
+    EXPECT_EQ(lcm_array(arr, 3), 1260ull);
+    EXPECT_EQ(lcm_array(arr, 0), 1ull);
+
+    reduce_ratio(arr, 4);
+    EXPECT_EQ(arr[0], 2ull);
+    EXPECT_EQ(arr[1], 3ull);
+    EXPECT_EQ(arr[2], 5ull);
+    EXPECT_EQ(arr[3], 7ull);
+
+    long long num[] = {6, -10, 9, 0, 5};
+    long long den[] = {8, 4, -12, 7, 0};
+    reduce_fractions(num, den, 5);
+    EXPECT_EQ(num[0], 3);
+    EXPECT_EQ(den[0], 4);
+    EXPECT_EQ(num[1], -5);
+    EXPECT_EQ(den[1], 2);
+    EXPECT_EQ(num[2], -3);
+    EXPECT_EQ(den[2], 4);
+    EXPECT_EQ(num[3], 0);
+    EXPECT_EQ(den[3], 1);
+    EXPECT_EQ(num[4], 5);
+    EXPECT_EQ(den[4], 0);
+
+    // a magnitude of 2^63 only fits as a negative numerator
+    long long num_min[] = {1, LLONG_MIN, LLONG_MIN, LLONG_MIN, LLONG_MIN, 3};
+    long long den_min[] = {LLONG_MIN, -1, 1, -2, LLONG_MIN, LLONG_MIN};
+    reduce_fractions(num_min, den_min, 6);
+    EXPECT_EQ(num_min[0], 1); // unchanged
+    EXPECT_EQ(den_min[0], LLONG_MIN);
+    EXPECT_EQ(num_min[1], LLONG_MIN); // unchanged
+    EXPECT_EQ(den_min[1], -1);
+    EXPECT_EQ(num_min[2], LLONG_MIN);
+    EXPECT_EQ(den_min[2], 1);
+    EXPECT_EQ(num_min[3], 1ll << 62);
+    EXPECT_EQ(den_min[3], 1);
+    EXPECT_EQ(num_min[4], 1);
+    EXPECT_EQ(den_min[4], 1);
+    EXPECT_EQ(num_min[5], 3); // unchanged
+    EXPECT_EQ(den_min[5], LLONG_MIN);
+}
+
+TEST_F(NumberTheoryTests, fibonacci)
+{
+    EXPECT_EQ(fibonacci(0), 0);
+    EXPECT_EQ(fibonacci(1), 1);
+    EXPECT_EQ(fibonacci(2), 1);
+    EXPECT_EQ(fibonacci(10), 55);
+    EXPECT_EQ(fibonacci(90), 2880067194370816120ull);
+    EXPECT_EQ(lucas(0), 2);
+    EXPECT_EQ(lucas(1), 1);
+    EXPECT_EQ(lucas(10), 123);
+    ASSERT_NEAR(3.54224848179261915075e20L / fibonacci(100), 1.0L, 1e-15);
+
+    unsigned __int128 f;
+    ASSERT_TRUE(fibonacci_exact(100, &f));
+    EXPECT_TRUE(f == (unsigned __int128)3542248481ull * 100000000000ull + 79261915075ull);
+    ASSERT_TRUE(fibonacci_exact(FIBONACCI_EXACT_MAX, &f));
+    EXPECT_TRUE(f / 1000000000000000000ull / 1000000000000000000ull == 332ull); // F(186) = 332825...
+    EXPECT_FALSE(fibonacci_exact(FIBONACCI_EXACT_MAX + 1, &f));
+    ASSERT_TRUE(lucas_exact(100, &f));
+    EXPECT_TRUE(f == (unsigned __int128)7920708398ull * 100000000000ull + 48372253127ull);
+    EXPECT_FALSE(lucas_exact(LUCAS_EXACT_MAX + 1, &f));
+
+    // big integers agree with the 128-bit values, the residues and the digits of the display limit
+    bigint_t big;
+    bigint_init(&big);
+    char str[128];
+    for (unsigned long n : {0ul, 1ul, 2ul, 100ul, (unsigned long)FIBONACCI_EXACT_MAX})
+    {
+        fibonacci_big(n, &big);
+        ASSERT_TRUE(fibonacci_exact(n, &f));
+        ASSERT_LE(big.size, 2u);
+        EXPECT_EQ(big.size > 0 ? big.limbs[0] : 0, (uint64_t)f) << n;
+        EXPECT_EQ(big.size > 1 ? big.limbs[1] : 0, (uint64_t)(f >> 64)) << n;
+    }
+    lucas_big(100, &big);
+    bigint_get_string(&big, str, sizeof(str));
+    EXPECT_STREQ(str, "792070839848372253127");
+    fibonacci_big(FIBONACCI_DIGITS100_MAX, &big);
+    EXPECT_EQ(bigint_get_string(&big, str, sizeof(str)), 100u);
+    fibonacci_big(FIBONACCI_DIGITS100_MAX + 1, &big);
+    EXPECT_EQ(bigint_get_string(&big, str, sizeof(str)), 101u);
+    lucas_big(LUCAS_DIGITS100_MAX, &big);
+    EXPECT_EQ(bigint_get_string(&big, str, sizeof(str)), 100u);
+    lucas_big(LUCAS_DIGITS100_MAX + 1, &big);
+    EXPECT_EQ(bigint_get_string(&big, str, sizeof(str)), 101u);
+    fibonacci_big(1000000, &big);
+    EXPECT_EQ(bigint_bit_length(&big), 694241u); // F(10^6) has 208988 digits
+    EXPECT_EQ(bigint_divmod_u64(&big, &big, 1000000007ull), fibonacci_mod(1000000, 1000000007ull));
+    bigint_free(&big);
+}
+
+TEST_F(NumberTheoryTests, fibonacci_mod)
+{
+    EXPECT_EQ(fibonacci_mod(10, 1), 0ull);
+    EXPECT_EQ(fibonacci_mod(10, 7), 55ull % 7);
+    EXPECT_EQ(fibonacci_mod(100, 1000000007ull), 687995182ull);
+    EXPECT_EQ(fibonacci_mod(1000000, 1000000007ull), 918091266ull);
+    // F(n) = F(n-1) + F(n-2) also holds for the residues with a modulus close to 2^64
+    unsigned long long m = 18446744073709551557ull;
+    unsigned long long n = 1000000000000000000ull;
+    EXPECT_EQ(fibonacci_mod(n, m), (fibonacci_mod(n - 1, m) + (unsigned __int128)fibonacci_mod(n - 2, m)) % m);
+    EXPECT_EQ(lucas_mod(10, 100), 23ull);
+    EXPECT_EQ(lucas_mod(0, 5), 2ull);
+}
+
+TEST_F(NumberTheoryTests, comb_row)
+{
+    // rows of Pascal's triangle built by additions
+    std::vector<unsigned __int128> pascal(1, 1);
+    std::vector<unsigned long long> row64(COMB_ROW_U64_MAX + 2);
+    std::vector<unsigned __int128> row128(COMB_ROW_EXACT_MAX + 2);
+    std::vector<long double> rowld(COMB_ROW_EXACT_MAX + 2);
+    for (unsigned long n = 0; n <= COMB_ROW_EXACT_MAX; n++)
+    {
+        ASSERT_TRUE(comb_row_exact(n, row128.data()));
+        comb_row(n, rowld.data());
+        if (n <= COMB_ROW_U64_MAX)
+        {
+            ASSERT_TRUE(comb_row_u64(n, row64.data()));
+        }
+        for (unsigned long k = 0; k <= n; k++)
+        {
+            ASSERT_TRUE(row128[k] == pascal[k]);
+            ASSERT_LE(fabsl(rowld[k] - (long double)pascal[k]), 1e-17L * (long double)pascal[k]);
+            if (n <= COMB_ROW_U64_MAX)
+            {
+                ASSERT_EQ(row64[k], (unsigned long long)pascal[k]);
+                ASSERT_EQ(rowld[k], (long double)row64[k]);
+            }
+        }
+        pascal.push_back(1);
+        for (unsigned long k = n; k > 0; k--)
+        {
+            pascal[k] += pascal[k - 1];
+        }
+    }
+    EXPECT_FALSE(comb_row_u64(COMB_ROW_U64_MAX + 1, row64.data()));
+    EXPECT_FALSE(comb_row_exact(COMB_ROW_EXACT_MAX + 1, row128.data()));
+
+    std::vector<long double> big(1001);
+    comb_row(1000, big.data());
+    EXPECT_NEAR(logl(big[500]), log_comb(1000, 500), 1e-15);
+    EXPECT_NEAR(logl(big[17]), log_comb(1000, 17), 1e-15);
+
+    // primes below n use Lucas' theorem, the largest one the inverses
+    const unsigned long long primes[] = {2, 7, 1000000007ull, 18446744073709551557ull};
+    std::vector<unsigned long long> row(301);
+    for (unsigned long long m : primes)
+    {
+        std::vector<unsigned long long> triangle(1, 1 % m);
+        for (unsigned long n = 0; n <= 300; n++)
+        {
+            ASSERT_TRUE(comb_row_mod(n, m, row.data()));
+            for (unsigned long k = 0; k <= n; k++)
+            {
+                ASSERT_EQ(row[k], triangle[k]);
+            }
+            triangle.push_back(1 % m);
+            for (unsigned long k = n; k > 0; k--)
+            {
+                triangle[k] = (triangle[k] + (unsigned __int128)triangle[k - 1]) % m;
+            }
+        }
+    }
+    EXPECT_FALSE(comb_row_mod(10, 1000000008ull, row.data()));
+    EXPECT_FALSE(comb_row_mod(10, 1, row.data()));
+}
+
+TEST_F(NumberTheoryTests, linear_recurrence)
+{
+    // Fibonacci as a recurrence of order 2
+    long double fib_coef[] = {1, 1};
+    long double fib_init[] = {0, 1};
+    EXPECT_EQ(linear_recurrence(fib_coef, fib_init, 2, 0), 0);
+    EXPECT_EQ(linear_recurrence(fib_coef, fib_init, 2, 1), 1);
+    EXPECT_EQ(linear_recurrence(fib_coef, fib_init, 2, 50), fibonacci(50));
+
+    // tribonacci: 0, 0, 1, 1, 2, 4, 7, 13, 24, 44, 81
+    long double tri_coef[] = {1, 1, 1};
+    long double tri_init[] = {0, 0, 1};
+    EXPECT_EQ(linear_recurrence(tri_coef, tri_init, 3, 10), 81);
+
+    // a(n) = 2a(n-1) => 3 * 2^n
+    long double geo_coef[] = {2};
+    long double geo_init[] = {3};
+    EXPECT_EQ(linear_recurrence(geo_coef, geo_init, 1, 20), 3 * 1048576);
+
+    unsigned long long fib_coef_mod[] = {1, 1};
+    unsigned long long fib_init_mod[] = {0, 1};
+    EXPECT_EQ(linear_recurrence_mod(fib_coef_mod, fib_init_mod, 2, 1000000, 1000000007ull),
+              fibonacci_mod(1000000, 1000000007ull));
+    unsigned long long tri_coef_mod[] = {1, 1, 1};
+    unsigned long long tri_init_mod[] = {0, 0, 1};
+    EXPECT_EQ(linear_recurrence_mod(tri_coef_mod, tri_init_mod, 3, 10, 7), 81ull % 7);
+
+    // exact terms of any size, also with negative coefficients
+    bigint_t big, fib;
+    bigint_init(&big);
+    bigint_init(&fib);
+    long long fib_coef_big[] = {1, 1};
+    long long fib_init_big[] = {0, 1};
+    linear_recurrence_big(fib_coef_big, fib_init_big, 2, 1000, &big);
+    fibonacci_big(1000, &fib);
+    EXPECT_EQ(bigint_cmp(&big, &fib), 0);
+    long long tri_coef_big[] = {1, 1, 1};
+    long long tri_init_big[] = {0, 0, 1};
+    linear_recurrence_big(tri_coef_big, tri_init_big, 3, 10, &big);
+    EXPECT_EQ(bigint_get_ld(&big), 81.0L);
+    // a(n) = 2a(n-1) - a(n-2) + 0a(n-3) with a(0) = -5, a(1) = -2 => 3n - 5, init[2] = 1
+    long long lin_coef_big[] = {2, -1, 0};
+    long long lin_init_big[] = {-5, -2, 1};
+    linear_recurrence_big(lin_coef_big, lin_init_big, 3, 1000000, &big);
+    EXPECT_EQ(bigint_get_ld(&big), 2999995.0L);
+    linear_recurrence_big(lin_coef_big, lin_init_big, 3, 1, &big);
+    EXPECT_EQ(bigint_get_ld(&big), -2.0L);
+    bigint_free(&big);
+    bigint_free(&fib);
+}
+
+class BigintTests : public Test
+{
+};
+
+TEST_F(BigintTests, string_conversion)
+{
+    bigint_t a;
+    bigint_init(&a);
+    char str[100];
+    const char *num = "-123456789012345678901234567890123456789012345678901234567890";
+    ASSERT_TRUE(bigint_set_string(&a, num, strlen(num)));
+    EXPECT_EQ(bigint_get_string(&a, str, sizeof(str)), strlen(num));
+    EXPECT_STREQ(str, num);
+    ASSERT_TRUE(bigint_set_string(&a, "+0000", 5));
+    EXPECT_TRUE(bigint_is_zero(&a));
+    bigint_get_string(&a, str, sizeof(str));
+    EXPECT_STREQ(str, "0");
+    EXPECT_FALSE(bigint_set_string(&a, "12a", 3));
+    EXPECT_FALSE(bigint_set_string(&a, "-", 1));
+    bigint_free(&a);
+}
+
+TEST_F(BigintTests, arithmetic)
+{
+    bigint_t a, b, c, q, r;
+    bigint_init(&a);
+    bigint_init(&b);
+    bigint_init(&c);
+    bigint_init(&q);
+    bigint_init(&r);
+    char str[200];
+
+    // (2^64 - 1) + 1 = 2^64
+    bigint_set_u64(&a, 18446744073709551615ull);
+    bigint_set_u64(&b, 1);
+    bigint_add(&c, &a, &b);
+    bigint_get_string(&c, str, sizeof(str));
+    EXPECT_STREQ(str, "18446744073709551616");
+    bigint_sub(&c, &b, &c);
+    bigint_get_string(&c, str, sizeof(str));
+    EXPECT_STREQ(str, "-18446744073709551615");
+
+    // 2^200 / 3^50
+    bigint_set_u64(&a, 2);
+    bigint_pow_u64(&a, &a, 200);
+    bigint_get_string(&a, str, sizeof(str));
+    EXPECT_STREQ(str, "1606938044258990275541962092341162602522202993782792835301376");
+    bigint_set_u64(&b, 3);
+    bigint_pow_u64(&b, &b, 50);
+    bigint_divmod(&q, &r, &a, &b);
+    bigint_get_string(&q, str, sizeof(str));
+    EXPECT_STREQ(str, "2238393297946874000179418290327143433");
+    bigint_get_string(&r, str, sizeof(str));
+    EXPECT_STREQ(str, "249667313308346329176559");
+    bigint_mul(&c, &q, &b);
+    bigint_add(&c, &c, &r);
+    EXPECT_EQ(bigint_cmp(&c, &a), 0);
+
+    bigint_neg(&a, &a);
+    bigint_divmod(&q, &r, &a, &b);
+    EXPECT_EQ(q.sign, -1);
+    EXPECT_EQ(r.sign, -1);
+
+    bigint_shl(&c, &b, 100);
+    bigint_shr(&c, &c, 100);
+    EXPECT_EQ(bigint_cmp(&c, &b), 0);
+    EXPECT_EQ(bigint_bit_length(&b), 80u); // 3^50 < 2^80
+
+    // gcd(6^40, 4^30) = 2^40
+    bigint_set_u64(&a, 6);
+    bigint_pow_u64(&a, &a, 40);
+    bigint_set_u64(&b, 4);
+    bigint_pow_u64(&b, &b, 30);
+    bigint_gcd(&c, &a, &b);
+    bigint_set_u64(&a, 1ull << 40);
+    EXPECT_EQ(bigint_cmp(&c, &a), 0);
+
+    // a * x + y with a negative a, also when the result crosses zero
+    bigint_set_i64(&a, -5);
+    bigint_mul_add_u64(&c, &a, 2, 3);
+    bigint_get_string(&c, str, sizeof(str));
+    EXPECT_STREQ(str, "-7");
+    bigint_mul_add_u64(&c, &a, 2, 10);
+    EXPECT_TRUE(bigint_is_zero(&c));
+    EXPECT_EQ(c.sign, 1);
+    bigint_mul_add_u64(&c, &a, 2, 18446744073709551615ull);
+    bigint_get_string(&c, str, sizeof(str));
+    EXPECT_STREQ(str, "18446744073709551605");
+    bigint_mul_add_u64(&c, &a, 0, 4);
+    bigint_get_string(&c, str, sizeof(str));
+    EXPECT_STREQ(str, "4");
+    bigint_set_u64(&a, 1);
+    bigint_shl(&a, &a, 128);
+    bigint_neg(&a, &a);
+    bigint_mul_add_u64(&c, &a, 1, 1); // -2^128 + 1, borrows through two limbs
+    bigint_get_string(&c, str, sizeof(str));
+    EXPECT_STREQ(str, "-340282366920938463463374607431768211455");
+    bigint_set_u64(&a, 7);
+    bigint_mul_add_u64(&c, &a, 3, 1);
+    bigint_get_string(&c, str, sizeof(str));
+    EXPECT_STREQ(str, "22");
+
+    bigint_free(&a);
+    bigint_free(&b);
+    bigint_free(&c);
+    bigint_free(&q);
+    bigint_free(&r);
+}
+
+class RationalTests : public Test
+{
+};
+
+TEST_F(RationalTests, arithmetic)
+{
+    rational_t a, b, c;
+    rational_init(&a);
+    rational_init(&b);
+    rational_init(&c);
+    char str[200];
+
+    // 1/3 * 3 = 1
+    rational_set_i64(&a, 1, 3);
+    rational_set_i64(&b, 3, 1);
+    rational_mul(&c, &a, &b);
+    rational_get_string(&c, str, sizeof(str));
+    EXPECT_STREQ(str, "1");
+
+    // 1/6 - 1/4 = -1/12
+    rational_set_i64(&a, 1, 6);
+    rational_set_i64(&b, 1, 4);
+    rational_sub(&c, &a, &b);
+    rational_get_string(&c, str, sizeof(str));
+    EXPECT_STREQ(str, "-1/12");
+
+    EXPECT_FALSE(rational_div(&c, &a, &c) && rational_is_zero(&c));
+    rational_set_i64(&b, 0, 5);
+    EXPECT_FALSE(rational_div(&c, &a, &b));
+
+    ASSERT_TRUE(rational_set_decimal(&a, "-12.5e-3", '.'));
+    rational_get_string(&a, str, sizeof(str));
+    EXPECT_STREQ(str, "-1/80");
+    ASSERT_TRUE(rational_set_decimal(&a, "0,1", ','));
+    ASSERT_TRUE(rational_set_decimal(&b, "0,2", ','));
+    rational_add(&c, &a, &b);
+    rational_get_string(&c, str, sizeof(str));
+    EXPECT_STREQ(str, "3/10");
+    EXPECT_FALSE(rational_set_decimal(&a, "1.2.3", '.'));
+
+    rational_set_ld(&a, 0.375L);
+    rational_get_string(&a, str, sizeof(str));
+    EXPECT_STREQ(str, "3/8");
+    rational_set_ld(&a, -1e30L);
+    EXPECT_EQ(rational_get_ld(&a), -1e30L);
+
+    rational_free(&a);
+    rational_free(&b);
+    rational_free(&c);
+}
+
+TEST_F(RationalTests, promotion)
+{
+    rational_t a, sum, term;
+    rational_init(&a);
+    rational_init(&sum);
+    rational_init(&term);
+    char str[400];
+
+    // (2/3)^200 does not fit in 128 bits
+    rational_set_i64(&a, 2, 3);
+    rational_pow(&a, &a, 200);
+    EXPECT_TRUE(a.big);
+    ASSERT_NEAR(rational_get_ld(&a), 6.0498998981937e-36L, 1e-47L);
+    rational_mul(&a, &a, &a);
+    rational_pow(&term, &a, 0);
+    rational_get_string(&term, str, sizeof(str));
+    EXPECT_STREQ(str, "1");
+
+    // harmonic number H(100) requires big numbers with lazy reduction
+    for (int i = 1; i <= 100; i++)
+    {
+        rational_set_i64(&term, 1, i);
+        rational_add(&sum, &sum, &term);
+    }
+    ASSERT_NEAR(rational_get_ld(&sum), 5.18737751763962026080511767565825315790897212670845165317653L, 1e-15L);
+    rational_get_string(&sum, str, sizeof(str));
+    EXPECT_STREQ(str, "14466636279520351160221518043104131447711/2788815009188499086581352357412492142272");
+    // and back: H(100) - H(100) = 0, small again
+    rational_sub(&sum, &sum, &sum);
+    EXPECT_TRUE(rational_is_zero(&sum));
+    EXPECT_TRUE(rational_is_integer(&sum));
+    EXPECT_FALSE(sum.big);
+
+    rational_free(&a);
+    rational_free(&sum);
+    rational_free(&term);
+}
+
+class DecimalTests : public Test
+{
+};
+
+TEST_F(DecimalTests, arithmetic)
+{
+    decimal128_t a, b;
+    char str[DEC_STRING_SIZE];
+
+    ASSERT_TRUE(dec128_from_string(&a, "0.1", '.'));
+    ASSERT_TRUE(dec128_from_string(&b, "0.2", '.'));
+    dec128_to_string(dec128_add(a, b), str, '.');
+    EXPECT_STREQ(str, "0.3");
+    dec128_to_string(dec128_sub(a, b), str, '.');
+    EXPECT_STREQ(str, "-0.1");
+    dec128_to_string(dec128_mul(a, b), str, '.');
+    EXPECT_STREQ(str, "0.02");
+    dec128_to_string(dec128_div(a, b), str, '.');
+    EXPECT_STREQ(str, "0.5");
+
+    // trailing zeros of the operands are kept
+    ASSERT_TRUE(dec128_from_string(&a, "1,50", ','));
+    dec128_to_string(dec128_add(a, a), str, ',');
+    EXPECT_STREQ(str, "3,00");
+
+    // rounding to 34 digits, half to even
+    ASSERT_TRUE(dec128_from_string(&a, "1", '.'));
+    ASSERT_TRUE(dec128_from_string(&b, "3", '.'));
+    dec128_to_string(dec128_div(a, b), str, '.');
+    EXPECT_STREQ(str, "0.3333333333333333333333333333333333");
+    ASSERT_TRUE(dec128_from_string(&a, "2", '.'));
+    dec128_to_string(dec128_div(a, b), str, '.');
+    EXPECT_STREQ(str, "0.6666666666666666666666666666666667");
+    ASSERT_TRUE(dec128_from_string(&a, "12345678901234567890123456789012345", '.'));
+    dec128_to_string(a, str, '.');
+    EXPECT_STREQ(str, "1.234567890123456789012345678901234e+34");
+    ASSERT_TRUE(dec128_from_string(&a, "1234567890123456789012345678901235", '.'));
+    ASSERT_TRUE(dec128_from_string(&b, "0.5", '.'));
+    dec128_to_string(dec128_add(a, b), str, '.');
+    EXPECT_STREQ(str, "1234567890123456789012345678901236");
+    ASSERT_TRUE(dec128_from_string(&a, "1234567890123456789012345678901234", '.'));
+    dec128_to_string(dec128_add(a, b), str, '.');
+    EXPECT_STREQ(str, "1234567890123456789012345678901234");
+
+    // products and quotients wider than 128 bits
+    ASSERT_TRUE(dec128_from_string(&a, "9999999999999999999999999999999999", '.'));
+    dec128_to_string(dec128_mul(a, a), str, '.');
+    EXPECT_STREQ(str, "9.999999999999999999999999999999998e+67");
+    ASSERT_TRUE(dec128_from_string(&b, "7.777777777777777777777777777777777", '.'));
+    dec128_to_string(dec128_div(a, b), str, '.');
+    EXPECT_STREQ(str, "1285714285714285714285714285714286");
+
+    // far apart exponents, exponent range, specials
+    ASSERT_TRUE(dec128_from_string(&a, "1e100", '.'));
+    ASSERT_TRUE(dec128_from_string(&b, "-1e-100", '.'));
+    dec128_to_string(dec128_add(a, b), str, '.');
+    EXPECT_STREQ(str, "1.000000000000000000000000000000000e+100");
+    ASSERT_TRUE(dec128_from_string(&a, "1e6144", '.'));
+    EXPECT_FALSE(dec128_is_finite(dec128_mul(a, a)));
+    ASSERT_TRUE(dec128_from_string(&b, "0", '.'));
+    dec128_to_string(dec128_div(a, b), str, '.');
+    EXPECT_STREQ(str, "inf");
+    EXPECT_FALSE(dec128_from_string(&a, "1.2.3", '.'));
+    EXPECT_FALSE(dec128_from_string(&a, "e5", '.'));
+
+    dec128_to_string(dec128_from_ld(0.1L), str, '.');
+    EXPECT_STREQ(str, "0.1");
+    dec128_to_string(dec128_from_ld(-2432902008176640000.0L), str, '.');
+    EXPECT_STREQ(str, "-2432902008176640000");
+    EXPECT_EQ(dec128_to_ld(dec128_from_ld(-1.25e-30L)), -1.25e-30L);
+}
+
+TEST_F(DecimalTests, decimal64)
+{
+    decimal64_t a, b;
+    char str[DEC_STRING_SIZE];
+
+    ASSERT_TRUE(dec64_from_string(&a, "0.1", '.'));
+    ASSERT_TRUE(dec64_from_string(&b, "0.2", '.'));
+    EXPECT_EQ(dec64_add(a, b).bits, 0x31A0000000000003ULL); // 3E-1
+    dec64_to_string(dec64_add(a, b), str, '.');
+    EXPECT_STREQ(str, "0.3");
+
+    // coefficient in the large-coefficient encoding
+    ASSERT_TRUE(dec64_from_string(&a, "9999999999999999", '.'));
+    EXPECT_EQ(a.bits >> 61, 3ULL);
+    dec64_to_string(a, str, '.');
+    EXPECT_STREQ(str, "9999999999999999");
+    ASSERT_TRUE(dec64_from_string(&b, "1", '.'));
+    dec64_to_string(dec64_add(a, b), str, '.');
+    EXPECT_STREQ(str, "1.000000000000000e+16");
+    dec64_to_string(dec64_div(b, dec64_from_ld(7.0L)), str, '.');
+    EXPECT_STREQ(str, "0.1428571428571429");
+    dec64_to_string(dec64_mul(a, a), str, '.');
+    EXPECT_STREQ(str, "9.999999999999998e+31");
+
+    // subnormal results lose digits
+    ASSERT_TRUE(dec64_from_string(&a, "1.234e-395", '.'));
+    ASSERT_TRUE(dec64_from_string(&b, "0.001", '.'));
+    dec64_to_string(dec64_mul(a, b), str, '.');
+    EXPECT_STREQ(str, "1e-398");
+    EXPECT_TRUE(dec64_is_zero(dec64_mul(b, dec64_mul(a, b))));
+}
+
+class BigfloatTests : public Test
+{
+};
+
+TEST_F(BigfloatTests, arithmetic)
+{
+    bigfloat_t a, b, c;
+    size_t prec = bigfloat_digits_to_prec(60);
+    bigfloat_init(&a, prec);
+    bigfloat_init(&b, prec);
+    bigfloat_init(&c, prec);
+    char str[300];
+
+    ASSERT_TRUE(bigfloat_set_string(&a, "1", '.'));
+    ASSERT_TRUE(bigfloat_set_string(&b, "3", '.'));
+    ASSERT_TRUE(bigfloat_div(&c, &a, &b));
+    bigfloat_get_string(&c, str, sizeof(str), 60, '.');
+    EXPECT_STREQ(str, "0.333333333333333333333333333333333333333333333333333333333333");
+    bigfloat_mul(&c, &c, &b);
+    bigfloat_get_string(&c, str, sizeof(str), 60, '.');
+    EXPECT_STREQ(str, "1");
+    EXPECT_FALSE(bigfloat_div(&c, &a, &c) && bigfloat_is_zero(&c));
+    bigfloat_set_i64(&b, 0);
+    EXPECT_FALSE(bigfloat_div(&c, &a, &b));
+
+    ASSERT_TRUE(bigfloat_set_string(&a, "-12,5e-3", ','));
+    bigfloat_get_string(&a, str, sizeof(str), 60, ',');
+    EXPECT_STREQ(str, "-0,0125");
+    EXPECT_EQ(bigfloat_get_ld(&a), -0.0125L);
+    EXPECT_FALSE(bigfloat_set_string(&a, "1.2.3", '.'));
+    EXPECT_FALSE(bigfloat_set_string(&a, "1e", '.'));
+
+    // 1e40 + 1 - 1e40 needs more than long double
+    ASSERT_TRUE(bigfloat_set_string(&a, "1e40", '.'));
+    bigfloat_set_i64(&b, 1);
+    bigfloat_add(&c, &a, &b);
+    bigfloat_sub(&c, &c, &a);
+    bigfloat_get_string(&c, str, sizeof(str), 60, '.');
+    EXPECT_STREQ(str, "1");
+    bigfloat_mul(&c, &a, &a);
+    bigfloat_get_string(&c, str, sizeof(str), 60, '.');
+    EXPECT_STREQ(str, "1e+80");
+    EXPECT_LT(bigfloat_cmp(&b, &a), 0);
+    EXPECT_GT(bigfloat_cmp(&b, &c) * bigfloat_cmp(&c, &b), -2);
+
+    bigfloat_free(&a);
+    bigfloat_free(&b);
+    bigfloat_free(&c);
+}
+
+TEST_F(BigfloatTests, root)
+{
+    bigfloat_t a, r;
+    bigfloat_init(&a, bigfloat_digits_to_prec(1000));
+    bigfloat_init(&r, bigfloat_digits_to_prec(1000));
+    static char str[1100];
+
+    bigfloat_set_i64(&a, 2);
+    ASSERT_TRUE(bigfloat_root(&r, &a, 2));
+    bigfloat_get_string(&r, str, sizeof(str), 1000, '.');
+    EXPECT_EQ(strlen(str), 1001u);
+    EXPECT_EQ(strncmp(str, "1.41421356237309504880168872420969807856967187537694", 52), 0);
+    EXPECT_STREQ(str + 991, "2951848847"); // last ten of the 1000 digits
+    bigfloat_mul(&r, &r, &r);
+    bigfloat_get_string(&r, str, sizeof(str), 990, '.');
+    EXPECT_STREQ(str, "2");
+
+    bigfloat_set_i64(&a, -1000);
+    ASSERT_TRUE(bigfloat_root(&r, &a, 3));
+    bigfloat_get_string(&r, str, sizeof(str), 900, '.');
+    EXPECT_STREQ(str, "-10");
+    EXPECT_FALSE(bigfloat_root(&r, &a, 2));
+    EXPECT_FALSE(bigfloat_root(&r, &a, 0));
+    ASSERT_TRUE(bigfloat_set_string(&a, "1e-300", '.'));
+    ASSERT_TRUE(bigfloat_root(&r, &a, 7));
+    EXPECT_NEAR(bigfloat_get_ld(&r), 1.389495494373137637e-43L, 1e-60L);
+
+    bigfloat_free(&a);
+    bigfloat_free(&r);
+}
+
+TEST_F(BigfloatTests, rounding_ties)
+{
+    // q = 2^64 + odd is a tie at 64 bits, a / b and sqrt(q^2 -+ 1) are rounded once like q
+    bigfloat_t a, b, r, expected;
+    bigfloat_init(&a, 256);
+    bigfloat_init(&b, 64);
+    bigfloat_init(&r, 64);
+    bigfloat_init(&expected, 64);
+    bigint_t q, m, one;
+    bigint_init(&q);
+    bigint_init(&m);
+    bigint_init(&one);
+    bigint_set_u64(&one, 1);
+    unsigned long long state = 11;
+    for (int i = 0; i < 2000; i++)
+    {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        bigint_set_u128(&q, ((unsigned __int128)1 << 64) + ((state >> 1) | 1));
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        long long odd = (long long)(state >> 34) | 1;
+        bigint_set_i64(&m, odd);
+        bigint_mul(&m, &q, &m);
+        bigfloat_set_bigint(&a, &m, -3);
+        bigfloat_set_i64(&b, (i % 2 == 0) ? odd : -odd);
+        bigfloat_set_bigint(&expected, &q, -3);
+        if (i % 2 == 1)
+        {
+            bigfloat_neg(&expected, &expected);
+        }
+        ASSERT_TRUE(bigfloat_div(&r, &a, &b));
+        ASSERT_EQ(bigfloat_cmp(&r, &expected), 0) << i;
+
+        bigint_mul(&m, &q, &q);
+        (i % 2 == 0) ? bigint_add(&m, &m, &one) : bigint_sub(&m, &m, &one);
+        bigfloat_set_bigint(&a, &m, 0);
+        bigint_shl(&m, &q, 1);
+        (i % 2 == 0) ? bigint_add(&m, &m, &one) : bigint_sub(&m, &m, &one);
+        bigfloat_set_bigint(&expected, &m, -1);
+        ASSERT_TRUE(bigfloat_root(&r, &a, 2));
+        ASSERT_EQ(bigfloat_cmp(&r, &expected), 0) << i;
+    }
+    bigint_free(&q);
+    bigint_free(&m);
+    bigint_free(&one);
+    bigfloat_free(&a);
+    bigfloat_free(&b);
+    bigfloat_free(&r);
+    bigfloat_free(&expected);
+}
+
+class ConstantsTests : public Test
+{
+};
+
+TEST_F(ConstantsTests, digits)
+{
+    const char *prefixes[CONSTANT_COUNT] = {
+        "3.14159265358979323846264338327950288419716939937510",
+        "2.71828182845904523536028747135266249775724709369995",
+        "0.69314718055994530941723212145817656807550013436025",
+        "1.41421356237309504880168872420969807856967187537694"};
+    const char *tails[CONSTANT_COUNT] = {"9216420199", "8957035035", "2344535348", "2951848847"};
+    bigfloat_t x;
+    bigfloat_init(&x, bigfloat_digits_to_prec(1000));
+    static char str[1100];
+
+    constants_clear_cache();
+    for (int c = 0; c < CONSTANT_COUNT; c++)
+    {
+        constant_get(&x, c);
+        size_t len = bigfloat_get_string(&x, str, sizeof(str), 1000, '.');
+        ASSERT_GE(len, 1001u);
+        EXPECT_EQ(strncmp(str, prefixes[c], 52), 0) << c;
+        EXPECT_STREQ(str + len - 10, tails[c]) << c;
+    }
+    EXPECT_EQ(constant_get_ld(CONSTANT_PI), 3.14159265358979323846264338327950288L);
+    EXPECT_EQ(constant_get_ld(CONSTANT_E), 2.71828182845904523536028747135266250L);
+    bigfloat_free(&x);
+}
+
+TEST_F(ConstantsTests, cache)
+{
+    bigfloat_t x;
+    char str[100];
+    constants_clear_cache();
+    EXPECT_EQ(constant_cached_prec(CONSTANT_PI), 0u);
+
+    bigfloat_init(&x, bigfloat_digits_to_prec(500));
+    constant_get(&x, CONSTANT_PI);
+    size_t prec = constant_cached_prec(CONSTANT_PI);
+    EXPECT_GT(prec, x.prec);
+    bigfloat_free(&x);
+
+    // lower precision is rounded from the cached value
+    bigfloat_init(&x, bigfloat_digits_to_prec(30));
+    constant_get(&x, CONSTANT_PI);
+    EXPECT_EQ(constant_cached_prec(CONSTANT_PI), prec);
+    bigfloat_get_string(&x, str, sizeof(str), 30, '.');
+    EXPECT_STREQ(str, "3.14159265358979323846264338328");
+    bigfloat_free(&x);
+
+    bigfloat_init(&x, bigfloat_digits_to_prec(600));
+    constant_get(&x, CONSTANT_PI);
+    EXPECT_GT(constant_cached_prec(CONSTANT_PI), prec);
+    bigfloat_free(&x);
+    constants_clear_cache();
+    EXPECT_EQ(constant_cached_prec(CONSTANT_PI), 0u);
+}
+
+class PolynomialTests : public Test
+{
+};
+
+TEST_F(PolynomialTests, eval)
+{
+    // (x - 1)^12 expanded
+    long double c[13];
+    for (int k = 0; k <= 12; k++)
+    {
+        c[k] = (long double)comb(12, k) * ((12 - k) % 2 ? -1 : 1);
+    }
+    EXPECT_EQ(poly_eval(c, 12, 3.0L), 4096.0L);
+    EXPECT_EQ(poly_eval_estrin(c, 12, 3.0L), 4096.0L);
+    EXPECT_EQ(poly_eval(c, 0, 5.0L), 1.0L);
+    EXPECT_EQ(poly_eval_estrin(c, 0, 5.0L), 1.0L);
+    for (int d = 0; d <= 12; d++)
+    {
+        EXPECT_NEAR(poly_eval_estrin(c, d, 0.75L), poly_eval(c, d, 0.75L), 1e-15L) << d;
+    }
+
+    double dc[6] = {1.0, -2.0, 0.5, 3.0, -1.0, 0.25};
+    double x[19], y[19];
+    for (int i = 0; i < 19; i++)
+    {
+        x[i] = i * 0.37 - 3.0;
+    }
+    poly_eval_batch(dc, 5, x, y, 19);
+    for (int i = 0; i < 19; i++)
+    {
+        double r = dc[5];
+        for (int k = 4; k >= 0; k--)
+        {
+            r = r * x[i] + dc[k];
+        }
+        EXPECT_EQ(y[i], r) << i;
+    }
+    poly_eval_batch(dc, 5, x, x, 19); // in place
+    EXPECT_EQ(memcmp(x, y, sizeof(x)), 0);
+}
+
+TEST_F(PolynomialTests, roots)
+{
+    long double re[20], im[20];
+
+    long double quad[3] = {2.0L, -3.0L, 1.0L}; // x^2 - 3x + 2
+    ASSERT_EQ(poly_roots(quad, 2, re, im), 2);
+    EXPECT_NEAR(re[0], 1.0L, 1e-18L);
+    EXPECT_NEAR(re[1], 2.0L, 1e-18L);
+    EXPECT_EQ(im[0], 0.0L);
+    EXPECT_EQ(im[1], 0.0L);
+
+    long double cub[5] = {0.0L, 1.0L, 0.0L, 1.0L, 0.0L}; // x^3 + x with a zero leading coefficient
+    ASSERT_EQ(poly_roots(cub, 4, re, im), 3);
+    EXPECT_EQ(re[0], 0.0L);
+    EXPECT_NEAR(im[0], -1.0L, 1e-18L);
+    EXPECT_EQ(re[1], 0.0L);
+    EXPECT_EQ(im[1], 0.0L);
+    EXPECT_NEAR(im[2], 1.0L, 1e-18L);
+
+    // (x - 1)(x - 2)...(x - 15)
+    long double w[16] = {1.0L};
+    for (int k = 1; k <= 15; k++)
+    {
+        w[k] = 0.0L;
+        for (int j = k; j >= 1; j--)
+        {
+            w[j] = w[j - 1] - k * w[j];
+        }
+        w[0] *= -k;
+    }
+    ASSERT_EQ(poly_roots(w, 15, re, im), 15);
+    for (int k = 0; k < 15; k++)
+    {
+        EXPECT_NEAR(re[k], k + 1.0L, 1e-6L);
+        EXPECT_EQ(im[k], 0.0L);
+    }
+
+    // multiple roots are only found to about LDBL_EPSILON^(1/m), the clusters are still real
+    long double triple[4] = {-1.0L, 3.0L, -3.0L, 1.0L};          // (x - 1)^3
+    long double quadruple[5] = {1.0L, -4.0L, 6.0L, -4.0L, 1.0L}; // (x - 1)^4
+    long double mixed[5] = {-4.0L, 12.0L, -13.0L, 6.0L, -1.0L};  // -(x - 1)^2 (x - 2)^2
+    ASSERT_EQ(poly_roots(triple, 3, re, im), 3);
+    for (int k = 0; k < 3; k++)
+    {
+        EXPECT_NEAR(re[k], 1.0L, 1e-12L);
+        EXPECT_EQ(im[k], 0.0L);
+    }
+    ASSERT_EQ(poly_roots(quadruple, 4, re, im), 4);
+    for (int k = 0; k < 4; k++)
+    {
+        EXPECT_NEAR(re[k], 1.0L, 1e-12L);
+        EXPECT_EQ(im[k], 0.0L);
+    }
+    ASSERT_EQ(poly_roots(mixed, 4, re, im), 4);
+    for (int k = 0; k < 4; k++)
+    {
+        EXPECT_NEAR(re[k], (k < 2) ? 1.0L : 2.0L, 1e-9L);
+        EXPECT_EQ(im[k], 0.0L);
+    }
+    long double pair[5] = {1.0L, 0.0L, 2.0L, 0.0L, 1.0L}; // (x^2 + 1)^2 keeps its double complex roots
+    ASSERT_EQ(poly_roots(pair, 4, re, im), 4);
+    for (int k = 0; k < 4; k++)
+    {
+        EXPECT_NEAR(fabsl(im[k]), 1.0L, 1e-9L);
+    }
+
+    // roots near both ends of the range of long double: x^2 - 1e3000 x + 1
+    long double extreme[3] = {1.0L, -1e3000L, 1.0L};
+    ASSERT_EQ(poly_roots(extreme, 2, re, im), 2);
+    EXPECT_LE(fabsl(re[0] / 1e-3000L - 1.0L), 1e-15L);
+    EXPECT_LE(fabsl(re[1] / 1e3000L - 1.0L), 1e-15L);
+    EXPECT_EQ(im[0], 0.0L);
+    EXPECT_EQ(im[1], 0.0L);
+    long double wide[4] = {-1e-2000L, 1.0L, 0.0L, 1e-2000L}; // 1e-2000 x^3 + x - 1e-2000
+    ASSERT_EQ(poly_roots(wide, 3, re, im), 3);
+    EXPECT_LE(fabsl(im[0] / 1e1000L + 1.0L), 1e-15L); // -i 1e1000, i 1e1000, 1e-2000
+    EXPECT_LE(fabsl(im[1] / 1e1000L - 1.0L), 1e-15L);
+    EXPECT_LE(fabsl(re[2] / 1e-2000L - 1.0L), 1e-15L);
+    EXPECT_EQ(im[2], 0.0L);
+
+    // x^20 - 1, roots of unity
+    long double u[21] = {-1.0L};
+    u[20] = 1.0L;
+    ASSERT_EQ(poly_roots(u, 20, re, im), 20);
+    for (int k = 0; k < 20; k++)
+    {
+        EXPECT_NEAR(re[k] * re[k] + im[k] * im[k], 1.0L, 1e-17L);
+    }
+    EXPECT_EQ(re[0], -1.0L);
+    EXPECT_EQ(re[19], 1.0L);
+
+    long double zero[3] = {0.0L, 0.0L, 0.0L};
+    EXPECT_EQ(poly_roots(zero, 2, re, im), -1);
+    EXPECT_EQ(poly_roots(quad, 0, re, im), 0);
+}
+
+class MatrixTests : public Test
+{
+};
+
+TEST_F(MatrixTests, gemm)
+{
+    // sizes that are not multiples of the tiles, the last one is split among threads
+    size_t dims[3][3] = {{3, 5, 7}, {37, 130, 29}, {203, 211, 300}};
+    matrix_set_threads(3);
+    for (int d = 0; d < 3; d++)
+    {
+        size_t m = dims[d][0], n = dims[d][1], k = dims[d][2];
+        matrix_t a, b, c;
+        matrix_init(&a, m, k);
+        matrix_init(&b, k, n);
+        matrix_init(&c, m, n);
+        for (size_t i = 0; i < m * k; i++)
+        {
+            a.data[i] = (double)((i * 7) % 11) - 5.0;
+        }
+        for (size_t i = 0; i < k * n; i++)
+        {
+            b.data[i] = (double)((i * 5) % 13) - 6.0;
+        }
+        for (size_t i = 0; i < m * n; i++)
+        {
+            c.data[i] = 1.0;
+        }
+        // integer products are exact
+        matrix_gemm(m, n, k, 2.0, a.data, k, b.data, n, -1.0, c.data, n);
+        for (size_t i = 0; i < m; i++)
+        {
+            for (size_t j = 0; j < n; j++)
+            {
+                double s = 0.0;
+                for (size_t p = 0; p < k; p++)
+                {
+                    s += a.data[i * k + p] * b.data[p * n + j];
+                }
+                ASSERT_EQ(c.data[i * n + j], 2.0 * s - 1.0) << d << " " << i << " " << j;
+            }
+        }
+        ASSERT_TRUE(matrix_mul(&c, &a, &b));
+        EXPECT_EQ(c.rows, m);
+        EXPECT_EQ(c.cols, n);
+        EXPECT_FALSE(matrix_mul(&c, &b, &b));
+        matrix_free(&a);
+        matrix_free(&b);
+        matrix_free(&c);
+    }
+    matrix_set_threads(0);
+}
+
+TEST_F(MatrixTests, lu)
+{
+    double data[9] = {2.0, 1.0, 1.0, 4.0, -6.0, 0.0, -2.0, 7.0, 2.0};
+    matrix_t a, x, b;
+    matrix_init(&a, 3, 3);
+    matrix_init(&x, 0, 0);
+    matrix_init(&b, 3, 1);
+    memcpy(a.data, data, sizeof(data));
+    EXPECT_NEAR(matrix_det(&a), -16.0, 1e-12);
+
+    b.data[0] = 5.0;
+    b.data[1] = -2.0;
+    b.data[2] = 9.0;
+    ASSERT_TRUE(matrix_solve(&x, &a, &b));
+    EXPECT_NEAR(x.data[0], 1.0, 1e-12);
+    EXPECT_NEAR(x.data[1], 1.0, 1e-12);
+    EXPECT_NEAR(x.data[2], 2.0, 1e-12);
+
+    // a larger system uses the blocked decomposition, A * A^-1 = I
+    size_t n = 150;
+    matrix_resize(&a, n, n);
+    for (size_t i = 0; i < n; i++)
+    {
+        for (size_t j = 0; j < n; j++)
+        {
+            a.data[i * n + j] = 1.0 / (1.0 + i + 2.0 * j) + ((i == j) ? 1.0 : 0.0);
+        }
+    }
+    ASSERT_TRUE(matrix_inverse(&x, &a));
+    matrix_mul(&b, &a, &x);
+    double err = 0.0;
+    for (size_t i = 0; i < n; i++)
+    {
+        for (size_t j = 0; j < n; j++)
+        {
+            err = fmax(err, fabs(b.data[i * n + j] - ((i == j) ? 1.0 : 0.0)));
+        }
+    }
+    EXPECT_LT(err, 1e-12);
+
+    // singular and non-square matrices
+    matrix_resize(&a, 3, 3);
+    for (size_t i = 0; i < 9; i++)
+    {
+        a.data[i] = (double)(i % 3);
+    }
+    EXPECT_EQ(matrix_det(&a), 0.0);
+    EXPECT_FALSE(matrix_inverse(&x, &a));
+    matrix_resize(&a, 2, 3);
+    EXPECT_TRUE(std::isnan(matrix_det(&a)));
+    EXPECT_FALSE(matrix_solve(&x, &a, &b));
+    matrix_free(&a);
+    matrix_free(&x);
+    matrix_free(&b);
+}
+
+class StatsTests : public Test
+{
+};
+
+TEST_F(StatsTests, accumulate)
+{
+    stats_t s;
+    stats_init(&s);
+    EXPECT_EQ(s.count, 0ULL);
+    EXPECT_TRUE(std::isnan(stats_mean(&s)));
+    EXPECT_TRUE(std::isnan(stats_min(&s)));
+
+    double data[8] = {2.0, 4.0, 4.0, 4.0, 5.0, 5.0, 7.0, 9.0};
+    for (int i = 0; i < 8; i++)
+    {
+        stats_add(&s, data[i]);
+    }
+    EXPECT_EQ(s.count, 8ULL);
+    EXPECT_NEAR(stats_mean(&s), 5.0L, 1e-15L);
+    EXPECT_NEAR(stats_population_variance(&s), 4.0L, 1e-15L);
+    EXPECT_NEAR(stats_variance(&s), 32.0L / 7.0L, 1e-15L);
+    EXPECT_NEAR(stats_stddev(&s), sqrtl(32.0L / 7.0L), 1e-15L);
+    EXPECT_EQ(stats_min(&s), 2.0L);
+    EXPECT_EQ(stats_max(&s), 9.0L);
+
+    stats_t one;
+    stats_init(&one);
+    stats_add(&one, 3.0L);
+    EXPECT_EQ(stats_mean(&one), 3.0L);
+    EXPECT_EQ(stats_population_variance(&one), 0.0L);
+    EXPECT_TRUE(std::isnan(stats_variance(&one)));
+
+    // a large offset does not destroy the variance
+    stats_t off;
+    stats_init(&off);
+    for (int i = 0; i < 8; i++)
+    {
+        stats_add(&off, 1e9 + data[i]);
+    }
+    EXPECT_NEAR(stats_population_variance(&off), 4.0L, 1e-9L);
+}
+
+TEST_F(StatsTests, merge)
+{
+    size_t n = 5000;
+    double *x = (double *)malloc(n * sizeof(double));
+    for (size_t i = 0; i < n; i++)
+    {
+        x[i] = 1e6 + (double)((i * 7919) % 1000) / 10.0;
+    }
+
+    stats_t seq, parts, arr;
+    stats_init(&seq);
+    stats_init(&parts);
+    stats_init(&arr);
+    for (size_t i = 0; i < n; i++)
+    {
+        stats_add(&seq, x[i]);
+    }
+
+    // uneven parts merged in order, including an empty one
+    size_t cuts[5] = {0, 1, 1, 1700, n};
+    for (int p = 0; p + 1 < 5; p++)
+    {
+        stats_t part;
+        stats_init(&part);
+        for (size_t i = cuts[p]; i < cuts[p + 1]; i++)
+        {
+            stats_add(&part, x[i]);
+        }
+        stats_merge(&parts, &part);
+    }
+    stats_add_array(&arr, x, n);
+
+    EXPECT_EQ(parts.count, seq.count);
+    EXPECT_EQ(arr.count, seq.count);
+    EXPECT_NEAR(stats_mean(&parts), stats_mean(&seq), 1e-9L);
+    EXPECT_NEAR(stats_mean(&arr), stats_mean(&seq), 1e-9L);
+    EXPECT_NEAR(stats_variance(&parts), stats_variance(&seq), 1e-9L * stats_variance(&seq));
+    EXPECT_NEAR(stats_variance(&arr), stats_variance(&seq), 1e-9L * stats_variance(&seq));
+    EXPECT_EQ(stats_min(&arr), stats_min(&seq));
+    EXPECT_EQ(stats_max(&parts), stats_max(&seq));
+    free(x);
+}
+
+TEST_F(StatsTests, sums)
+{
+    EXPECT_EQ(sum_array(NULL, 0), 0.0);
+    EXPECT_EQ(sum_array_compensated(NULL, 0), 0.0);
+    EXPECT_TRUE(std::isnan(mean_array(NULL, 0)));
+
+    double small[5] = {1.0, 2.0, 3.0, 4.0, 5.0};
+    EXPECT_EQ(sum_array(small, 5), 15.0);
+    EXPECT_EQ(sum_array_compensated(small, 5), 15.0);
+    EXPECT_EQ(mean_array(small, 5), 3.0);
+    EXPECT_EQ(variance_array(small, 5), 2.5);
+    EXPECT_TRUE(std::isnan(variance_array(small, 1)));
+
+    // 0.1 is not exact, sequential summation of a million copies is off by about 1e-6
+    size_t n = 1000003;
+    double *x = (double *)malloc(n * sizeof(double));
+    for (size_t i = 0; i < n; i++)
+    {
+        x[i] = 0.1;
+    }
+    long double exact = (long double)0.1 * n;
+    EXPECT_NEAR(sum_array(x, n), (double)exact, 1e-9);
+    EXPECT_EQ(sum_array_compensated(x, n), (double)exact);
+
+    // heavy cancellation is resolved only by the compensated sum
+    double c[7] = {1e16, 1.0, -1e16, 1.0, 3.0, 1e-3, -3.0};
+    EXPECT_EQ(sum_array_compensated(c, 7), 2.001);
+
+    // variance with a large offset, the same result as the streaming summary
+    stats_t s;
+    stats_init(&s);
+    for (size_t i = 0; i < n; i++)
+    {
+        x[i] = 1e8 + (double)(i % 17);
+        stats_add(&s, x[i]);
+    }
+    EXPECT_NEAR(mean_array(x, n), (double)stats_mean(&s), 1e-7);
+    EXPECT_NEAR(variance_array(x, n), (double)stats_variance(&s), 1e-9 * (double)stats_variance(&s));
+
+    // nan is ignored by the minimum and maximum wherever it is, like in stats_add
+    for (size_t at : {(size_t)0, (size_t)5, (size_t)1001})
+    {
+        x[at] = NAN;
+        stats_t all;
+        stats_init(&all);
+        stats_add_array(&all, x, n);
+        EXPECT_EQ(stats_min(&all), 1e8) << at;
+        EXPECT_EQ(stats_max(&all), 1e8 + 16) << at;
+        x[at] = 1e8;
+    }
+    double nans[3] = {NAN, NAN, NAN};
+    stats_t none;
+    stats_init(&none);
+    stats_add_array(&none, nans, 3);
+    EXPECT_EQ(stats_min(&none), INFINITY);
+    EXPECT_EQ(stats_max(&none), -INFINITY);
+    free(x);
+}
+
+TEST_F(StatsTests, reproducible)
+{
+    EXPECT_EQ(sum_array_reproducible(NULL, 0), 0.0);
+    double c[5] = {1e16, 1.0, -1e16, 1.0, 1e-300};
+    EXPECT_EQ(sum_array_reproducible(c, 3), 1.0);
+    EXPECT_EQ(sum_array_reproducible(c, 5), 2.0);
+    double tiny[3] = {4.9406564584124654e-324, 4.9406564584124654e-324, -9.8813129168249309e-324};
+    EXPECT_EQ(sum_array_reproducible(tiny, 2), 9.8813129168249309e-324);
+    EXPECT_EQ(sum_array_reproducible(tiny, 3), 0.0);
+    double big[3] = {1.7976931348623157e308, 1.7976931348623157e308, -1.7976931348623157e308};
+    EXPECT_EQ(sum_array_reproducible(big, 3), 1.7976931348623157e308);
+    EXPECT_TRUE(std::isinf(sum_array_reproducible(big, 2)));
+    double inf[2] = {INFINITY, -INFINITY};
+    EXPECT_EQ(sum_array_reproducible(inf, 1), INFINITY);
+    EXPECT_TRUE(std::isnan(sum_array_reproducible(inf, 2)));
+
+    size_t n = 100000;
+    double *x = (double *)malloc(n * sizeof(double));
+    for (size_t i = 0; i < n; i++)
+    {
+        x[i] = 1e3 + (double)((i * 7919) % 1000) / 7.0 * ((i % 3 == 0) ? -1e-5 : 1.0);
+    }
+    double whole = sum_array_reproducible(x, n);
+    EXPECT_NEAR(whole, sum_array_compensated(x, n), 1e-9);
+
+    // any split into parts and any order of the values give the same bits
+    stats_repro_t all, parts;
+    stats_repro_init(&all, x[0]);
+    stats_repro_init(&parts, x[0]);
+    stats_repro_add_array(&all, x, n);
+    repro_sum_t r;
+    repro_sum_init(&r);
+    size_t cuts[6] = {0, 7, 4099, 4100, 77777, n};
+    for (int p = 4; p >= 0; p--)
+    {
+        repro_sum_t part;
+        stats_repro_t sp;
+        repro_sum_init(&part);
+        stats_repro_init(&sp, x[0]);
+        for (size_t i = cuts[p + 1]; i > cuts[p]; i--)
+        {
+            repro_sum_add(&part, x[i - 1]);
+        }
+        stats_repro_add_array(&sp, x + cuts[p], cuts[p + 1] - cuts[p]);
+        repro_sum_merge(&r, &part);
+        stats_repro_merge(&parts, &sp);
+    }
+    EXPECT_EQ(repro_sum_get(&r), whole);
+
+    stats_t a, b, ref;
+    stats_repro_get(&all, &a);
+    stats_repro_get(&parts, &b);
+    stats_init(&ref);
+    stats_add_array(&ref, x, n);
+    EXPECT_EQ(a.count, (unsigned long long)n);
+    EXPECT_EQ(stats_mean(&a), stats_mean(&b));
+    EXPECT_EQ(stats_variance(&a), stats_variance(&b));
+    EXPECT_NEAR(stats_variance(&a), stats_variance(&ref), 1e-12L * stats_variance(&ref));
+    EXPECT_EQ(stats_min(&a), stats_min(&ref));
+    EXPECT_EQ(stats_max(&b), stats_max(&ref));
+    free(x);
+}
+
+TEST_F(StatsTests, pair)
+{
+    stats_pair_t a, b, c;
+    stats_pair_init(&a);
+    stats_pair_add(&a, 1.0, 2.0);
+    EXPECT_TRUE(std::isnan(stats_pair_covariance(&a)));
+    stats_pair_add(&a, 1.0, 5.0);
+    EXPECT_TRUE(std::isnan(stats_pair_slope(&a)));
+    EXPECT_TRUE(std::isnan(stats_pair_correlation(&a)));
+
+    // y = 3 x + 2 + noise, far from the origin
+    size_t n = 10007;
+    double *x = (double *)malloc(n * sizeof(double));
+    double *y = (double *)malloc(n * sizeof(double));
+    unsigned long long state = 99;
+    long double sx = 0.0L, sy = 0.0L;
+    for (size_t i = 0; i < n; i++)
+    {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        double noise = (double)(state >> 11) / 9007199254740992.0 - 0.5;
+        x[i] = 1e6 + 0.01 * i;
+        y[i] = 3.0 * x[i] + 2.0 + noise;
+        sx += x[i];
+        sy += y[i];
+    }
+    long double mx = sx / n, my = sy / n, qx = 0.0L, qy = 0.0L, cxy = 0.0L;
+    for (size_t i = 0; i < n; i++)
+    {
+        qx += (x[i] - mx) * (x[i] - mx);
+        qy += (y[i] - my) * (y[i] - my);
+        cxy += (x[i] - mx) * (y[i] - my);
+    }
+    stats_pair_init(&a);
+    stats_pair_init(&b);
+    stats_pair_init(&c);
+    for (size_t i = 0; i < n; i++)
+    {
+        stats_pair_add(&a, x[i], y[i]);
+    }
+    stats_pair_add_array(&b, x, y, 3001);
+    stats_pair_add_array(&c, x + 3001, y + 3001, n - 3001);
+    stats_pair_merge(&b, &c);
+    for (const stats_pair_t *s : {&a, &b})
+    {
+        EXPECT_EQ(s->count, (unsigned long long)n);
+        EXPECT_NEAR(stats_pair_covariance(s), cxy / (n - 1), 1e-9L * fabsl(cxy / (n - 1)));
+        EXPECT_NEAR(stats_pair_correlation(s), cxy / sqrtl(qx * qy), 1e-9L);
+        EXPECT_NEAR(stats_pair_slope(s), cxy / qx, 1e-9L * 3.0L);
+        EXPECT_NEAR(stats_pair_intercept(s), my - cxy / qx * mx, 1e-6L * fabsl(my));
+    }
+    EXPECT_NEAR(stats_pair_slope(&b), 3.0L, 1e-3L);
+
+    // an exact line
+    stats_pair_init(&a);
+    for (int i = 0; i < 10; i++)
+    {
+        stats_pair_add(&a, i, 7.0 - 2.0 * i);
+    }
+    EXPECT_NEAR(stats_pair_correlation(&a), -1.0L, 1e-15L);
+    EXPECT_NEAR(stats_pair_slope(&a), -2.0L, 1e-15L);
+    EXPECT_NEAR(stats_pair_intercept(&a), 7.0L, 1e-14L);
+    free(x);
+    free(y);
+}
+
+class ColumnarTests : public Test
+{
+};
+
+TEST_F(ColumnarTests, parse)
+{
+    const char *text[] = {"0", "-12.5", "1e-5", "0.1", "9007199254740993", "123456789012345678901234567890",
+                          "2.2250738585072011e-308", ".5", "1.", "inf"};
+    for (int i = 0; i < 10; i++)
+    {
+        double v = 0.0;
+        ASSERT_TRUE(col_parse_double(text[i], text[i] + strlen(text[i]), &v)) << text[i];
+        EXPECT_EQ(v, strtod(text[i], NULL)) << text[i];
+    }
+    const char *bad[] = {"", "-", "1e", "1.2.3", "0x", "abc"};
+    for (int i = 0; i < 6; i++)
+    {
+        double v;
+        EXPECT_FALSE(col_parse_double(bad[i], bad[i] + strlen(bad[i]), &v)) << bad[i];
+    }
+    // only the given range is parsed
+    double v;
+    const char *two = "12,34";
+    ASSERT_TRUE(col_parse_double(two, two + 2, &v));
+    EXPECT_EQ(v, 12.0);
+
+    long long k;
+    const char *min = "-9223372036854775808", *max = "9223372036854775807", *over = "9223372036854775808";
+    ASSERT_TRUE(col_parse_int64(min, min + strlen(min), &k));
+    EXPECT_EQ(k, INT64_MIN);
+    ASSERT_TRUE(col_parse_int64(max, max + strlen(max), &k));
+    EXPECT_EQ(k, INT64_MAX);
+    EXPECT_FALSE(col_parse_int64(over, over + strlen(over), &k));
+    EXPECT_FALSE(col_parse_int64(two, two + 5, &k));
+}
+
+TEST_F(ColumnarTests, file)
+{
+    const char *path = "columnar_test.col";
+    unsigned char types[2] = {COL_FLOAT64, COL_INT64};
+    col_writer_t w;
+    ASSERT_EQ(col_writer_open(&w, path, 2, types), COL_OK);
+    // more rows than one group
+    size_t n = COL_GROUP_ROWS + 10;
+    for (size_t i = 0; i < n; i++)
+    {
+        col_value_t row[2];
+        row[0].f = i * 0.5;
+        row[1].i = -(long long)i;
+        ASSERT_EQ(col_writer_row(&w, row), COL_OK);
+    }
+    ASSERT_EQ(col_writer_close(&w), COL_OK);
+
+    col_file_t f;
+    ASSERT_EQ(col_open(&f, path), COL_OK);
+    EXPECT_EQ(f.cols, 2u);
+    EXPECT_EQ(f.rows, n);
+    EXPECT_EQ(f.groups, 2u);
+    size_t rows, row = 0;
+    for (size_t g = 0; g < f.groups; g++)
+    {
+        const double *x = (const double *)col_column(&f, g, 0, &rows);
+        const long long *y = (const long long *)col_column(&f, g, 1, &rows);
+        EXPECT_EQ((uintptr_t)x % 8, 0u);
+        for (size_t i = 0; i < rows; i++, row++)
+        {
+            ASSERT_EQ(x[i], row * 0.5);
+            ASSERT_EQ(y[i], -(long long)row);
+        }
+    }
+    EXPECT_EQ(row, n);
+    col_close(&f);
+
+    // missing values are skipped by the runs of present values, an ordinary nan is present
+    double m = col_missing();
+    double missing[7] = {m, 1.0, NAN, m, m, 3.0, m};
+    EXPECT_TRUE(std::isnan(m));
+    EXPECT_TRUE(col_is_missing(m));
+    EXPECT_FALSE(col_is_missing(NAN));
+    EXPECT_FALSE(col_is_missing(-NAN));
+    size_t first;
+    EXPECT_EQ(col_present_run(missing, 7, &first), 2u);
+    EXPECT_EQ(first, 1u);
+    EXPECT_EQ(col_present_run(missing + 3, 4, &first), 1u);
+    EXPECT_EQ(first, 2u);
+    EXPECT_EQ(col_present_run(missing + 6, 1, &first), 0u);
+    EXPECT_EQ(first, 1u);
+    EXPECT_EQ(col_present_run(missing, 0, &first), 0u);
+
+    // a truncated file and a text file are rejected
+    FILE *out = fopen(path, "r+b");
+    ASSERT_NE(out, (FILE *)NULL);
+    ASSERT_EQ(ftruncate(fileno(out), 100), 0);
+    fclose(out);
+    EXPECT_EQ(col_open(&f, path), COL_FORMAT_ERR);
+    out = fopen(path, "w");
+    fputs("1 2 3 4 5 6 7 8 9 10\n", out);
+    fclose(out);
+    EXPECT_EQ(col_open(&f, path), COL_FORMAT_ERR);
+    remove(path);
+    EXPECT_EQ(col_open(&f, path), COL_IO_ERR);
+}
+
+TEST_F(ColumnarTests, csv_scan)
+{
+    // separators at every position of the vector blocks and in the scalar tail
+    size_t n = 1000;
+    char *text = (char *)malloc(n);
+    unsigned *offsets = (unsigned *)malloc(n * sizeof(unsigned));
+    unsigned long long state = 7;
+    std::vector<unsigned> expected;
+    for (size_t i = 0; i < n; i++)
+    {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        unsigned r = (unsigned)(state >> 56);
+        text[i] = (r < 40) ? ',' : (r < 60) ? '\n' : (char)r;
+        if (text[i] == ',' || text[i] == '\n')
+        {
+            expected.push_back((unsigned)i);
+        }
+    }
+    for (size_t len : {(size_t)0, (size_t)63, (size_t)64, (size_t)129, n})
+    {
+        size_t count = col_csv_scan(text, len, offsets);
+        size_t want = std::lower_bound(expected.begin(), expected.end(), (unsigned)len) - expected.begin();
+        ASSERT_EQ(count, want) << len;
+        for (size_t i = 0; i < count; i++)
+        {
+            ASSERT_EQ(offsets[i], expected[i]) << len;
+        }
+    }
+    free(text);
+    free(offsets);
+}
+
+TEST_F(StatsTests, tdigest)
+{
+    tdigest_t t;
+    tdigest_init(&t);
+    EXPECT_TRUE(std::isnan(tdigest_quantile(&t, 0.5)));
+    tdigest_add(&t, 3.0);
+    EXPECT_EQ(tdigest_quantile(&t, 0.5), 3.0);
+
+    // a shuffled permutation of 0..n-1, the quantile q is about q * (n - 1)
+    size_t n = 200000;
+    double *x = (double *)malloc(n * sizeof(double));
+    unsigned long long seed = 1;
+    for (size_t i = 0; i < n; i++)
+    {
+        // Fisher-Yates shuffle driven by a linear congruential generator
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        size_t j = (size_t)((seed >> 33) % (i + 1));
+        x[i] = x[j];
+        x[j] = (double)i;
+    }
+    tdigest_t all, parts;
+    tdigest_init(&all);
+    tdigest_init(&parts);
+    tdigest_add_array(&all, x, n);
+    for (size_t start = 0; start < n; start += 30000)
+    {
+        tdigest_t part;
+        tdigest_init(&part);
+        tdigest_add_array(&part, x + start, (n - start < 30000) ? n - start : 30000);
+        tdigest_merge(&parts, &part);
+    }
+    EXPECT_EQ(tdigest_count(&all), (unsigned long long)n);
+    EXPECT_EQ(tdigest_count(&parts), (unsigned long long)n);
+    EXPECT_LE(all.centroids, (size_t)TDIGEST_CENTROIDS);
+    EXPECT_EQ(tdigest_quantile(&all, 0.0), 0.0);
+    EXPECT_EQ(tdigest_quantile(&parts, 1.0), (double)(n - 1));
+    double q[6] = {0.001, 0.01, 0.5, 0.95, 0.99, 0.999};
+    for (int i = 0; i < 6; i++)
+    {
+        // the error of the rank is small, especially in the tails
+        double tolerance = 0.01 * sqrt(q[i] * (1.0 - q[i])) * n;
+        EXPECT_NEAR(tdigest_quantile(&all, q[i]), q[i] * (n - 1), tolerance) << q[i];
+        EXPECT_NEAR(tdigest_quantile(&parts, q[i]), q[i] * (n - 1), tolerance) << q[i];
+    }
+    EXPECT_TRUE(std::isnan(tdigest_quantile(&all, 1.5)));
+
+    // large weights keep the size and accuracy of the digest
+    tdigest_t many;
+    tdigest_init(&many);
+    for (int i = 0; i < 100; i++)
+    {
+        tdigest_merge(&many, &all);
+    }
+    EXPECT_EQ(tdigest_count(&many), 100ULL * n);
+    EXPECT_LE(many.centroids, (size_t)TDIGEST_CENTROIDS);
+    EXPECT_NEAR(tdigest_quantile(&many, 0.999), 0.999 * (n - 1), 0.01 * sqrt(0.999 * 0.001) * n);
+    free(x);
+}
+
+TEST_F(StatsTests, select)
+{
+    // small arrays with duplicates and nan, every rank is checked against the sorted values
+    double values[13] = {5.0, -1.0, NAN, 3.0, 3.0, 8.0, -7.5, 3.0, NAN, 0.0, 12.0, -1.0, 2.5};
+    double sorted[11] = {-7.5, -1.0, -1.0, 0.0, 2.5, 3.0, 3.0, 3.0, 5.0, 8.0, 12.0};
+    double x[13];
+    for (size_t k = 0; k < 11; k++)
+    {
+        memcpy(x, values, sizeof(values));
+        EXPECT_EQ(select_kth(x, 13, k), sorted[k]) << k;
+    }
+    memcpy(x, values, sizeof(values));
+    EXPECT_TRUE(std::isnan(select_kth(x, 13, 11)));
+    memcpy(x, values, sizeof(values));
+    EXPECT_EQ(median_array(x, 13), 3.0);
+    memcpy(x, values, sizeof(values));
+    EXPECT_EQ(median_array(x, 2), 2.0);
+    memcpy(x, values, sizeof(values));
+    EXPECT_EQ(quantile_array(x, 13, 0.0), -7.5);
+    memcpy(x, values, sizeof(values));
+    EXPECT_EQ(quantile_array(x, 13, 1.0), 12.0);
+    memcpy(x, values, sizeof(values));
+    EXPECT_DOUBLE_EQ(quantile_array(x, 13, 0.95), 10.0); // position 9.5
+    EXPECT_TRUE(std::isnan(median_array(x, 0)));
+    EXPECT_TRUE(std::isnan(quantile_array(x, 13, -0.1)));
+
+    // large arrays: a shuffled permutation, sorted values and few distinct values, serially and in parallel
+    size_t n = (1 << 22) + 1;
+    double *big = (double *)malloc(n * sizeof(double));
+    for (int threads = 1; threads <= 3; threads += 2)
+    {
+        select_set_threads(threads);
+        unsigned long long seed = 1;
+        for (size_t i = 0; i < n; i++)
+        {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            size_t j = (size_t)((seed >> 33) % (i + 1));
+            big[i] = big[j];
+            big[j] = (double)i;
+        }
+        EXPECT_EQ(median_array(big, n), (double)(n / 2));
+        EXPECT_EQ(select_kth(big, n, 12345), 12345.0);
+        EXPECT_EQ(quantile_array(big, n, 0.25), (double)(n - 1) / 4);
+        for (size_t i = 0; i < n; i++)
+        {
+            big[i] = (double)i;
+        }
+        EXPECT_EQ(select_kth(big, n, n - 1), (double)(n - 1));
+        EXPECT_EQ(median_array(big, n - 1), (double)(n - 2) / 2);
+        for (size_t i = 0; i < n; i++)
+        {
+            big[i] = (double)(i % 4);
+        }
+        EXPECT_EQ(median_array(big, n), 2.0 - (n % 4 == 1)); // one more 0 than 3
+        big[n / 2] = NAN;
+        EXPECT_EQ(select_kth(big, n, n - 2), 3.0);
+    }
+    select_set_threads(0);
+    free(big);
+}
+
+TEST_F(StatsTests, sort)
+{
+    double x[9] = {3.0, NAN, -0.5, INFINITY, 3.0, -INFINITY, 1e-300, -2e10, NAN};
+    double sorted[7] = {-INFINITY, -2e10, -0.5, 1e-300, 3.0, 3.0, INFINITY};
+    sort_array(x, 9);
+    for (int i = 0; i < 7; i++)
+    {
+        EXPECT_EQ(x[i], sorted[i]) << i;
+    }
+    EXPECT_TRUE(std::isnan(x[7]) && std::isnan(x[8]));
+
+    // pseudo-random numbers of both signs, serially and split among threads
+    size_t n = (1 << 22) + 3;
+    double *big = (double *)malloc(n * sizeof(double));
+    for (int threads = 1; threads <= 3; threads += 2)
+    {
+        select_set_threads(threads);
+        unsigned long long seed = 7;
+        for (size_t i = 0; i < n; i++)
+        {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            big[i] = ldexp((double)(long long)seed, (int)(seed % 64) - 96);
+        }
+        double sum = sum_array_reproducible(big, n);
+        sort_array(big, n);
+        bool increasing = true;
+        for (size_t i = 1; i < n; i++)
+        {
+            increasing = increasing && big[i - 1] <= big[i];
+        }
+        EXPECT_TRUE(increasing);
+        EXPECT_EQ(sum_array_reproducible(big, n), sum); // the same values
+    }
+    select_set_threads(0);
+    free(big);
+}
+
+class ExtsortTests : public Test
+{
+};
+
+/** @struct extsort_adder
+ *  @brief Part of the numbers added by one thread of ExtsortTests.
+ */
+struct extsort_adder
+{
+    extsort_t *e;
+    const double *x;
+    size_t n;
+    int status;
+};
+
+/**
+ * @brief Thread function, adds the numbers of an extsort_adder in batches of 1000.
+ */
+static void *extsort_add_thread(void *arg)
+{
+    extsort_adder *a = (extsort_adder *)arg;
+    a->status = EXTSORT_OK;
+    for (size_t i = 0; i < a->n && a->status == EXTSORT_OK; i += 1000)
+    {
+        a->status = extsort_add(a->e, a->x + i, (a->n - i < 1000) ? a->n - i : 1000);
+    }
+    return NULL;
+}
+
+TEST_F(ExtsortTests, quantiles)
+{
+    // a buffer of the smallest budget holds 43690 numbers, so the numbers are written in several runs
+    size_t n = 300001;
+    double *x = (double *)malloc(n * sizeof(double));
+    unsigned long long seed = 3;
+    for (size_t i = 0; i < n; i++)
+    {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        x[i] = (i % 1000 == 0) ? NAN : (double)(seed >> 40) - 8e6;
+    }
+    double q[5] = {0.0, 0.001, 0.5, 0.99, 1.0};
+    double exact[5], result[5];
+    extsort_t e, small;
+    extsort_init(&e, 0);
+    extsort_init(&small, 0);
+    for (size_t i = 0; i < n; i += 1000)
+    {
+        EXPECT_EQ(extsort_add(&e, x + i, (n - i < 1000) ? n - i : 1000), EXTSORT_OK);
+    }
+    EXPECT_EQ(extsort_add(&small, x + 1, 999), EXTSORT_OK);
+    EXPECT_EQ(extsort_count(&e), (unsigned long long)(n - 301));
+    EXPECT_EQ(extsort_quantiles(&e, q, 5, result), EXTSORT_OK);
+    EXPECT_GT(e.runs, (size_t)1);
+    double *copy = (double *)malloc(n * sizeof(double));
+    for (int i = 0; i < 5; i++)
+    {
+        memcpy(copy, x, n * sizeof(double));
+        exact[i] = quantile_array(copy, n, q[i]);
+        EXPECT_EQ(result[i], exact[i]) << q[i];
+    }
+
+    // numbers added after a query and a query of numbers kept in memory
+    double more[2] = {1e9, 2e9};
+    EXPECT_EQ(extsort_add(&e, more, 2), EXTSORT_OK);
+    EXPECT_EQ(extsort_quantiles(&e, q + 4, 1, result), EXTSORT_OK);
+    EXPECT_EQ(result[0], 2e9);
+    EXPECT_EQ(extsort_quantiles(&small, q, 5, result), EXTSORT_OK);
+    EXPECT_EQ(small.file, (FILE *)NULL);
+    EXPECT_EQ(result[2], quantile_array(x + 1, 999, 0.5));
+    extsort_free(&e);
+    extsort_free(&small);
+
+    // threads adding at once, the full buffers are written while the others go on
+    extsort_init(&e, 0);
+    extsort_adder adders[4];
+    pthread_t ids[4];
+    for (size_t t = 0; t < 4; t++)
+    {
+        size_t first = t * (n / 4), last = (t == 3) ? n : (t + 1) * (n / 4);
+        adders[t] = {&e, x + first, last - first, EXTSORT_OK};
+        ASSERT_EQ(pthread_create(&ids[t], NULL, extsort_add_thread, &adders[t]), 0);
+    }
+    for (size_t t = 0; t < 4; t++)
+    {
+        pthread_join(ids[t], NULL);
+        EXPECT_EQ(adders[t].status, EXTSORT_OK);
+    }
+    EXPECT_EQ(extsort_count(&e), (unsigned long long)(n - 301));
+    EXPECT_EQ(extsort_quantiles(&e, q, 5, result), EXTSORT_OK);
+    EXPECT_GT(e.runs, (size_t)4);
+    for (int i = 0; i < 5; i++)
+    {
+        EXPECT_EQ(result[i], exact[i]) << q[i];
+    }
+    extsort_free(&e);
+
+    extsort_init(&e, 0);
+    EXPECT_EQ(extsort_quantiles(&e, q, 1, result), EXTSORT_OK);
+    EXPECT_TRUE(std::isnan(result[0]));
+    extsort_free(&e);
+    free(copy);
+    free(x);
+}
+
+/**
+ * @brief Tells whether every bin of the histogram counts the values between its ends.
+ */
+static bool histogram_matches(const histogram_t *h, const double *x, size_t n)
+{
+    for (size_t i = 0; i < h->bins; i++)
+    {
+        double lo = histogram_edge(h, i), hi = histogram_edge(h, i + 1);
+        unsigned long long count = 0;
+        for (size_t k = 0; k < n; k++)
+        {
+            count += (x[k] >= lo && x[k] < hi);
+        }
+        if (count != h->count[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST_F(StatsTests, histogram)
+{
+    histogram_t h, u;
+    EXPECT_FALSE(histogram_init(&h, HIST_LINEAR, 0, 0.0, 1.0));
+    EXPECT_FALSE(histogram_init(&h, HIST_LINEAR, 10, 1.0, 1.0));
+    EXPECT_FALSE(histogram_init(&h, HIST_LOG, 10, 0.0, 1.0));
+    EXPECT_FALSE(histogram_init(&h, HIST_ADAPTIVE, HIST_MAX_BINS + 1, 0.0, 0.0));
+
+    double x[9] = {-1.0, 0.0, 0.5, 9.99, 10.0, 100.0, NAN, INFINITY, 3.5};
+    ASSERT_TRUE(histogram_init(&h, HIST_LINEAR, 10, 0.0, 10.0));
+    histogram_add_array(&h, x, 9);
+    EXPECT_EQ(h.below, 1ULL);
+    EXPECT_EQ(h.count[0], 2ULL);
+    EXPECT_EQ(h.count[3], 1ULL);
+    EXPECT_EQ(h.count[9], 1ULL);
+    EXPECT_EQ(h.above, 3ULL);
+    EXPECT_EQ(histogram_count(&h), 8ULL);
+    EXPECT_EQ(histogram_edge(&h, 10), 10.0);
+    ASSERT_TRUE(histogram_init(&u, HIST_LINEAR, 5, 0.0, 10.0));
+    EXPECT_FALSE(histogram_merge(&h, &u));
+
+    double y[6] = {0.5, 1.0, 10.0, 999.0, -3.0, 1000.0};
+    ASSERT_TRUE(histogram_init(&h, HIST_LOG, 3, 1.0, 1000.0));
+    histogram_add_array(&h, y, 6);
+    EXPECT_EQ(h.below, 2ULL);
+    EXPECT_EQ(h.count[0], 1ULL);
+    EXPECT_EQ(h.count[1], 1ULL);
+    EXPECT_EQ(h.count[2], 1ULL);
+    EXPECT_EQ(h.above, 1ULL);
+    EXPECT_NEAR(histogram_edge(&h, 2), 100.0, 1e-9);
+
+    // adaptive histograms of parts of growing ranges, merged, and of the whole array
+    size_t n = 30000;
+    double *z = (double *)malloc(n * sizeof(double));
+    for (size_t i = 0; i < n; i++)
+    {
+        z[i] = (i < 10000) ? 0.001 * i : (i < 20000) ? 1000.0 + 0.37 * i : -500.0 - 1.5 * (i % 7);
+    }
+    histogram_t all, parts;
+    ASSERT_TRUE(histogram_init(&all, HIST_ADAPTIVE, 64, 0.0, 0.0));
+    ASSERT_TRUE(histogram_init(&parts, HIST_ADAPTIVE, 64, 0.0, 0.0));
+    EXPECT_TRUE(std::isnan(histogram_edge(&all, 0)));
+    histogram_add_array(&all, z, n);
+    for (size_t start = 0; start < n; start += 7000)
+    {
+        ASSERT_TRUE(histogram_init(&u, HIST_ADAPTIVE, 64, 0.0, 0.0));
+        histogram_add_array(&u, z + start, (n - start < 7000) ? n - start : 7000);
+        EXPECT_TRUE(histogram_merge(&parts, &u));
+    }
+    EXPECT_EQ(histogram_count(&all), (unsigned long long)n);
+    EXPECT_EQ(histogram_count(&parts), (unsigned long long)n);
+    EXPECT_EQ(all.below + all.above + parts.below + parts.above, 0ULL);
+    EXPECT_TRUE(histogram_matches(&all, z, n));
+    EXPECT_TRUE(histogram_matches(&parts, z, n));
+    int exponent;
+    EXPECT_EQ(frexp(parts.width, &exponent), 0.5); // a power of two
+    free(z);
+}
+
+TEST_F(StatsTests, window)
+{
+    window_t w;
+    stats_t r;
+    EXPECT_FALSE(window_init(&w, 0));
+    ASSERT_TRUE(window_init(&w, 37));
+    window_get(&w, &r);
+    EXPECT_TRUE(std::isnan(stats_mean(&r)));
+
+    // large values followed by small ones, with an infinity and nan in between
+    size_t n = 1000;
+    double *x = (double *)malloc(n * sizeof(double));
+    unsigned long long state = 12345;
+    for (size_t i = 0; i < n; i++)
+    {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        x[i] = (double)(state >> 40) / (1 << 24) * ((i < 300) ? 1e9 : 1.0);
+    }
+    x[500] = INFINITY;
+    x[600] = NAN;
+    for (size_t i = 0; i < n; i++)
+    {
+        window_add(&w, x[i]);
+        window_get(&w, &r);
+        size_t first = (i + 1 > 37) ? i + 1 - 37 : 0;
+        stats_t e;
+        stats_init(&e);
+        for (size_t k = first; k <= i; k++)
+        {
+            stats_add(&e, x[k]);
+        }
+        ASSERT_EQ(r.count, e.count);
+        if (std::isfinite(stats_mean(&e)))
+        {
+            ASSERT_NEAR(stats_mean(&r), stats_mean(&e), 1e-9 * fabsl(stats_mean(&e)));
+            if (e.count > 1)
+            {
+                ASSERT_NEAR(stats_stddev(&r), stats_stddev(&e), 1e-9 * stats_stddev(&e) + 1e-12);
+            }
+        }
+        else
+        {
+            ASSERT_TRUE(std::isnan(stats_mean(&r)));
+        }
+        ASSERT_EQ(stats_min(&r), stats_min(&e));
+        ASSERT_EQ(stats_max(&r), stats_max(&e));
+    }
+    window_free(&w);
+    free(x);
+}
+
+class DistributionTests : public Test
+{
+};
+
+TEST_F(DistributionTests, binomial)
+{
+    EXPECT_NEAR(log_comb(50, 25), logl(126410606437752.0L), 1e-12);
+    EXPECT_TRUE(std::isinf(log_comb(3, 4)));
+    EXPECT_NEAR(binomial_pmf(3, 10, 0.5L), 120.0L / 1024, 1e-15);
+    EXPECT_NEAR(binomial_cdf(3, 10, 0.5L), 176.0L / 1024, 1e-15);
+    EXPECT_EQ(binomial_cdf(10, 10, 0.5L), 1.0L);
+    EXPECT_EQ(binomial_pmf(0, 10, 0.0L), 1.0L);
+    EXPECT_EQ(binomial_cdf(9, 10, 1.0L), 0.0L);
+    EXPECT_TRUE(std::isnan(binomial_pmf(1, 10, 1.5L)));
+    EXPECT_TRUE(std::isnan(binomial_quantile(0.5L, 10, NAN)));
+
+    // far beyond the range of comb and power, by symmetry cdf(n / 2) = (1 + pmf(n / 2)) / 2
+    unsigned long big = 1000000;
+    long double middle = binomial_pmf(big / 2, big, 0.5L);
+    EXPECT_NEAR(middle, sqrtl(2.0L / (3.14159265358979323846L * big)), 1e-9);
+    EXPECT_NEAR(binomial_cdf(big / 2, big, 0.5L), (1.0L + middle) / 2, 1e-15);
+    EXPECT_NEAR(binomial_cdf(big / 2 - 1, big, 0.5L), (1.0L - middle) / 2, 1e-15);
+    EXPECT_EQ(binomial_quantile(0.5L, big, 0.5L), big / 2);
+
+    unsigned long n = 1000;
+    long double p = 0.3L;
+    std::vector<double> pmf(n + 1), cdf(n + 1);
+    binomial_pmf_array(n, p, pmf.data());
+    binomial_cdf_array(n, p, cdf.data());
+    long double sum = 0.0L;
+    for (unsigned long k = 0; k <= n; k++)
+    {
+        sum += pmf[k];
+        ASSERT_NEAR(pmf[k], binomial_pmf(k, n, p), 1e-12 * pmf[k] + 1e-300);
+        ASSERT_NEAR(cdf[k], sum, 1e-13);
+        ASSERT_NEAR(cdf[k], binomial_cdf(k, n, p), 1e-15 + 1e-12 * cdf[k]);
+        if (pmf[k] > 1e-10 && k > 0)
+        {
+            ASSERT_EQ(binomial_quantile((cdf[k - 1] + cdf[k]) / 2, n, p), k);
+        }
+    }
+    EXPECT_NEAR(sum, 1.0L, 1e-13);
+    EXPECT_EQ(binomial_quantile(1.0L, n, p), n);
+    EXPECT_EQ(binomial_quantile(0.0L, n, p), 0);
+}
+
+TEST_F(DistributionTests, poisson)
+{
+    EXPECT_NEAR(poisson_pmf(2, 3.0L), expl(-3.0L) * 4.5L, 1e-15);
+    EXPECT_NEAR(poisson_cdf(2, 3.0L), expl(-3.0L) * 8.5L, 1e-15);
+    EXPECT_NEAR(poisson_cdf(40, 3.0L), 1.0L, 1e-15);
+    EXPECT_EQ(poisson_pmf(0, 0.0L), 1.0L);
+    EXPECT_EQ(poisson_quantile(0.9L, 0.0L), 0.0L);
+    EXPECT_TRUE(std::isinf(poisson_quantile(1.0L, 2.0L)));
+    EXPECT_TRUE(std::isnan(poisson_cdf(2, -1.0L)));
+
+    // lgamma keeps large means in range, the median of a large mean is close to it
+    EXPECT_NEAR(poisson_quantile(0.5L, 1e12L), 1e12L, 1.0L);
+    EXPECT_GT(poisson_pmf(1000000000000UL, 1e12L), 0.0L);
+
+    long double lambda = 50.0L;
+    size_t n = 200;
+    std::vector<double> pmf(n), cdf(n);
+    poisson_pmf_array(lambda, n, pmf.data());
+    poisson_cdf_array(lambda, n, cdf.data());
+    long double sum = 0.0L;
+    for (size_t k = 0; k < n; k++)
+    {
+        sum += pmf[k];
+        ASSERT_NEAR(pmf[k], poisson_pmf(k, lambda), 1e-12 * pmf[k] + 1e-300);
+        ASSERT_NEAR(cdf[k], sum, 1e-13);
+        ASSERT_NEAR(cdf[k], poisson_cdf(k, lambda), 1e-15 + 1e-12 * cdf[k]);
+        if (pmf[k] > 1e-10 && k > 0)
+        {
+            ASSERT_EQ(poisson_quantile((cdf[k - 1] + cdf[k]) / 2, lambda), k);
+        }
+    }
+
+    // a table shorter than the mode
+    poisson_cdf_array(lambda, 10, cdf.data());
+    EXPECT_NEAR(cdf[9], poisson_cdf(9, lambda), 1e-12 * cdf[9]);
+}
+
+TEST_F(DistributionTests, normal)
+{
+    EXPECT_NEAR(normal_pdf(0.0L, 0.0L, 1.0L), 0.398942280401432677939946L, 1e-18);
+    EXPECT_NEAR(normal_cdf(1.96L, 0.0L, 1.0L), 0.9750021048517795L, 1e-15);
+    EXPECT_NEAR(normal_quantile(0.975L, 0.0L, 1.0L), 1.95996398454005423552L, 1e-15);
+    EXPECT_NEAR(normal_quantile(0.5L, 3.0L, 2.0L), 3.0L, 1e-18);
+    EXPECT_NEAR(normal_cdf(13.0L, 10.0L, 2.0L), normal_cdf(1.5L, 0.0L, 1.0L), 1e-18);
+    EXPECT_TRUE(std::isinf(normal_quantile(0.0L, 0.0L, 1.0L)));
+    EXPECT_TRUE(std::isnan(normal_cdf(0.0L, 0.0L, 0.0L)));
+
+    // the tails keep their relative precision
+    const long double qs[] = {1e-300L, 1e-20L, 1e-5L, 0.02L, 0.3L, 0.7L, 0.999L, 1.0L - 1e-15L};
+    for (long double q : qs)
+    {
+        long double x = normal_quantile(q, 0.0L, 1.0L);
+        long double back = (q < 0.5L) ? normal_cdf(x, 0.0L, 1.0L) : 1.0L - normal_cdf(x, 0.0L, 1.0L);
+        long double tail = (q < 0.5L) ? q : 1.0L - q;
+        EXPECT_NEAR(back, tail, 1e-15 * tail);
+    }
+
+    double x[] = {-3.0, -0.5, 0.0, 1.0, 2.5};
+    double pdf[5], cdf[5];
+    normal_pdf_array(x, 5, 1.0, 2.0, pdf);
+    normal_cdf_array(x, 5, 1.0, 2.0, cdf);
+    for (size_t i = 0; i < 5; i++)
+    {
+        EXPECT_NEAR(pdf[i], normal_pdf(x[i], 1.0L, 2.0L), 1e-15);
+        EXPECT_NEAR(cdf[i], normal_cdf(x[i], 1.0L, 2.0L), 1e-15);
+    }
+    normal_cdf_array(x, 5, 1.0, -2.0, cdf);
+    EXPECT_TRUE(std::isnan(cdf[0]));
+}
+
+class RandomTests : public Test
+{
+};
+
+TEST_F(RandomTests, xoshiro)
+{
+    // outputs of the reference implementation, lane 0 gives every RNG_LANES-th value
+    rng_t r;
+    memset(&r, 0, sizeof(r));
+    const unsigned long long state[] = {1, 2, 3, 4};
+    for (int w = 0; w < 4; w++)
+    {
+        r.s[w][0] = state[w];
+    }
+    const unsigned long long expected[] = {11520, 0, 1509978240, 1215971899390074240ULL};
+    for (int i = 0; i < 4; i++)
+    {
+        EXPECT_EQ(rng_next(&r), expected[i]);
+        for (int lane = 1; lane < RNG_LANES; lane++)
+        {
+            rng_next(&r);
+        }
+    }
+
+    // the jump polynomials checked against the 2^128-th and 2^192-th power of the transition matrix
+    const unsigned long long start[] = {0x123456789abcdefULL, 0xfedcba987654321ULL, 0x1111, 0x2222};
+    const unsigned long long jumped[] = {0xd4c5927cc0208c18ULL, 0x3c690440c4c3230bULL, 0xe8fc25bfbedaa807ULL,
+                                         0xe925fc9b707e3a65ULL}; // 4 jumps
+    const unsigned long long long_jumped[] = {0x223c88aa65f69f07ULL, 0x63b7f2fbc5d33595ULL,
+                                              0x1378c03604162261ULL, 0x1bdb498b1aa0acb4ULL};
+    rng_t a, b;
+    for (int w = 0; w < 4; w++)
+    {
+        a.s[w][0] = b.s[w][0] = start[w];
+    }
+    a.lane = b.lane = 0;
+    rng_jump(&a);
+    rng_long_jump(&b);
+    for (int w = 0; w < 4; w++)
+    {
+        EXPECT_EQ(a.s[w][0], jumped[w]);
+        EXPECT_EQ(b.s[w][0], long_jumped[w]);
+    }
+
+    rng_seed(&r, 42);
+    EXPECT_EQ(rng_next(&r), 1546998764402558742ULL); // splitmix64 of 42
+}
+
+TEST_F(RandomTests, uniform)
+{
+    rng_t r, s;
+    rng_seed(&r, 7);
+    rng_seed(&s, 7);
+    rng_next(&r); // arrays starting in the middle of the lanes
+    rng_next(&s);
+
+    size_t n = 100001;
+    std::vector<double> x(n);
+    rng_uniform_array(&r, x.data(), n);
+    double sum = 0.0;
+    for (size_t i = 0; i < n; i++)
+    {
+        ASSERT_EQ(x[i], rng_uniform(&s));
+        ASSERT_TRUE(x[i] >= 0.0 && x[i] < 1.0);
+        sum += x[i];
+    }
+    EXPECT_EQ(rng_next(&r), rng_next(&s));
+    EXPECT_NEAR(sum / n, 0.5, 5.0 * sqrt(1.0 / 12 / n));
+
+    // the next stream does not repeat the values
+    rng_seed(&s, 7);
+    rng_jump(&s);
+    rng_seed(&r, 7);
+    EXPECT_NE(rng_next(&r), rng_next(&s));
+}
+
+TEST_F(RandomTests, normal)
+{
+    rng_t r;
+    rng_seed(&r, 2026);
+    size_t n = 1000000;
+    std::vector<double> x(n);
+    rng_normal_array(&r, x.data(), n, 3.0, 2.0);
+    stats_t s;
+    stats_init(&s);
+    stats_add_array(&s, x.data(), n);
+    EXPECT_NEAR(stats_mean(&s), 3.0, 5.0 * 2.0 / sqrt(n));
+    EXPECT_NEAR(stats_stddev(&s), 2.0, 0.01);
+
+    // the distribution at points in the layers, the wedges and the tail
+    const double points[] = {-4.0, -3.7, -2.0, -0.5, 0.0, 0.3, 1.0, 2.5, 3.6, 4.0};
+    std::sort(x.begin(), x.end());
+    for (double z : points)
+    {
+        double below = (double)(std::lower_bound(x.begin(), x.end(), 3.0 + 2.0 * z) - x.begin()) / n;
+        double p = normal_cdf(z, 0.0L, 1.0L);
+        EXPECT_NEAR(below, p, 5.0 * sqrt(p * (1.0 - p) / n) + 1e-6);
+    }
+
+    rng_seed(&r, 2026);
+    std::vector<double> y(n);
+    rng_normal_array(&r, y.data(), n, 3.0, 2.0);
+    std::sort(y.begin(), y.end());
+    EXPECT_TRUE(x == y);
+    double single = rng_normal(&r, 0.0, 1.0);
+    EXPECT_TRUE(std::isfinite(single));
+}
+
+/**
+ * @brief Samples 4 if a random point of the unit square lies in the quarter circle, 0 otherwise
+ */
+static void quarter_circle(rng_t *r, void *arg, double *out, size_t n)
+{
+    (void)arg;
+    double point[2 * MC_BLOCK];
+    rng_uniform_array(r, point, 2 * n);
+    for (size_t i = 0; i < n; i++)
+    {
+        out[i] = (point[2 * i] * point[2 * i] + point[2 * i + 1] * point[2 * i + 1] < 1.0) ? 4.0 : 0.0;
+    }
+}
+
+TEST_F(RandomTests, monte_carlo)
+{
+    stats_t one, three, many;
+    unsigned long long samples = 3000001;
+    monte_carlo(quarter_circle, NULL, samples, 99, 1, &one);
+    monte_carlo(quarter_circle, NULL, samples, 99, 3, &three);
+    monte_carlo(quarter_circle, NULL, samples, 99, 0, &many);
+    EXPECT_EQ(one.count, samples);
+    EXPECT_NEAR(stats_mean(&one), 3.14159265358979, 5.0 * stats_stddev(&one) / sqrt(samples));
+    // the same result for any number of threads
+    EXPECT_TRUE(one.mean == three.mean && one.m2 == three.m2);
+    EXPECT_TRUE(one.mean == many.mean && one.m2 == many.m2);
+
+    stats_t other;
+    monte_carlo(quarter_circle, NULL, samples, 100, 3, &other);
+    EXPECT_NE(one.mean, other.mean);
+    monte_carlo(quarter_circle, NULL, 0, 99, 3, &other);
+    EXPECT_EQ(other.count, 0ULL);
+}
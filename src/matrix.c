@@ -0,0 +1,553 @@
+/**
+ * @file matrix.c
+ * @brief Dense matrices of doubles
+ * @date 18.10.2026
+ */
+
+#define _POSIX_C_SOURCE 200809L // posix_memalign, sysconf
+
+#include "matrix.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define GEMM_MR 4                    // rows of the register tile
+#define GEMM_NR 4                    // columns of the register tile
+#define GEMM_MC 128                  // rows of the packed block of A, sized for the L2 cache
+#define GEMM_KC 256                  // depth of the packed blocks
+#define GEMM_NC 2048                 // columns of the packed block of B, sized for the L3 cache
+#define GEMM_PARALLEL_MIN 4000000.0  // smallest m * n * k that is split among threads
+#define GEMM_MIN_ROWS_PER_THREAD 64
+#define LU_BLOCK 64                  // width of the panels of the blocked LU decomposition
+
+typedef double gemm_vec __attribute__((vector_size(16))); // two doubles, one SSE2 register
+
+static int matrix_threads = 0;
+
+/** @struct gemm_task
+ *  @brief Band of rows of C = alpha * A * B + C computed by one thread.
+ */
+struct gemm_task
+{
+    size_t m, n, k;
+    double alpha;
+    const double *a;
+    size_t lda;
+    const double *b;
+    size_t ldb;
+    double *c;
+    size_t ldc;
+};
+
+/**
+ * @brief Allocates an array of n doubles aligned to a cache line.
+ */
+static double *matrix_alloc(size_t n)
+{
+    void *p = NULL;
+    if (posix_memalign(&p, 64, (n == 0 ? 1 : n) * sizeof(double)) != 0)
+    {
+        fprintf(stderr, "matrix - memory allocation error\n");
+        abort();
+    }
+    return p;
+}
+
+static size_t min_size(size_t a, size_t b)
+{
+    return (a < b) ? a : b;
+}
+
+void matrix_init(matrix_t *m, size_t rows, size_t cols)
+{
+    m->rows = rows;
+    m->cols = cols;
+    m->data = matrix_alloc(rows * cols);
+    memset(m->data, 0, rows * cols * sizeof(double));
+}
+
+void matrix_free(matrix_t *m)
+{
+    free(m->data);
+    m->data = NULL;
+    m->rows = m->cols = 0;
+}
+
+void matrix_resize(matrix_t *m, size_t rows, size_t cols)
+{
+    if (rows * cols != m->rows * m->cols)
+    {
+        free(m->data);
+        m->data = matrix_alloc(rows * cols);
+    }
+    m->rows = rows;
+    m->cols = cols;
+    memset(m->data, 0, rows * cols * sizeof(double));
+}
+
+void matrix_copy(matrix_t *r, const matrix_t *a)
+{
+    if (r == a)
+    {
+        return;
+    }
+    matrix_resize(r, a->rows, a->cols);
+    memcpy(r->data, a->data, a->rows * a->cols * sizeof(double));
+}
+
+void matrix_identity(matrix_t *m, size_t n)
+{
+    matrix_resize(m, n, n);
+    for (size_t i = 0; i < n; i++)
+    {
+        m->data[i * n + i] = 1.0;
+    }
+}
+
+void matrix_set_threads(int threads)
+{
+    matrix_threads = (threads < 0) ? 0 : threads;
+}
+
+/**
+ * @brief Packs an mc x kc block of A into panels of GEMM_MR rows stored by columns.
+ * @details Missing rows of the last panel are filled with zeros.
+ */
+static void pack_a(size_t mc, size_t kc, const double *a, size_t lda, double *buf)
+{
+    for (size_t i = 0; i < mc; i += GEMM_MR)
+    {
+        size_t mr = min_size(GEMM_MR, mc - i);
+        for (size_t p = 0; p < kc; p++)
+        {
+            for (size_t r = 0; r < GEMM_MR; r++)
+            {
+                *buf++ = (r < mr) ? a[(i + r) * lda + p] : 0.0;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Packs a kc x nc block of B into panels of GEMM_NR columns stored by rows.
+ * @details Missing columns of the last panel are filled with zeros.
+ */
+static void pack_b(size_t kc, size_t nc, const double *b, size_t ldb, double *buf)
+{
+    for (size_t j = 0; j < nc; j += GEMM_NR)
+    {
+        size_t nr = min_size(GEMM_NR, nc - j);
+        for (size_t p = 0; p < kc; p++)
+        {
+            for (size_t q = 0; q < GEMM_NR; q++)
+            {
+                *buf++ = (q < nr) ? b[p * ldb + j + q] : 0.0;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Adds alpha * (packed A panel) * (packed B panel) to the mr x nr tile of C.
+ * @details The 4x4 tile is accumulated in eight vector registers.
+ */
+static void gemm_kernel(size_t kc, const double *a, const double *b, double *c, size_t ldc, size_t mr, size_t nr,
+                        double alpha)
+{
+    gemm_vec c00 = {0.0, 0.0}, c01 = c00, c10 = c00, c11 = c00, c20 = c00, c21 = c00, c30 = c00, c31 = c00;
+    for (size_t p = 0; p < kc; p++)
+    {
+        gemm_vec b0, b1;
+        memcpy(&b0, b, sizeof(b0));
+        memcpy(&b1, b + 2, sizeof(b1));
+        gemm_vec a0 = {a[0], a[0]}, a1 = {a[1], a[1]}, a2 = {a[2], a[2]}, a3 = {a[3], a[3]};
+        c00 += a0 * b0;
+        c01 += a0 * b1;
+        c10 += a1 * b0;
+        c11 += a1 * b1;
+        c20 += a2 * b0;
+        c21 += a2 * b1;
+        c30 += a3 * b0;
+        c31 += a3 * b1;
+        a += GEMM_MR;
+        b += GEMM_NR;
+    }
+
+    double t[GEMM_MR][GEMM_NR];
+    memcpy(&t[0][0], &c00, sizeof(c00));
+    memcpy(&t[0][2], &c01, sizeof(c01));
+    memcpy(&t[1][0], &c10, sizeof(c10));
+    memcpy(&t[1][2], &c11, sizeof(c11));
+    memcpy(&t[2][0], &c20, sizeof(c20));
+    memcpy(&t[2][2], &c21, sizeof(c21));
+    memcpy(&t[3][0], &c30, sizeof(c30));
+    memcpy(&t[3][2], &c31, sizeof(c31));
+    for (size_t r = 0; r < mr; r++)
+    {
+        for (size_t q = 0; q < nr; q++)
+        {
+            c[r * ldc + q] += alpha * t[r][q];
+        }
+    }
+}
+
+/**
+ * @brief C += alpha * A * B in one thread, loops over the blocks in the order of Goto's algorithm.
+ */
+static void gemm_serial(const struct gemm_task *t)
+{
+    size_t nc_max = min_size(GEMM_NC, (t->n + GEMM_NR - 1) / GEMM_NR * GEMM_NR);
+    double *abuf = matrix_alloc(GEMM_MC * GEMM_KC);
+    double *bbuf = matrix_alloc(GEMM_KC * nc_max);
+
+    for (size_t jc = 0; jc < t->n; jc += GEMM_NC)
+    {
+        size_t nc = min_size(GEMM_NC, t->n - jc);
+        for (size_t pc = 0; pc < t->k; pc += GEMM_KC)
+        {
+            size_t kc = min_size(GEMM_KC, t->k - pc);
+            pack_b(kc, nc, t->b + pc * t->ldb + jc, t->ldb, bbuf);
+            for (size_t ic = 0; ic < t->m; ic += GEMM_MC)
+            {
+                size_t mc = min_size(GEMM_MC, t->m - ic);
+                pack_a(mc, kc, t->a + ic * t->lda + pc, t->lda, abuf);
+                for (size_t jr = 0; jr < nc; jr += GEMM_NR)
+                {
+                    for (size_t ir = 0; ir < mc; ir += GEMM_MR)
+                    {
+                        gemm_kernel(kc, abuf + ir * kc, bbuf + jr * kc, t->c + (ic + ir) * t->ldc + jc + jr, t->ldc,
+                                    min_size(GEMM_MR, mc - ir), min_size(GEMM_NR, nc - jr), t->alpha);
+                    }
+                }
+            }
+        }
+    }
+    free(abuf);
+    free(bbuf);
+}
+
+static void *gemm_thread(void *arg)
+{
+    gemm_serial(arg);
+    return NULL;
+}
+
+/**
+ * @brief Number of threads for a product of the given size.
+ */
+static size_t gemm_thread_count(size_t m, size_t n, size_t k)
+{
+    if ((double)m * n * k < GEMM_PARALLEL_MIN)
+    {
+        return 1;
+    }
+    long threads = matrix_threads;
+    if (threads == 0)
+    {
+        threads = sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    size_t max = m / GEMM_MIN_ROWS_PER_THREAD;
+    if (threads < 1 || max < 1)
+    {
+        return 1;
+    }
+    return min_size((size_t)threads, max);
+}
+
+void matrix_gemm(size_t m, size_t n, size_t k, double alpha, const double *a, size_t lda, const double *b,
+                 size_t ldb, double beta, double *c, size_t ldc)
+{
+    if (beta != 1.0)
+    {
+        for (size_t i = 0; i < m; i++)
+        {
+            for (size_t j = 0; j < n; j++)
+            {
+                c[i * ldc + j] = (beta == 0.0) ? 0.0 : beta * c[i * ldc + j];
+            }
+        }
+    }
+    if (m == 0 || n == 0 || k == 0 || alpha == 0.0)
+    {
+        return;
+    }
+
+    size_t threads = gemm_thread_count(m, n, k);
+    if (threads == 1)
+    {
+        struct gemm_task t = {m, n, k, alpha, a, lda, b, ldb, c, ldc};
+        gemm_serial(&t);
+        return;
+    }
+
+    // bands of rows, the last one is computed by the calling thread
+    struct gemm_task *tasks = malloc(threads * sizeof(struct gemm_task));
+    pthread_t *ids = malloc(threads * sizeof(pthread_t));
+    bool *started = calloc(threads, sizeof(bool));
+    if (tasks == NULL || ids == NULL || started == NULL)
+    {
+        fprintf(stderr, "matrix - memory allocation error\n");
+        abort();
+    }
+    size_t band = ((m + threads - 1) / threads + GEMM_MR - 1) / GEMM_MR * GEMM_MR;
+    size_t count = 0;
+    for (size_t row = 0; row < m; row += band)
+    {
+        struct gemm_task t = {min_size(band, m - row), n, k, alpha, a + row * lda, lda, b, ldb, c + row * ldc, ldc};
+        tasks[count++] = t;
+    }
+    for (size_t i = 0; i + 1 < count; i++)
+    {
+        started[i] = (pthread_create(&ids[i], NULL, gemm_thread, &tasks[i]) == 0);
+        if (!started[i])
+        {
+            gemm_serial(&tasks[i]);
+        }
+    }
+    gemm_serial(&tasks[count - 1]);
+    for (size_t i = 0; i + 1 < count; i++)
+    {
+        if (started[i])
+        {
+            pthread_join(ids[i], NULL);
+        }
+    }
+    free(tasks);
+    free(ids);
+    free(started);
+}
+
+bool matrix_mul(matrix_t *r, const matrix_t *a, const matrix_t *b)
+{
+    if (a->cols != b->rows)
+    {
+        return false;
+    }
+    matrix_t t;
+    matrix_init(&t, a->rows, b->cols);
+    matrix_gemm(a->rows, b->cols, a->cols, 1.0, a->data, a->cols, b->data, b->cols, 0.0, t.data, t.cols);
+    matrix_free(r);
+    *r = t;
+    return true;
+}
+
+bool matrix_lu(matrix_t *lu, size_t *perm, int *sign, const matrix_t *a)
+{
+    if (a->rows != a->cols)
+    {
+        return false;
+    }
+    matrix_copy(lu, a);
+    size_t n = a->rows;
+    double *d = lu->data;
+    bool regular = true;
+    *sign = 1;
+    for (size_t i = 0; i < n; i++)
+    {
+        perm[i] = i;
+    }
+
+    for (size_t k0 = 0; k0 < n; k0 += LU_BLOCK)
+    {
+        size_t k1 = min_size(k0 + LU_BLOCK, n);
+        // unblocked decomposition of the panel, rows are swapped in the whole matrix
+        for (size_t j = k0; j < k1; j++)
+        {
+            size_t p = j;
+            double max = fabs(d[j * n + j]);
+            for (size_t i = j + 1; i < n; i++)
+            {
+                if (fabs(d[i * n + j]) > max)
+                {
+                    max = fabs(d[i * n + j]);
+                    p = i;
+                }
+            }
+            if (max == 0.0)
+            {
+                regular = false;
+                continue;
+            }
+            if (p != j)
+            {
+                for (size_t q = 0; q < n; q++)
+                {
+                    double tmp = d[j * n + q];
+                    d[j * n + q] = d[p * n + q];
+                    d[p * n + q] = tmp;
+                }
+                size_t tmp = perm[j];
+                perm[j] = perm[p];
+                perm[p] = tmp;
+                *sign = -*sign;
+            }
+            for (size_t i = j + 1; i < n; i++)
+            {
+                double l = d[i * n + j] /= d[j * n + j];
+                for (size_t q = j + 1; q < k1; q++)
+                {
+                    d[i * n + q] -= l * d[j * n + q];
+                }
+            }
+        }
+        if (k1 == n)
+        {
+            break;
+        }
+        // U12 = L11^-1 * A12
+        for (size_t j = k0; j < k1; j++)
+        {
+            for (size_t i = j + 1; i < k1; i++)
+            {
+                double l = d[i * n + j];
+                for (size_t q = k1; q < n; q++)
+                {
+                    d[i * n + q] -= l * d[j * n + q];
+                }
+            }
+        }
+        // A22 -= L21 * U12
+        matrix_gemm(n - k1, n - k1, k1 - k0, -1.0, d + k1 * n + k0, n, d + k0 * n + k1, n, 1.0, d + k1 * n + k1, n);
+    }
+    return regular;
+}
+
+/**
+ * @brief Solves L * U * x = x for m right-hand sides stored by rows (n x m), overwriting x.
+ * @details Blocked like the decomposition, the contribution of the solved rows to a block of rows
+ * is subtracted by one multiplication.
+ */
+static void lu_substitute(const matrix_t *lu, double *x, size_t m)
+{
+    size_t n = lu->rows;
+    const double *d = lu->data;
+    for (size_t k0 = 0; k0 < n; k0 += LU_BLOCK)
+    {
+        size_t k1 = min_size(k0 + LU_BLOCK, n);
+        matrix_gemm(k1 - k0, m, k0, -1.0, d + k0 * n, n, x, m, 1.0, x + k0 * m, m);
+        for (size_t i = k0 + 1; i < k1; i++)
+        {
+            for (size_t k = k0; k < i; k++)
+            {
+                double l = d[i * n + k];
+                for (size_t q = 0; q < m; q++)
+                {
+                    x[i * m + q] -= l * x[k * m + q];
+                }
+            }
+        }
+    }
+    for (size_t k1 = n; k1 > 0;)
+    {
+        size_t k0 = (k1 > LU_BLOCK) ? k1 - LU_BLOCK : 0;
+        matrix_gemm(k1 - k0, m, n - k1, -1.0, d + k0 * n + k1, n, x + k1 * m, m, 1.0, x + k0 * m, m);
+        for (size_t i = k1; i-- > k0;)
+        {
+            for (size_t k = i + 1; k < k1; k++)
+            {
+                double u = d[i * n + k];
+                for (size_t q = 0; q < m; q++)
+                {
+                    x[i * m + q] -= u * x[k * m + q];
+                }
+            }
+            double pivot = d[i * n + i];
+            for (size_t q = 0; q < m; q++)
+            {
+                x[i * m + q] /= pivot;
+            }
+        }
+        k1 = k0;
+    }
+}
+
+double matrix_det(const matrix_t *a)
+{
+    if (a->rows != a->cols)
+    {
+        return NAN;
+    }
+    size_t n = a->rows;
+    size_t *perm = malloc((n == 0 ? 1 : n) * sizeof(size_t));
+    if (perm == NULL)
+    {
+        fprintf(stderr, "matrix - memory allocation error\n");
+        abort();
+    }
+    matrix_t lu;
+    matrix_init(&lu, 0, 0);
+    int sign;
+    double det = 0.0;
+    if (matrix_lu(&lu, perm, &sign, a))
+    {
+        // long double has a wider range for the intermediate products
+        long double p = sign;
+        for (size_t i = 0; i < n; i++)
+        {
+            p *= lu.data[i * n + i];
+        }
+        det = (double)p;
+    }
+    matrix_free(&lu);
+    free(perm);
+    return det;
+}
+
+bool matrix_solve(matrix_t *x, const matrix_t *a, const matrix_t *b)
+{
+    if (a->rows != a->cols || a->rows != b->rows)
+    {
+        return false;
+    }
+    size_t n = a->rows, m = b->cols;
+    size_t *perm = malloc((n == 0 ? 1 : n) * sizeof(size_t));
+    if (perm == NULL)
+    {
+        fprintf(stderr, "matrix - memory allocation error\n");
+        abort();
+    }
+    matrix_t lu;
+    matrix_init(&lu, 0, 0);
+    int sign;
+    bool ok = matrix_lu(&lu, perm, &sign, a);
+    if (ok)
+    {
+        matrix_t t;
+        matrix_init(&t, n, m);
+        for (size_t i = 0; i < n; i++)
+        {
+            memcpy(t.data + i * m, b->data + perm[i] * m, m * sizeof(double));
+        }
+        lu_substitute(&lu, t.data, m);
+        matrix_free(x);
+        *x = t;
+    }
+    matrix_free(&lu);
+    free(perm);
+    return ok;
+}
+
+bool matrix_inverse(matrix_t *r, const matrix_t *a)
+{
+    if (a->rows != a->cols)
+    {
+        return false;
+    }
+    matrix_t id;
+    matrix_init(&id, 0, 0);
+    matrix_identity(&id, a->rows);
+    bool ok = matrix_solve(&id, a, &id);
+    if (ok)
+    {
+        matrix_free(r);
+        *r = id;
+    }
+    else
+    {
+        matrix_free(&id);
+    }
+    return ok;
+}
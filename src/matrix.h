@@ -0,0 +1,125 @@
+/**
+ * @file matrix.h
+ * @brief Dense matrices of doubles
+ * @date 18.10.2026
+ *
+ * Matrices are stored by rows. Multiplication packs blocks of the operands that fit in the caches
+ * and computes 4x4 tiles of the result in vector registers. Large products are split by rows among
+ * threads. LU decomposition is blocked, so most of its work is done by the same multiplication.
+ * Every matrix_t has to be initialized with matrix_init and released with matrix_free, results of
+ * the operations are resized as needed. Allocation failure is fatal (the program is aborted).
+ */
+
+#ifndef MATRIX_H
+#define MATRIX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/** @struct matrix
+ *  @brief Dense matrix.
+ *  @param rows number of rows
+ *  @param cols number of columns
+ *  @param data elements by rows, element (i, j) is data[i * cols + j]
+ */
+struct matrix
+{
+    size_t rows;
+    size_t cols;
+    double *data;
+};
+
+typedef struct matrix matrix_t;
+
+/**
+ * @brief Initializes a zero matrix.
+ * @param m
+ * @param rows
+ * @param cols
+ */
+void matrix_init(matrix_t *m, size_t rows, size_t cols);
+
+/**
+ * @brief Frees memory of the matrix.
+ * @param m
+ */
+void matrix_free(matrix_t *m);
+
+/**
+ * @brief Changes the dimensions of the matrix and sets all its elements to zero.
+ */
+void matrix_resize(matrix_t *m, size_t rows, size_t cols);
+
+/**
+ * @brief r = a
+ */
+void matrix_copy(matrix_t *r, const matrix_t *a);
+
+/**
+ * @brief Sets the matrix to the n x n identity matrix.
+ */
+void matrix_identity(matrix_t *m, size_t n);
+
+/**
+ * @brief Sets the number of threads used by large multiplications.
+ * @param threads number of threads, 0 for the number of online processors (the default)
+ */
+void matrix_set_threads(int threads);
+
+/**
+ * @brief General matrix multiplication C = alpha * A * B + beta * C on row-major arrays.
+ * @details C must not overlap A or B. If beta is zero, C is not read.
+ * @param m rows of A and C
+ * @param n columns of B and C
+ * @param k columns of A and rows of B
+ * @param alpha
+ * @param a m x k matrix
+ * @param lda distance between the rows of a
+ * @param b k x n matrix
+ * @param ldb distance between the rows of b
+ * @param beta
+ * @param c m x n matrix
+ * @param ldc distance between the rows of c
+ */
+void matrix_gemm(size_t m, size_t n, size_t k, double alpha, const double *a, size_t lda, const double *b,
+                 size_t ldb, double beta, double *c, size_t ldc);
+
+/**
+ * @brief r = a * b
+ * @return false if the columns of a do not match the rows of b, r is unchanged in that case
+ */
+bool matrix_mul(matrix_t *r, const matrix_t *a, const matrix_t *b);
+
+/**
+ * @brief LU decomposition with partial pivoting, P * a = L * U.
+ * @details L has unit diagonal and is stored below the diagonal of lu, U on and above it.
+ * @param lu receives L and U, may be equal to a
+ * @param perm receives the permutation, row i of P * a is row perm[i] of a (n items)
+ * @param sign receives the sign of the permutation (1 or -1)
+ * @param a square matrix
+ * @return false if a is singular (a zero pivot was found) or not square
+ */
+bool matrix_lu(matrix_t *lu, size_t *perm, int *sign, const matrix_t *a);
+
+/**
+ * @brief Determinant of a square matrix.
+ * @return determinant, NAN if a is not square
+ */
+double matrix_det(const matrix_t *a);
+
+/**
+ * @brief r = a^-1
+ * @return false if a is singular or not square, r is unchanged in that case
+ */
+bool matrix_inverse(matrix_t *r, const matrix_t *a);
+
+/**
+ * @brief Solves a * x = b.
+ * @param x receives the solution, may be equal to b
+ * @param a square matrix
+ * @param b right-hand sides in columns
+ * @return false if a is singular, not square or its size does not match b, x is unchanged in that case
+ */
+bool matrix_solve(matrix_t *x, const matrix_t *a, const matrix_t *b);
+
+#endif
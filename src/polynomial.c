@@ -0,0 +1,560 @@
+/**
+ * @file polynomial.c
+ * @brief Evaluation and roots of polynomials
+ * @date 18.10.2026
+ */
+
+#include "polynomial.h"
+#include <float.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define POLY_MAX_ITERATIONS 200 // sweeps of the Aberth-Ehrlich iteration
+#define POLY_START_ANGLE 0.7L   // rotation of the initial approximations, avoids symmetric placement
+#define POLY_TWO_PI 6.28318530717958647692528676655900577L
+
+typedef double poly_vec __attribute__((vector_size(16))); // two doubles, one SSE2 register
+
+/** @struct poly_root
+ *  @brief Complex root, used for sorting.
+ */
+struct poly_root
+{
+    long double re;
+    long double im;
+};
+
+/** @struct poly_value
+ *  @brief Value of a polynomial at z evaluated without overflow.
+ *  @param reversed true if q(w) = w^n p(1/w) was evaluated at w = 1/z because |z| > 1
+ *  @param wr real part of the point of the evaluation, z or 1/z
+ *  @param wi imaginary part of the point of the evaluation
+ *  @param vr real part of p(z) or q(w)
+ *  @param vi imaginary part of p(z) or q(w)
+ *  @param dr real part of p'(z) or q'(w)
+ *  @param di imaginary part of p'(z) or q'(w)
+ *  @param bound rounding error bound of the value
+ */
+struct poly_value
+{
+    bool reversed;
+    long double wr, wi;
+    long double vr, vi;
+    long double dr, di;
+    long double bound;
+};
+
+long double poly_eval(const long double *coef, int degree, long double x)
+{
+    long double r = coef[degree];
+    for (int k = degree - 1; k >= 0; k--)
+    {
+        r = r * x + coef[k];
+    }
+    return r;
+}
+
+/**
+ * @brief Evaluates c[0] + c[1] x + ... + c[7] x^7 as a tree of independent products.
+ */
+static long double estrin_block(const long double *c, long double x, long double x2, long double x4)
+{
+    long double p01 = c[0] + c[1] * x;
+    long double p23 = c[2] + c[3] * x;
+    long double p45 = c[4] + c[5] * x;
+    long double p67 = c[6] + c[7] * x;
+    return (p01 + p23 * x2) + (p45 + p67 * x2) * x4;
+}
+
+long double poly_eval_estrin(const long double *coef, int degree, long double x)
+{
+    long double x2 = x * x;
+    long double x4 = x2 * x2;
+    long double x8 = x4 * x4;
+
+    // the highest block is padded with zeros
+    int top = degree / 8 * 8;
+    long double c[8] = {0.0L};
+    memcpy(c, coef + top, (size_t)(degree - top + 1) * sizeof(long double));
+    long double r = estrin_block(c, x, x2, x4);
+    for (int b = top - 8; b >= 0; b -= 8)
+    {
+        r = r * x8 + estrin_block(coef + b, x, x2, x4);
+    }
+    return r;
+}
+
+void poly_eval_batch(const double *coef, int degree, const double *x, double *y, size_t n)
+{
+    size_t i = 0;
+    // four independent vectors hide the latency of the multiply-add chain
+    for (; i + 8 <= n; i += 8)
+    {
+        poly_vec x0, x1, x2, x3;
+        memcpy(&x0, x + i, sizeof(x0));
+        memcpy(&x1, x + i + 2, sizeof(x1));
+        memcpy(&x2, x + i + 4, sizeof(x2));
+        memcpy(&x3, x + i + 6, sizeof(x3));
+        poly_vec y0 = {coef[degree], coef[degree]};
+        poly_vec y1 = y0, y2 = y0, y3 = y0;
+        for (int k = degree - 1; k >= 0; k--)
+        {
+            y0 = y0 * x0 + coef[k];
+            y1 = y1 * x1 + coef[k];
+            y2 = y2 * x2 + coef[k];
+            y3 = y3 * x3 + coef[k];
+        }
+        memcpy(y + i, &y0, sizeof(y0));
+        memcpy(y + i + 2, &y1, sizeof(y1));
+        memcpy(y + i + 4, &y2, sizeof(y2));
+        memcpy(y + i + 6, &y3, sizeof(y3));
+    }
+    for (; i < n; i++)
+    {
+        double r = coef[degree];
+        for (int k = degree - 1; k >= 0; k--)
+        {
+            r = r * x[i] + coef[k];
+        }
+        y[i] = r;
+    }
+}
+
+/**
+ * @brief Places the initial approximations on circles given by the Newton polygon.
+ * @details Every edge of the upper convex hull of the points (k, log|a_k|) from i to j gives j - i
+ * roots of modulus (|a_i| / |a_j|)^(1 / (j - i)).
+ * @param a coefficients, a[0] and a[n] are not zero
+ * @param n degree
+ * @param zr receives real parts of n approximations
+ * @param zi receives imaginary parts of n approximations
+ */
+static void aberth_start(const long double *a, int n, long double *zr, long double *zi)
+{
+    int *hull = malloc((size_t)(n + 1) * sizeof(int));
+    long double *lg = malloc((size_t)(n + 1) * sizeof(long double));
+    if (hull == NULL || lg == NULL)
+    {
+        fprintf(stderr, "polynomial - memory allocation error\n");
+        abort();
+    }
+
+    int h = 0;
+    for (int k = 0; k <= n; k++)
+    {
+        if (a[k] == 0.0L)
+        {
+            continue;
+        }
+        lg[k] = logl(fabsl(a[k]));
+        // removes points that are not above the segment from the previous hull point to k
+        while (h >= 2)
+        {
+            int o = hull[h - 2], p = hull[h - 1];
+            if ((p - o) * (lg[k] - lg[o]) - (lg[p] - lg[o]) * (k - o) < 0.0L)
+            {
+                break;
+            }
+            h--;
+        }
+        hull[h++] = k;
+    }
+
+    int idx = 0;
+    for (int e = 0; e + 1 < h; e++)
+    {
+        int i = hull[e], j = hull[e + 1];
+        long double radius = expl((lg[i] - lg[j]) / (j - i));
+        long double start = POLY_TWO_PI * i / n + POLY_START_ANGLE;
+        long double cr = radius * cosl(start), ci = radius * sinl(start);
+        long double step_r = cosl(POLY_TWO_PI / (j - i)), step_i = sinl(POLY_TWO_PI / (j - i));
+        // the points of the circle are obtained by rotation
+        for (int t = 0; t < j - i; t++)
+        {
+            zr[idx] = cr;
+            zi[idx++] = ci;
+            long double tmp = cr * step_r - ci * step_i;
+            ci = cr * step_i + ci * step_r;
+            cr = tmp;
+        }
+    }
+    free(hull);
+    free(lg);
+}
+
+/**
+ * @brief Complex division (ar + ai*i) / (br + bi*i) by Smith's method, the squares of the moduli are not formed.
+ */
+static void complex_div(long double ar, long double ai, long double br, long double bi, long double *qr, long double *qi)
+{
+    if (fabsl(br) >= fabsl(bi))
+    {
+        long double t = bi / br, d = br + bi * t;
+        *qr = (ar + ai * t) / d;
+        *qi = (ai - ar * t) / d;
+    }
+    else
+    {
+        long double t = br / bi, d = bi + br * t;
+        *qr = (ar * t + ai) / d;
+        *qi = (ai * t - ar) / d;
+    }
+}
+
+/**
+ * @brief Evaluates the polynomial and its derivative at z = x + y*i by Horner's scheme.
+ * @details Outside the unit circle the reversed polynomial is evaluated at 1/z, so the powers of z do not
+ * overflow or underflow for roots of any size that long double can hold.
+ * @param a coefficients, a[0] and a[n] are not zero
+ * @param n degree
+ * @param v receives the values
+ */
+static void poly_value_at(const long double *a, int n, long double x, long double y, struct poly_value *v)
+{
+    long double az = hypotl(x, y);
+    v->reversed = az > 1.0L;
+    v->wr = x;
+    v->wi = y;
+    if (v->reversed)
+    {
+        complex_div(1.0L, 0.0L, x, y, &v->wr, &v->wi);
+        az = 1.0L / az;
+    }
+    // the coefficient of w^k of q is a[n-k]
+    long double pr = a[v->reversed ? 0 : n], pi = 0.0L, dr = 0.0L, di = 0.0L, s = fabsl(pr);
+    for (int k = n - 1; k >= 0; k--)
+    {
+        long double c = a[v->reversed ? n - k : k];
+        long double t = dr * v->wr - di * v->wi + pr;
+        di = dr * v->wi + di * v->wr + pi;
+        dr = t;
+        t = pr * v->wr - pi * v->wi + c;
+        pi = pr * v->wi + pi * v->wr;
+        pr = t;
+        s = s * az + fabsl(c);
+    }
+    v->vr = pr;
+    v->vi = pi;
+    v->dr = dr;
+    v->di = di;
+    v->bound = 4.0L * n * LDBL_EPSILON * s;
+}
+
+/**
+ * @brief Newton correction p(z) / p'(z) of the approximation z = x + y*i.
+ * @details Outside the unit circle p / p' = z / (n - w * q'(w) / q(w)) with w = 1/z.
+ * @return true if |p(z)| is within the rounding error of Horner's scheme
+ */
+static bool newton_ratio(const long double *a, int n, long double x, long double y, long double *rr, long double *ri)
+{
+    struct poly_value v;
+    poly_value_at(a, n, x, y, &v);
+    bool converged = hypotl(v.vr, v.vi) <= v.bound;
+    if (!v.reversed)
+    {
+        complex_div(v.vr, v.vi, v.dr, v.di, rr, ri);
+        return converged;
+    }
+    if (v.vr == 0.0L && v.vi == 0.0L)
+    {
+        *rr = *ri = 0.0L; // an exact root
+        return converged;
+    }
+    long double tr, ti;
+    complex_div(v.dr, v.di, v.vr, v.vi, &tr, &ti);
+    complex_div(x, y, n - (v.wr * tr - v.wi * ti), -(v.wr * ti + v.wi * tr), rr, ri);
+    return converged;
+}
+
+/**
+ * @brief Aberth-Ehrlich iteration, the approximations are updated in place (Gauss-Seidel style).
+ * @details A root is accepted when |p(z)| is within the rounding error of Horner's scheme. Its last
+ * correction is still applied, as the actual error of the evaluation is usually far below the bound.
+ * @param a coefficients, a[0] and a[n] are not zero
+ * @param n degree
+ * @param zr real parts of the approximations
+ * @param zi imaginary parts of the approximations
+ */
+static void aberth(const long double *a, int n, long double *zr, long double *zi)
+{
+    bool *done = calloc((size_t)n, sizeof(bool));
+    if (done == NULL)
+    {
+        fprintf(stderr, "polynomial - memory allocation error\n");
+        abort();
+    }
+
+    int remaining = n;
+    for (int it = 0; it < POLY_MAX_ITERATIONS && remaining > 0; it++)
+    {
+        for (int i = 0; i < n; i++)
+        {
+            if (done[i])
+            {
+                continue;
+            }
+            // ratio = p / p' at z and the test of its rounding error bound
+            long double x = zr[i], y = zi[i];
+            long double rr, ri;
+            if (newton_ratio(a, n, x, y, &rr, &ri))
+            {
+                done[i] = true;
+                remaining--;
+            }
+
+            // sum of 1 / (z - z_j)
+            long double sr = 0.0L, si = 0.0L;
+            for (int j = 0; j < n; j++)
+            {
+                if (j != i)
+                {
+                    long double ur, ui;
+                    complex_div(1.0L, 0.0L, x - zr[j], y - zi[j], &ur, &ui);
+                    sr += ur;
+                    si += ui;
+                }
+            }
+            // w = ratio / (1 - ratio * sum)
+            long double wr, wi;
+            complex_div(rr, ri, 1.0L - (rr * sr - ri * si), -(rr * si + ri * sr), &wr, &wi);
+            if (!isfinite(wr) || !isfinite(wi))
+            {
+                // p' vanishes or the correction is singular, a small perturbation gets out of it
+                wr = wi = (hypotl(x, y) + 1.0L) * LDBL_EPSILON;
+            }
+            zr[i] = x - wr;
+            zi[i] = y - wi;
+        }
+    }
+    free(done);
+}
+
+/**
+ * @brief Root of the cluster of approximation i (union-find with path halving).
+ */
+static int cluster_find(int *parent, int i)
+{
+    while (parent[i] != i)
+    {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+/**
+ * @brief Refines a real m-fold root x with Newton's method on p^(m-1), where the root is simple.
+ */
+static long double polish_multiple(const long double *a, int n, int m, long double x)
+{
+    for (int iter = 0; iter < 3; iter++)
+    {
+        // Horner's rule on the derivatives of orders m - 1 and m
+        long double d0 = 0.0L, d1 = 0.0L;
+        for (int i = n; i >= m - 1; i--)
+        {
+            long double f0 = a[i], f1 = a[i];
+            for (int k = 0; k < m - 1; k++)
+            {
+                f0 *= i - k;
+                f1 *= i - k;
+            }
+            f1 *= i - m + 1;
+            d0 = d0 * x + f0;
+            d1 = (i >= m) ? d1 * x + f1 : d1;
+        }
+        if (d1 == 0.0L || !isfinite(d0 / d1))
+        {
+            break;
+        }
+        x -= d0 / d1;
+    }
+    return x;
+}
+
+/**
+ * @brief Moves clusters of approximations that cannot be told apart from real roots onto the real axis.
+ * @details An m-fold root is only found to about LDBL_EPSILON^(1/m), far from the axis for the fixed
+ * tolerance of poly_roots. Every approximation gets the inclusion radius n * (|p(z)| + rounding bound) /
+ * |a_n * prod(z - z_j)|, approximations whose disks overlap form a cluster holding as many roots. A cluster
+ * whose mean lies within its largest radius from the real axis is replaced by its real mean, refined as a
+ * simple root of p^(m-1).
+ */
+static void snap_clusters(const long double *a, int n, long double *zr, long double *zi)
+{
+    long double *radius = malloc((size_t)n * sizeof(long double));
+    int *parent = malloc((size_t)n * sizeof(int));
+    if (radius == NULL || parent == NULL)
+    {
+        fprintf(stderr, "polynomial - memory allocation error\n");
+        abort();
+    }
+
+    // the radii are computed from logarithms, |p(z)| = |z|^n |q(1/z)| does not overflow for large roots
+    for (int i = 0; i < n; i++)
+    {
+        long double x = zr[i], y = zi[i];
+        struct poly_value v;
+        poly_value_at(a, n, x, y, &v);
+        long double lg = logl(n * (hypotl(v.vr, v.vi) + v.bound)) - logl(fabsl(a[n]));
+        lg += v.reversed ? n * logl(hypotl(x, y)) : 0.0L;
+        for (int j = 0; j < n; j++)
+        {
+            if (j != i)
+            {
+                lg -= logl(hypotl(x - zr[j], y - zi[j]));
+            }
+        }
+        radius[i] = expl(lg);
+        // coincident approximations carry no bound
+        radius[i] = isfinite(radius[i]) ? radius[i] : 0.0L;
+        parent[i] = i;
+    }
+
+    for (int i = 0; i < n; i++)
+    {
+        for (int j = i + 1; j < n; j++)
+        {
+            if (hypotl(zr[i] - zr[j], zi[i] - zi[j]) <= radius[i] + radius[j])
+            {
+                parent[cluster_find(parent, j)] = cluster_find(parent, i);
+            }
+        }
+    }
+
+    for (int i = 0; i < n; i++)
+    {
+        if (cluster_find(parent, i) != i)
+        {
+            continue;
+        }
+        int count = 0;
+        long double sum_re = 0.0L, sum_im = 0.0L, largest = 0.0L;
+        for (int j = 0; j < n; j++)
+        {
+            if (cluster_find(parent, j) == i)
+            {
+                count++;
+                sum_re += zr[j];
+                sum_im += zi[j];
+                largest = (radius[j] > largest) ? radius[j] : largest;
+            }
+        }
+        if (fabsl(sum_im / count) > largest)
+        {
+            continue;
+        }
+        long double mean = (count > 1) ? polish_multiple(a, n, count, sum_re / count) : 0.0L;
+        for (int j = 0; j < n; j++)
+        {
+            if (cluster_find(parent, j) == i)
+            {
+                // a single root keeps its value, a cluster becomes its polished mean
+                zr[j] = (count > 1) ? mean : zr[j];
+                zi[j] = 0.0L;
+            }
+        }
+    }
+    free(radius);
+    free(parent);
+}
+
+/**
+ * @brief Compares roots by the real parts and then by the imaginary parts.
+ */
+static int root_cmp(const void *a, const void *b)
+{
+    const struct poly_root *x = a, *y = b;
+    if (x->re != y->re)
+    {
+        return (x->re < y->re) ? -1 : 1;
+    }
+    if (x->im != y->im)
+    {
+        return (x->im < y->im) ? -1 : 1;
+    }
+    return 0;
+}
+
+int poly_roots(const long double *coef, int degree, long double *re, long double *im)
+{
+    if (degree < 0)
+    {
+        return -1;
+    }
+    for (int k = 0; k <= degree; k++)
+    {
+        if (!isfinite(coef[k]))
+        {
+            return -1;
+        }
+    }
+    while (degree >= 0 && coef[degree] == 0.0L)
+    {
+        degree--;
+    }
+    if (degree < 0)
+    {
+        return -1;
+    }
+
+    // zero roots are exact, the rest is a polynomial with a nonzero constant term
+    int zeros = 0;
+    while (coef[zeros] == 0.0L)
+    {
+        zeros++;
+    }
+    const long double *a = coef + zeros;
+    int n = degree - zeros;
+    if (n == 1)
+    {
+        re[0] = -a[0] / a[1];
+        im[0] = 0.0L;
+    }
+    else if (n > 1)
+    {
+        aberth_start(a, n, re, im);
+        aberth(a, n, re, im);
+        for (int k = 0; k < n; k++)
+        {
+            if (!isfinite(re[k]) || !isfinite(im[k]))
+            {
+                return -1; // no wrong roots, the iteration left the range of long double
+            }
+        }
+        snap_clusters(a, n, re, im);
+    }
+    for (int k = n; k < degree; k++)
+    {
+        re[k] = im[k] = 0.0L;
+    }
+    if (degree < 2)
+    {
+        return degree;
+    }
+
+    struct poly_root *roots = malloc((size_t)degree * sizeof(struct poly_root));
+    if (roots == NULL)
+    {
+        fprintf(stderr, "polynomial - memory allocation error\n");
+        abort();
+    }
+    long double tolerance = sqrtl(LDBL_EPSILON);
+    for (int k = 0; k < degree; k++)
+    {
+        long double mod = hypotl(re[k], im[k]);
+        roots[k].re = (fabsl(re[k]) <= tolerance * mod) ? 0.0L : re[k];
+        roots[k].im = (fabsl(im[k]) <= tolerance * mod) ? 0.0L : im[k];
+    }
+    qsort(roots, (size_t)degree, sizeof(struct poly_root), root_cmp);
+    for (int k = 0; k < degree; k++)
+    {
+        re[k] = roots[k].re;
+        im[k] = roots[k].im;
+    }
+    free(roots);
+    return degree;
+}
@@ -0,0 +1,67 @@
+/**
+ * @file polynomial.h
+ * @brief Evaluation and roots of polynomials
+ * @date 18.10.2026
+ *
+ * A polynomial of degree n is given by its coefficients coef[0] + coef[1] x + ... + coef[n] x^n.
+ * Roots are found simultaneously by the Aberth-Ehrlich iteration started from the Newton polygon
+ * of the coefficients, so all of them converge cubically also for widely spread magnitudes.
+ */
+
+#ifndef POLYNOMIAL_H
+#define POLYNOMIAL_H
+
+#include <stddef.h>
+
+/**
+ * @brief Evaluates the polynomial by Horner's scheme.
+ * @param coef coefficients from the constant term
+ * @param degree degree of the polynomial (at least 0)
+ * @param x
+ * @return Value at x.
+ */
+long double poly_eval(const long double *coef, int degree, long double x);
+
+/**
+ * @brief Evaluates the polynomial by Estrin's scheme.
+ * @details Blocks of eight coefficients are evaluated as a tree of independent multiplications and
+ * combined by Horner's scheme in x^8, which shortens the dependency chain of long polynomials.
+ * The result can differ from poly_eval in the last bits.
+ * @param coef coefficients from the constant term
+ * @param degree degree of the polynomial (at least 0)
+ * @param x
+ * @return Value at x.
+ */
+long double poly_eval_estrin(const long double *coef, int degree, long double x);
+
+/**
+ * @brief Evaluates the polynomial at n points, y[i] = p(x[i]).
+ * @details Several points are evaluated at once in vector registers. The results equal Horner's
+ * scheme in double.
+ * @param coef coefficients from the constant term
+ * @param degree degree of the polynomial (at least 0)
+ * @param x points, may be equal to y
+ * @param y results
+ * @param n number of points
+ */
+void poly_eval_batch(const double *coef, int degree, const double *x, double *y, size_t n);
+
+/**
+ * @brief Finds all complex roots of the polynomial.
+ * @details
+ * Leading zero coefficients lower the degree. Roots are sorted by their real parts and then by their
+ * imaginary parts. Approximations whose inclusion disks overlap form a cluster (a multiple root), a cluster
+ * whose mean is within its error bound from the real axis is returned as its real mean, so real and
+ * multiple real roots of real polynomials are returned as real numbers. Remaining real and imaginary
+ * parts smaller than sqrt(LDBL_EPSILON) * |root| are set to zero. Outside the unit circle the reversed
+ * polynomial is evaluated at 1/z, so roots of any magnitude of long double are found.
+ * @param coef coefficients from the constant term
+ * @param degree degree of the polynomial
+ * @param re receives real parts of the roots (at least degree items)
+ * @param im receives imaginary parts of the roots (at least degree items)
+ * @return Number of roots, -1 if all coefficients are zero, some of them is not finite or the iteration
+ * does not stay within the range of long double.
+ */
+int poly_roots(const long double *coef, int degree, long double *re, long double *im);
+
+#endif
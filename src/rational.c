@@ -0,0 +1,499 @@
+/**
+ * @file rational.c
+ * @brief Exact rational numbers
+ * @date 18.10.2026
+ */
+
+#include "rational.h"
+#include "math_library.h"
+#include <math.h>
+#include <string.h>
+
+typedef unsigned __int128 uint128;
+
+#define RATIONAL_REDUCE_SLACK 256 // growth in bits allowed before the big representation is reduced again
+
+static uint128 abs_i128(__int128 x)
+{
+    return (x < 0) ? (uint128)0 - (uint128)x : (uint128)x;
+}
+
+/**
+ * @brief Copies the value of a into bigints num and den (both already initialized).
+ */
+static void rational_to_big(const rational_t *a, bigint_t *num, bigint_t *den)
+{
+    if (a->big)
+    {
+        bigint_copy(num, &a->bnum);
+        bigint_copy(den, &a->bden);
+    }
+    else
+    {
+        bigint_set_i128(num, a->num);
+        bigint_set_i128(den, a->den);
+    }
+}
+
+/**
+ * @brief Moves num and den into r, reduces the fraction if it grew too much since the last reduction.
+ */
+static void rational_set_big(rational_t *r, bigint_t *num, bigint_t *den)
+{
+    bigint_swap(&r->bnum, num);
+    bigint_swap(&r->bden, den);
+    if (r->bden.sign < 0)
+    {
+        r->bden.sign = 1;
+        bigint_neg(&r->bnum, &r->bnum);
+    }
+    if (!r->big)
+    {
+        r->big = true;
+        r->reduced_bits = 0;
+    }
+    size_t bits = bigint_bit_length(&r->bnum) + bigint_bit_length(&r->bden);
+    if (bits > 2 * r->reduced_bits + RATIONAL_REDUCE_SLACK)
+    {
+        rational_normalize(r);
+    }
+}
+
+/**
+ * @brief Stores a small fraction into r, den has to be positive.
+ */
+static void rational_set_small(rational_t *r, __int128 num, __int128 den)
+{
+    r->big = false;
+    r->num = num;
+    r->den = den;
+}
+
+void rational_init(rational_t *r)
+{
+    r->big = false;
+    r->num = 0;
+    r->den = 1;
+    bigint_init(&r->bnum);
+    bigint_init(&r->bden);
+    r->reduced_bits = 0;
+}
+
+void rational_free(rational_t *r)
+{
+    bigint_free(&r->bnum);
+    bigint_free(&r->bden);
+    r->big = false;
+    r->num = 0;
+    r->den = 1;
+}
+
+void rational_copy(rational_t *r, const rational_t *a)
+{
+    if (r == a)
+    {
+        return;
+    }
+    r->big = a->big;
+    r->num = a->num;
+    r->den = a->den;
+    r->reduced_bits = a->reduced_bits;
+    if (a->big)
+    {
+        bigint_copy(&r->bnum, &a->bnum);
+        bigint_copy(&r->bden, &a->bden);
+    }
+}
+
+void rational_set_i64(rational_t *r, long long num, long long den)
+{
+    if (den < 0)
+    {
+        rational_set_small(r, -(__int128)num, -(__int128)den);
+    }
+    else
+    {
+        rational_set_small(r, num, den);
+    }
+}
+
+void rational_set_ld(rational_t *r, long double x)
+{
+    if (x == 0.0L)
+    {
+        rational_set_small(r, 0, 1);
+        return;
+    }
+    // x = mantissa * 2^exp, the mantissa of long double has 64 bits
+    int exp;
+    long double m = frexpl(fabsl(x), &exp);
+    unsigned long long mantissa = ldexpl(m, 64);
+    exp -= 64;
+    int tz = __builtin_ctzll(mantissa);
+    mantissa >>= tz;
+    exp += tz;
+
+    bigint_t num, den;
+    bigint_init(&num);
+    bigint_init(&den);
+    bigint_set_u64(&num, mantissa);
+    bigint_set_u64(&den, 1);
+    if (exp > 0)
+    {
+        bigint_shl(&num, &num, exp);
+    }
+    else
+    {
+        bigint_shl(&den, &den, -exp);
+    }
+    if (x < 0.0L)
+    {
+        num.sign = -1;
+    }
+    rational_set_big(r, &num, &den);
+    rational_normalize(r);
+    bigint_free(&num);
+    bigint_free(&den);
+}
+
+bool rational_set_decimal(rational_t *r, const char *str, char dp_sep)
+{
+    char digits[strlen(str) + 2];
+    size_t len = 0;
+    long scale = 0;
+    bool point = false;
+    const char *pos = str;
+
+    if (*pos == '-' || *pos == '+')
+    {
+        digits[len++] = *pos++;
+    }
+    for (; *pos != '\0' && *pos != 'e' && *pos != 'E'; pos++)
+    {
+        if (*pos == dp_sep && !point)
+        {
+            point = true;
+        }
+        else if (*pos >= '0' && *pos <= '9')
+        {
+            digits[len++] = *pos;
+            scale -= point;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    if (*pos != '\0')
+    {
+        // exponent
+        bigint_t e;
+        bigint_init(&e);
+        __int128 exp;
+        bool valid = bigint_set_string(&e, pos + 1, strlen(pos + 1)) && bigint_get_i128(&e, &exp) &&
+                     exp < 1000000 && exp > -1000000;
+        bigint_free(&e);
+        if (!valid)
+        {
+            return false;
+        }
+        scale += (long)exp;
+    }
+
+    bigint_t num, den, ten;
+    bigint_init(&num);
+    bigint_init(&den);
+    bigint_init(&ten);
+    if (!bigint_set_string(&num, digits, len))
+    {
+        bigint_free(&num);
+        bigint_free(&den);
+        bigint_free(&ten);
+        return false;
+    }
+    bigint_set_u64(&ten, 10);
+    bigint_pow_u64(&ten, &ten, (scale < 0) ? -scale : scale);
+    if (scale >= 0)
+    {
+        bigint_mul(&num, &num, &ten);
+        bigint_set_u64(&den, 1);
+    }
+    else
+    {
+        bigint_swap(&den, &ten);
+    }
+    rational_set_big(r, &num, &den);
+    rational_normalize(r);
+    bigint_free(&num);
+    bigint_free(&den);
+    bigint_free(&ten);
+    return true;
+}
+
+long double rational_get_ld(const rational_t *r)
+{
+    if (!r->big)
+    {
+        return (long double)r->num / (long double)r->den;
+    }
+    // keeps 128 significant bits of both parts, so that neither of them overflows
+    size_t nbits = bigint_bit_length(&r->bnum), dbits = bigint_bit_length(&r->bden);
+    size_t nshift = (nbits > 128) ? nbits - 128 : 0, dshift = (dbits > 128) ? dbits - 128 : 0;
+    bigint_t num, den;
+    bigint_init(&num);
+    bigint_init(&den);
+    bigint_shr(&num, &r->bnum, nshift);
+    bigint_shr(&den, &r->bden, dshift);
+    long double result = ldexpl(bigint_get_ld(&num) / bigint_get_ld(&den), (long)nshift - (long)dshift);
+    bigint_free(&num);
+    bigint_free(&den);
+    return result;
+}
+
+void rational_normalize(rational_t *r)
+{
+    if (!r->big)
+    {
+        uint128 g = gcd_u128(abs_i128(r->num), (uint128)r->den);
+        if (g > 1)
+        {
+            r->num /= (__int128)g;
+            r->den /= (__int128)g;
+        }
+        return;
+    }
+
+    bigint_t g;
+    bigint_init(&g);
+    bigint_gcd(&g, &r->bnum, &r->bden);
+    if (g.size != 1 || g.limbs[0] != 1)
+    {
+        bigint_divmod(&r->bnum, NULL, &r->bnum, &g);
+        bigint_divmod(&r->bden, NULL, &r->bden, &g);
+    }
+    bigint_free(&g);
+
+    __int128 num, den;
+    if (bigint_get_i128(&r->bnum, &num) && bigint_get_i128(&r->bden, &den))
+    {
+        rational_set_small(r, num, den);
+    }
+    r->reduced_bits = bigint_bit_length(&r->bnum) + bigint_bit_length(&r->bden);
+}
+
+size_t rational_get_string(rational_t *r, char *str, size_t size)
+{
+    rational_normalize(r);
+    bigint_t num, den;
+    bigint_init(&num);
+    bigint_init(&den);
+    rational_to_big(r, &num, &den);
+
+    size_t len = bigint_get_string(&num, NULL, 0);
+    size_t den_len = 0;
+    bool integer = (den.size == 1 && den.limbs[0] == 1);
+    if (!integer)
+    {
+        den_len = bigint_get_string(&den, NULL, 0);
+    }
+    size_t total = len + (integer ? 0 : 1 + den_len);
+    if (total < size)
+    {
+        bigint_get_string(&num, str, size);
+        if (!integer)
+        {
+            str[len] = '/';
+            bigint_get_string(&den, str + len + 1, size - len - 1);
+        }
+    }
+    bigint_free(&num);
+    bigint_free(&den);
+    return total;
+}
+
+bool rational_is_zero(const rational_t *r)
+{
+    return r->big ? bigint_is_zero(&r->bnum) : r->num == 0;
+}
+
+bool rational_is_integer(rational_t *r)
+{
+    rational_normalize(r);
+    return !r->big && r->den == 1;
+}
+
+/**
+ * @brief r = a + sign*b
+ */
+static void rational_add_signed(rational_t *r, const rational_t *a, const rational_t *b, int sign)
+{
+    if (!a->big && !b->big)
+    {
+        __int128 bn = b->num, n, t1, t2, d;
+        bool ok = (sign > 0) || !__builtin_sub_overflow((__int128)0, b->num, &bn);
+        if (ok && a->den == b->den)
+        {
+            // common denominator, no multiplication needed
+            if (!__builtin_add_overflow(a->num, bn, &n))
+            {
+                rational_set_small(r, n, a->den);
+                return;
+            }
+        }
+        else if (ok)
+        {
+            // a/b + c/d = (a*(d/g) + c*(b/g)) / (b/g*d), g = gcd(b, d) only when the plain formula overflows
+            __int128 g = 1;
+            for (int attempt = 0; attempt < 2; attempt++)
+            {
+                if (!__builtin_mul_overflow(a->num, b->den / g, &t1) && !__builtin_mul_overflow(bn, a->den / g, &t2) &&
+                    !__builtin_add_overflow(t1, t2, &n) && !__builtin_mul_overflow(a->den / g, b->den, &d))
+                {
+                    rational_set_small(r, n, d);
+                    return;
+                }
+                g = (__int128)gcd_u128((uint128)a->den, (uint128)b->den);
+                if (g == 1)
+                {
+                    break;
+                }
+            }
+        }
+    }
+
+    bigint_t an, ad, bn, bd, t;
+    bigint_init(&an);
+    bigint_init(&ad);
+    bigint_init(&bn);
+    bigint_init(&bd);
+    bigint_init(&t);
+    rational_to_big(a, &an, &ad);
+    rational_to_big(b, &bn, &bd);
+    if (sign < 0)
+    {
+        bigint_neg(&bn, &bn);
+    }
+    if (bigint_cmp(&ad, &bd) == 0)
+    {
+        bigint_add(&an, &an, &bn);
+    }
+    else
+    {
+        bigint_mul(&an, &an, &bd);
+        bigint_mul(&t, &bn, &ad);
+        bigint_add(&an, &an, &t);
+        bigint_mul(&ad, &ad, &bd);
+    }
+    rational_set_big(r, &an, &ad);
+    bigint_free(&an);
+    bigint_free(&ad);
+    bigint_free(&bn);
+    bigint_free(&bd);
+    bigint_free(&t);
+}
+
+void rational_add(rational_t *r, const rational_t *a, const rational_t *b)
+{
+    rational_add_signed(r, a, b, 1);
+}
+
+void rational_sub(rational_t *r, const rational_t *a, const rational_t *b)
+{
+    rational_add_signed(r, a, b, -1);
+}
+
+void rational_mul(rational_t *r, const rational_t *a, const rational_t *b)
+{
+    if (!a->big && !b->big)
+    {
+        __int128 n, d;
+        if (!__builtin_mul_overflow(a->num, b->num, &n) && !__builtin_mul_overflow(a->den, b->den, &d))
+        {
+            rational_set_small(r, n, d);
+            return;
+        }
+        // cross reduction before giving up on the small representation
+        __int128 g1 = (__int128)gcd_u128(abs_i128(a->num), (uint128)b->den);
+        __int128 g2 = (__int128)gcd_u128(abs_i128(b->num), (uint128)a->den);
+        if (!__builtin_mul_overflow(a->num / g1, b->num / g2, &n) &&
+            !__builtin_mul_overflow(a->den / g2, b->den / g1, &d))
+        {
+            rational_set_small(r, n, d);
+            return;
+        }
+    }
+
+    bigint_t an, ad, bn, bd;
+    bigint_init(&an);
+    bigint_init(&ad);
+    bigint_init(&bn);
+    bigint_init(&bd);
+    rational_to_big(a, &an, &ad);
+    rational_to_big(b, &bn, &bd);
+    bigint_mul(&an, &an, &bn);
+    bigint_mul(&ad, &ad, &bd);
+    rational_set_big(r, &an, &ad);
+    bigint_free(&an);
+    bigint_free(&ad);
+    bigint_free(&bn);
+    bigint_free(&bd);
+}
+
+bool rational_div(rational_t *r, const rational_t *a, const rational_t *b)
+{
+    if (rational_is_zero(b))
+    {
+        return false;
+    }
+    rational_t inv;
+    rational_init(&inv);
+    if (!b->big && (uint128)b->num != (uint128)1 << 127) // -num overflows only for the minimal value
+    {
+        if (b->num < 0)
+        {
+            rational_set_small(&inv, -b->den, -b->num);
+        }
+        else
+        {
+            rational_set_small(&inv, b->den, b->num);
+        }
+    }
+    else
+    {
+        bigint_t num, den;
+        bigint_init(&num);
+        bigint_init(&den);
+        rational_to_big(b, &num, &den);
+        rational_set_big(&inv, &den, &num); // the sign is moved to the numerator
+        bigint_free(&num);
+        bigint_free(&den);
+    }
+    rational_mul(r, a, &inv);
+    rational_free(&inv);
+    return true;
+}
+
+void rational_pow(rational_t *r, const rational_t *a, unsigned long e)
+{
+    rational_t base, result;
+    rational_init(&base);
+    rational_init(&result);
+    rational_copy(&base, a);
+    rational_normalize(&base);
+    rational_set_i64(&result, 1, 1);
+    while (e > 0)
+    {
+        if (e & 1)
+        {
+            rational_mul(&result, &result, &base);
+        }
+        e >>= 1;
+        if (e > 0)
+        {
+            rational_mul(&base, &base, &base);
+        }
+    }
+    rational_copy(r, &result);
+    rational_free(&base);
+    rational_free(&result);
+}
@@ -0,0 +1,139 @@
+/**
+ * @file rational.h
+ * @brief Exact rational numbers
+ * @date 18.10.2026
+ *
+ * Numerator and denominator are kept in 128-bit integers while they fit and are promoted
+ * to arbitrary-precision integers (bigint.h) on overflow.
+ * Fractions are reduced lazily: only when an operation would overflow, when the size of the
+ * big representation grows past a threshold, or on conversion to a string.
+ * Every rational_t has to be initialized with rational_init and released with rational_free.
+ */
+
+#ifndef RATIONAL_H
+#define RATIONAL_H
+
+#include "bigint.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+/** @struct rational
+ *  @brief Rational number num/den, den > 0.
+ *  @param big true if the value is stored in bnum/bden instead of num/den
+ *  @param num numerator of the small representation
+ *  @param den denominator of the small representation
+ *  @param bnum numerator of the big representation
+ *  @param bden denominator of the big representation
+ *  @param reduced_bits size of the big representation after the last reduction
+ */
+struct rational
+{
+    bool big;
+    __int128 num;
+    __int128 den;
+    bigint_t bnum;
+    bigint_t bden;
+    size_t reduced_bits;
+};
+
+typedef struct rational rational_t;
+
+/**
+ * @brief Initializes the number to zero.
+ * @param r
+ */
+void rational_init(rational_t *r);
+
+/**
+ * @brief Frees memory of the number.
+ * @param r
+ */
+void rational_free(rational_t *r);
+
+/**
+ * @brief r = a
+ */
+void rational_copy(rational_t *r, const rational_t *a);
+
+/**
+ * @brief r = num/den
+ * @param r
+ * @param num
+ * @param den den != 0
+ */
+void rational_set_i64(rational_t *r, long long num, long long den);
+
+/**
+ * @brief Sets r to the exact value of x.
+ * @param r
+ * @param x finite number
+ */
+void rational_set_ld(rational_t *r, long double x);
+
+/**
+ * @brief Parses a number in decimal notation, e.g. "-12.5e-3", exactly.
+ * @param r receives the value
+ * @param str string to be parsed
+ * @param dp_sep decimal point character
+ * @return false if str is not a valid number
+ */
+bool rational_set_decimal(rational_t *r, const char *str, char dp_sep);
+
+/**
+ * @brief Converts the number to long double.
+ */
+long double rational_get_ld(const rational_t *r);
+
+/**
+ * @brief Reduces the fraction to its lowest terms and demotes it to 128 bits if possible.
+ * @param r
+ */
+void rational_normalize(rational_t *r);
+
+/**
+ * @brief Writes the reduced fraction as "num/den" or "num" if den = 1.
+ * @param r the fraction is reduced in place
+ * @param str destination
+ * @param size size of str
+ * @return length of the string, the string is written only if it is lower than size
+ */
+size_t rational_get_string(rational_t *r, char *str, size_t size);
+
+/**
+ * @brief Tests whether the number is zero.
+ */
+bool rational_is_zero(const rational_t *r);
+
+/**
+ * @brief Tests whether the number is an integer.
+ * @param r the fraction is reduced in place
+ */
+bool rational_is_integer(rational_t *r);
+
+/**
+ * @brief r = a + b
+ */
+void rational_add(rational_t *r, const rational_t *a, const rational_t *b);
+
+/**
+ * @brief r = a - b
+ */
+void rational_sub(rational_t *r, const rational_t *a, const rational_t *b);
+
+/**
+ * @brief r = a * b
+ */
+void rational_mul(rational_t *r, const rational_t *a, const rational_t *b);
+
+/**
+ * @brief r = a / b
+ * @return false if b is zero, r is unchanged in that case
+ */
+bool rational_div(rational_t *r, const rational_t *a, const rational_t *b);
+
+/**
+ * @brief r = a^e
+ */
+void rational_pow(rational_t *r, const rational_t *a, unsigned long e);
+
+#endif
@@ -0,0 +1,1506 @@
+/**
+ * @file stddev.c
+ * @brief Sample standard deviation of numbers read from the standard input
+ * @date 18.10.2026
+ *
+ * Usage: stddev [-r] [-c column] [-t threads] [-p percentiles [-e] [-m megabytes]] [-H histogram] [file]
+ *        stddev --window size [-c column] [file]
+ *        stddev --csv [-r] [-t threads] [file]
+ *        stddev --csv [--pair x,y]... [-t threads] [file]
+ *
+ * Numbers are separated by white space (any character up to the space). The standard input is read in
+ * large blocks and parsed in place, the values are summarized in batches by the streaming statistics of
+ * the math library, so the memory use does not depend on the size of the input. A file given by its name
+ * is mapped to memory and split into chunks that end at separators, the chunks are summarized by
+ * separate threads and the partial summaries are merged. A columnar file (columnar.h) is used without
+ * parsing, its column given by -c (0 by default) is split by rows among the threads. With -r, the sums
+ * are kept exactly, so the result does not depend on the number of threads. With -p 50,95,99, the given
+ * percentiles are printed after the standard deviation, one per line, estimated by a t-digest of every
+ * thread (the digests are merged like the other summaries). With -e, the percentiles are exact: all numbers
+ * are collected within the memory budget given by -m in MiB (256 by default), sorted runs of them are
+ * spilled to a temporary file in $TMPDIR and merged (extsort.h). With -H, a histogram is counted in the
+ * same pass and printed last: -H 50 has 50 bins of a width that adapts to the numbers, -H 50,0,10 has 50
+ * bins from 0 to 10 and -H 50,1,1e6,log has 50 bins of equal ratios. With --window N, a line with the
+ * mean, standard deviation, minimum and maximum of the last N numbers is printed after every number
+ * instead, the numbers are processed in order by one thread and the lines are flushed after every block
+ * read from the standard input, so the tool can follow a live stream. With --csv, the input is CSV text
+ * and every column is summarized in one pass: the commas and line breaks are found by the vector scanner
+ * of columnar.h, the fields between them are parsed into batches of their columns and a line
+ * "name count mean stddev min max" is printed per column. A header line is detected like in csv2col,
+ * empty fields are missing values. A file is split among the threads at line breaks. Every --pair x,y
+ * (column indices) adds a line "pair x y count covariance correlation slope intercept" of the lines where
+ * both values are present, the slope and intercept are those of the least-squares line y = slope x +
+ * intercept. The co-moments are merged like the other summaries, they are not reproducible with -r.
+ */
+
+#define _POSIX_C_SOURCE 200809L // mmap, fstat, sysconf
+
+#include "columnar.h"
+#include "extsort.h"
+#include "math_library.h"
+#include <fcntl.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define STDDEV_BLOCK (1 << 20)      // bytes read at once
+#define STDDEV_BATCH 1024           // values passed to the statistics at once
+#define STDDEV_MIN_CHUNK (1 << 22)  // smallest part of a mapped file given to a thread
+#define STDDEV_MAX_PERCENTILES 64   // longest list of percentiles given by -p
+#define STDDEV_MEMORY 256           // default memory budget of the exact percentiles in MiB
+#define STDDEV_CSV_WINDOW (1 << 16) // characters of CSV text scanned for separators at once
+#define STDDEV_CSV_BATCH 256        // values of a column of CSV text passed to the statistics at once
+#define STDDEV_MAX_PAIRS 64         // most pairs of columns given by --pair
+
+/**
+ * @brief Tells whether c separates numbers.
+ */
+static inline bool is_separator(char c)
+{
+    return (unsigned char)c <= ' ';
+}
+
+/** @struct summary
+ *  @brief Summary of the numbers, either streaming or reproducible, optionally with their distribution.
+ *  @param reproducible true if repro is used, false for stats
+ *  @param quantiles true if digest is used
+ *  @param shift_set false until the shift of repro is known (the first number is used)
+ *  @param stats streaming summary
+ *  @param repro reproducible summary
+ *  @param digest sketch of the distribution for quantiles
+ *  @param exact collection of all numbers for exact quantiles shared by all summaries, or NULL
+ *  @param histogram true if hist is used
+ *  @param hist counts of the numbers in bins
+ *  @param window sliding window printed after every number instead of the other statistics, or NULL
+ */
+struct summary
+{
+    bool reproducible;
+    bool quantiles;
+    bool shift_set;
+    stats_t stats;
+    stats_repro_t repro;
+    tdigest_t digest;
+    extsort_t *exact;
+    bool histogram;
+    histogram_t hist;
+    window_t *window;
+};
+
+/**
+ * @brief Initializes an empty summary, the shift of a reproducible one is the first added number.
+ */
+static void summary_init(struct summary *s, bool reproducible, bool quantiles)
+{
+    s->reproducible = reproducible;
+    s->quantiles = quantiles;
+    s->shift_set = false;
+    s->exact = NULL;
+    s->histogram = false;
+    s->window = NULL;
+    stats_init(&s->stats);
+    stats_repro_init(&s->repro, 0.0);
+    tdigest_init(&s->digest);
+}
+
+/**
+ * @brief Sets the shift of an empty reproducible summary, summaries merged together need the same shift.
+ */
+static void summary_set_shift(struct summary *s, double shift)
+{
+    stats_repro_init(&s->repro, isfinite(shift) ? shift : 0.0);
+    s->shift_set = true;
+}
+
+/**
+ * @brief Adds n numbers to the summary.
+ */
+static void summary_add(struct summary *s, const double *x, size_t n)
+{
+    if (s->window != NULL)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            stats_t w;
+            window_add(s->window, x[i]);
+            window_get(s->window, &w);
+            printf("%.15g %.15g %.15g %.15g\n", (double)stats_mean(&w), (double)stats_stddev(&w), (double)stats_min(&w),
+                   (double)stats_max(&w));
+        }
+        return;
+    }
+    if (s->quantiles)
+    {
+        tdigest_add_array(&s->digest, x, n);
+    }
+    if (s->exact != NULL)
+    {
+        extsort_add(s->exact, x, n); // the status is checked at the end
+    }
+    if (s->histogram)
+    {
+        histogram_add_array(&s->hist, x, n);
+    }
+    if (!s->reproducible)
+    {
+        stats_add_array(&s->stats, x, n);
+        return;
+    }
+    if (!s->shift_set && n > 0)
+    {
+        summary_set_shift(s, x[0]);
+    }
+    stats_repro_add_array(&s->repro, x, n);
+}
+
+/**
+ * @brief Merges summary t into s.
+ * @details The summaries are copies of one summary, so their histograms have the same mode and number of
+ * bins. Fixed bins are the same, the bins of adaptive histograms are widened by every copy on its own and
+ * histogram_merge aligns them.
+ * @return false if the histograms cannot be merged, an error message is printed in that case
+ */
+static bool summary_merge(struct summary *s, const struct summary *t)
+{
+    bool ok = true;
+    if (s->quantiles)
+    {
+        tdigest_merge(&s->digest, &t->digest);
+    }
+    if (s->histogram && !histogram_merge(&s->hist, &t->hist))
+    {
+        fprintf(stderr, "stddev - the histograms of the threads have different bins\n");
+        ok = false;
+    }
+    if (s->reproducible)
+    {
+        stats_repro_merge(&s->repro, &t->repro);
+    }
+    else
+    {
+        stats_merge(&s->stats, &t->stats);
+    }
+    return ok;
+}
+
+/**
+ * @brief Parses all numbers in [p, end) and adds them to the summary.
+ * @param batch buffer of STDDEV_BATCH values
+ * @param filled number of values in the batch, updated
+ * @return false if a token is not a number, an error message is printed in that case
+ */
+static bool process(const char *p, const char *end, struct summary *s, double *batch, size_t *filled)
+{
+    while (true)
+    {
+        while (p < end && is_separator(*p))
+        {
+            p++;
+        }
+        if (p == end)
+        {
+            return true;
+        }
+        const char *token = p;
+        while (p < end && !is_separator(*p))
+        {
+            p++;
+        }
+        if (!col_parse_double(token, p, &batch[*filled]))
+        {
+            int len = (p - token > 40) ? 40 : (int)(p - token);
+            fprintf(stderr, "stddev - invalid number '%.*s'\n", len, token);
+            return false;
+        }
+        if (++*filled == STDDEV_BATCH)
+        {
+            summary_add(s, batch, STDDEV_BATCH);
+            *filled = 0;
+        }
+    }
+}
+
+/** @struct chunk
+ *  @brief Part of a mapped file summarized by one thread.
+ *  @param begin first character
+ *  @param end character after the last one
+ *  @param summary summary of the numbers in the chunk, initialized by the caller
+ *  @param ok false if the chunk contains an invalid number
+ */
+struct chunk
+{
+    const char *begin;
+    const char *end;
+    struct summary summary;
+    bool ok;
+};
+
+/** @struct column_part
+ *  @brief Rows of a column of a columnar file summarized by one thread.
+ *  @param file columnar file
+ *  @param column index of the column
+ *  @param first first row
+ *  @param last row after the last one
+ *  @param summary summary of the values, initialized by the caller
+ */
+struct column_part
+{
+    const col_file_t *file;
+    unsigned column;
+    size_t first;
+    size_t last;
+    struct summary summary;
+};
+
+/**
+ * @brief Thread function, summarizes the numbers of a chunk (struct chunk).
+ */
+static void *chunk_thread(void *arg)
+{
+    struct chunk *c = arg;
+    double batch[STDDEV_BATCH];
+    size_t filled = 0;
+    c->ok = process(c->begin, c->end, &c->summary, batch, &filled);
+    summary_add(&c->summary, batch, filled);
+    return NULL;
+}
+
+/**
+ * @brief Thread function, summarizes the rows of a column (struct column_part).
+ * @details Runs of present values of doubles are summarized in place, missing values are skipped like the
+ * empty fields of --csv. Integers are converted in batches.
+ */
+static void *column_thread(void *arg)
+{
+    struct column_part *p = arg;
+    bool integers = (p->file->types[p->column] == COL_INT64);
+    size_t start = 0;
+    for (size_t g = 0; g < p->file->groups && start < p->last; g++)
+    {
+        size_t rows;
+        const void *values = col_column(p->file, g, p->column, &rows);
+        size_t from = (p->first > start) ? p->first - start : 0;
+        size_t to = (p->last - start < rows) ? p->last - start : rows;
+        for (size_t i = from, first, len; !integers && i < to; i = first + len)
+        {
+            len = col_present_run((const double *)values + i, to - i, &first);
+            first += i;
+            summary_add(&p->summary, (const double *)values + first, len);
+        }
+        for (size_t i = from; integers && i < to; i += STDDEV_BATCH)
+        {
+            double batch[STDDEV_BATCH];
+            size_t len = (to - i < STDDEV_BATCH) ? to - i : STDDEV_BATCH;
+            for (size_t k = 0; k < len; k++)
+            {
+                batch[k] = (double)((const long long *)values)[i + k];
+            }
+            summary_add(&p->summary, batch, len);
+        }
+        start += rows;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Runs the thread function on every task, the last task in the calling thread.
+ * @param thread thread function
+ * @param tasks array of count tasks of task_size bytes
+ */
+static void run_parallel(void *(*thread)(void *), void *tasks, size_t task_size, size_t count)
+{
+    pthread_t *ids = malloc(count * sizeof(pthread_t));
+    bool *started = calloc(count, sizeof(bool));
+    if (ids == NULL || started == NULL)
+    {
+        fprintf(stderr, "stddev - memory allocation error\n");
+        abort();
+    }
+    for (size_t i = 0; i + 1 < count; i++)
+    {
+        started[i] = (pthread_create(&ids[i], NULL, thread, (char *)tasks + i * task_size) == 0);
+        if (!started[i])
+        {
+            thread((char *)tasks + i * task_size);
+        }
+    }
+    thread((char *)tasks + (count - 1) * task_size);
+    for (size_t i = 0; i + 1 < count; i++)
+    {
+        if (started[i])
+        {
+            pthread_join(ids[i], NULL);
+        }
+    }
+    free(ids);
+    free(started);
+}
+
+/**
+ * @brief Number of parts of the input for the given number of threads.
+ * @param threads number of threads, 0 for the number of online processors
+ * @param max largest useful number of parts
+ */
+static size_t part_count(long threads, size_t max)
+{
+    if (threads == 0)
+    {
+        threads = sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    return (threads < 1 || max < 1) ? 1 : ((size_t)threads < max ? (size_t)threads : max);
+}
+
+/**
+ * @brief Summarizes a stream read in blocks, a block is whatever a read returns (at most STDDEV_BLOCK).
+ * @return false if the stream contains an invalid number or cannot be read
+ */
+static bool summarize_stream(FILE *f, struct summary *s)
+{
+    // room for an incomplete number from the previous block
+    char *buffer = malloc(STDDEV_BLOCK + COL_MAX_TOKEN);
+    double *batch = malloc(STDDEV_BATCH * sizeof(double));
+    if (buffer == NULL || batch == NULL)
+    {
+        fprintf(stderr, "stddev - memory allocation error\n");
+        abort();
+    }
+
+    size_t filled = 0, carry = 0;
+    bool ok = true;
+    while (ok)
+    {
+        ssize_t got = read(fileno(f), buffer + carry, STDDEV_BLOCK);
+        if (got < 0)
+        {
+            perror("stddev");
+            ok = false;
+            break;
+        }
+        size_t len = carry + (size_t)got;
+        if (got == 0)
+        {
+            ok = process(buffer, buffer + len, s, batch, &filled);
+            break;
+        }
+        // the number at the end of the block may continue in the next one
+        size_t cut = len;
+        while (cut > 0 && !is_separator(buffer[cut - 1]))
+        {
+            cut--;
+        }
+        if (len - cut > COL_MAX_TOKEN)
+        {
+            fprintf(stderr, "stddev - number too long\n");
+            ok = false;
+            break;
+        }
+        ok = process(buffer, buffer + cut, s, batch, &filled);
+        carry = len - cut;
+        memmove(buffer, buffer + cut, carry);
+        if (s->window != NULL)
+        {
+            // a live stream gets the lines of the numbers read so far
+            summary_add(s, batch, filled);
+            filled = 0;
+            fflush(stdout);
+        }
+    }
+    summary_add(s, batch, filled);
+    free(buffer);
+    free(batch);
+    return ok;
+}
+
+/**
+ * @brief Maps a file to memory for sequential reading.
+ * @param size receives the size of the file
+ * @param ok set to false if the file cannot be mapped, an error message is printed in that case
+ * @return mapped file, NULL if it is empty or cannot be mapped
+ */
+static const char *map_file(const char *path, size_t *size, bool *ok)
+{
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0)
+    {
+        perror(path);
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        *ok = false;
+        return NULL;
+    }
+    *size = (size_t)st.st_size;
+    if (*size == 0)
+    {
+        close(fd);
+        return NULL;
+    }
+    const char *data = mmap(NULL, *size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        perror(path);
+        *ok = false;
+        return NULL;
+    }
+    posix_madvise((void *)data, *size, POSIX_MADV_SEQUENTIAL);
+    return data;
+}
+
+/**
+ * @brief Summarizes a file mapped to memory, its chunks are processed in parallel.
+ * @param threads number of threads, 0 for the number of online processors
+ * @return false if the file contains an invalid number, cannot be mapped or the summaries cannot be merged
+ */
+static bool summarize_file(const char *path, long threads, struct summary *s)
+{
+    size_t size;
+    bool mapped = true;
+    const char *data = map_file(path, &size, &mapped);
+    if (data == NULL)
+    {
+        return mapped;
+    }
+
+    // all chunks of a reproducible summary use the first number of the file as the shift
+    const char *first = data, *first_end;
+    while (first < data + size && is_separator(*first))
+    {
+        first++;
+    }
+    for (first_end = first; first_end < data + size && !is_separator(*first_end); first_end++)
+    {
+    }
+    double shift;
+    if (first == first_end || !col_parse_double(first, first_end, &shift))
+    {
+        shift = 0.0;
+    }
+    summary_set_shift(s, shift);
+
+    size_t count = part_count(threads, size / STDDEV_MIN_CHUNK);
+    struct chunk *chunks = malloc(count * sizeof(struct chunk));
+    if (chunks == NULL)
+    {
+        fprintf(stderr, "stddev - memory allocation error\n");
+        abort();
+    }
+    // every chunk starts right after a separator, so no number is split
+    size_t begin = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        size_t end = (i + 1 == count) ? size : size / count * (i + 1);
+        while (end < size && !is_separator(data[end - 1]))
+        {
+            end++;
+        }
+        end = (end < begin) ? begin : end;
+        chunks[i].begin = data + begin;
+        chunks[i].end = data + end;
+        chunks[i].summary = *s;
+        begin = end;
+    }
+    run_parallel(chunk_thread, chunks, sizeof(struct chunk), count);
+    bool ok = true;
+    for (size_t i = 0; i < count; i++)
+    {
+        ok &= summary_merge(s, &chunks[i].summary);
+        ok &= chunks[i].ok;
+    }
+    munmap((void *)data, size);
+    free(chunks);
+    return ok;
+}
+
+/**
+ * @brief Summarizes a column of a columnar file, parts of its rows are processed in parallel.
+ * @param threads number of threads, 0 for the number of online processors
+ * @return false if the column does not exist or the summaries of the parts cannot be merged
+ */
+static bool summarize_columnar(const col_file_t *f, unsigned column, long threads, struct summary *s)
+{
+    if (column >= f->cols)
+    {
+        fprintf(stderr, "stddev - the file has only %u columns\n", f->cols);
+        return false;
+    }
+    if (f->rows == 0)
+    {
+        return true;
+    }
+    // the shift of a reproducible summary is the first value of the column
+    size_t rows = 0;
+    const void *values = NULL;
+    for (size_t g = 0; rows == 0; g++)
+    {
+        values = col_column(f, g, column, &rows);
+    }
+    double shift = (f->types[column] == COL_INT64) ? (double)*(const long long *)values : *(const double *)values;
+    summary_set_shift(s, shift);
+
+    size_t count = part_count(threads, f->rows * sizeof(double) / STDDEV_MIN_CHUNK);
+    struct column_part *parts = malloc(count * sizeof(struct column_part));
+    if (parts == NULL)
+    {
+        fprintf(stderr, "stddev - memory allocation error\n");
+        abort();
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        parts[i].file = f;
+        parts[i].column = column;
+        parts[i].first = f->rows / count * i;
+        parts[i].last = (i + 1 == count) ? f->rows : f->rows / count * (i + 1);
+        parts[i].summary = *s;
+    }
+    run_parallel(column_thread, parts, sizeof(struct column_part), count);
+    bool ok = true;
+    for (size_t i = 0; i < count; i++)
+    {
+        ok &= summary_merge(s, &parts[i].summary);
+    }
+    free(parts);
+    return ok;
+}
+
+/** @struct csv_columns
+ *  @brief Summaries of all columns of CSV text, either streaming or reproducible.
+ *  @param cols number of columns
+ *  @param reproducible true if repro is used, false for stats
+ *  @param stats streaming summary of every column
+ *  @param repro reproducible summary of every column
+ *  @param batch values not added yet, STDDEV_CSV_BATCH per column
+ *  @param filled number of the values in the batch of every column
+ *  @param offsets separators of a window of the text found by col_csv_scan
+ *  @param pairs number of the pairs of columns summarized together
+ *  @param pair columns of the pairs, x and y of every pair
+ *  @param pair_stats summary of every pair
+ *  @param row values of the current line, nan for the missing ones, used only for pairs
+ *  @param pair_batch pairs not added yet, STDDEV_CSV_BATCH values of x and then of y per pair
+ *  @param pair_filled number of the pairs in the batch of every pair of columns
+ */
+struct csv_columns
+{
+    unsigned cols;
+    bool reproducible;
+    stats_t *stats;
+    stats_repro_t *repro;
+    double *batch;
+    size_t *filled;
+    unsigned *offsets;
+    size_t pairs;
+    const unsigned *pair;
+    stats_pair_t *pair_stats;
+    double *row;
+    double *pair_batch;
+    size_t *pair_filled;
+};
+
+/**
+ * @brief Allocates the summaries of the columns and of the pairs of columns and empty batches.
+ */
+static void csv_columns_alloc(struct csv_columns *c, unsigned cols, bool reproducible, size_t pairs,
+                              const unsigned *pair)
+{
+    c->cols = cols;
+    c->reproducible = reproducible;
+    c->pairs = pairs;
+    c->pair = pair;
+    c->pair_stats = malloc(pairs * sizeof(stats_pair_t));
+    c->row = malloc(cols * sizeof(double));
+    c->pair_batch = malloc(pairs * 2 * STDDEV_CSV_BATCH * sizeof(double));
+    c->pair_filled = calloc(pairs, sizeof(size_t));
+    if ((pairs > 0 && (c->pair_stats == NULL || c->pair_batch == NULL || c->pair_filled == NULL)) || c->row == NULL)
+    {
+        fprintf(stderr, "stddev - memory allocation error\n");
+        abort();
+    }
+    for (unsigned i = 0; i < cols; i++)
+    {
+        c->row[i] = NAN;
+    }
+    c->stats = malloc(cols * sizeof(stats_t));
+    c->repro = reproducible ? malloc(cols * sizeof(stats_repro_t)) : NULL;
+    c->batch = malloc((size_t)cols * STDDEV_CSV_BATCH * sizeof(double));
+    c->filled = calloc(cols, sizeof(size_t));
+    c->offsets = malloc(STDDEV_CSV_WINDOW * sizeof(unsigned));
+    if (c->stats == NULL || (reproducible && c->repro == NULL) || c->batch == NULL || c->filled == NULL ||
+        c->offsets == NULL)
+    {
+        fprintf(stderr, "stddev - memory allocation error\n");
+        abort();
+    }
+}
+
+/**
+ * @brief Initializes empty summaries of the columns and of the pairs of columns.
+ * @param shifts shifts of the reproducible summaries of all columns, summaries merged together need the
+ * same shifts
+ * @param pairs number of the pairs of columns
+ * @param pair columns of the pairs, x and y of every pair, they must stay valid
+ */
+static void csv_columns_init(struct csv_columns *c, unsigned cols, bool reproducible, const double *shifts,
+                             size_t pairs, const unsigned *pair)
+{
+    csv_columns_alloc(c, cols, reproducible, pairs, pair);
+    for (size_t i = 0; i < pairs; i++)
+    {
+        stats_pair_init(&c->pair_stats[i]);
+    }
+    for (unsigned i = 0; i < cols; i++)
+    {
+        stats_init(&c->stats[i]);
+        if (reproducible)
+        {
+            stats_repro_init(&c->repro[i], isfinite(shifts[i]) ? shifts[i] : 0.0);
+        }
+    }
+}
+
+/**
+ * @brief Initializes c as a copy of the summaries of t with empty batches.
+ */
+static void csv_columns_copy(struct csv_columns *c, const struct csv_columns *t)
+{
+    csv_columns_alloc(c, t->cols, t->reproducible, t->pairs, t->pair);
+    memcpy(c->stats, t->stats, t->cols * sizeof(stats_t));
+    memcpy(c->pair_stats, t->pair_stats, t->pairs * sizeof(stats_pair_t));
+    if (t->reproducible)
+    {
+        memcpy(c->repro, t->repro, t->cols * sizeof(stats_repro_t));
+    }
+}
+
+/**
+ * @brief Adds the batch of a column to its summary.
+ */
+static void csv_columns_flush(struct csv_columns *c, unsigned column)
+{
+    const double *x = c->batch + (size_t)column * STDDEV_CSV_BATCH;
+    if (c->reproducible)
+    {
+        stats_repro_add_array(&c->repro[column], x, c->filled[column]);
+    }
+    else
+    {
+        stats_add_array(&c->stats[column], x, c->filled[column]);
+    }
+    c->filled[column] = 0;
+}
+
+/**
+ * @brief Adds the batches of all columns and pairs of columns to their summaries.
+ */
+static void csv_columns_flush_all(struct csv_columns *c)
+{
+    for (unsigned i = 0; i < c->cols; i++)
+    {
+        csv_columns_flush(c, i);
+    }
+    for (size_t i = 0; i < c->pairs; i++)
+    {
+        const double *x = c->pair_batch + 2 * i * STDDEV_CSV_BATCH;
+        stats_pair_add_array(&c->pair_stats[i], x, x + STDDEV_CSV_BATCH, c->pair_filled[i]);
+        c->pair_filled[i] = 0;
+    }
+}
+
+/**
+ * @brief Adds the pairs of columns of a complete line to their batches and clears the line.
+ */
+static void csv_columns_pairs(struct csv_columns *c)
+{
+    for (size_t i = 0; i < c->pairs; i++)
+    {
+        double x = c->row[c->pair[2 * i]], y = c->row[c->pair[2 * i + 1]];
+        if (isnan(x) || isnan(y))
+        {
+            continue; // a missing value
+        }
+        double *batch = c->pair_batch + 2 * i * STDDEV_CSV_BATCH;
+        batch[c->pair_filled[i]] = x;
+        batch[STDDEV_CSV_BATCH + c->pair_filled[i]] = y;
+        if (++c->pair_filled[i] == STDDEV_CSV_BATCH)
+        {
+            stats_pair_add_array(&c->pair_stats[i], batch, batch + STDDEV_CSV_BATCH, STDDEV_CSV_BATCH);
+            c->pair_filled[i] = 0;
+        }
+    }
+    for (size_t i = 0; i < 2 * c->pairs; i++)
+    {
+        c->row[c->pair[i]] = NAN;
+    }
+}
+
+/**
+ * @brief Merges the summaries of the columns of t into c, the batches of t must be flushed.
+ */
+static void csv_columns_merge(struct csv_columns *c, const struct csv_columns *t)
+{
+    for (unsigned i = 0; i < c->cols; i++)
+    {
+        if (c->reproducible)
+        {
+            stats_repro_merge(&c->repro[i], &t->repro[i]);
+        }
+        else
+        {
+            stats_merge(&c->stats[i], &t->stats[i]);
+        }
+    }
+    for (size_t i = 0; i < c->pairs; i++)
+    {
+        stats_pair_merge(&c->pair_stats[i], &t->pair_stats[i]);
+    }
+}
+
+/**
+ * @brief Frees the summaries of the columns.
+ */
+static void csv_columns_free(struct csv_columns *c)
+{
+    free(c->stats);
+    free(c->repro);
+    free(c->batch);
+    free(c->filled);
+    free(c->offsets);
+    free(c->pair_stats);
+    free(c->row);
+    free(c->pair_batch);
+    free(c->pair_filled);
+}
+
+/**
+ * @brief Removes spaces, tabs and carriage returns around a field.
+ */
+static void csv_trim(const char **begin, const char **end)
+{
+    while (*begin < *end && (**begin == ' ' || **begin == '\t' || **begin == '\r'))
+    {
+        (*begin)++;
+    }
+    while (*end > *begin && ((*end)[-1] == ' ' || (*end)[-1] == '\t' || (*end)[-1] == '\r'))
+    {
+        (*end)--;
+    }
+}
+
+/**
+ * @brief Adds a field ended by a separator to the batch of its column, an empty field is a missing value.
+ * @param column index of the field in its line, updated for the next field
+ * @param line_end true if the field is the last one of its line
+ * @return false if the field is not a number or the line has a different number of fields, an error
+ * message is printed in that case
+ */
+static bool csv_field(struct csv_columns *c, const char *begin, const char *end, unsigned *column, bool line_end)
+{
+    csv_trim(&begin, &end);
+    if (*column == 0 && begin == end && line_end)
+    {
+        return true; // empty line
+    }
+    if (*column >= c->cols || (line_end && *column + 1 < c->cols))
+    {
+        fprintf(stderr, "stddev - a line does not have %u fields\n", c->cols);
+        return false;
+    }
+    if (begin < end)
+    {
+        double *batch = c->batch + (size_t)*column * STDDEV_CSV_BATCH;
+        if (!col_parse_double(begin, end, &batch[c->filled[*column]]))
+        {
+            int len = (end - begin > 40) ? 40 : (int)(end - begin);
+            fprintf(stderr, "stddev - invalid number '%.*s'\n", len, begin);
+            return false;
+        }
+        c->row[*column] = batch[c->filled[*column]];
+        if (++c->filled[*column] == STDDEV_CSV_BATCH)
+        {
+            csv_columns_flush(c, *column);
+        }
+    }
+    if (line_end && c->pairs > 0)
+    {
+        csv_columns_pairs(c);
+    }
+    *column = line_end ? 0 : *column + 1;
+    return true;
+}
+
+/**
+ * @brief Parses the CSV lines in [p, end) and adds their fields to the summaries of their columns.
+ * @details The separators of windows of STDDEV_CSV_WINDOW characters are found by col_csv_scan, the fields
+ * between them are parsed. The last line does not need a line break. The batches are not flushed.
+ * @return false if a field is not a number or a line has a different number of fields
+ */
+static bool process_csv(const char *p, const char *end, struct csv_columns *c)
+{
+    unsigned column = 0;
+    const char *field = p;
+    for (const char *w = p; w < end; w += STDDEV_CSV_WINDOW)
+    {
+        size_t len = ((size_t)(end - w) < STDDEV_CSV_WINDOW) ? (size_t)(end - w) : STDDEV_CSV_WINDOW;
+        size_t count = col_csv_scan(w, len, c->offsets);
+        for (size_t i = 0; i < count; i++)
+        {
+            const char *separator = w + c->offsets[i];
+            if (!csv_field(c, field, separator, &column, *separator == '\n'))
+            {
+                return false;
+            }
+            field = separator + 1;
+        }
+    }
+    return (field < end || column > 0) ? csv_field(c, field, end, &column, true) : true;
+}
+
+/**
+ * @brief Reads the first line of CSV text: its number of fields, and their names if it is a header.
+ * @param names receives copies of the names of the columns if the line is a header (it does not contain
+ * numbers only), NULL otherwise
+ * @param cols receives the number of fields
+ * @return start of the data, after the header, or NULL if the line has too many fields
+ */
+static const char *csv_header(const char *p, const char *end, char ***names, unsigned *cols)
+{
+    const char *line_end = memchr(p, '\n', (size_t)(end - p));
+    line_end = (line_end != NULL) ? line_end : end;
+    unsigned count = 0;
+    bool header = false;
+    for (const char *field = p; field <= line_end; count++)
+    {
+        const char *sep = field;
+        while (sep < line_end && *sep != ',')
+        {
+            sep++;
+        }
+        const char *b = field, *e = sep;
+        double v;
+        csv_trim(&b, &e);
+        header |= (b < e && !col_parse_double(b, e, &v));
+        field = sep + 1;
+    }
+    if (count > COL_MAX_COLUMNS)
+    {
+        fprintf(stderr, "stddev - more than %d columns\n", COL_MAX_COLUMNS);
+        return NULL;
+    }
+    *cols = count;
+    *names = NULL;
+    if (!header)
+    {
+        return p;
+    }
+    *names = malloc(count * sizeof(char *));
+    if (*names == NULL)
+    {
+        fprintf(stderr, "stddev - memory allocation error\n");
+        abort();
+    }
+    const char *field = p;
+    for (unsigned i = 0; i < count; i++)
+    {
+        const char *sep = field;
+        while (sep < line_end && *sep != ',')
+        {
+            sep++;
+        }
+        const char *b = field, *e = sep;
+        csv_trim(&b, &e);
+        (*names)[i] = malloc((size_t)(e - b) + 1);
+        if ((*names)[i] == NULL)
+        {
+            fprintf(stderr, "stddev - memory allocation error\n");
+            abort();
+        }
+        memcpy((*names)[i], b, (size_t)(e - b));
+        (*names)[i][e - b] = '\0';
+        field = sep + 1;
+    }
+    return (line_end < end) ? line_end + 1 : end;
+}
+
+/**
+ * @brief Shifts of reproducible summaries, the fields of the first line of the data (0 if not a number).
+ */
+static void csv_shifts(const char *p, const char *end, unsigned cols, double *shifts)
+{
+    const char *field = p;
+    for (unsigned i = 0; i < cols; i++)
+    {
+        const char *sep = field;
+        while (sep < end && *sep != ',' && *sep != '\n')
+        {
+            sep++;
+        }
+        const char *b = field, *e = sep;
+        csv_trim(&b, &e);
+        if (b == e || !col_parse_double(b, e, &shifts[i]))
+        {
+            shifts[i] = 0.0;
+        }
+        field = (sep < end && *sep == ',') ? sep + 1 : sep;
+    }
+}
+
+/** @struct csv_table
+ *  @brief Columns of CSV text and their summaries.
+ *  @param names names from the header, or NULL
+ *  @param columns summaries, initialized when the first line is read
+ *  @param started true after the first line
+ *  @param pairs number of the pairs of columns summarized together
+ *  @param pair columns of the pairs, x and y of every pair
+ */
+struct csv_table
+{
+    char **names;
+    struct csv_columns columns;
+    bool started;
+    size_t pairs;
+    const unsigned *pair;
+};
+
+/**
+ * @brief Reads the header of the text and initializes the summaries of its columns.
+ * @return start of the data, or NULL if the header is invalid
+ */
+static const char *csv_start(const char *p, const char *end, bool reproducible, struct csv_table *t)
+{
+    unsigned cols;
+    const char *data = csv_header(p, end, &t->names, &cols);
+    if (data == NULL)
+    {
+        return NULL;
+    }
+    for (size_t i = 0; i < 2 * t->pairs; i++)
+    {
+        if (t->pair[i] >= cols)
+        {
+            fprintf(stderr, "stddev - the file has only %u columns\n", cols);
+            return NULL;
+        }
+    }
+    double *shifts = malloc(cols * sizeof(double));
+    if (shifts == NULL)
+    {
+        fprintf(stderr, "stddev - memory allocation error\n");
+        abort();
+    }
+    csv_shifts(data, end, cols, shifts);
+    csv_columns_init(&t->columns, cols, reproducible, shifts, t->pairs, t->pair);
+    free(shifts);
+    t->started = true;
+    return data;
+}
+
+/** @struct csv_chunk
+ *  @brief Lines of a mapped CSV file summarized by one thread.
+ *  @param begin first character, the start of a line
+ *  @param end character after the last one
+ *  @param columns summaries of the columns of the chunk, initialized by the caller
+ *  @param ok false if the chunk contains an invalid line
+ */
+struct csv_chunk
+{
+    const char *begin;
+    const char *end;
+    struct csv_columns columns;
+    bool ok;
+};
+
+/**
+ * @brief Thread function, summarizes the columns of a chunk of lines (struct csv_chunk).
+ */
+static void *csv_thread(void *arg)
+{
+    struct csv_chunk *c = arg;
+    c->ok = process_csv(c->begin, c->end, &c->columns);
+    csv_columns_flush_all(&c->columns);
+    return NULL;
+}
+
+/**
+ * @brief Summarizes the columns of a mapped CSV file, chunks of its lines are processed in parallel.
+ * @param threads number of threads, 0 for the number of online processors
+ * @return false if the file contains an invalid line or cannot be mapped
+ */
+static bool summarize_csv_file(const char *path, long threads, bool reproducible, struct csv_table *t)
+{
+    size_t size;
+    bool ok = true;
+    const char *data = map_file(path, &size, &ok);
+    const char *begin = (data != NULL) ? csv_start(data, data + size, reproducible, t) : NULL;
+    if (begin == NULL)
+    {
+        if (data != NULL)
+        {
+            munmap((void *)data, size);
+        }
+        return ok && data == NULL;
+    }
+
+    size_t rest = (size_t)(data + size - begin);
+    size_t count = part_count(threads, rest / STDDEV_MIN_CHUNK);
+    struct csv_chunk *chunks = malloc(count * sizeof(struct csv_chunk));
+    if (chunks == NULL)
+    {
+        fprintf(stderr, "stddev - memory allocation error\n");
+        abort();
+    }
+    // every chunk starts at the start of a line
+    size_t start = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        size_t stop = (i + 1 == count) ? rest : rest / count * (i + 1);
+        while (stop < rest && stop > 0 && begin[stop - 1] != '\n')
+        {
+            stop++;
+        }
+        stop = (stop < start) ? start : stop;
+        chunks[i].begin = begin + start;
+        chunks[i].end = begin + stop;
+        csv_columns_copy(&chunks[i].columns, &t->columns);
+        start = stop;
+    }
+    run_parallel(csv_thread, chunks, sizeof(struct csv_chunk), count);
+    for (size_t i = 0; i < count; i++)
+    {
+        csv_columns_merge(&t->columns, &chunks[i].columns);
+        ok &= chunks[i].ok;
+        csv_columns_free(&chunks[i].columns);
+    }
+    munmap((void *)data, size);
+    free(chunks);
+    return ok;
+}
+
+/**
+ * @brief Summarizes the columns of CSV text read from a stream in blocks that end at line breaks.
+ * @return false if the stream contains an invalid line or cannot be read
+ */
+static bool summarize_csv_stream(FILE *f, bool reproducible, struct csv_table *t)
+{
+    // room for an incomplete line from the previous block
+    char *buffer = malloc(2 * STDDEV_BLOCK);
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "stddev - memory allocation error\n");
+        abort();
+    }
+    size_t carry = 0;
+    bool ok = true;
+    while (ok)
+    {
+        ssize_t got = read(fileno(f), buffer + carry, STDDEV_BLOCK);
+        if (got < 0)
+        {
+            perror("stddev");
+            ok = false;
+            break;
+        }
+        size_t len = carry + (size_t)got, cut = len;
+        while (got > 0 && cut > 0 && buffer[cut - 1] != '\n')
+        {
+            cut--;
+        }
+        if (got > 0 && len - cut >= STDDEV_BLOCK)
+        {
+            fprintf(stderr, "stddev - line too long\n");
+            ok = false;
+            break;
+        }
+        const char *data = buffer;
+        if (cut > 0 && !t->started && (data = csv_start(buffer, buffer + cut, reproducible, t)) == NULL)
+        {
+            ok = false;
+            break;
+        }
+        ok = (cut == 0) || process_csv(data, buffer + cut, &t->columns);
+        if (got == 0)
+        {
+            break;
+        }
+        carry = len - cut;
+        memmove(buffer, buffer + cut, carry);
+    }
+    if (t->started)
+    {
+        csv_columns_flush_all(&t->columns);
+    }
+    free(buffer);
+    return ok;
+}
+
+/**
+ * @brief Parses a comma-separated list of percentiles from 0 to 100.
+ * @param list
+ * @param percentiles receives at most STDDEV_MAX_PERCENTILES percentiles
+ * @return number of percentiles, 0 if the list is invalid
+ */
+static size_t parse_percentiles(const char *list, double *percentiles)
+{
+    size_t count = 0;
+    const char *p = list;
+    while (count < STDDEV_MAX_PERCENTILES)
+    {
+        const char *comma = strchr(p, ',');
+        const char *end = (comma != NULL) ? comma : p + strlen(p);
+        double v;
+        if (!col_parse_double(p, end, &v) || !(v >= 0.0 && v <= 100.0))
+        {
+            return 0;
+        }
+        percentiles[count++] = v;
+        if (comma == NULL)
+        {
+            return count;
+        }
+        p = comma + 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Parses a histogram given as bins, bins,low,high or bins,low,high,log and initializes it.
+ * @return false if the histogram is invalid
+ */
+static bool parse_histogram(const char *spec, histogram_t *h)
+{
+    double v[3] = {0.0, 0.0, 0.0};
+    size_t count = 0;
+    const char *p = spec;
+    bool log_scale = false;
+    while (true)
+    {
+        const char *comma = strchr(p, ',');
+        const char *end = (comma != NULL) ? comma : p + strlen(p);
+        if (count == 3 && strcmp(p, "log") == 0)
+        {
+            log_scale = true;
+        }
+        else if (count == 3 || !col_parse_double(p, end, &v[count++]))
+        {
+            return false;
+        }
+        if (comma == NULL)
+        {
+            break;
+        }
+        p = comma + 1;
+    }
+    if (count == 2 || !(v[0] >= 1.0 && v[0] <= HIST_MAX_BINS) || v[0] != floor(v[0]))
+    {
+        return false;
+    }
+    int mode = (count == 1) ? HIST_ADAPTIVE : log_scale ? HIST_LOG : HIST_LINEAR;
+    return histogram_init(h, mode, (size_t)v[0], v[1], v[2]);
+}
+
+/**
+ * @brief Prints the bins from the first to the last nonempty one as lines "h lower upper count", preceded
+ * and followed by the counts below and above them when there are such numbers.
+ */
+static void print_histogram(const histogram_t *h)
+{
+    size_t first = 0, last = h->bins;
+    while (first < last && h->count[first] == 0)
+    {
+        first++;
+    }
+    while (last > first && h->count[last - 1] == 0)
+    {
+        last--;
+    }
+    if (h->below > 0)
+    {
+        printf("below %llu\n", h->below);
+    }
+    for (size_t i = first; i < last; i++)
+    {
+        printf("h %.15g %.15g %llu\n", histogram_edge(h, i), histogram_edge(h, i + 1), h->count[i]);
+    }
+    if (h->above > 0)
+    {
+        printf("above %llu\n", h->above);
+    }
+}
+
+/**
+ * @brief Name of a column of CSV text, its index if there is no header.
+ * @param buffer room for the index
+ */
+static const char *csv_name(const struct csv_table *t, unsigned column, char *buffer)
+{
+    if (t->names != NULL)
+    {
+        return t->names[column];
+    }
+    sprintf(buffer, "%u", column);
+    return buffer;
+}
+
+/**
+ * @brief Summarizes all columns of CSV text and prints a line "name count mean stddev min max" for every
+ * column, the name is its index if there is no header. A line "pair x y count covariance correlation
+ * slope intercept" follows for every pair of columns, of the lines where both values are present.
+ * @param path file name, NULL or "-" for the standard input
+ * @param threads number of threads, 0 for the number of online processors
+ * @param pairs number of the pairs of columns
+ * @param pair columns of the pairs, x and y of every pair
+ * @return false if the text contains an invalid line or cannot be read
+ */
+static bool summarize_csv(const char *path, long threads, bool reproducible, size_t pairs, const unsigned *pair)
+{
+    struct csv_table t;
+    t.names = NULL;
+    t.started = false;
+    t.pairs = pairs;
+    t.pair = pair;
+    bool ok = (path == NULL || strcmp(path, "-") == 0) ? summarize_csv_stream(stdin, reproducible, &t)
+                                                         : summarize_csv_file(path, threads, reproducible, &t);
+    char x[16], y[16];
+    for (unsigned i = 0; ok && t.started && i < t.columns.cols; i++)
+    {
+        stats_t s = t.columns.stats[i];
+        if (reproducible)
+        {
+            stats_repro_get(&t.columns.repro[i], &s);
+        }
+        printf("%s %llu %.15Lg %.15Lg %.15Lg %.15Lg\n", csv_name(&t, i, x), s.count, stats_mean(&s),
+               stats_stddev(&s), stats_min(&s), stats_max(&s));
+    }
+    for (size_t i = 0; ok && t.started && i < pairs; i++)
+    {
+        const stats_pair_t *s = &t.columns.pair_stats[i];
+        printf("pair %s %s %llu %.15Lg %.15Lg %.15Lg %.15Lg\n", csv_name(&t, pair[2 * i], x),
+               csv_name(&t, pair[2 * i + 1], y), s->count, stats_pair_covariance(s), stats_pair_correlation(s),
+               stats_pair_slope(s), stats_pair_intercept(s));
+    }
+    if (t.started)
+    {
+        for (unsigned i = 0; t.names != NULL && i < t.columns.cols; i++)
+        {
+            free(t.names[i]);
+        }
+        csv_columns_free(&t.columns);
+    }
+    free(t.names);
+    return ok;
+}
+
+int main(int argc, char *argv[])
+{
+    long threads = 0;
+    long column = 0;
+    bool reproducible = false, exact = false;
+    long memory = STDDEV_MEMORY;
+    double percentiles[STDDEV_MAX_PERCENTILES];
+    size_t percentile_count = 0;
+    histogram_t hist;
+    bool histogram = false;
+    long window_size = 0;
+    bool csv = false;
+    unsigned pair[2 * STDDEV_MAX_PAIRS];
+    size_t pairs = 0;
+    const char *path = NULL;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-r") == 0)
+        {
+            reproducible = true;
+        }
+        else if (strcmp(argv[i], "-e") == 0)
+        {
+            exact = true;
+        }
+        else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+        {
+            char *stop;
+            memory = strtol(argv[++i], &stop, 10);
+            if (*stop != '\0' || memory < 1 || memory > (long)(SIZE_MAX >> 20))
+            {
+                fprintf(stderr, "stddev - invalid memory budget '%s'\n", argv[i]);
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+        {
+            char *stop;
+            column = strtol(argv[++i], &stop, 10);
+            if (*stop != '\0' || column < 0 || column >= COL_MAX_COLUMNS)
+            {
+                fprintf(stderr, "stddev - invalid column '%s'\n", argv[i]);
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+        {
+            char *stop;
+            threads = strtol(argv[++i], &stop, 10);
+            if (*stop != '\0' || threads < 1)
+            {
+                fprintf(stderr, "stddev - invalid number of threads '%s'\n", argv[i]);
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc)
+        {
+            percentile_count = parse_percentiles(argv[++i], percentiles);
+            if (percentile_count == 0)
+            {
+                fprintf(stderr, "stddev - invalid percentiles '%s'\n", argv[i]);
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--csv") == 0)
+        {
+            csv = true;
+        }
+        else if (strcmp(argv[i], "--pair") == 0 && i + 1 < argc)
+        {
+            unsigned x, y;
+            int used = 0;
+            if (pairs == STDDEV_MAX_PAIRS || sscanf(argv[++i], "%u,%u%n", &x, &y, &used) != 2 ||
+                argv[i][used] != '\0' || x >= COL_MAX_COLUMNS || y >= COL_MAX_COLUMNS)
+            {
+                fprintf(stderr, "stddev - invalid pair of columns '%s'\n", argv[i]);
+                return 1;
+            }
+            pair[2 * pairs] = x;
+            pair[2 * pairs++ + 1] = y;
+        }
+        else if (strcmp(argv[i], "--window") == 0 && i + 1 < argc)
+        {
+            char *stop;
+            window_size = strtol(argv[++i], &stop, 10);
+            if (*stop != '\0' || window_size < 1)
+            {
+                fprintf(stderr, "stddev - invalid window size '%s'\n", argv[i]);
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "-H") == 0 && i + 1 < argc)
+        {
+            histogram = parse_histogram(argv[++i], &hist);
+            if (!histogram)
+            {
+                fprintf(stderr, "stddev - invalid histogram '%s'\n", argv[i]);
+                return 1;
+            }
+        }
+        else if (path == NULL && (argv[i][0] != '-' || strcmp(argv[i], "-") == 0))
+        {
+            path = argv[i];
+        }
+        else
+        {
+            window_size = -1;
+            break;
+        }
+    }
+    if (window_size < 0 || (window_size > 0 && (reproducible || percentile_count > 0 || histogram || csv)) ||
+        (csv && (percentile_count > 0 || histogram || column != 0)) || (pairs > 0 && (!csv || reproducible)))
+    {
+        fprintf(stderr, "usage: stddev [-r] [-c column] [-t threads] [-p percentiles [-e] [-m megabytes]] [-H histogram] [file]\n"
+                        "       stddev --window size [-c column] [file]\n"
+                        "       stddev --csv [-r] [-t threads] [file]\n"
+                        "       stddev --csv [--pair x,y]... [-t threads] [file]\n");
+        return 1;
+    }
+    if (csv)
+    {
+        return summarize_csv(path, threads, reproducible, pairs, pair) ? 0 : 1;
+    }
+
+    // the threads of the mapped files and of the sorting of the exact percentiles
+    select_set_threads((int)threads);
+    struct summary sum;
+    summary_init(&sum, reproducible, percentile_count > 0 && !exact);
+    if (histogram)
+    {
+        sum.histogram = true;
+        sum.hist = hist;
+    }
+    window_t window;
+    if (window_size > 0)
+    {
+        // the lines follow the order of the numbers
+        threads = 1;
+        window_init(&window, (size_t)window_size);
+        sum.window = &window;
+    }
+    extsort_t runs;
+    if (percentile_count > 0 && exact)
+    {
+        extsort_init(&runs, (size_t)memory << 20);
+        sum.exact = &runs;
+    }
+    bool ok;
+    col_file_t f;
+    if (path == NULL || strcmp(path, "-") == 0)
+    {
+        ok = summarize_stream(stdin, &sum);
+    }
+    else if (col_open(&f, path) == COL_OK)
+    {
+        ok = summarize_columnar(&f, (unsigned)column, threads, &sum);
+        col_close(&f);
+    }
+    else
+    {
+        ok = summarize_file(path, threads, &sum);
+    }
+    if (sum.window != NULL)
+    {
+        window_free(&window);
+        return ok ? 0 : 1;
+    }
+    stats_t s = sum.stats;
+    if (reproducible)
+    {
+        stats_repro_get(&sum.repro, &s);
+    }
+    if (ok && s.count < 2)
+    {
+        fprintf(stderr, "stddev - at least two numbers are required\n");
+        ok = false;
+    }
+    double q[STDDEV_MAX_PERCENTILES], values[STDDEV_MAX_PERCENTILES];
+    for (size_t i = 0; ok && i < percentile_count; i++)
+    {
+        q[i] = percentiles[i] / 100.0;
+        values[i] = tdigest_quantile(&sum.digest, q[i]);
+    }
+    if (ok && sum.exact != NULL && extsort_quantiles(&runs, q, percentile_count, values) != EXTSORT_OK)
+    {
+        perror("stddev - temporary file");
+        ok = false;
+    }
+    if (sum.exact != NULL)
+    {
+        extsort_free(&runs);
+    }
+    if (!ok)
+    {
+        return 1;
+    }
+    printf("%.15Lg\n", stats_stddev(&s));
+    for (size_t i = 0; i < percentile_count; i++)
+    {
+        printf("p%g %.15g\n", percentiles[i], values[i]);
+    }
+    if (histogram)
+    {
+        print_histogram(&sum.hist);
+    }
+    return 0;
+}